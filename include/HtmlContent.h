@@ -9,13 +9,7 @@
         "<html lang=\"en\"> "
         "<head> "
             "<title>${title}</title> "
-            "<style> "
-            "body { background-color: #FFFFFF; color: #000000; } "
-            "h1 { text-align: center; background-color: #5878B0; color: #FFFFFF; border: 3px; border-radius: 15px; } "
-            "h2 { text-align: center; background-color: #58ADB0; color: #FFFFFF; border: 3px; } "
-            "#wrapper { background-color: #E6EFFF; padding: 20px; margin-left: auto; margin-right: auto; max-width: 700px; box-shadow: 3px 3px 3px #333 } "
-            "#info { font-size: 30px; font-weight: bold; line-height: 150%; } "
-            "</style> "
+            "<link rel=\"stylesheet\" href=\"/style.css\"> "
         "</head> "
         ""
         "<div id=\"wrapper\"> "
@@ -25,44 +19,106 @@
         "</html>"
     };
 
-    const char PROGMEM ADMIN_PAGE[] = {
-        "<form name=\"settings\" method=\"post\" id=\"settings\" action=\"admin\"> "
-            "<h2>WiFi</h2> "
-            "SSID: <input maxlength=\"32\" type=\"text\" value=\"${ssid}\" name=\"ssid\" id=\"ssid\"> <br> "
-            "Password: <input maxlength=\"63\" type=\"text\" value=\"${pwd}\" name=\"pwd\" id=\"pwd\"> <br> "
-            "<h2>Application</h2> "
-            "Title: <input maxlength=\"50\" type=\"text\" value=\"${title}\" name=\"title\" id=\"title\"> <br> "
-            "Heading: <input maxlength=\"50\" type=\"text\" value=\"${heading}\" name=\"heading\" id=\"heading\"> <br> "
-            "Units:<br>"
-            "<input type=\"radio\" id=\"celsius\" name=\"units\" value=\"celsius\" ${unitcchecked}>"
-            "<label for=\"celsius\">Celsius</label>"
-            "<br>"
-            "<input type=\"radio\" id=\"fahrenheit\" name=\"units\" value=\"fahrenheit\" ${unitfchecked}>"
-            "<label for=\"fahrenheit\">Fahrenheit</label>"
-            "<h2>Admin</h2> "
-            "Admin User: <input maxlength=\"12\" type=\"text\" value=\"${adminuser}\" name=\"adminuser\" id=\"adminuser\"> <br> "
-            "Admin Password: <input maxlength=\"12\" type=\"text\" value=\"${adminpwd}\" name=\"adminpwd\" id=\"adminpwd\"> <br> "
-            "<br> "
-            "<input type=\"submit\"> <a href='/'><h4>Home</h4></a>"
-        "</form>"
+    // Formats for snprintf_P rather than templates; Keeps the API endpoints off the heap...
+    const char PROGMEM INFO_JSON[] = {
+        "{"
+            "\"title_text\": \"%s\", "
+            "\"heading_text\": \"%s\", "
+            "\"device_id\": \"%s\", "
+            "\"hostname\": \"%s\", "
+            "\"temp\": %s, "
+            "\"temp_unit\": \"%s\", "
+            "\"humidity_percent\": %s, "
+            "\"timestamp_ms\": %s, "
+            "\"time_synced\": %s"
+        "}"
     };
 
-    const char PROGMEM ROOT_PAGE[] = {
-        "Temperature:\t${temp}&deg;${unit}<br>"
-        "Humidity:\t${humidity}%<br><br>"
-        "Device ID:\t${deviceid}<br><br>"
+    const char PROGMEM BOOT_JSON[] = {
+        "{"
+            "\"settings_loaded_ms\": %lu, "
+            "\"sensor_ready_ms\": %lu, "
+            "\"server_up_ms\": %lu, "
+            "\"associated_ms\": %lu, "
+            "\"ip_acquired_ms\": %lu, "
+            "\"last_connect_ms\": %lu, "
+            "\"last_connect_direct\": %s, "
+            "\"connects\": %lu, "
+            "\"battery_mode\": %s, "
+            "\"battery_wakes\": %lu, "
+            "\"battery_failed_wakes\": %lu, "
+            "\"last_wake_sensor_ready_ms\": %lu, "
+            "\"last_wake_ip_acquired_ms\": %lu, "
+            "\"last_wake_delivered_ms\": %lu, "
+            "\"last_wake_ms\": %lu, "
+            "\"battery_average_ua\": %lu"
+        "}"
     };
 
-    const char PROGMEM INFO_JSON[] = {
+    const char PROGMEM DIAG_JSON[] = {
         "{"
-            "\"title_text\": \"${title}\", "
-            "\"heading_text\": \"${heading}\", "
-            "\"device_id\": \"${deviceid}\", "
-            "\"hostname\": \"${hostname}\", "
-            "\"temp\": ${tempvalue}, "
-            "\"temp_unit\": \"${tempunit}\", "
-            "\"humidity_percent\": ${humidity}"
+            "\"requests_admitted\": %lu, "
+            "\"requests_rate_limited\": %lu, "
+            "\"requests_rejected_busy\": %lu, "
+            "\"network_state\": \"%s\", "
+            "\"network_reconnects\": %lu, "
+            "\"flash_writes\": %lu, "
+            "\"settings_sequence\": %lu, "
+            "\"backlog_readings\": %lu, "
+            "\"backlog_queued\": %lu, "
+            "\"backlog_dropped\": %lu, "
+            "\"backlog_forwarded\": %lu, "
+            "\"mqtt_state\": \"%s\", "
+            "\"mqtt_connects\": %lu, "
+            "\"mqtt_published\": %lu, "
+            "\"mqtt_acknowledged\": %lu, "
+            "\"mqtt_resent\": %lu, "
+            "\"mqtt_last_refusal\": %lu, "
+            "\"mqtt_backlog_readings\": %lu, "
+            "\"mqtt_backlog_dropped\": %lu, "
+            "\"broadcast_enabled\": %s, "
+            "\"mdns_running\": %s, "
+            "\"hub_mode\": %s, "
+            "\"hub_sensors\": %lu, "
+            "\"power_cpu_mhz\": %lu, "
+            "\"power_sleep_mode\": \"%s\", "
+            "\"power_duty_percent\": %lu, "
+            "\"power_sample_duty_percent\": %lu, "
+            "\"power_sample_energy_uj\": %lu, "
+            "\"power_average_sample_energy_uj\": %lu, "
+            "\"power_total_energy_mj\": %lu"
         "}"
     };
 
+    // Only the head; The handlers and history follow in chunks...
+    const char PROGMEM HEAP_JSON[] = {
+        "{"
+            "\"alloc_counting\": %s, "
+            "\"allocs\": %lu, "
+            "\"alloc_bytes\": %lu, "
+            "\"free_bytes\": %lu, "
+            "\"max_block_bytes\": %lu, "
+            "\"fragmentation_percent\": %lu, "
+            "\"worst_free_bytes\": %lu, "
+            "\"worst_max_block_bytes\": %lu, "
+            "\"worst_fragmentation_percent\": %lu, "
+            "\"loops\": %lu, "
+            "\"loops_allocating\": %lu, "
+            "\"last_loop_allocs\": %lu, "
+            "\"last_loop_alloc_bytes\": %lu, "
+            "\"max_loop_allocs\": %lu, "
+            "\"handlers\": ["
+    };
+
+    // Only the head; The sections follow in chunks...
+    const char PROGMEM PROFILE_JSON[] = {
+        "{"
+            "\"enabled\": %s, "
+            "\"cpu_mhz\": %lu, "
+            "\"loops\": %lu, "
+            "\"slowest_loop_us\": %lu, "
+            "\"slowest_loop_at_ms\": %lu, "
+            "\"sections\": ["
+    };
+
 #endif
\ No newline at end of file
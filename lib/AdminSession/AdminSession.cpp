@@ -0,0 +1,143 @@
+/*
+    AdminSession - A class used to issue and check short lived session tokens
+    for the admin pages, so that only the first admin request of a session
+    has to go through the digest authentication.
+
+    Written by: Scott Griffis
+    Date: 10-19-2026
+*/
+
+#include "AdminSession.h"
+
+#include <Arduino.h>
+#include <bearssl/bearssl.h>
+
+/**
+ * #### CLASS CONSTRUCTOR ####
+ * Allows for external instantiation of
+ * the class into an object.
+*/
+AdminSession::AdminSession() {
+    // Keys are generated by revokeAll() once the hardware RNG is usable...
+    memset(key, 0, sizeof(key));
+}
+
+/**
+ * Generates a new random key, which invalidates every
+ * token issued so far. Must be called once at startup and
+ * then whenever the admin credentials change.
+*/
+void AdminSession::revokeAll() {
+    ESP.random(key, sizeof(key));
+}
+
+/**
+ * Issues a new session token in the form of a Set-Cookie
+ * header value.
+ * 
+ * @param nowMillis The current time in milliseconds as unsigned long.
+ * 
+ * @return Returns the value for the Set-Cookie header as String.
+*/
+String AdminSession::issueCookie(unsigned long nowMillis) {
+    uint8_t mac[ADMIN_SESSION_MAC_LEN];
+    calcMac((uint32_t) nowMillis, mac);
+
+    char token[ADMIN_SESSION_TOKEN_LEN + 1];
+    snprintf(token, sizeof(token), "%08lx", (unsigned long) (uint32_t) nowMillis);
+    for (int i = 0; i < ADMIN_SESSION_MAC_LEN; i++) {
+        snprintf(&token[8 + (i * 2)], 3, "%02x", mac[i]);
+    }
+
+    String cookie = F(ADMIN_SESSION_COOKIE "=");
+    cookie.concat(token);
+    cookie.concat(F("; Path=/admin; Max-Age="));
+    cookie.concat(String(ADMIN_SESSION_TTL_MILLIS / 1000ul));
+    cookie.concat(F("; Secure; HttpOnly; SameSite=Strict"));
+
+    return cookie;
+}
+
+/**
+ * Checks to see if the given Cookie header holds a session token
+ * which is both genuine and not yet expired. The cookie's name must
+ * start the header or follow "; ", so a cookie whose name merely
+ * ends the same way isn't taken for it. The token's MAC is
+ * compared in constant time so its timing gives nothing away.
+ * 
+ * @param cookieHeader The Cookie header from the request as String.
+ * @param nowMillis The current time in milliseconds as unsigned long.
+ * 
+ * @return Returns true if the session is valid otherwise false as bool.
+*/
+bool AdminSession::isValid(const String &cookieHeader, unsigned long nowMillis) {
+    int index = cookieHeader.indexOf(F(ADMIN_SESSION_COOKIE "="));
+    while (index > 0 && !(index >= 2 && cookieHeader[index - 2] == ';' && cookieHeader[index - 1] == ' ')) { // Tail of another cookie's name...
+        index = cookieHeader.indexOf(F(ADMIN_SESSION_COOKIE "="), index + 1);
+    }
+    if (index < 0) { // No session cookie...
+
+        return false;
+    }
+    index += strlen(ADMIN_SESSION_COOKIE "=");
+    if ((cookieHeader.length() - index) < ADMIN_SESSION_TOKEN_LEN) { // Token is cut short...
+
+        return false;
+    }
+    const char *token = cookieHeader.c_str() + index;
+
+    /* Decode Token */
+    uint8_t given[4 + ADMIN_SESSION_MAC_LEN];
+    for (int i = 0; i < (int) sizeof(given); i++) {
+        char hex[3] = {token[i * 2], token[(i * 2) + 1], '\0'};
+        char *end = nullptr;
+        given[i] = (uint8_t) strtoul(hex, &end, 16);
+        if (end != &hex[2]) { // Not hex...
+
+            return false;
+        }
+    }
+    uint32_t issuedMillis = ((uint32_t) given[0] << 24) | ((uint32_t) given[1] << 16) | ((uint32_t) given[2] << 8) | given[3];
+    if (((uint32_t) nowMillis - issuedMillis) >= ADMIN_SESSION_TTL_MILLIS) { // Expired; Rollover safe as unsigned...
+
+        return false;
+    }
+
+    /* Compare MAC in Constant Time */
+    uint8_t expected[ADMIN_SESSION_MAC_LEN];
+    calcMac(issuedMillis, expected);
+    uint8_t diff = 0;
+    for (int i = 0; i < ADMIN_SESSION_MAC_LEN; i++) {
+        diff |= (uint8_t) (expected[i] ^ given[4 + i]);
+    }
+
+    return (diff == 0);
+}
+
+/*
+=================================================================
+Private Functions
+=================================================================
+*/
+
+/**
+ * #### PRIVATE ####
+ * Calculates the truncated HMAC-SHA256 of the given issue time
+ * using the current key.
+ * 
+ * @param issuedMillis The time the token was issued as uint32_t.
+ * @param mac Where to put the ADMIN_SESSION_MAC_LEN bytes of MAC as uint8_t*.
+*/
+void AdminSession::calcMac(uint32_t issuedMillis, uint8_t *mac) {
+    uint8_t message[4] = {
+        (uint8_t) (issuedMillis >> 24), (uint8_t) (issuedMillis >> 16), 
+        (uint8_t) (issuedMillis >> 8), (uint8_t) issuedMillis
+    };
+
+    br_hmac_key_context keyContext;
+    br_hmac_context context;
+    br_hmac_key_init(&keyContext, &br_sha256_vtable, key, sizeof(key));
+    br_hmac_init(&context, &keyContext, ADMIN_SESSION_MAC_LEN);
+    br_hmac_update(&context, message, sizeof(message));
+    br_hmac_out(&context, mac);
+}
@@ -0,0 +1,43 @@
+/*
+    AdminSession - A class used to issue and check short lived session tokens
+    for the admin pages. Once a user has passed the digest authentication a
+    token is handed to the browser as a cookie, after which requests carrying
+    the token are let in without another digest challenge and the MD5 work
+    that goes with it.
+
+    A token is the time it was issued followed by an HMAC-SHA256 of that time
+    made with a random key which only lives in RAM. So tokens can't be forged,
+    and all tokens are invalidated by a reboot or by changing the key.
+
+    Written by: Scott Griffis
+    Date: 10-19-2026
+*/
+
+#ifndef AdminSession_h
+    #define AdminSession_h
+
+    #include <stdint.h>
+    #include <stddef.h>
+    #include <WString.h>
+
+    #define ADMIN_SESSION_COOKIE "TBSESSION"
+    #define ADMIN_SESSION_TTL_MILLIS 600000ul // 10 Minutes
+    #define ADMIN_SESSION_KEY_LEN 32
+    #define ADMIN_SESSION_MAC_LEN 16 // Truncated HMAC-SHA256
+    #define ADMIN_SESSION_TOKEN_LEN (8 + (ADMIN_SESSION_MAC_LEN * 2))
+
+    class AdminSession {
+        private:
+            uint8_t        key              [ADMIN_SESSION_KEY_LEN];
+
+            void           calcMac           (uint32_t issuedMillis, uint8_t *mac);
+
+        public:
+            AdminSession();
+
+            void           revokeAll         ()                       ;
+            String         issueCookie       (unsigned long nowMillis);
+            bool           isValid           (const String &cookieHeader, unsigned long nowMillis);
+    };
+
+#endif
@@ -0,0 +1,403 @@
+/*
+    BroadcastPacket - A class used to write and read the packets TempBuddy units send
+    on the broadcast port.
+
+    Written by: Scott Griffis
+    Date: 10-19-2026
+*/
+
+#include "BroadcastPacket.h"
+#include <string.h>
+#include <stdio.h>
+
+#define UNSIGNED_TEXT_SIZE 21 // Max of 20 digits + null
+
+/**
+ * Used to read the header of a packet: Its kind, the IP Address
+ * and the Device ID. The IP Address isn't kept as the address the
+ * packet came from is more to be trusted. The packet must stay
+ * as it is until its readings have been taken.
+ *
+ * @param data The packet as const char*; Need not be null terminated.
+ * @param length The length of the packet as size_t.
+ *
+ * @return Returns true if a TempBuddy packet with readings otherwise false as bool.
+*/
+bool BroadcastPacket::begin(const char* data, size_t length) {
+    const char *field;
+    size_t fieldLength;
+    cursor = data;
+    end = data + length;
+
+    if (!nextField(cursor, end, "::", field, fieldLength)) { // Empty...
+        cursor = nullptr;
+
+        return false;
+    }
+    if (fieldLength == 16 && memcmp(field, "TempBuddy-Sensor", 16) == 0) { // Live broadcast...
+        isLive = true;
+    } else if (fieldLength == 17 && memcmp(field, "TempBuddy-Backlog", 17) == 0) { // Forwarded after an outage...
+        isLive = false;
+    } else { // Not ours...
+        cursor = nullptr;
+
+        return false;
+    }
+    if (
+        !nextField(cursor, end, "::", field, fieldLength) // IP Address
+        || !nextField(cursor, end, "::", field, fieldLength)
+        || !parseDeviceId(field, fieldLength, deviceId)
+        || cursor == nullptr
+    ) { // Header cut short or bad ID...
+        cursor = nullptr;
+
+        return false;
+    }
+
+    return true;
+}
+
+/**
+ * Used to take the next reading from the packet. A live broadcast
+ * gives its one reading, unless malformed. A backlog packet gives
+ * each of its readings in turn, oldest first, skipping any that are
+ * malformed.
+ *
+ * @param reading Receives the reading as QueuedReading&.
+ *
+ * @return Returns true if a reading was given otherwise false as bool.
+*/
+bool BroadcastPacket::nextReading(QueuedReading& reading) {
+    if (isLive) { // The rest of the fields make up the one reading...
+        if (cursor == nullptr) { // Already taken...
+
+            return false;
+        }
+        const char *start = cursor;
+        cursor = nullptr;
+
+        return parseReading(start, end - start, "::", reading);
+    }
+    const char *field;
+    size_t fieldLength;
+    while (nextField(cursor, end, "::", field, fieldLength)) { // Each field is a reading...
+        if (parseReading(field, fieldLength, ";", reading)) {
+
+            return true;
+        }
+    }
+
+    return false;
+}
+
+/**
+ * Used to tell a live broadcast from a backlog packet.
+ *
+ * @return Returns true if a live broadcast otherwise false as bool.
+*/
+bool BroadcastPacket::getIsLive() {
+
+    return isLive;
+}
+
+uint32_t BroadcastPacket::getDeviceId() {
+
+    return deviceId;
+}
+
+/**
+ * Used to turn a device ID, six hex digits, into a number.
+ *
+ * @param text The ID as const char*; Need not be null terminated.
+ * @param length The length of the ID as size_t.
+ * @param id Receives the ID as uint32_t&.
+ *
+ * @return Returns true if the ID was valid otherwise false as bool.
+*/
+bool BroadcastPacket::parseDeviceId(const char* text, size_t length, uint32_t& id) {
+    if (length != 6) { // IDs are always six digits...
+
+        return false;
+    }
+    id = 0;
+    for (size_t i = 0; i < length; i++) {
+        char c = text[i];
+        uint8_t digit;
+        if (c >= '0' && c <= '9') {
+            digit = c - '0';
+        } else if (c >= 'A' && c <= 'F') {
+            digit = c - 'A' + 10;
+        } else if (c >= 'a' && c <= 'f') {
+            digit = c - 'a' + 10;
+        } else { // Not hex...
+
+            return false;
+        }
+        id = (id << 4) | digit;
+    }
+
+    return true;
+}
+
+/**
+ * Used to write the live broadcast of a reading, such as:
+ * TempBuddy-Sensor::192.168.123.31::A4C372::T_15.630000::H_34.520000::TS_1792410886123::SEQ_411
+ *
+ * @param buffer Where to put the null terminated packet as char*.
+ * @param size The size of the buffer; BROADCAST_LIVE_PACKET_SIZE always fits as size_t.
+ * @param ipAddr The IP Address of the unit as const char*.
+ * @param deviceId The Device ID of the unit as const char*.
+ * @param reading The reading to send as const QueuedReading&.
+ *
+ * @return Returns the length of the packet or 0 if it didn't fit as size_t.
+*/
+size_t BroadcastPacket::formatLive(char* buffer, size_t size, const char* ipAddr, const char* deviceId, const QueuedReading& reading) {
+    char timestamp[UNSIGNED_TEXT_SIZE];
+    formatUnsigned(reading.timestamp, timestamp);
+    int length = snprintf(
+        buffer, size, "TempBuddy-Sensor::%s::%s::T_%f::H_%f::TS_%s::SEQ_%lu",
+        ipAddr, deviceId, reading.temperature, reading.humidity, timestamp, (unsigned long) reading.sequence
+    );
+
+    return ((length > 0 && (size_t) length < size) ? (size_t) length : 0);
+}
+
+/**
+ * Used to write a backlog packet of readings held through an outage,
+ * oldest first, such as:
+ * TempBuddy-Backlog::192.168.123.31::A4C372::SEQ_410;T_15.610000;H_34.520000;TS_1792410856123::...
+ *
+ * @param buffer Where to put the null terminated packet as char*.
+ * @param size The size of the buffer; BROADCAST_BACKLOG_PACKET_SIZE always fits a batch as size_t.
+ * @param ipAddr The IP Address of the unit as const char*.
+ * @param deviceId The Device ID of the unit as const char*.
+ * @param readings The readings to send as const QueuedReading*.
+ * @param count The number of readings as uint8_t.
+ *
+ * @return Returns the length of the packet or 0 if it didn't fit as size_t.
+*/
+size_t BroadcastPacket::formatBacklog(char* buffer, size_t size, const char* ipAddr, const char* deviceId, const QueuedReading* readings, uint8_t count) {
+    int length = snprintf(buffer, size, "TempBuddy-Backlog::%s::%s", ipAddr, deviceId);
+    for (uint8_t i = 0; i < count && length > 0 && (size_t) length < size; i++) {
+        char timestamp[UNSIGNED_TEXT_SIZE];
+        formatUnsigned(readings[i].timestamp, timestamp);
+        int added = snprintf(
+            &buffer[length], size - length, "::SEQ_%lu;T_%f;H_%f;TS_%s",
+            (unsigned long) readings[i].sequence, readings[i].temperature, readings[i].humidity, timestamp
+        );
+        length = (added < 0 ? -1 : length + added);
+    }
+
+    return ((length > 0 && (size_t) length < size) ? (size_t) length : 0);
+}
+
+/*
+=================================================================
+Private Functions
+=================================================================
+*/
+
+/**
+ * #### PRIVATE ####
+ * Used to walk the fields of a packet. Each call gives the next field
+ * and moves the cursor past its separator; The cursor becomes nullptr
+ * once the last field has been given.
+ *
+ * @param cursor Where the next field starts as const char*&.
+ * @param end Just past the last char of the text as const char*.
+ * @param separator Text between fields as const char*.
+ * @param field Receives the start of the field as const char*&.
+ * @param fieldLength Receives the length of the field as size_t&.
+ *
+ * @return Returns true if a field was given otherwise false as bool.
+*/
+bool BroadcastPacket::nextField(const char*& cursor, const char* end, const char* separator, const char*& field, size_t& fieldLength) {
+    if (cursor == nullptr || cursor > end) { // No more...
+
+        return false;
+    }
+    size_t separatorLength = strlen(separator);
+    const char *at = cursor;
+    while ((size_t) (end - at) >= separatorLength && memcmp(at, separator, separatorLength) != 0) {
+        at++;
+    }
+    field = cursor;
+    if ((size_t) (end - at) < separatorLength) { // Last field...
+        fieldLength = end - cursor;
+        cursor = nullptr;
+    } else {
+        fieldLength = at - cursor;
+        cursor = at + separatorLength;
+    }
+
+    return true;
+}
+
+/**
+ * #### PRIVATE ####
+ * Used to parse a reading made up of T_, H_, TS_ and SEQ_ fields. The
+ * temperature and humidity must be there; The others are taken as 0 if
+ * not, as sent by older firmware. Fields not known are skipped.
+ *
+ * @param field The reading as const char*.
+ * @param length The length of the reading as size_t.
+ * @param separator Text between the fields of the reading as const char*.
+ * @param reading Receives the reading as QueuedReading&.
+ *
+ * @return Returns true if the reading was valid otherwise false as bool.
+*/
+bool BroadcastPacket::parseReading(const char* field, size_t length, const char* separator, QueuedReading& reading) {
+    const char *cursor = field;
+    const char *end = field + length;
+    const char *part;
+    size_t partLength;
+    bool hasTemperature = false;
+    bool hasHumidity = false;
+    reading = {0ull, 0, 0.0f, 0.0f};
+
+    while (nextField(cursor, end, separator, part, partLength)) {
+        int32_t centi;
+        uint64_t value;
+        if (partLength > 2 && memcmp(part, "T_", 2) == 0) { // Temperature...
+            if (!parseCenti(&part[2], partLength - 2, centi) || centi < -32768 || centi > 32767) {
+
+                return false;
+            }
+            reading.temperature = centi / 100.0f;
+            hasTemperature = true;
+        } else if (partLength > 2 && memcmp(part, "H_", 2) == 0) { // Humidity...
+            if (!parseCenti(&part[2], partLength - 2, centi) || centi < 0 || centi > 10000) {
+
+                return false;
+            }
+            reading.humidity = centi / 100.0f;
+            hasHumidity = true;
+        } else if (partLength > 3 && memcmp(part, "TS_", 3) == 0) { // Timestamp...
+            if (!parseUnsigned(&part[3], partLength - 3, value)) {
+
+                return false;
+            }
+            reading.timestamp = value;
+        } else if (partLength > 4 && memcmp(part, "SEQ_", 4) == 0) { // Sequence...
+            if (!parseUnsigned(&part[4], partLength - 4, value) || value > 0xFFFFFFFFull) {
+
+                return false;
+            }
+            reading.sequence = (uint32_t) value;
+        }
+    }
+
+    return (hasTemperature && hasHumidity);
+}
+
+/**
+ * #### PRIVATE ####
+ * Used to parse a whole number made up only of digits.
+ *
+ * @param text The number as const char*.
+ * @param length The length of the number as size_t.
+ * @param value Receives the number as uint64_t&.
+ *
+ * @return Returns true if valid otherwise false as bool.
+*/
+bool BroadcastPacket::parseUnsigned(const char* text, size_t length, uint64_t& value) {
+    if (length == 0 || length > 20) { // Empty or too big...
+
+        return false;
+    }
+    value = 0ull;
+    for (size_t i = 0; i < length; i++) {
+        if (text[i] < '0' || text[i] > '9') { // Not a digit...
+
+            return false;
+        }
+        uint64_t digit = (uint64_t) (text[i] - '0');
+        if (value > (0xFFFFFFFFFFFFFFFFull - digit) / 10ull) { // Overflows...
+
+            return false;
+        }
+        value = (value * 10ull) + digit;
+    }
+
+    return true;
+}
+
+/**
+ * #### PRIVATE ####
+ * Used to parse a decimal number, such as 15.630000 or -2.5, into
+ * hundredths, rounding on the third decimal place.
+ *
+ * @param text The number as const char*.
+ * @param length The length of the number as size_t.
+ * @param value Receives the number in hundredths as int32_t&.
+ *
+ * @return Returns true if valid otherwise false as bool.
+*/
+bool BroadcastPacket::parseCenti(const char* text, size_t length, int32_t& value) {
+    size_t i = 0;
+    bool isNegative = (length > 0 && text[0] == '-');
+    if (isNegative) {
+        i++;
+    }
+    int32_t whole = 0;
+    int32_t fraction = 0; // Hundredths
+    uint8_t places = 0;
+    bool hasDigit = false;
+    bool isFraction = false;
+    for (; i < length; i++) {
+        char c = text[i];
+        if (c == '.' && !isFraction) { // Onto the fraction...
+            isFraction = true;
+        } else if (c < '0' || c > '9') { // Not a number...
+
+            return false;
+        } else if (!isFraction) {
+            whole = (whole * 10) + (c - '0');
+            if (whole > 1000000) { // Far beyond any reading...
+
+                return false;
+            }
+            hasDigit = true;
+        } else {
+            if (places < 2) {
+                fraction = (fraction * 10) + (c - '0');
+            } else if (places == 2 && c >= '5') { // Round up...
+                fraction++;
+            }
+            places++;
+            hasDigit = true;
+        }
+    }
+    if (!hasDigit) { // Just a sign or point...
+
+        return false;
+    }
+    if (places == 1) { // Tenths given...
+        fraction *= 10;
+    }
+    value = (whole * 100) + fraction;
+    if (isNegative) {
+        value = -value;
+    }
+
+    return true;
+}
+
+/**
+ * #### PRIVATE ####
+ * Used to write a whole number as decimal text, since the printf
+ * family on the device can't be relied upon to handle 64-bit values.
+ *
+ * @param value The number as uint64_t.
+ * @param buffer Where to put the null terminated text, UNSIGNED_TEXT_SIZE long as char*.
+*/
+void BroadcastPacket::formatUnsigned(uint64_t value, char* buffer) {
+    char text[UNSIGNED_TEXT_SIZE];
+    int index = sizeof(text) - 1;
+    text[index] = '\0';
+    do {
+        text[--index] = (char) ('0' + (value % 10ull));
+        value /= 10ull;
+    } while (value > 0ull);
+    memcpy(buffer, &text[index], sizeof(text) - index);
+}
@@ -0,0 +1,59 @@
+/*
+    BroadcastPacket - A class used to write and read the packets TempBuddy
+    units send on the broadcast port, being the live broadcast of the latest reading
+    and the backlog packets forwarded after an outage. Such as:
+
+        TempBuddy-Sensor::192.168.123.31::A4C372::T_15.63::H_34.52::TS_1792410886123::SEQ_411
+        TempBuddy-Backlog::192.168.123.31::A4C372::SEQ_410;T_15.61;H_34.52;TS_1792410856123::...
+
+    The packet is read in place, within the length given, without making
+    any copies or allocations. begin() reads the header, after which the
+    readings are taken one at a time with nextReading(). Temperature and
+    humidity are rounded to hundredths, which is finer than the sensor.
+
+    formatLive() and formatBacklog() write the packets into a buffer of
+    the caller's, likewise without allocations, so a reading can go out
+    as often as it is taken without wearing on the heap.
+
+    Nothing here depends on the Arduino core, so the same code serves the
+    hub of the firmware and the collector under tools.
+
+    Written by: Scott Griffis
+    Date: 10-19-2026
+*/
+
+#ifndef BroadcastPacket_h
+    #define BroadcastPacket_h
+
+    #include <stdint.h>
+    #include <stddef.h>
+    #include <ReadingQueue.h>
+
+    #define BROADCAST_LIVE_PACKET_SIZE 128
+    #define BROADCAST_BACKLOG_PACKET_SIZE (96 + (READING_BATCH_SIZE * 72)) // Header, then up to 72 per reading
+
+    class BroadcastPacket {
+        private:
+            const char*    cursor           = nullptr; // Start of the next reading; nullptr once read
+            const char*    end              = nullptr;
+            bool           isLive           = false;
+            uint32_t       deviceId         = 0;
+
+            static bool    nextField         (const char*& cursor, const char* end, const char* separator, const char*& field, size_t& fieldLength);
+            static bool    parseReading      (const char* field, size_t length, const char* separator, QueuedReading& reading);
+            static bool    parseUnsigned     (const char* text, size_t length, uint64_t& value);
+            static bool    parseCenti        (const char* text, size_t length, int32_t& value);
+            static void    formatUnsigned    (uint64_t value, char* buffer);
+
+        public:
+            bool           begin             (const char* data, size_t length);
+            bool           nextReading       (QueuedReading& reading) ;
+            bool           getIsLive         ()                       ;
+            uint32_t       getDeviceId       ()                       ;
+
+            static bool    parseDeviceId     (const char* text, size_t length, uint32_t& id);
+            static size_t  formatLive        (char* buffer, size_t size, const char* ipAddr, const char* deviceId, const QueuedReading& reading);
+            static size_t  formatBacklog     (char* buffer, size_t size, const char* ipAddr, const char* deviceId, const QueuedReading* readings, uint8_t count);
+    };
+
+#endif
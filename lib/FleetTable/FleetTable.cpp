@@ -0,0 +1,229 @@
+/*
+    FleetTable - A class used by a hub to keep the latest reading of every
+    TempBuddy on the network, taken from the broadcasts they send.
+
+    Written by: Scott Griffis
+    Date: 10-19-2026
+*/
+
+#include "FleetTable.h"
+#include <string.h>
+
+/**
+ * #### CLASS CONSTRUCTOR ####
+ * Allows for external instantiation of
+ * the class into an object.
+*/
+FleetTable::FleetTable() {
+    memset(entries, 0, sizeof(entries));
+}
+
+/**
+ * Takes in a packet received on the broadcast port. A live broadcast
+ * gives the latest reading of its sensor, and a backlog packet gives
+ * readings its sensor held on to through an outage.
+ *
+ * @param data The packet as const char*; Need not be null terminated.
+ * @param length The length of the packet as size_t.
+ * @param ip The address the packet came from as uint32_t.
+ * @param nowMillis The current millis() as unsigned long.
+ *
+ * @return Returns true if the packet was understood otherwise false as bool.
+*/
+bool FleetTable::handlePacket(const char* data, size_t length, uint32_t ip, unsigned long nowMillis) {
+    BroadcastPacket packet;
+    QueuedReading reading;
+    packetCount++;
+
+    if (!packet.begin(data, length)) { // Not ours or malformed...
+        rejectedCount++;
+
+        return false;
+    }
+    FleetEntry *entry = nullptr;
+    while (packet.nextReading(reading)) {
+        if (entry == nullptr) { // First good reading...
+            entry = find(packet.getDeviceId(), ip, nowMillis);
+        }
+        apply(entry, reading, packet.getIsLive(), nowMillis);
+    }
+    if (entry == nullptr) { // Nothing usable...
+        rejectedCount++;
+
+        return false;
+    }
+
+    return true;
+}
+
+/**
+ * Records a reading taken by this device, so the hub is part of
+ * its own fleet.
+ *
+ * @param deviceId The ID of the device as const char*.
+ * @param ip The address of the device as uint32_t.
+ * @param reading The reading as const QueuedReading&.
+ * @param nowMillis The current millis() as unsigned long.
+ *
+ * @return Returns true if recorded otherwise false as bool.
+*/
+bool FleetTable::record(const char* deviceId, uint32_t ip, const QueuedReading& reading, unsigned long nowMillis) {
+    uint32_t id = 0;
+    if (!BroadcastPacket::parseDeviceId(deviceId, strlen(deviceId), id)) { // Not a valid ID...
+
+        return false;
+    }
+    apply(find(id, ip, nowMillis), reading, true, nowMillis);
+
+    return true;
+}
+
+/**
+ * Drops the sensors not heard from in FLEET_EXPIRE_MILLIS.
+ *
+ * @param nowMillis The current millis() as unsigned long.
+*/
+void FleetTable::expire(unsigned long nowMillis) {
+    uint16_t i = 0;
+    while (i < count) {
+        if ((nowMillis - entries[i].lastSeenMillis) >= FLEET_EXPIRE_MILLIS) { // Gone quiet; Last entry fills the gap...
+            entries[i] = entries[count - 1];
+            count--;
+        } else {
+            i++;
+        }
+    }
+}
+
+uint16_t FleetTable::getCount() {
+
+    return count;
+}
+
+/**
+ * Used to get an entry of the table. The order changes as sensors
+ * come and go.
+ *
+ * @param index The position in the table, below getCount(), as uint16_t.
+ *
+ * @return Returns the entry as const FleetEntry&.
+*/
+const FleetEntry& FleetTable::getEntry(uint16_t index) {
+
+    return entries[index];
+}
+
+/**
+ * Used to tell if a sensor hasn't been heard from in a while.
+ *
+ * @param entry The sensor's entry as const FleetEntry&.
+ * @param nowMillis The current millis() as unsigned long.
+ *
+ * @return Returns true if stale otherwise false as bool.
+*/
+bool FleetTable::isStale(const FleetEntry& entry, unsigned long nowMillis) {
+
+    return ((nowMillis - entry.lastSeenMillis) >= FLEET_STALE_MILLIS); // Unsigned math handles rollover
+}
+
+unsigned long FleetTable::getPacketCount() {
+
+    return packetCount;
+}
+
+unsigned long FleetTable::getRejectedCount() {
+
+    return rejectedCount;
+}
+
+unsigned long FleetTable::getEvictedCount() {
+
+    return evictedCount;
+}
+
+/*
+=================================================================
+Private Functions
+=================================================================
+*/
+
+/**
+ * #### PRIVATE ####
+ * Used to find the entry of a sensor, making one if it's new. When
+ * the table is full the sensor heard from longest ago makes way.
+ *
+ * @param id The device ID as uint32_t.
+ * @param ip The address the sensor was heard from as uint32_t.
+ * @param nowMillis The current millis() as unsigned long.
+ *
+ * @return Returns the entry as FleetEntry*.
+*/
+FleetEntry* FleetTable::find(uint32_t id, uint32_t ip, unsigned long nowMillis) {
+    FleetEntry *entry = nullptr;
+    for (uint16_t i = 0; i < count; i++) {
+        if (entries[i].id == id) { // Known...
+            entry = &entries[i];
+            break;
+        }
+    }
+    if (entry == nullptr && count < FLEET_MAX_SENSORS) { // New and room for it...
+        entry = &entries[count++];
+        memset(entry, 0, sizeof(FleetEntry));
+        entry->id = id;
+    } else if (entry == nullptr) { // New and full; Quietest goes...
+        entry = &entries[0];
+        for (uint16_t i = 1; i < count; i++) {
+            if ((nowMillis - entries[i].lastSeenMillis) > (nowMillis - entry->lastSeenMillis)) {
+                entry = &entries[i];
+            }
+        }
+        memset(entry, 0, sizeof(FleetEntry));
+        entry->id = id;
+        evictedCount++;
+    }
+    entry->ip = ip;
+
+    return entry;
+}
+
+/**
+ * #### PRIVATE ####
+ * Used to apply a reading to a sensor's entry. A newer reading than
+ * the one held replaces it; A live reading older than the one held
+ * means the sensor restarted, while an older backlog reading is one
+ * that was counted as missed turning up late.
+ *
+ * @param entry The sensor's entry as FleetEntry*.
+ * @param reading The reading as const QueuedReading&.
+ * @param isLive True if from a live broadcast as bool.
+ * @param nowMillis The current millis() as unsigned long.
+*/
+void FleetTable::apply(FleetEntry* entry, const QueuedReading& reading, bool isLive, unsigned long nowMillis) {
+    bool isNew = (entry->lastSeenMillis == 0ul && entry->heard == 0);
+    bool isTaken = (isNew || reading.sequence == 0 || entry->sequence == 0);
+
+    if (!isTaken && reading.sequence > entry->sequence) { // Newer...
+        uint32_t skipped = reading.sequence - entry->sequence - 1;
+        if (isLive && skipped > 0) { // Some never arrived; Yet...
+            uint32_t missed = entry->missed + skipped;
+            entry->missed = (missed > 0xFFFF ? 0xFFFF : (uint16_t) missed);
+        }
+        isTaken = true;
+    } else if (!isTaken && reading.sequence < entry->sequence) { // Older...
+        if (isLive) { // Sensor restarted...
+            isTaken = true;
+        } else if (entry->missed > 0) { // Late arrival...
+            entry->missed--;
+        }
+    }
+    if (isTaken) { // Becomes the latest...
+        entry->sequence = reading.sequence;
+        entry->timestamp = reading.timestamp;
+        entry->centiCelsius = (int16_t) (reading.temperature * 100.0f + (reading.temperature < 0.0f ? -0.5f : 0.5f));
+        entry->centiHumidity = (uint16_t) (reading.humidity * 100.0f + 0.5f);
+    }
+    if (entry->heard < 0xFFFF) {
+        entry->heard++;
+    }
+    entry->lastSeenMillis = (nowMillis == 0ul ? 1ul : nowMillis); // Zero marks a new entry
+}
@@ -0,0 +1,78 @@
+/*
+    FleetTable - A class used by a hub to keep the latest reading of every
+    TempBuddy on the network, taken from the broadcasts they send. Both the
+    live broadcast and the backlog packets forwarded after an outage are
+    understood.
+
+    The table is a fixed array of compact entries keyed by device ID, so
+    its size never changes however many sensors there are. Entries not
+    heard from for FLEET_STALE_MILLIS are marked stale, and those not heard
+    from for FLEET_EXPIRE_MILLIS are dropped to make room. Should the table
+    fill up with sensors still being heard from, the one heard from longest
+    ago makes way for the new one, and that is counted.
+
+    Packets are parsed in place by BroadcastPacket, without making any
+    copies or allocations, so a burst of packets from a large fleet costs
+    only the time to walk each one. Sequence numbers are used to
+    tell a new reading from a repeat of the last one, and to count the
+    readings missed along the way.
+
+    Written by: Scott Griffis
+    Date: 10-19-2026
+*/
+
+#ifndef FleetTable_h
+    #define FleetTable_h
+
+    #include <stdint.h>
+    #include <stddef.h>
+    #include <ReadingQueue.h>
+    #include <BroadcastPacket.h>
+
+    #define FLEET_MAX_SENSORS 128
+    #define FLEET_MAX_PACKET_SIZE 768 // Longer packets are cut short; Holds a full backlog packet
+    #define FLEET_STALE_MILLIS 60000ul // About six missed broadcasts
+    #define FLEET_EXPIRE_MILLIS 900000ul
+
+    // *****************************************************************************
+    // The latest reading of a single sensor; Kept small as there are many
+    // *****************************************************************************
+    struct FleetEntry {
+        uint32_t       id               ; // Device ID as a number; Six hex digits
+        uint32_t       ip               ; // As held by IPAddress
+        uint64_t       timestamp        ; // Millis since the Unix epoch; 0 if unsynced
+        uint32_t       sequence         ; // 0 if the sensor doesn't send them
+        uint32_t       lastSeenMillis   ;
+        int16_t        centiCelsius     ;
+        uint16_t       centiHumidity    ;
+        uint16_t       heard            ; // Readings heard, repeats included; Stops at 65535
+        uint16_t       missed           ; // Readings skipped over; Stops at 65535
+    };
+
+    class FleetTable {
+        private:
+            FleetEntry     entries          [FLEET_MAX_SENSORS];
+            uint16_t       count            = 0;
+            unsigned long  packetCount      = 0ul;
+            unsigned long  rejectedCount    = 0ul; // Not a TempBuddy packet or malformed
+            unsigned long  evictedCount     = 0ul; // Pushed out of a full table
+
+            FleetEntry*    find              (uint32_t id, uint32_t ip, unsigned long nowMillis);
+            void           apply             (FleetEntry* entry, const QueuedReading& reading, bool isLive, unsigned long nowMillis);
+
+        public:
+            FleetTable();
+
+            bool           handlePacket      (const char* data, size_t length, uint32_t ip, unsigned long nowMillis);
+            bool           record            (const char* deviceId, uint32_t ip, const QueuedReading& reading, unsigned long nowMillis);
+            void           expire            (unsigned long nowMillis);
+
+            uint16_t       getCount          ()                       ;
+            const FleetEntry& getEntry       (uint16_t index)         ;
+            bool           isStale           (const FleetEntry& entry, unsigned long nowMillis);
+            unsigned long  getPacketCount    ()                       ;
+            unsigned long  getRejectedCount  ()                       ;
+            unsigned long  getEvictedCount   ()                       ;
+    };
+
+#endif
@@ -0,0 +1,268 @@
+/*
+    HeapMonitor - A class used to keep an eye on the heap so that the slow
+    fragmentation caused by short lived allocations can be found and fixed
+    before it starves TLS handshakes of a large enough block.
+
+    Written by: Scott Griffis
+    Date: 10-19-2026
+*/
+
+#include "HeapMonitor.h"
+
+static volatile uint32_t allocCount = 0;
+static volatile uint32_t allocBytes = 0;
+
+#ifdef HEAP_MONITOR
+    // The linker points every call to malloc, realloc and calloc at these...
+    extern "C" {
+        void* __real_malloc(size_t size);
+        void* __real_realloc(void *ptr, size_t size);
+        void* __real_calloc(size_t count, size_t size);
+
+        void* __wrap_malloc(size_t size) {
+            HeapMonitor::noteAlloc(size);
+
+            return __real_malloc(size);
+        }
+
+        void* __wrap_realloc(void *ptr, size_t size) {
+            HeapMonitor::noteAlloc(size);
+
+            return __real_realloc(ptr, size);
+        }
+
+        void* __wrap_calloc(size_t count, size_t size) {
+            HeapMonitor::noteAlloc(count * size);
+
+            return __real_calloc(count, size);
+        }
+    }
+#endif
+
+/**
+ * #### CLASS CONSTRUCTOR ####
+ * Allows for external instantiation of
+ * the class into an object.
+*/
+HeapMonitor::HeapMonitor() {
+    worst = {0ul, UINT32_MAX, UINT32_MAX, 0};
+}
+
+/**
+ * Used to tell if allocations are being counted, which depends on how
+ * the firmware was built.
+ *
+ * @return Returns true if allocations are counted otherwise false as bool.
+*/
+bool HeapMonitor::isCounting() {
+    #ifdef HEAP_MONITOR
+
+        return true;
+    #else
+
+        return false;
+    #endif
+}
+
+/**
+ * Used to count an allocation. Called by the wrapped allocator, and by
+ * a host test standing in for it, such as through operator new.
+ *
+ * @param size The number of bytes asked for as size_t.
+*/
+void HeapMonitor::noteAlloc(size_t size) {
+    allocCount++;
+    allocBytes += size;
+}
+
+/**
+ * Used to get the number of allocations made since boot.
+ *
+ * @return Returns the number of allocations as uint32_t.
+*/
+uint32_t HeapMonitor::getAllocCount() {
+
+    return allocCount;
+}
+
+/**
+ * Used to get the number of bytes asked for since boot.
+ *
+ * @return Returns the number of bytes as uint32_t.
+*/
+uint32_t HeapMonitor::getAllocBytes() {
+
+    return allocBytes;
+}
+
+/**
+ * Used to mark the start of a loop iteration.
+*/
+void HeapMonitor::beginLoop() {
+    loopStartAllocs = allocCount;
+    loopStartBytes = allocBytes;
+}
+
+/**
+ * Used to mark the end of a loop iteration, recording what it allocated
+ * including any request handled during it. The heap is sampled from
+ * here once every HEAP_SAMPLE_MILLIS.
+ *
+ * @param nowMillis The current millis() as unsigned long.
+*/
+void HeapMonitor::endLoop(unsigned long nowMillis) {
+    lastLoopAllocs = allocCount - loopStartAllocs;
+    lastLoopBytes = allocBytes - loopStartBytes;
+    loopCount++;
+    if (lastLoopAllocs > 0) { // Allocated something...
+        allocLoopCount++;
+        if (lastLoopAllocs > maxLoopAllocs) { // New high...
+            maxLoopAllocs = lastLoopAllocs;
+        }
+    }
+
+    if (historyCount == 0 || (nowMillis - lastSampleMillis) >= HEAP_SAMPLE_MILLIS) { // Time for a sample; Unsigned math handles rollover...
+        sample(nowMillis);
+    }
+}
+
+/**
+ * Runs the given handler, recording the allocations it made under the
+ * given name. Once HEAP_MAX_HANDLERS names are tracked any other names
+ * are run but not recorded.
+ *
+ * @param name The name to record under; Must outlive the monitor as const char*.
+ * @param handler The handler to run as const std::function<void()>&.
+*/
+void HeapMonitor::measure(const char *name, const std::function<void()> &handler) {
+    uint32_t startAllocs = allocCount;
+    uint32_t startBytes = allocBytes;
+    handler();
+    uint32_t allocs = allocCount - startAllocs;
+    uint32_t bytes = allocBytes - startBytes;
+
+    HandlerHeapStats *stats = nullptr;
+    for (uint8_t i = 0; i < handlerCount; i++) {
+        if (strcmp(handlers[i].name, name) == 0) { // Seen before...
+            stats = &handlers[i];
+            break;
+        }
+    }
+    if (stats == nullptr && handlerCount < HEAP_MAX_HANDLERS) { // First time...
+        stats = &handlers[handlerCount++];
+        *stats = {name, 0ul, 0, 0, 0};
+    }
+    if (stats == nullptr) { // No room...
+
+        return;
+    }
+    stats->calls++;
+    stats->lastAllocs = allocs;
+    stats->lastBytes = bytes;
+    if (allocs > stats->maxAllocs) { // New high...
+        stats->maxAllocs = allocs;
+    }
+}
+
+/**
+ * Used to get the current state of the heap.
+ *
+ * @return Returns the current state as HeapSample.
+*/
+HeapSample HeapMonitor::getCurrent() {
+    HeapSample current = {millis(), 0, 0, 0};
+    ESP.getHeapStats(&current.freeBytes, &current.maxBlock, &current.fragmentation);
+
+    return current;
+}
+
+/**
+ * Used to get the worst of each heap figure seen by the samples so far.
+ *
+ * @return Returns the worst figures as const HeapSample&.
+*/
+const HeapSample& HeapMonitor::getWorst() {
+
+    return worst;
+}
+
+uint8_t HeapMonitor::getHistoryCount() {
+
+    return historyCount;
+}
+
+const HeapSample& HeapMonitor::getHistory(uint8_t index) {
+    uint8_t oldest = (historyCount < HEAP_HISTORY_SIZE) ? 0 : historyNext;
+
+    return history[(oldest + index) % HEAP_HISTORY_SIZE];
+}
+
+uint32_t HeapMonitor::getLastLoopAllocs() {
+
+    return lastLoopAllocs;
+}
+
+uint32_t HeapMonitor::getLastLoopBytes() {
+
+    return lastLoopBytes;
+}
+
+uint32_t HeapMonitor::getMaxLoopAllocs() {
+
+    return maxLoopAllocs;
+}
+
+unsigned long HeapMonitor::getLoopCount() {
+
+    return loopCount;
+}
+
+unsigned long HeapMonitor::getAllocLoopCount() {
+
+    return allocLoopCount;
+}
+
+uint8_t HeapMonitor::getHandlerCount() {
+
+    return handlerCount;
+}
+
+const HandlerHeapStats& HeapMonitor::getHandler(uint8_t index) {
+
+    return handlers[index];
+}
+
+/*
+=================================================================
+Private Functions
+=================================================================
+*/
+
+/**
+ * #### PRIVATE ####
+ * Takes a sample of the heap into the history, replacing the
+ * oldest once full, and keeps track of the worst figures.
+ *
+ * @param nowMillis The current millis() as unsigned long.
+*/
+void HeapMonitor::sample(unsigned long nowMillis) {
+    HeapSample current = getCurrent();
+    current.millis = nowMillis;
+    lastSampleMillis = nowMillis;
+
+    history[historyNext] = current;
+    historyNext = (historyNext + 1) % HEAP_HISTORY_SIZE;
+    if (historyCount < HEAP_HISTORY_SIZE) { // Not full yet...
+        historyCount++;
+    }
+
+    if (current.freeBytes < worst.freeBytes) { // Lowest yet...
+        worst.freeBytes = current.freeBytes;
+    }
+    if (current.maxBlock < worst.maxBlock) { // Smallest yet...
+        worst.maxBlock = current.maxBlock;
+    }
+    if (current.fragmentation > worst.fragmentation) { // Most yet...
+        worst.fragmentation = current.fragmentation;
+    }
+}
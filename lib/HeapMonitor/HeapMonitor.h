@@ -0,0 +1,98 @@
+/*
+    HeapMonitor - A class used to keep an eye on the heap so that the slow
+    fragmentation caused by short lived allocations can be found and fixed
+    before it starves TLS handshakes of a large enough block. It samples
+    the free heap, largest free block and fragmentation over time, and
+    counts the allocations and bytes made by each loop iteration and by
+    each measured web handler.
+
+    Counting allocations needs the firmware to be linked with malloc,
+    realloc and calloc wrapped, which is turned on by building with:
+        -D HEAP_MONITOR -Wl,--wrap=malloc -Wl,--wrap=realloc -Wl,--wrap=calloc
+    Without those the counts stay at zero but heap sampling still works.
+    Host tests count instead by calling noteAlloc() from operator new.
+    Allocations made by the WiFi SDK go straight to the allocator and are
+    never counted.
+
+    Written by: Scott Griffis
+    Date: 10-19-2026
+*/
+
+#ifndef HeapMonitor_h
+    #define HeapMonitor_h
+
+    #include <Arduino.h>
+    #include <functional>
+
+    #define HEAP_SAMPLE_MILLIS 60000ul // How often the heap is sampled
+    #define HEAP_HISTORY_SIZE 30 // Number of samples kept
+    #define HEAP_MAX_HANDLERS 12 // Number of handlers tracked
+
+    // *****************************************************************************
+    // The state of the heap at a point in time
+    // *****************************************************************************
+    struct HeapSample {
+        unsigned long  millis           ;
+        uint32_t       freeBytes        ;
+        uint32_t       maxBlock         ; // Largest single allocation possible
+        uint8_t        fragmentation    ; // Percent
+    };
+
+    // *****************************************************************************
+    // Allocations made by a single handler
+    // *****************************************************************************
+    struct HandlerHeapStats {
+        const char    *name             ;
+        unsigned long  calls            ;
+        uint32_t       lastAllocs       ;
+        uint32_t       lastBytes        ;
+        uint32_t       maxAllocs        ;
+    };
+
+    class HeapMonitor {
+        private:
+            HeapSample     history          [HEAP_HISTORY_SIZE];
+            uint8_t        historyCount     = 0;
+            uint8_t        historyNext      = 0;
+            HeapSample     worst            ; // Lowest free and max block, highest fragmentation
+            unsigned long  lastSampleMillis = 0ul;
+
+            uint32_t       loopStartAllocs  = 0;
+            uint32_t       loopStartBytes   = 0;
+            uint32_t       lastLoopAllocs   = 0;
+            uint32_t       lastLoopBytes    = 0;
+            uint32_t       maxLoopAllocs    = 0;
+            unsigned long  loopCount        = 0ul;
+            unsigned long  allocLoopCount   = 0ul; // Loops which allocated anything
+
+            HandlerHeapStats handlers       [HEAP_MAX_HANDLERS];
+            uint8_t        handlerCount     = 0;
+
+            void sample(unsigned long nowMillis);
+
+        public:
+            HeapMonitor();
+
+            static bool    isCounting        ()                       ;
+            static void    noteAlloc         (size_t size)            ;
+            static uint32_t getAllocCount    ()                       ;
+            static uint32_t getAllocBytes    ()                       ;
+
+            void           beginLoop         ()                       ;
+            void           endLoop           (unsigned long nowMillis);
+            void           measure           (const char* name, const std::function<void()>& handler);
+
+            HeapSample     getCurrent        ()                       ;
+            const HeapSample& getWorst       ()                       ;
+            uint8_t        getHistoryCount   ()                       ;
+            const HeapSample& getHistory     (uint8_t index)          ; // 0 is the oldest
+            uint32_t       getLastLoopAllocs ()                       ;
+            uint32_t       getLastLoopBytes  ()                       ;
+            uint32_t       getMaxLoopAllocs  ()                       ;
+            unsigned long  getLoopCount      ()                       ;
+            unsigned long  getAllocLoopCount ()                       ;
+            uint8_t        getHandlerCount   ()                       ;
+            const HandlerHeapStats& getHandler(uint8_t index)         ;
+    };
+
+#endif
@@ -0,0 +1,204 @@
+/*
+    LoopProfiler - A class used to find out which section of the main loop
+    is behind a stall.
+
+    Written by: Scott Griffis
+    Date: 10-19-2026
+*/
+
+#include "LoopProfiler.h"
+
+/**
+ * #### CLASS CONSTRUCTOR ####
+ * Allows for external instantiation of
+ * the class into an object.
+ *
+ * @param names The name of each section, indexed by section; Must outlive the profiler as const char* const*.
+ * @param sectionCount The number of sections, up to PROFILER_MAX_SECTIONS as uint8_t.
+*/
+LoopProfiler::LoopProfiler(const char* const *names, uint8_t sectionCount) {
+    this->names = names;
+    this->sectionCount = (sectionCount > PROFILER_MAX_SECTIONS ? PROFILER_MAX_SECTIONS : sectionCount);
+    memset(sections, 0, sizeof(sections));
+    memset(currentMicros, 0, sizeof(currentMicros));
+    memset(worstMicros, 0, sizeof(worstMicros));
+}
+
+/**
+ * Used to tell if the loop is being profiled, which depends on how
+ * the firmware was built.
+ *
+ * @return Returns true if profiling otherwise false as bool.
+*/
+bool LoopProfiler::isEnabled() {
+    #ifdef LOOP_PROFILER
+
+        return true;
+    #else
+
+        return false;
+    #endif
+}
+
+/**
+ * Used to mark the start of a loop iteration.
+*/
+void LoopProfiler::beginLoop() {
+    memset(currentMicros, 0, sizeof(currentMicros));
+    loopStartMicros = micros();
+}
+
+/**
+ * Records one run of a section, turning its cycles into time at the
+ * speed the CPU is running at now, which is the speed it ran at.
+ *
+ * @param section The index of the section as uint8_t.
+ * @param cycles How many cycles it took as uint32_t.
+*/
+void LoopProfiler::record(uint8_t section, uint32_t cycles) {
+    if (section >= sectionCount) { // Unknown section...
+
+        return;
+    }
+    uint64_t nanos = toNanos(cycles);
+    uint32_t runMicros = (uint32_t) (nanos / 1000ull);
+    SectionProfile &profile = sections[section];
+    profile.count++;
+    profile.totalNanos += nanos;
+    if (runMicros > profile.maxMicros) { // Slowest yet...
+        profile.maxMicros = runMicros;
+    }
+    profile.buckets[bucketFor(runMicros)]++;
+    currentMicros[section] += runMicros;
+}
+
+/**
+ * Used to mark the end of a loop iteration. If it was the slowest
+ * yet, the time taken by each of its sections is kept.
+*/
+void LoopProfiler::endLoop() {
+    uint32_t loopMicros = micros() - loopStartMicros; // Unsigned math handles wrap...
+    loopCount++;
+    if (loopMicros > maxLoopMicros) { // Slowest yet...
+        maxLoopMicros = loopMicros;
+        memcpy(worstMicros, currentMicros, sizeof(worstMicros));
+        worstMillis = millis();
+    }
+}
+
+/**
+ * Prints a readable report of every section and of the slowest loop
+ * to the given output, such as Serial.
+ *
+ * @param out Where to print the report as Print&.
+*/
+void LoopProfiler::printReport(Print &out) {
+    if (!isEnabled()) { // Nothing recorded...
+        out.println(F("Loop profiler not enabled; Build with -D LOOP_PROFILER."));
+
+        return;
+    }
+    out.printf("Loops: %lu, slowest: %lu us at %lu ms\n", loopCount, (unsigned long) maxLoopMicros, worstMillis);
+    for (uint8_t i = 0; i < sectionCount; i++) {
+        const SectionProfile &profile = sections[i];
+        out.printf(
+            "%-10s runs: %lu, avg: %lu us, max: %lu us, in slowest loop: %lu us\n",
+            names[i], (unsigned long) profile.count, (unsigned long) getAverageMicros(i),
+            (unsigned long) profile.maxMicros, (unsigned long) worstMicros[i]
+        );
+        out.print(F("           histogram (<us:runs):"));
+        for (uint8_t b = 0; b < PROFILER_BUCKET_COUNT; b++) {
+            if (profile.buckets[b] > 0) { // Only buckets with runs...
+                if (b == PROFILER_BUCKET_COUNT - 1) { // Last is unbounded...
+                    out.printf(" >=%lu:%lu", (1ul << b), (unsigned long) profile.buckets[b]);
+                } else { // Bounded...
+                    out.printf(" %lu:%lu", (1ul << (b + 1)), (unsigned long) profile.buckets[b]);
+                }
+            }
+        }
+        out.println();
+    }
+}
+
+uint8_t LoopProfiler::getSectionCount() {
+
+    return sectionCount;
+}
+
+const char* LoopProfiler::getSectionName(uint8_t section) {
+
+    return names[section];
+}
+
+const SectionProfile& LoopProfiler::getSection(uint8_t section) {
+
+    return sections[section];
+}
+
+/**
+ * Used to get the average time a run of the section took.
+ *
+ * @param section The index of the section as uint8_t.
+ *
+ * @return Returns the average in micros, 0 if never run as uint32_t.
+*/
+uint32_t LoopProfiler::getAverageMicros(uint8_t section) {
+    const SectionProfile &profile = sections[section];
+
+    return (profile.count > 0 ? (uint32_t) ((profile.totalNanos / profile.count) / 1000ull) : 0);
+}
+
+unsigned long LoopProfiler::getLoopCount() {
+
+    return loopCount;
+}
+
+uint32_t LoopProfiler::getMaxLoopMicros() {
+
+    return maxLoopMicros;
+}
+
+uint32_t LoopProfiler::getWorstMicros(uint8_t section) {
+
+    return worstMicros[section];
+}
+
+unsigned long LoopProfiler::getWorstMillis() {
+
+    return worstMillis;
+}
+
+/*
+=================================================================
+Private Functions
+=================================================================
+*/
+
+/**
+ * #### PRIVATE ####
+ * Works out which bucket a duration falls in. Bucket n holds
+ * durations from 2^n up to 2^(n+1) micros, with bucket 0 also
+ * holding anything under a micro.
+ *
+ * @param micros The duration as uint32_t.
+ *
+ * @return Returns the index of the bucket as uint8_t.
+*/
+uint8_t LoopProfiler::bucketFor(uint32_t micros) {
+    uint8_t bucket = (uint8_t) (31 - __builtin_clz(micros | 1u));
+
+    return (bucket < PROFILER_BUCKET_COUNT ? bucket : PROFILER_BUCKET_COUNT - 1);
+}
+
+/**
+ * #### PRIVATE ####
+ * Converts cycles to nanos at the speed the CPU is running.
+ *
+ * @param cycles The cycles as uint32_t.
+ *
+ * @return Returns the nanos as uint64_t.
+*/
+uint64_t LoopProfiler::toNanos(uint32_t cycles) {
+
+    return ((uint64_t) cycles * 1000ull) / ESP.getCpuFreqMHz();
+}
@@ -0,0 +1,89 @@
+/*
+    LoopProfiler - A class used to find out which section of the main loop
+    is behind a stall. Each named section is timed with the CPU's cycle
+    counter and its durations kept in a histogram of power of two buckets
+    in micros, along with its count, total and slowest. The slowest loop
+    iteration seen is captured in full, section by section.
+
+    Profiling is turned on by building with -D LOOP_PROFILER. Without it
+    the PROFILE_ macros expand to the bare calls, so the loop pays nothing,
+    and the profiler simply reports that it isn't enabled.
+
+    The CPU speed is dropped and raised between passes, so the cycles of
+    a section are turned into time as each run is recorded, at the speed
+    it ran at; Converting totals at report time would misstate every run
+    made at the other speed. A whole loop is timed with micros() since
+    the speed can change within one.
+
+    The cycle counter wraps every 2^32 cycles, about 26 seconds at 160MHz,
+    so a single section running longer than that is misreported.
+
+    Written by: Scott Griffis
+    Date: 10-19-2026
+*/
+
+#ifndef LoopProfiler_h
+    #define LoopProfiler_h
+
+    #include <Arduino.h>
+
+    #define PROFILER_MAX_SECTIONS 12 // Number of sections tracked
+    #define PROFILER_BUCKET_COUNT 24 // Bucket n holds durations under 2^(n+1) micros; The last holds the rest
+
+    #ifdef LOOP_PROFILER
+        #define PROFILE_LOOP_BEGIN(profiler) (profiler).beginLoop()
+        #define PROFILE_SECTION(profiler, section, call) { uint32_t _profileStart = ESP.getCycleCount(); call; (profiler).record((section), ESP.getCycleCount() - _profileStart); }
+        #define PROFILE_LOOP_END(profiler) (profiler).endLoop()
+    #else
+        #define PROFILE_LOOP_BEGIN(profiler)
+        #define PROFILE_SECTION(profiler, section, call) { call; }
+        #define PROFILE_LOOP_END(profiler)
+    #endif
+
+    // *****************************************************************************
+    // Timings of a single section of the loop
+    // *****************************************************************************
+    struct SectionProfile {
+        uint32_t       count            ;
+        uint64_t       totalNanos       ; // Nanos so runs under a micro still add up
+        uint32_t       maxMicros        ;
+        uint32_t       buckets          [PROFILER_BUCKET_COUNT];
+    };
+
+    class LoopProfiler {
+        private:
+            const char* const *names        ;
+            uint8_t        sectionCount     ;
+            SectionProfile sections         [PROFILER_MAX_SECTIONS];
+
+            uint32_t       loopStartMicros  = 0;
+            uint32_t       currentMicros    [PROFILER_MAX_SECTIONS];
+            unsigned long  loopCount        = 0ul;
+            uint32_t       maxLoopMicros    = 0; // Slowest loop seen
+            uint32_t       worstMicros      [PROFILER_MAX_SECTIONS]; // Sections of the slowest loop
+            unsigned long  worstMillis      = 0ul; // When the slowest loop ended
+
+            static uint8_t bucketFor(uint32_t micros);
+            static uint64_t toNanos(uint32_t cycles);
+
+        public:
+            LoopProfiler(const char* const *names, uint8_t sectionCount);
+
+            static bool    isEnabled         ()                       ;
+
+            void           beginLoop         ()                       ;
+            void           record            (uint8_t section, uint32_t cycles);
+            void           endLoop           ()                       ;
+            void           printReport       (Print& out)             ;
+
+            uint8_t        getSectionCount   ()                       ;
+            const char*    getSectionName    (uint8_t section)        ;
+            const SectionProfile& getSection (uint8_t section)        ;
+            uint32_t       getAverageMicros  (uint8_t section)        ;
+            unsigned long  getLoopCount      ()                       ;
+            uint32_t       getMaxLoopMicros  ()                       ;
+            uint32_t       getWorstMicros    (uint8_t section)        ;
+            unsigned long  getWorstMillis    ()                       ;
+    };
+
+#endif
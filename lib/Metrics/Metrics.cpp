@@ -0,0 +1,385 @@
+/*
+    Metrics - Classes used to keep runtime telemetry of the device and to
+    write it out in the Prometheus text exposition format so that it can
+    be scraped directly.
+
+    Written by: Scott Griffis
+    Date: 10-19-2026
+*/
+
+#include "Metrics.h"
+#include <stdarg.h>
+
+// Upper bounds of the latency buckets in micros along with their labels in seconds...
+static const uint32_t BUCKET_MICROS[METRICS_BUCKET_COUNT] = {
+    5000, 10000, 25000, 50000, 100000, 250000, 500000, 1000000, 2500000, 5000000
+};
+static const char *BUCKET_LABELS[METRICS_BUCKET_COUNT] = {
+    "0.005", "0.01", "0.025", "0.05", "0.1", "0.25", "0.5", "1", "2.5", "5"
+};
+
+const br_ssl_session_cache_class *Metrics::originalCacheVtable = nullptr;
+uint32_t Metrics::fullHandshakes = 0;
+uint32_t Metrics::resumedHandshakes = 0;
+
+/*
+=================================================================
+MetricsWriter Functions
+=================================================================
+*/
+
+/**
+ * #### CLASS CONSTRUCTOR ####
+ * Allows for external instantiation of
+ * the class into an object.
+ *
+ * @param sink Called with each full buffer of text as Sink.
+*/
+MetricsWriter::MetricsWriter(Sink sink) {
+    this->sink = sink;
+}
+
+/**
+ * Writes the HELP and TYPE lines which must come ahead of the
+ * samples of a metric.
+ *
+ * @param name The name of the metric as const char*.
+ * @param type One of counter, gauge or histogram as const char*.
+ * @param help A description of the metric as const char*.
+*/
+void MetricsWriter::family(const char *name, const char *type, const char *help) {
+    append("# HELP "); // Put together piece by piece, as the help can run past what appendf() holds
+    append(name);
+    append(" ");
+    append(help);
+    append("\n# TYPE ");
+    append(name);
+    append(" ");
+    append(type);
+    append("\n");
+}
+
+/**
+ * Writes a sample of a metric.
+ *
+ * @param name The name of the metric as const char*.
+ * @param labels Labels such as path="/" or nullptr for none as const char*.
+ * @param value The value as uint64_t.
+*/
+void MetricsWriter::sample(const char *name, const char *labels, uint64_t value) {
+    char text[21]; // Max of 20 digits + null
+    int index = sizeof(text) - 1;
+    text[index] = '\0';
+    do {
+        text[--index] = (char) ('0' + (value % 10ull));
+        value /= 10ull;
+    } while (value > 0ull);
+
+    append(name);
+    appendLabels(labels, nullptr);
+    appendf(" %s\n", &text[index]);
+}
+
+/**
+ * Writes a sample of a metric.
+ *
+ * @param name The name of the metric as const char*.
+ * @param labels Labels such as path="/" or nullptr for none as const char*.
+ * @param value The value as int32_t.
+*/
+void MetricsWriter::sample(const char *name, const char *labels, int32_t value) {
+    append(name);
+    appendLabels(labels, nullptr);
+    appendf(" %ld\n", (long) value);
+}
+
+/**
+ * Writes a sample of a metric.
+ *
+ * @param name The name of the metric as const char*.
+ * @param labels Labels such as path="/" or nullptr for none as const char*.
+ * @param value The value as float.
+*/
+void MetricsWriter::sample(const char *name, const char *labels, float value) {
+    append(name);
+    appendLabels(labels, nullptr);
+    appendf(" %.2f\n", value);
+}
+
+/**
+ * Writes the bucket, sum and count samples of a latency histogram.
+ * The buckets are made cumulative as Prometheus expects.
+ *
+ * @param name The name of the metric as const char*.
+ * @param labels Labels such as path="/" or nullptr for none as const char*.
+ * @param histogram The histogram to write as const LatencyHistogram&.
+*/
+void MetricsWriter::histogram(const char *name, const char *labels, const LatencyHistogram &histogram) {
+    char le[16];
+    uint32_t cumulative = 0;
+    for (int i = 0; i < METRICS_BUCKET_COUNT; i++) {
+        cumulative += histogram.buckets[i];
+        snprintf(le, sizeof(le), "le=\"%s\"", BUCKET_LABELS[i]);
+        appendf("%s_bucket", name);
+        appendLabels(labels, le);
+        appendf(" %lu\n", (unsigned long) cumulative);
+    }
+    appendf("%s_bucket", name);
+    appendLabels(labels, "le=\"+Inf\"");
+    appendf(" %lu\n", (unsigned long) histogram.count);
+
+    appendf("%s_sum", name);
+    appendLabels(labels, nullptr);
+    appendf(
+        " %lu.%06lu\n",
+        (unsigned long) (histogram.sumMicros / 1000000ull),
+        (unsigned long) (histogram.sumMicros % 1000000ull)
+    );
+    appendf("%s_count", name);
+    appendLabels(labels, nullptr);
+    appendf(" %lu\n", (unsigned long) histogram.count);
+}
+
+/**
+ * Hands off whatever text is still buffered to the sink. Must be
+ * called once everything has been written.
+*/
+void MetricsWriter::flush() {
+    if (length > 0) { // Something to hand off...
+        sink(buffer, length);
+        length = 0;
+    }
+}
+
+/**
+ * #### PRIVATE ####
+ * Adds the given text to the buffer, handing off the buffer to
+ * the sink each time it fills.
+ *
+ * @param text The text to add as const char*.
+*/
+void MetricsWriter::append(const char *text) {
+    while (*text != '\0') {
+        if (length == sizeof(buffer)) { // Full...
+            flush();
+        }
+        buffer[length++] = *text++;
+    }
+}
+
+/**
+ * #### PRIVATE ####
+ * Adds formatted text to the buffer. Formatted pieces are small so
+ * they're put together on the stack first.
+ *
+ * @param format The printf style format as const char*.
+*/
+void MetricsWriter::appendf(const char *format, ...) {
+    char text[128];
+    va_list args;
+    va_start(args, format);
+    vsnprintf(text, sizeof(text), format, args);
+    va_end(args);
+
+    append(text);
+}
+
+/**
+ * #### PRIVATE ####
+ * Adds the label set of a sample, if it has any labels.
+ *
+ * @param labels Labels of the metric or nullptr for none as const char*.
+ * @param extraLabel Another label, such as le, or nullptr for none as const char*.
+*/
+void MetricsWriter::appendLabels(const char *labels, const char *extraLabel) {
+    if (labels == nullptr && extraLabel == nullptr) { // Nothing to add...
+
+        return;
+    }
+    append("{");
+    if (labels != nullptr) { // Metric labels first...
+        append(labels);
+    }
+    if (labels != nullptr && extraLabel != nullptr) { // Both...
+        append(",");
+    }
+    if (extraLabel != nullptr) { // Then the extra...
+        append(extraLabel);
+    }
+    append("}");
+}
+
+/*
+=================================================================
+Metrics Functions
+=================================================================
+*/
+
+/**
+ * #### CLASS CONSTRUCTOR ####
+ * Allows for external instantiation of
+ * the class into an object.
+*/
+Metrics::Metrics() {
+    sensorLatency = {};
+}
+
+/**
+ * Records a handled request and how long it took.
+ *
+ * @param path The path of the endpoint; Must outlive the metrics as const char*.
+ * @param micros How long the request took in micros as uint32_t.
+*/
+void Metrics::observeRequest(const char *path, uint32_t micros) {
+    EndpointMetrics *endpoint = nullptr;
+    for (uint8_t i = 0; i < endpointCount; i++) {
+        if (strcmp(endpoints[i].path, path) == 0) { // Seen before...
+            endpoint = &endpoints[i];
+            break;
+        }
+    }
+    if (endpoint == nullptr && endpointCount < METRICS_MAX_ENDPOINTS) { // First time...
+        endpoint = &endpoints[endpointCount++];
+        *endpoint = {};
+        endpoint->path = path;
+    }
+    if (endpoint == nullptr) { // No room...
+
+        return;
+    }
+    endpoint->requests++;
+    observe(endpoint->latency, micros);
+}
+
+/**
+ * Records a read of the sensor and how long it took.
+ *
+ * @param isOk True if the sensor gave a reading as bool.
+ * @param micros How long the read took in micros as uint32_t.
+*/
+void Metrics::observeSensorRead(bool isOk, uint32_t micros) {
+    sensorReads++;
+    if (!isOk) { // Failed...
+        sensorFailures++;
+    }
+    observe(sensorLatency, micros);
+}
+
+/**
+ * Records a sent broadcast.
+*/
+void Metrics::countBroadcast() {
+    broadcasts++;
+}
+
+/**
+ * Writes the metrics kept by this class to the given writer.
+ *
+ * @param writer The writer to write to as MetricsWriter&.
+*/
+void Metrics::writeTo(MetricsWriter &writer) {
+    char labels[48];
+
+    writer.family("tempbuddy_http_requests_total", "counter", "Requests handled by endpoint.");
+    for (uint8_t i = 0; i < endpointCount; i++) {
+        snprintf(labels, sizeof(labels), "path=\"%s\"", endpoints[i].path);
+        writer.sample("tempbuddy_http_requests_total", labels, (uint64_t) endpoints[i].requests);
+    }
+    writer.family("tempbuddy_http_request_duration_seconds", "histogram", "Time taken to handle requests by endpoint.");
+    for (uint8_t i = 0; i < endpointCount; i++) {
+        snprintf(labels, sizeof(labels), "path=\"%s\"", endpoints[i].path);
+        writer.histogram("tempbuddy_http_request_duration_seconds", labels, endpoints[i].latency);
+    }
+
+    writer.family("tempbuddy_tls_handshakes_total", "counter", "Completed TLS handshakes by type.");
+    writer.sample("tempbuddy_tls_handshakes_total", "type=\"full\"", (uint64_t) fullHandshakes);
+    writer.sample("tempbuddy_tls_handshakes_total", "type=\"resumed\"", (uint64_t) resumedHandshakes);
+
+    writer.family("tempbuddy_sensor_reads_total", "counter", "Reads of the sensor.");
+    writer.sample("tempbuddy_sensor_reads_total", nullptr, (uint64_t) sensorReads);
+    writer.family("tempbuddy_sensor_read_failures_total", "counter", "Reads of the sensor which got no reading.");
+    writer.sample("tempbuddy_sensor_read_failures_total", nullptr, (uint64_t) sensorFailures);
+    writer.family("tempbuddy_sensor_read_duration_seconds", "histogram", "Time taken to read the sensor.");
+    writer.histogram("tempbuddy_sensor_read_duration_seconds", nullptr, sensorLatency);
+
+    writer.family("tempbuddy_broadcasts_total", "counter", "Readings broadcast to the network.");
+    writer.sample("tempbuddy_broadcasts_total", nullptr, (uint64_t) broadcasts);
+}
+
+/**
+ * Starts counting the TLS handshakes of the given session cache by
+ * replacing its vtable with one that counts and then calls through
+ * to the original. Only one cache may be watched.
+ *
+ * @param cache The cache, as given by ServerSessions::getCache() as const br_ssl_session_cache_class**.
+*/
+void Metrics::watchSessionCache(const br_ssl_session_cache_class **cache) {
+    static br_ssl_session_cache_class countingVtable;
+    if (originalCacheVtable != nullptr) { // Already watching...
+
+        return;
+    }
+    originalCacheVtable = *cache;
+    countingVtable = *originalCacheVtable;
+    countingVtable.save = countingSave;
+    countingVtable.load = countingLoad;
+    *cache = &countingVtable;
+}
+
+uint32_t Metrics::getFullHandshakes() {
+
+    return fullHandshakes;
+}
+
+uint32_t Metrics::getResumedHandshakes() {
+
+    return resumedHandshakes;
+}
+
+/*
+=================================================================
+Private Functions
+=================================================================
+*/
+
+/**
+ * #### PRIVATE ####
+ * Adds an observed duration to the given histogram.
+ *
+ * @param histogram The histogram to add to as LatencyHistogram&.
+ * @param micros The duration in micros as uint32_t.
+*/
+void Metrics::observe(LatencyHistogram &histogram, uint32_t micros) {
+    histogram.count++;
+    histogram.sumMicros += micros;
+    for (int i = 0; i < METRICS_BUCKET_COUNT; i++) {
+        if (micros <= BUCKET_MICROS[i]) { // Fits this bucket...
+            histogram.buckets[i]++;
+            break;
+        }
+    }
+}
+
+/**
+ * #### PRIVATE ####
+ * Stands in for the session cache's save, which happens once a full
+ * handshake completes.
+*/
+void Metrics::countingSave(const br_ssl_session_cache_class **ctx, br_ssl_server_context *serverCtx, const br_ssl_session_parameters *params) {
+    fullHandshakes++;
+    originalCacheVtable->save(ctx, serverCtx, params);
+}
+
+/**
+ * #### PRIVATE ####
+ * Stands in for the session cache's load, which finds the session
+ * when the client resumes one.
+*/
+int Metrics::countingLoad(const br_ssl_session_cache_class **ctx, br_ssl_server_context *serverCtx, br_ssl_session_parameters *params) {
+    int isFound = originalCacheVtable->load(ctx, serverCtx, params);
+    if (isFound) { // Resumed...
+        resumedHandshakes++;
+    }
+
+    return isFound;
+}
@@ -0,0 +1,101 @@
+/*
+    Metrics - Classes used to keep runtime telemetry of the device and to
+    write it out in the Prometheus text exposition format so that it can
+    be scraped directly. Metrics keeps the counters and latency histograms
+    which nothing else in the firmware already keeps: requests and latency
+    for each endpoint, sensor reads, broadcasts and TLS handshakes.
+
+    MetricsWriter streams the text through a small fixed buffer, handing
+    it off to a sink each time the buffer fills, so no part of the output
+    is ever held on the heap.
+
+    TLS handshakes are counted by swapping the vtable of the web server's
+    session cache for one which counts before calling the original. The
+    cache saves a session after each full handshake and loads one for each
+    resumed handshake.
+
+    Written by: Scott Griffis
+    Date: 10-19-2026
+*/
+
+#ifndef Metrics_h
+    #define Metrics_h
+
+    #include <Arduino.h>
+    #include <functional>
+    #include <bearssl/bearssl.h>
+
+    #define METRICS_MAX_ENDPOINTS 12 // Number of endpoints tracked
+    #define METRICS_BUCKET_COUNT 10 // Latency histogram buckets, not counting +Inf
+    #define METRICS_WRITER_BUFFER_SIZE 256
+
+    // *****************************************************************************
+    // Counts of observed durations falling at or below each bucket bound
+    // *****************************************************************************
+    struct LatencyHistogram {
+        uint32_t       buckets          [METRICS_BUCKET_COUNT]; // Not cumulative
+        uint32_t       count            ;
+        uint64_t       sumMicros        ;
+    };
+
+    class MetricsWriter {
+        public:
+            typedef std::function<void(const char*, size_t)> Sink;
+
+        private:
+            char           buffer           [METRICS_WRITER_BUFFER_SIZE];
+            size_t         length           = 0;
+            Sink           sink             ;
+
+            void append(const char* text);
+            void appendf(const char* format, ...);
+            void appendLabels(const char* labels, const char* extraLabel);
+
+        public:
+            MetricsWriter(Sink sink);
+
+            void           family            (const char* name, const char* type, const char* help);
+            void           sample            (const char* name, const char* labels, uint64_t value);
+            void           sample            (const char* name, const char* labels, int32_t value);
+            void           sample            (const char* name, const char* labels, float value);
+            void           histogram         (const char* name, const char* labels, const LatencyHistogram& histogram);
+            void           flush             ()                       ;
+    };
+
+    class Metrics {
+        private:
+            struct EndpointMetrics {
+                const char    *path             ;
+                uint32_t       requests         ;
+                LatencyHistogram latency        ;
+            };
+
+            EndpointMetrics endpoints       [METRICS_MAX_ENDPOINTS];
+            uint8_t        endpointCount    = 0;
+            uint32_t       sensorReads      = 0;
+            uint32_t       sensorFailures   = 0;
+            LatencyHistogram sensorLatency  ;
+            uint32_t       broadcasts       = 0;
+
+            static const br_ssl_session_cache_class *originalCacheVtable;
+            static uint32_t fullHandshakes;
+            static uint32_t resumedHandshakes;
+
+            static void observe(LatencyHistogram &histogram, uint32_t micros);
+            static void countingSave(const br_ssl_session_cache_class **ctx, br_ssl_server_context *serverCtx, const br_ssl_session_parameters *params);
+            static int countingLoad(const br_ssl_session_cache_class **ctx, br_ssl_server_context *serverCtx, br_ssl_session_parameters *params);
+
+        public:
+            Metrics();
+
+            void           observeRequest    (const char* path, uint32_t micros);
+            void           observeSensorRead (bool isOk, uint32_t micros);
+            void           countBroadcast    ()                       ;
+            void           writeTo           (MetricsWriter& writer)  ;
+
+            static void    watchSessionCache (const br_ssl_session_cache_class **cache);
+            static uint32_t getFullHandshakes()                       ;
+            static uint32_t getResumedHandshakes()                    ;
+    };
+
+#endif
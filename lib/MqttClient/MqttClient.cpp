@@ -0,0 +1,511 @@
+/*
+    MqttClient - A small MQTT 3.1.1 client used to publish to a broker from
+    within the main loop without holding it up.
+
+    Written by: Scott Griffis
+    Date: 10-19-2026
+*/
+
+#include "MqttClient.h"
+
+// Packet types, already shifted into the top of the fixed header...
+#define MQTT_CONNECT     0x10
+#define MQTT_CONNACK     0x20
+#define MQTT_PUBLISH     0x30
+#define MQTT_PUBACK      0x40
+#define MQTT_PINGREQ     0xC0
+#define MQTT_PINGRESP    0xD0
+#define MQTT_DISCONNECT  0xE0
+
+#define MQTT_PUBLISH_DUP 0x08 // Set on a resent QoS 1 message
+
+// Phases of reading an incoming packet...
+#define RX_FIXED_HEADER  0
+#define RX_LENGTH        1
+#define RX_BODY          2
+
+#define RX_MAX_PER_LOOP  256 // Bytes read per pass so a chatty broker can't hold up the loop
+
+/**
+ * #### CLASS CONSTRUCTOR ####
+ * Allows for external instantiation of
+ * the class into an object.
+ *
+ * @param client The connection used to reach the broker as Client&.
+*/
+MqttClient::MqttClient(Client &client) {
+    this->client = &client;
+}
+
+/**
+ * Sets the broker to publish to, dropping any connection to the
+ * previous one along with any message waiting on it. Given an empty
+ * host the client is turned off. The text given isn't copied so it
+ * must stay put until the client is next configured.
+ *
+ * @param host The name or address of the broker; Empty to turn off as const char*.
+ * @param port The port of the broker as uint16_t.
+ * @param clientId The ID to connect as as const char*.
+ * @param user The user to log in as; Empty for none as const char*.
+ * @param pwd The password to log in with as const char*.
+ * @param willTopic Where the broker publishes, retained, should the device drop off as const char*.
+ * @param willMessage What the broker publishes should the device drop off as const char*.
+*/
+void MqttClient::configure(const char *host, uint16_t port, const char *clientId, const char *user, const char *pwd, const char *willTopic, const char *willMessage) {
+    disconnect();
+    this->host = host;
+    this->port = port;
+    this->clientId = clientId;
+    this->user = user;
+    this->pwd = pwd;
+    this->willTopic = willTopic;
+    this->willMessage = willMessage;
+
+    state = (host[0] == '\0' ? MQTT_OFF : MQTT_DISCONNECTED);
+    hasAttempted = false;
+    retryMillis = MQTT_RETRY_MIN_MILLIS;
+    inflightLength = 0;
+}
+
+/**
+ * Drives the client and must be called on every pass of the loop.
+ * It connects when it's time to, reads whatever the broker sent,
+ * keeps the connection alive and resends an unacknowledged message.
+ *
+ * @param nowMillis The current millis() as unsigned long.
+*/
+void MqttClient::loop(unsigned long nowMillis) {
+    if (state == MQTT_OFF) { // Nothing to do...
+
+        return;
+    }
+    if (state == MQTT_DISCONNECTED) { // Reconnect once it's time; Unsigned math handles rollover...
+        if (!hasAttempted || (nowMillis - stateMillis) >= retryMillis) { // Time to try...
+            connect(nowMillis);
+        }
+
+        return;
+    }
+    if (!client->connected()) { // Broker or network went away...
+        dropConnection(nowMillis);
+
+        return;
+    }
+
+    readIncoming(nowMillis);
+    if (state == MQTT_CONNECTING && (nowMillis - stateMillis) >= MQTT_ACK_TIMEOUT_MILLIS) { // Broker never accepted...
+        dropConnection(nowMillis);
+    }
+    if (state != MQTT_CONNECTED) { // Still waiting to be accepted or was refused...
+
+        return;
+    }
+
+    if (isPingPending && (nowMillis - pingMillis) >= MQTT_ACK_TIMEOUT_MILLIS) { // Connection is dead...
+        dropConnection(nowMillis);
+
+        return;
+    }
+    if (!isPingPending && (nowMillis - lastSendMillis) >= (MQTT_KEEP_ALIVE_SECS * 1000ul / 2)) { // Quiet for half the keep alive...
+        const uint8_t ping[] = {MQTT_PINGREQ, 0};
+        if (writePacket(ping, sizeof(ping))) { // Sent...
+            isPingPending = true;
+            pingMillis = nowMillis;
+        }
+    }
+    if (inflightLength > 0 && (nowMillis - inflightMillis) >= MQTT_ACK_TIMEOUT_MILLIS) { // Not acknowledged; Send again...
+        inflight[0] |= MQTT_PUBLISH_DUP;
+        if (writePacket(inflight, inflightLength)) { // Sent...
+            inflightMillis = nowMillis;
+            resendCount++;
+        }
+    }
+}
+
+/**
+ * Used to tell if a message of the given QoS would be taken right
+ * now, which needs a connection and, for QoS 1, that no other QoS 1
+ * message is still waiting on its acknowledgement.
+ *
+ * @param qos The QoS of the message, 0 or 1 as uint8_t.
+ *
+ * @return Returns true if the message would be taken otherwise false as bool.
+*/
+bool MqttClient::canPublish(uint8_t qos) {
+
+    return (state == MQTT_CONNECTED && (qos == 0 || inflightLength == 0));
+}
+
+/**
+ * Publishes a message to the broker. A QoS 1 message is kept and
+ * resent until the broker acknowledges it, including after a
+ * reconnect. Nothing is sent unless the whole message can be
+ * written right away.
+ *
+ * @param topic The topic to publish to as const char*.
+ * @param payload The message as const char*.
+ * @param length The length of the message as size_t.
+ * @param qos The QoS of the message, 0 or 1 as uint8_t.
+ * @param isRetained True if the broker should keep it for later subscribers as bool.
+ *
+ * @return Returns true if the message was taken otherwise false, when
+ * it can be tried again later, as bool.
+*/
+bool MqttClient::publish(const char *topic, const char *payload, size_t length, uint8_t qos, bool isRetained) {
+    if (!canPublish(qos)) { // Not now...
+
+        return false;
+    }
+    size_t topicLength = strlen(topic);
+    size_t remaining = 2 + topicLength + (qos > 0 ? 2 : 0) + length;
+    if (remaining + 3 > MQTT_MAX_PACKET_SIZE) { // Too big to ever send...
+
+        return false;
+    }
+
+    uint8_t *buffer = (qos > 0 ? inflight : packet);
+    uint8_t type = MQTT_PUBLISH | (qos > 0 ? 0x02 : 0x00) | (isRetained ? 0x01 : 0x00);
+    size_t index = putHeader(buffer, type, remaining);
+    index += putString(&buffer[index], topic);
+    uint16_t packetId = 0;
+    if (qos > 0) { // Identified for the acknowledgement...
+        packetId = nextPacketId;
+        nextPacketId = (nextPacketId == 0xFFFF ? 1 : nextPacketId + 1);
+        buffer[index++] = (uint8_t) (packetId >> 8);
+        buffer[index++] = (uint8_t) (packetId & 0xFF);
+    }
+    memcpy(&buffer[index], payload, length);
+    index += length;
+
+    if (!writePacket(buffer, index)) { // No room or broken...
+
+        return false;
+    }
+    publishCount++;
+    if (qos > 0) { // Keep until acknowledged...
+        inflightLength = index;
+        inflightId = packetId;
+        inflightMillis = millis();
+    }
+
+    return true;
+}
+
+/**
+ * Disconnects from the broker cleanly, so the last will is not
+ * published. The client reconnects on a later pass of loop().
+*/
+void MqttClient::disconnect() {
+    if (state == MQTT_CONNECTED) { // Tell the broker...
+        const uint8_t bye[] = {MQTT_DISCONNECT, 0};
+        writePacket(bye, sizeof(bye));
+    }
+    if (state == MQTT_CONNECTED || state == MQTT_CONNECTING) { // Socket is open...
+        client->stop();
+    }
+    if (state != MQTT_OFF) { // Back to waiting...
+        state = MQTT_DISCONNECTED;
+        stateMillis = millis();
+    }
+}
+
+MqttClient::State MqttClient::getState() {
+
+    return state;
+}
+
+/**
+ * Used to get the name of the current state, for reporting.
+ *
+ * @return Returns the name of the state as const char*.
+*/
+const char* MqttClient::getStateName() {
+    switch (state) {
+        case MQTT_DISCONNECTED: return "disconnected";
+        case MQTT_CONNECTING: return "connecting";
+        case MQTT_CONNECTED: return "connected";
+        default: return "off";
+    }
+}
+
+bool MqttClient::isConnected() {
+
+    return (state == MQTT_CONNECTED);
+}
+
+/**
+ * Used to tell if a QoS 1 message is still waiting on the broker
+ * to acknowledge it.
+ *
+ * @return Returns true if waiting otherwise false as bool.
+*/
+bool MqttClient::hasInflight() {
+
+    return (inflightLength > 0);
+}
+
+uint8_t MqttClient::getLastRefusal() {
+
+    return lastRefusal;
+}
+
+unsigned long MqttClient::getConnectCount() {
+
+    return connectCount;
+}
+
+unsigned long MqttClient::getPublishCount() {
+
+    return publishCount;
+}
+
+unsigned long MqttClient::getAckCount() {
+
+    return ackCount;
+}
+
+unsigned long MqttClient::getResendCount() {
+
+    return resendCount;
+}
+
+/*
+=================================================================
+Private Functions
+=================================================================
+*/
+
+/**
+ * #### PRIVATE ####
+ * Opens a connection to the broker and sends the CONNECT packet,
+ * backing off before the next attempt if it can't.
+ *
+ * @param nowMillis The current millis() as unsigned long.
+*/
+void MqttClient::connect(unsigned long nowMillis) {
+    hasAttempted = true;
+    stateMillis = nowMillis;
+    client->setTimeout(MQTT_CONNECT_TIMEOUT_MILLIS);
+    if (!client->connect(host, port)) { // Unreachable; Back off...
+        retryMillis = min(retryMillis * 2, (uint32_t) MQTT_RETRY_MAX_MILLIS);
+
+        return;
+    }
+
+    bool hasWill = (willTopic[0] != '\0');
+    bool hasUser = (user[0] != '\0');
+    size_t remaining = 10 + 2 + strlen(clientId);
+    if (hasWill) { // Will topic and message...
+        remaining += 2 + strlen(willTopic) + 2 + strlen(willMessage);
+    }
+    if (hasUser) { // User and password...
+        remaining += 2 + strlen(user) + 2 + strlen(pwd);
+    }
+    if (remaining + 3 > MQTT_MAX_PACKET_SIZE) { // Can't be sent...
+        client->stop();
+        state = MQTT_OFF;
+
+        return;
+    }
+
+    uint8_t flags = 0x02; // Clean session
+    if (hasWill) { // Will is QoS 1 and retained...
+        flags |= 0x04 | 0x08 | 0x20;
+    }
+    if (hasUser) { // Log in...
+        flags |= 0x80 | 0x40;
+    }
+    size_t index = putHeader(packet, MQTT_CONNECT, remaining);
+    index += putString(&packet[index], "MQTT");
+    packet[index++] = 4; // Protocol level of 3.1.1
+    packet[index++] = flags;
+    packet[index++] = (uint8_t) (MQTT_KEEP_ALIVE_SECS >> 8);
+    packet[index++] = (uint8_t) (MQTT_KEEP_ALIVE_SECS & 0xFF);
+    index += putString(&packet[index], clientId);
+    if (hasWill) { // Will topic and message...
+        index += putString(&packet[index], willTopic);
+        index += putString(&packet[index], willMessage);
+    }
+    if (hasUser) { // User and password...
+        index += putString(&packet[index], user);
+        index += putString(&packet[index], pwd);
+    }
+
+    rxPhase = RX_FIXED_HEADER;
+    isPingPending = false;
+    if (!writePacket(packet, index)) { // Connection already failing...
+        dropConnection(nowMillis);
+
+        return;
+    }
+    state = MQTT_CONNECTING;
+}
+
+/**
+ * #### PRIVATE ####
+ * Closes a connection that failed, leaving any QoS 1 message to be
+ * resent once reconnected.
+ *
+ * @param nowMillis The current millis() as unsigned long.
+*/
+void MqttClient::dropConnection(unsigned long nowMillis) {
+    client->stop();
+    state = MQTT_DISCONNECTED;
+    stateMillis = nowMillis;
+    isPingPending = false;
+}
+
+/**
+ * #### PRIVATE ####
+ * Reads whatever the broker has sent, a byte at a time, handling
+ * each packet as it completes. Only the start of each packet is
+ * kept since that's all that's needed of the packets expected.
+ *
+ * @param nowMillis The current millis() as unsigned long.
+*/
+void MqttClient::readIncoming(unsigned long nowMillis) {
+    for (int count = 0; count < RX_MAX_PER_LOOP && client->available() > 0; count++) {
+        int value = client->read();
+        if (value < 0) { // Nothing after all...
+            break;
+        }
+        uint8_t byte = (uint8_t) value;
+
+        if (rxPhase == RX_FIXED_HEADER) { // New packet...
+            rxType = byte;
+            rxLength = 0;
+            rxMultiplier = 1;
+            rxIndex = 0;
+            rxPhase = RX_LENGTH;
+        } else if (rxPhase == RX_LENGTH) { // Remaining length, 7 bits at a time...
+            rxLength += (byte & 0x7F) * rxMultiplier;
+            rxMultiplier *= 128;
+            if ((byte & 0x80) == 0) { // Last length byte...
+                rxPhase = RX_BODY;
+            } else if (rxMultiplier > (128ul * 128ul * 128ul)) { // Longer than the protocol allows...
+                dropConnection(nowMillis);
+
+                return;
+            }
+        } else { // Body...
+            if (rxIndex < sizeof(rxData)) { // Keep the start...
+                rxData[rxIndex] = byte;
+            }
+            rxIndex++;
+        }
+
+        if (rxPhase == RX_BODY && rxIndex == rxLength) { // Packet complete...
+            rxPhase = RX_FIXED_HEADER;
+            handlePacket(nowMillis);
+            if (state != MQTT_CONNECTING && state != MQTT_CONNECTED) { // Refused...
+
+                return;
+            }
+        }
+    }
+}
+
+/**
+ * #### PRIVATE ####
+ * Acts on a packet received from the broker.
+ *
+ * @param nowMillis The current millis() as unsigned long.
+*/
+void MqttClient::handlePacket(unsigned long nowMillis) {
+    switch (rxType & 0xF0) {
+        case MQTT_CONNACK:
+            if (state != MQTT_CONNECTING || rxLength < 2) { // Not expected...
+                break;
+            }
+            if (rxData[1] != 0) { // Refused; Back off...
+                lastRefusal = rxData[1];
+                retryMillis = min(retryMillis * 2, (uint32_t) MQTT_RETRY_MAX_MILLIS);
+                dropConnection(nowMillis);
+                break;
+            }
+            state = MQTT_CONNECTED;
+            stateMillis = nowMillis;
+            retryMillis = MQTT_RETRY_MIN_MILLIS;
+            connectCount++;
+            if (inflightLength > 0) { // Left from before; Send again right away...
+                inflightMillis = nowMillis - MQTT_ACK_TIMEOUT_MILLIS;
+            }
+            break;
+        case MQTT_PUBACK:
+            if (inflightLength > 0 && rxLength >= 2 && ((rxData[0] << 8) | rxData[1]) == inflightId) { // Ours...
+                inflightLength = 0;
+                ackCount++;
+            }
+            break;
+        case MQTT_PINGRESP:
+            isPingPending = false;
+            break;
+        default: // Nothing else is expected of a publish only client...
+            break;
+    }
+}
+
+/**
+ * #### PRIVATE ####
+ * Writes a whole packet if the connection has room for it, so the
+ * write never waits on the network.
+ *
+ * @param data The packet as const uint8_t*.
+ * @param length The length of the packet as size_t.
+ *
+ * @return Returns true if written otherwise false as bool.
+*/
+bool MqttClient::writePacket(const uint8_t *data, size_t length) {
+    if (client->availableForWrite() < (int) length) { // No room right now...
+
+        return false;
+    }
+    if (client->write(data, length) != length) { // Connection is broken...
+        dropConnection(millis());
+
+        return false;
+    }
+    lastSendMillis = millis();
+
+    return true;
+}
+
+/**
+ * #### PRIVATE ####
+ * Puts the fixed header of a packet into the buffer.
+ *
+ * @param buffer Where to put the header as uint8_t*.
+ * @param type The type and flags of the packet as uint8_t.
+ * @param remaining The length of the packet after the header as size_t.
+ *
+ * @return Returns the length of the header as size_t.
+*/
+size_t MqttClient::putHeader(uint8_t *buffer, uint8_t type, size_t remaining) {
+    size_t index = 0;
+    buffer[index++] = type;
+    do {
+        uint8_t digit = remaining % 128;
+        remaining /= 128;
+        buffer[index++] = (remaining > 0 ? (digit | 0x80) : digit);
+    } while (remaining > 0);
+
+    return index;
+}
+
+/**
+ * #### PRIVATE ####
+ * Puts a length prefixed string into the buffer.
+ *
+ * @param buffer Where to put the string as uint8_t*.
+ * @param text The text as const char*.
+ *
+ * @return Returns the number of bytes put as size_t.
+*/
+size_t MqttClient::putString(uint8_t *buffer, const char *text) {
+    size_t length = strlen(text);
+    buffer[0] = (uint8_t) (length >> 8);
+    buffer[1] = (uint8_t) (length & 0xFF);
+    memcpy(&buffer[2], text, length);
+
+    return length + 2;
+}
@@ -0,0 +1,112 @@
+/*
+    MqttClient - A small MQTT 3.1.1 client used to publish to a broker from
+    within the main loop without holding it up. It only publishes, at QoS 0
+    or QoS 1, and supports a retained last will so that the broker tells
+    subscribers when the device drops off.
+
+    Everything is driven from loop(), which connects, reads whatever the
+    broker has sent, keeps the connection alive and resends a QoS 1 message
+    that hasn't been acknowledged. Nothing waits on the broker: a publish is
+    only written when the socket has room for all of it, otherwise it is
+    turned down so the caller can try again on a later pass. A single QoS 1
+    message may be waiting on its acknowledgement at a time, and it is kept
+    across reconnects until acknowledged.
+
+    Connecting is the one step that can wait, while the broker's name is
+    looked up and the TCP connection made, and it's bounded by
+    MQTT_CONNECT_TIMEOUT_MILLIS. Failed attempts back off from
+    MQTT_RETRY_MIN_MILLIS up to MQTT_RETRY_MAX_MILLIS.
+
+    Written by: Scott Griffis
+    Date: 10-19-2026
+*/
+
+#ifndef MqttClient_h
+    #define MqttClient_h
+
+    #include <Arduino.h>
+    #include <Client.h>
+
+    #define MQTT_MAX_PACKET_SIZE 640 // Largest packet sent, including headers
+    #define MQTT_KEEP_ALIVE_SECS 60
+    #define MQTT_CONNECT_TIMEOUT_MILLIS 1000ul // Bounds the name lookup and TCP connect
+    #define MQTT_ACK_TIMEOUT_MILLIS 10000ul // Time given the broker to answer before resending or giving up
+    #define MQTT_RETRY_MIN_MILLIS 2000ul
+    #define MQTT_RETRY_MAX_MILLIS 60000ul
+
+    class MqttClient {
+        public:
+            enum State : uint8_t {
+                MQTT_OFF, // <----------------- No broker configured
+                MQTT_DISCONNECTED, // <-------- Waiting to try connecting
+                MQTT_CONNECTING, // <---------- Connected; Waiting on the broker to accept
+                MQTT_CONNECTED
+            };
+
+        private:
+            Client        *client           ;
+            const char    *host             = "";
+            uint16_t       port             = 1883;
+            const char    *clientId         = "";
+            const char    *user             = "";
+            const char    *pwd              = "";
+            const char    *willTopic        = "";
+            const char    *willMessage      = "";
+
+            State          state            = MQTT_OFF;
+            unsigned long  stateMillis      = 0ul; // When the current state began
+            bool           hasAttempted     = false; // Connect attempted since configured
+            uint32_t       retryMillis      = MQTT_RETRY_MIN_MILLIS;
+            unsigned long  lastSendMillis   = 0ul;
+            bool           isPingPending    = false;
+            unsigned long  pingMillis       = 0ul;
+            uint16_t       nextPacketId     = 1;
+            uint8_t        lastRefusal      = 0; // Return code of the last refused connect
+
+            uint8_t        packet           [MQTT_MAX_PACKET_SIZE];
+            uint8_t        inflight         [MQTT_MAX_PACKET_SIZE]; // QoS 1 message waiting on its acknowledgement
+            size_t         inflightLength   = 0; // 0 when none
+            uint16_t       inflightId       = 0;
+            unsigned long  inflightMillis   = 0ul;
+
+            uint8_t        rxPhase          = 0; // Fixed header, remaining length or body
+            uint8_t        rxType           = 0;
+            uint32_t       rxLength         = 0;
+            uint32_t       rxMultiplier     = 1;
+            uint32_t       rxIndex          = 0;
+            uint8_t        rxData           [4]; // Only the start of each packet is needed
+
+            unsigned long  connectCount     = 0ul;
+            unsigned long  publishCount     = 0ul;
+            unsigned long  ackCount         = 0ul;
+            unsigned long  resendCount      = 0ul;
+
+            void connect(unsigned long nowMillis);
+            void dropConnection(unsigned long nowMillis);
+            void readIncoming(unsigned long nowMillis);
+            void handlePacket(unsigned long nowMillis);
+            bool writePacket(const uint8_t* data, size_t length);
+            static size_t putHeader(uint8_t* buffer, uint8_t type, size_t remaining);
+            static size_t putString(uint8_t* buffer, const char* text);
+
+        public:
+            MqttClient(Client& client);
+
+            void           configure         (const char* host, uint16_t port, const char* clientId, const char* user, const char* pwd, const char* willTopic, const char* willMessage);
+            void           loop              (unsigned long nowMillis);
+            bool           canPublish        (uint8_t qos)            ;
+            bool           publish           (const char* topic, const char* payload, size_t length, uint8_t qos, bool isRetained);
+            void           disconnect        ()                       ;
+
+            State          getState          ()                       ;
+            const char*    getStateName      ()                       ;
+            bool           isConnected       ()                       ;
+            bool           hasInflight       ()                       ;
+            uint8_t        getLastRefusal    ()                       ;
+            unsigned long  getConnectCount   ()                       ;
+            unsigned long  getPublishCount   ()                       ;
+            unsigned long  getAckCount       ()                       ;
+            unsigned long  getResendCount    ()                       ;
+    };
+
+#endif
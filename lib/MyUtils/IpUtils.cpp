@@ -4,69 +4,93 @@
 */
 
 #include "IpUtils.h"
+#include <string.h>
 
-IPAddress IpUtils::stringIPv4ToIPAddress(String ip) {
-    String oct[4];
-
-    int curIndex = 0;
-    String temp = "";
-    for (unsigned int i = 0; i < ip.length(); i++) {
-        if (ip.charAt(i) != '.') {
-            temp.concat(ip.charAt(i));
-        } else {
-            oct[curIndex] = String(temp);
-            temp = "";
-            curIndex ++;
-        }
+/**
+ * Parses a null terminated dotted IPv4 Address into an IPAddress.
+ *
+ * @param text The text to parse as const char*.
+ * @param address Where to put the address; Only set when OK as IPAddress&.
+ *
+ * @return Returns IP_PARSE_OK or why the text isn't an address as IpParseStatus.
+*/
+IpParseStatus IpUtils::parseIPv4(const char *text, IPAddress &address) {
+    uint32_t value = 0;
+    IpParseStatus status = parseIPv4(text, strlen(text), value);
+    if (status == IP_PARSE_OK) { // Good address...
+        address = IPAddress(getOctet(value, 0), getOctet(value, 1), getOctet(value, 2), getOctet(value, 3));
     }
-    oct[curIndex] = String(temp);
 
-    return IPAddress(oct[0].toInt(), oct[1].toInt(), oct[2].toInt(), oct[3].toInt());
+    return status;
 }
 
-unsigned long IpUtils::ipv4ToBinary(String ip) {
-    /* Pull Appart IP Into Octets */
-    unsigned int oct[4];
+/**
+ * Parses a null terminated dotted IPv4 Address into an IPAddress,
+ * for when anything unparsable may simply be treated as unset.
+ *
+ * @param text The text to parse as const char*.
+ *
+ * @return Returns the address or 0.0.0.0 if the text isn't one as IPAddress.
+*/
+IPAddress IpUtils::toIPAddress(const char *text) {
+    IPAddress address = IPAddress(0, 0, 0, 0);
+    parseIPv4(text, address);
+
+    return address;
+}
 
-    int curIndex = 0;
-    String temp = "";
-    for (unsigned int i = 0; i < ip.length(); i++) {
-        if (ip.charAt(i) != '.') {
-            temp.concat(ip.charAt(i));
-        } else {
-            oct[curIndex] = String(temp).toInt();
-            temp = "";
-            curIndex ++;
+/**
+ * Formats an IPv4 Address in dotted form into the given buffer
+ * without any allocation. A buffer of IPV4_TEXT_SIZE always fits.
+ *
+ * @param address The address to format as const IPAddress&.
+ * @param buffer Where to put the null terminated text as char*.
+ * @param size The size of the buffer as size_t.
+ *
+ * @return Returns the length of the text or 0 if the buffer was too small as size_t.
+*/
+size_t IpUtils::formatIPv4(const IPAddress &address, char *buffer, size_t size) {
+    char text[IPV4_TEXT_SIZE];
+    size_t length = 0;
+    for (int i = 0; i < 4; i++) {
+        uint8_t octet = address[i];
+        if (octet >= 100) { // Hundreds...
+            text[length++] = (char) ('0' + (octet / 100));
+        }
+        if (octet >= 10) { // Tens...
+            text[length++] = (char) ('0' + ((octet / 10) % 10));
         }
+        text[length++] = (char) ('0' + (octet % 10));
+        text[length++] = '.';
     }
-    oct[curIndex] = String(temp).toInt();
+    text[--length] = '\0'; // Trailing dot becomes the end
 
-    /* Derive Binary From Octets */
-    unsigned long ipBin = 0UL;
-    for (int i = 0; i < 4; i ++) {
-        ipBin = (ipBin << 8);
-        ipBin = (ipBin | oct[i]);
+    if (length >= size) { // Won't fit...
+        if (size > 0) { // Leave it empty...
+            buffer[0] = '\0';
+        }
+
+        return 0;
     }
+    memcpy(buffer, text, length + 1);
 
-    return ipBin;
+    return length;
 }
 
-IPAddress IpUtils::deriveNetworkBroadcastAddress(String ip, String subnet) {
-    unsigned long ipBin = ipv4ToBinary(ip);
-    unsigned long subBin = ipv4ToBinary(subnet);
+/**
+ * Works out the broadcast address of the network the given address
+ * is on. The bit math works the same regardless of byte order.
+ *
+ * @param ip An address on the network as const IPAddress&.
+ * @param subnet The subnet mask of the network as const IPAddress&.
+ *
+ * @return Returns the broadcast address of the network as IPAddress.
+*/
+IPAddress IpUtils::deriveNetworkBroadcastAddress(const IPAddress &ip, const IPAddress &subnet) {
+    uint32_t ipBin = (uint32_t) ip;
+    uint32_t subBin = (uint32_t) subnet;
 
     /* Calculate Network Broadcast IP */
-    unsigned long temp = (ipBin & subBin);
-    temp = (temp | (~ subBin));
 
-    /* Pull Octets From Binary */
-    unsigned int oct[4];
-    for (int i = 3; i >= 0; i --) {
-        oct[i] = temp & 255;
-        temp = (temp >> 8);
-    }
-
-    IPAddress result = IPAddress(oct[0], oct[1], oct[2], oct[3]);
-
-    return result;
-}
\ No newline at end of file
+    return IPAddress((ipBin & subBin) | (~ subBin));
+}
@@ -1,15 +1,98 @@
 #ifndef IpUtils_h
     #define IpUtils_h
 
-    #include <WString.h>
+    #include <stddef.h>
+    #include <stdint.h>
     #include <IPAddress.h>
 
+    #define IPV4_TEXT_SIZE 16 // Longest dotted IPv4 Address + 1 null
+
+    enum IpParseStatus : uint8_t {
+        IP_PARSE_OK,
+        IP_PARSE_EMPTY,
+        IP_PARSE_BAD_CHAR, // <-------- Something other than digits and dots
+        IP_PARSE_BAD_OCTET, // <------- Missing, too long or over 255
+        IP_PARSE_OCTET_COUNT // <------ Not exactly 4 octets
+    };
+
     class IpUtils {
         private:
 
         public:
-            static IPAddress stringIPv4ToIPAddress(String ip);
-            static IPAddress deriveNetworkBroadcastAddress(String ip, String subnet);
-            static unsigned long ipv4ToBinary(String ip);
+            /**
+             * Parses a dotted IPv4 Address such as 192.168.1.10 without
+             * any allocation. Each octet must have 1 to 3 digits and be no
+             * more than 255, and there must be exactly 4 of them. Usable
+             * at compile time.
+             *
+             * @param text The text to parse, need not be null terminated as const char*.
+             * @param length The length of the text as size_t.
+             * @param address Where to put the address with the first octet in
+             * the high byte; Only set when OK as uint32_t&.
+             *
+             * @return Returns IP_PARSE_OK or why the text isn't an address as IpParseStatus.
+            */
+            static constexpr IpParseStatus parseIPv4(const char *text, size_t length, uint32_t &address) {
+                if (length == 0) { // Nothing there...
+
+                    return IP_PARSE_EMPTY;
+                }
+
+                uint32_t result = 0;
+                uint16_t octet = 0;
+                uint8_t digits = 0;
+                uint8_t octets = 0;
+                for (size_t i = 0; i <= length; i++) {
+                    char c = (i < length) ? text[i] : '.'; // End closes the last octet
+                    if (c == '.') { // End of an octet...
+                        if (digits == 0 || octet > 255) { // Missing or too big...
+
+                            return IP_PARSE_BAD_OCTET;
+                        }
+                        if (++octets > 4) { // Too many...
+
+                            return IP_PARSE_OCTET_COUNT;
+                        }
+                        result = (result << 8) | octet;
+                        octet = 0;
+                        digits = 0;
+                    } else if (c >= '0' && c <= '9') { // Part of an octet...
+                        if (++digits > 3) { // Too long...
+
+                            return IP_PARSE_BAD_OCTET;
+                        }
+                        octet = (octet * 10) + (c - '0');
+                    } else {
+
+                        return IP_PARSE_BAD_CHAR;
+                    }
+                }
+                if (octets != 4) { // Too few...
+
+                    return IP_PARSE_OCTET_COUNT;
+                }
+                address = result;
+
+                return IP_PARSE_OK;
+            }
+
+            /**
+             * Used to get one octet of an address given with the first
+             * octet in the high byte, as done by parseIPv4().
+             *
+             * @param address The address as uint32_t.
+             * @param index The octet wanted, 0 being the first as int.
+             *
+             * @return Returns the octet as uint8_t.
+            */
+            static constexpr uint8_t getOctet(uint32_t address, int index) {
+
+                return (uint8_t) (address >> (8 * (3 - index)));
+            }
+
+            static IpParseStatus parseIPv4(const char *text, IPAddress &address);
+            static IPAddress toIPAddress(const char *text);
+            static size_t formatIPv4(const IPAddress &address, char *buffer, size_t size);
+            static IPAddress deriveNetworkBroadcastAddress(const IPAddress &ip, const IPAddress &subnet);
     };
-#endif
\ No newline at end of file
+#endif
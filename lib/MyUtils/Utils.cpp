@@ -1,30 +1,5 @@
 #include "Utils.h"
 
-/**
- * Used to provide a hash of the given NonVolatileSettings.
- * 
- * @param nvSet An instance of NonVolatileSettings to calculate a hash for.
- * 
- * @return Returns the calculated hash value as String.
-*/
-String Utils::hashNvSettings(struct NonVolatileSettings nvSet) {
-    String content = "";
-    content = content + String(nvSet.ssid);
-    content = content + String(nvSet.pwd);
-    content = content + String(nvSet.adminUser);
-    content = content + String(nvSet.adminPwd);
-    content = content + String(nvSet.title);
-    content = content + String(nvSet.heading);
-    content = content + String(nvSet.isCelsius);
-
-    MD5Builder builder = MD5Builder();
-    builder.begin();
-    builder.add(content);
-    builder.calculate();
-
-    return builder.toString();
-}
-
 /**
  * Function used to perform a MD5 Hash on a given string
  * the result is the MD5 Hash.
@@ -59,4 +34,114 @@ String Utils::genDeviceIdFromMacAddr(String macAddress) {
     result.toUpperCase();
 
     return result;
+}
+
+/**
+ * Escapes the given value into the given buffer, so that it can be
+ * safely placed between the quotes of a JSON string without the need
+ * for a String. The escaped value is cut short if it doesn't fit.
+ * 
+ * @param value The null terminated value to escape as const char*.
+ * @param buffer Where to put the null terminated escaped value as char*.
+ * @param size The size of the buffer, at least 1 as size_t.
+ * 
+ * @return Returns the length of the escaped value as size_t.
+*/
+size_t Utils::jsonEscape(const char *value, char *buffer, size_t size) {
+    size_t length = 0;
+    for (; *value != '\0'; value++) {
+        char c = *value;
+        bool needsBackslash = (c == '"' || c == '\\');
+        if ((length + (needsBackslash ? 2 : 1)) >= size) { // No more room...
+            break;
+        }
+        if (needsBackslash) { // Needs a backslash...
+            buffer[length++] = '\\';
+        } else if ((unsigned char) c < 0x20) { // Control char; Not allowed...
+            c = ' ';
+        }
+        buffer[length++] = c;
+    }
+    buffer[length] = '\0';
+
+    return length;
+}
+
+/**
+ * Escapes the given value and appends it to the end of the given
+ * String, so that it can be safely placed between the quotes of a 
+ * JSON string without the need for a copy of the value.
+ * 
+ * @param out The String to append to as String&.
+ * @param value The null terminated value to escape as const char*.
+*/
+void Utils::appendJsonEscaped(String &out, const char *value) {
+    for (; *value != '\0'; value++) {
+        char c = *value;
+        if (c == '"' || c == '\\') { // Needs a backslash...
+            out.concat('\\');
+            out.concat(c);
+        } else if ((unsigned char) c < 0x20) { // Control char; Not allowed...
+            out.concat(' ');
+        } else {
+            out.concat(c);
+        }
+    }
+}
+
+/**
+ * Formats the given 64-bit value as decimal text into the given
+ * buffer, for when a String would be a needless allocation. A 
+ * buffer of UINT64_TEXT_SIZE always fits.
+ * 
+ * @param value The value to format as uint64_t.
+ * @param buffer Where to put the null terminated text as char*.
+ * @param size The size of the buffer as size_t.
+ * 
+ * @return Returns the length of the text or 0 if the buffer was too small as size_t.
+*/
+size_t Utils::formatUint64(uint64_t value, char *buffer, size_t size) {
+    char text[UINT64_TEXT_SIZE];
+    int index = sizeof(text) - 1;
+    text[index] = '\0';
+    do {
+        text[--index] = (char) ('0' + (value % 10ull));
+        value /= 10ull;
+    } while (value > 0ull);
+
+    size_t length = (sizeof(text) - 1) - index;
+    if (length >= size) { // Won't fit...
+
+        return 0;
+    }
+    memcpy(buffer, &text[index], length + 1);
+
+    return length;
+}
+
+/**
+ * Parses a MAC Address in the form of AA:BB:CC:DD:EE:FF into
+ * its 6 bytes.
+ * 
+ * @param text The MAC Address as const char*.
+ * @param mac Where to put the 6 bytes of the MAC Address as uint8_t*.
+ * 
+ * @return Returns true if the text was a valid MAC Address otherwise false as bool.
+*/
+bool Utils::parseMacAddress(const char *text, uint8_t *mac) {
+    if (strlen(text) != 17) { // Wrong size...
+
+        return false;
+    }
+    for (int i = 0; i < 6; i++) {
+        char hex[3] = {text[i * 3], text[(i * 3) + 1], '\0'};
+        char *end = nullptr;
+        mac[i] = (uint8_t) strtoul(hex, &end, 16);
+        if (end != &hex[2] || (i < 5 && text[(i * 3) + 2] != ':')) { // Malformed...
+
+            return false;
+        }
+    }
+
+    return true;
 }
\ No newline at end of file
@@ -3,13 +3,18 @@
 
     #include <Settings.h>
 
+    #define UINT64_TEXT_SIZE 21 // Max of 20 digits + null
+
     class Utils {
         private:
 
         public:
-            static String hashNvSettings(struct NonVolatileSettings nvSet);
             static String hashString(String string);
             static String genDeviceIdFromMacAddr(String macAddress);
+            static size_t jsonEscape(const char *value, char *buffer, size_t size);
+            static void appendJsonEscaped(String &out, const char *value);
+            static size_t formatUint64(uint64_t value, char *buffer, size_t size);
+            static bool parseMacAddress(const char *text, uint8_t *mac);
     };
 
 #endif
@@ -0,0 +1,318 @@
+/*
+    NetworkManager - A class used to bring up and look after the device's
+    WiFi connection, keeping the device's addressing current as the WiFi
+    events of the ESP8266 come in.
+
+    Written by: Scott Griffis
+    Date: 10-19-2026
+*/
+
+#include "NetworkManager.h"
+
+/**
+ * #### CLASS CONSTRUCTOR ####
+ * Allows for external instantiation of
+ * the class into an object.
+*/
+NetworkManager::NetworkManager() {
+    ipAddress = IPAddress(0, 0, 0, 0);
+    subnetMask = IPAddress(0, 0, 0, 0);
+    bcastAddress = IPAddress(0, 0, 0, 0);
+}
+
+/**
+ * Puts the device into client mode such that it will
+ * connect to the specified WiFi network. If the config
+ * holds the BSSID and channel of the access point then a
+ * direct connect is tried first.
+ * 
+ * @param config How to join the network as StationConfig.
+*/
+void NetworkManager::beginStation(const StationConfig &config) {
+    strncpy(ssid, config.ssid, sizeof(ssid) - 1);
+    ssid[sizeof(ssid) - 1] = '\0';
+    strncpy(pwd, config.pwd, sizeof(pwd) - 1);
+    pwd[sizeof(pwd) - 1] = '\0';
+
+    connectedHandler = WiFi.onStationModeConnected(
+        [this](const WiFiEventStationModeConnected &event) { 
+            memcpy(bssid, event.bssid, sizeof(bssid));
+            channel = event.channel;
+            connectedPending = true; 
+        }
+    );
+    gotIpHandler = WiFi.onStationModeGotIP(
+        [this](const WiFiEventStationModeGotIP &) { gotIpPending = true; }
+    );
+    disconnectedHandler = WiFi.onStationModeDisconnected(
+        [this](const WiFiEventStationModeDisconnected &) { disconnectPending = true; }
+    );
+
+    WiFi.persistent(false); // Settings class owns the credentials; Spare the flash
+    WiFi.setAutoReconnect(false); // Reconnects are paced by update()
+    WiFi.setOutputPower(20.5F);
+    WiFi.setHostname(config.hostname);
+    WiFi.mode(WiFiMode::WIFI_STA);
+    if (config.ip.isSet()) { // Static addressing...
+        WiFi.config(config.ip, config.gateway, config.subnet, config.dns);
+    } else { // DHCP...
+        WiFi.config(IPAddress(0, 0, 0, 0), IPAddress(0, 0, 0, 0), IPAddress(0, 0, 0, 0));
+    }
+
+    isFastConnect = (config.bssid != nullptr && config.channel > 0);
+    if (isFastConnect) { // Join the known access point directly...
+        WiFi.begin(ssid, pwd, config.channel, config.bssid);
+    } else { // Scan for it...
+        WiFi.begin(ssid, pwd);
+    }
+
+    setAddress(IPAddress(0, 0, 0, 0), IPAddress(0, 0, 0, 0));
+    enterState(NET_CONNECTING, millis());
+}
+
+/**
+ * Puts the device into AP Mode so that user can
+ * connect via WiFi directly to the device to configure
+ * the device.
+ * 
+ * @param hostname The hostname to give the device as const char*.
+ * @param ssid The SSID of the network to present as const char*.
+ * @param pwd The password of the network to present as const char*.
+ * @param ip The device's IP Address on the network as IPAddress.
+ * @param gateway The gateway of the network as IPAddress.
+ * @param subnet The subnet mask of the network as IPAddress.
+*/
+void NetworkManager::beginAccessPoint(const char *hostname, const char *ssid, const char *pwd, IPAddress ip, IPAddress gateway, IPAddress subnet) {
+    connectedHandler = nullptr;
+    gotIpHandler = nullptr;
+    disconnectedHandler = nullptr;
+
+    WiFi.setOutputPower(20.5F);
+    WiFi.setHostname(hostname);
+    WiFi.mode(WiFiMode::WIFI_AP);
+    WiFi.softAPConfig(ip, gateway, subnet);
+    WiFi.softAP(ssid, pwd);
+
+    setAddress(WiFi.softAPIP(), subnet);
+    enterState(NET_ACCESS_POINT, millis());
+}
+
+/**
+ * Works through any WiFi events which have come in since the last
+ * call and retries the connection when it is due. Meant to be 
+ * called every pass of the loop.
+ * 
+ * @param nowMillis The current time in milliseconds as unsigned long.
+ * 
+ * @return Returns true if the device's addressing changed since the
+ * last call otherwise false as bool.
+*/
+bool NetworkManager::update(unsigned long nowMillis) {
+    if (connectedPending) { // Associated with access point...
+        connectedPending = false;
+        associatedMillis = nowMillis;
+    }
+    if (disconnectPending) { // Lost or failed to get the network...
+        disconnectPending = false;
+        if (state == NET_CONNECTING && isFastConnect) { // Direct connect failed...
+            fallBackToScan(nowMillis);
+        } else if (state == NET_ONLINE) { // Dropped off; Failures while connecting are left to the timeout...
+            setAddress(IPAddress(0, 0, 0, 0), IPAddress(0, 0, 0, 0));
+            enterState(NET_OFFLINE, nowMillis);
+        }
+    }
+    if (gotIpPending) { // Got a new or renewed lease...
+        gotIpPending = false;
+        if (state != NET_ACCESS_POINT) {
+            setAddress(WiFi.localIP(), WiFi.subnetMask());
+            backoffMillis = NET_MIN_BACKOFF_MILLIS;
+            if (state != NET_ONLINE) { // New connection rather than a renewal...
+                gotIpMillis = nowMillis;
+                lastWasFastConnect = isFastConnect;
+                connectCount++;
+            }
+            enterState(NET_ONLINE, nowMillis);
+        }
+    }
+
+    switch (state) {
+        case NET_CONNECTING:
+            if (isFastConnect && (nowMillis - stateMillis) >= NET_FAST_CONNECT_TIMEOUT_MILLIS) { // Direct connect is taking too long...
+                fallBackToScan(nowMillis);
+            } else if ((nowMillis - stateMillis) >= NET_CONNECT_TIMEOUT_MILLIS) { // Gave up waiting...
+                WiFi.disconnect();
+                enterState(NET_OFFLINE, nowMillis);
+            }
+            break;
+        case NET_OFFLINE:
+            if ((nowMillis - stateMillis) >= backoffMillis) { // Time to try again...
+                backoffMillis = min(backoffMillis * 2ul, NET_MAX_BACKOFF_MILLIS);
+                reconnectCount++;
+                isFastConnect = false;
+                WiFi.begin(ssid, pwd); // Scan as access point may have changed
+                enterState(NET_CONNECTING, nowMillis);
+            }
+            break;
+        default:
+            break;
+    }
+
+    bool changed = addressChanged;
+    addressChanged = false;
+
+    return changed;
+}
+
+NetworkManager::State NetworkManager::getState() {
+
+    return state;
+}
+
+/**
+ * Gets a short name for the current state for
+ * use in diagnostics.
+ * 
+ * @return Returns the name of the state as const char*.
+*/
+const char* NetworkManager::getStateName() {
+    switch (state) {
+        case NET_ACCESS_POINT: return "access_point";
+        case NET_CONNECTING: return "connecting";
+        case NET_ONLINE: return "online";
+        case NET_OFFLINE: return "offline";
+        default: return "idle";
+    }
+}
+
+/**
+ * Used to determine if the device currently has an
+ * address on a network, either as a station or as an
+ * access point.
+ * 
+ * @return Returns true if on a network otherwise false as bool.
+*/
+bool NetworkManager::isOnline() {
+
+    return (state == NET_ONLINE || state == NET_ACCESS_POINT);
+}
+
+IPAddress NetworkManager::getIpAddress() {
+
+    return ipAddress;
+}
+
+IPAddress NetworkManager::getBcastAddress() {
+
+    return bcastAddress;
+}
+
+unsigned long NetworkManager::getReconnectCount() {
+
+    return reconnectCount;
+}
+
+/**
+ * Gets the number of times the station has connected and
+ * gotten an IP Address, which may be used to detect new
+ * connections.
+ * 
+ * @return Returns the count as unsigned long.
+*/
+unsigned long NetworkManager::getConnectCount() {
+
+    return connectCount;
+}
+
+/**
+ * Gets the BSSID of the access point the station last
+ * associated with.
+ * 
+ * @return Returns a pointer to the 6 bytes of BSSID as const uint8_t*.
+*/
+const uint8_t* NetworkManager::getBssid() {
+
+    return bssid;
+}
+
+int32_t NetworkManager::getChannel() {
+
+    return channel;
+}
+
+unsigned long NetworkManager::getAssociatedMillis() {
+
+    return associatedMillis;
+}
+
+unsigned long NetworkManager::getGotIpMillis() {
+
+    return gotIpMillis;
+}
+
+/**
+ * Gets how long the last successful connection took from
+ * the time the connection attempt started until an IP
+ * Address was gotten.
+ * 
+ * @return Returns the duration in milliseconds as unsigned long.
+*/
+unsigned long NetworkManager::getLastConnectDuration() {
+
+    return (gotIpMillis - connectStartMillis);
+}
+
+/**
+ * Used to determine if the last successful connection was
+ * made directly to the known access point, skipping the scan.
+ * 
+ * @return Returns true if it was a direct connect otherwise false as bool.
+*/
+bool NetworkManager::getLastWasFastConnect() {
+
+    return lastWasFastConnect;
+}
+
+/*
+=================================================================
+Private Functions
+=================================================================
+*/
+
+/**
+ * #### PRIVATE ####
+ * Moves the state machine into the given state.
+*/
+void NetworkManager::enterState(State newState, unsigned long nowMillis) {
+    if (newState == NET_CONNECTING && state != NET_CONNECTING) { // New connection attempt...
+        connectStartMillis = nowMillis;
+    }
+    state = newState;
+    stateMillis = nowMillis;
+}
+
+/**
+ * #### PRIVATE ####
+ * Abandons the direct connect to the known access point and
+ * starts over with a regular scan for the network.
+*/
+void NetworkManager::fallBackToScan(unsigned long nowMillis) {
+    isFastConnect = false;
+    WiFi.begin(ssid, pwd);
+    stateMillis = nowMillis; // Give the scan its own full timeout
+}
+
+/**
+ * #### PRIVATE ####
+ * Sets the device's address and derives the broadcast address
+ * from it, flagging the change if there was one.
+*/
+void NetworkManager::setAddress(IPAddress ip, IPAddress mask) {
+    if (ip == ipAddress && mask == subnetMask) { // Nothing changed...
+
+        return;
+    }
+    ipAddress = ip;
+    subnetMask = mask;
+    bcastAddress = IpUtils::deriveNetworkBroadcastAddress(ip, mask);
+    addressChanged = true;
+}
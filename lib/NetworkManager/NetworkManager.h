@@ -0,0 +1,111 @@
+/*
+    NetworkManager - A class used to bring up and look after the device's
+    WiFi connection. It is a small state machine driven by the WiFi events of
+    the ESP8266. Each time the station gets an IP Address (including when a
+    DHCP renewal hands out a different one) the device's addressing is derived
+    anew, and when the station drops off the network it is brought back with
+    an exponential backoff between attempts.
+
+    When the access point of the last good connection is known, the station
+    first tries to join it directly by its BSSID and channel, which skips the
+    scan for it. If that doesn't pan out quickly the regular scan is used.
+
+    The WiFi events only raise flags, the actual work happens in update()
+    which is meant to be called from the loop.
+
+    Written by: Scott Griffis
+    Date: 10-19-2026
+*/
+
+#ifndef NetworkManager_h
+    #define NetworkManager_h
+
+    #include <ESP8266WiFi.h>
+    #include <IpUtils.h>
+
+    #define NET_CONNECT_TIMEOUT_MILLIS 30000ul // Max time to wait for an IP Address
+    #define NET_FAST_CONNECT_TIMEOUT_MILLIS 5000ul // Max time to try a direct connect before scanning
+    #define NET_MIN_BACKOFF_MILLIS 1000ul
+    #define NET_MAX_BACKOFF_MILLIS 60000ul
+
+    // *****************************************************************************
+    // Structure used to describe how the station should join the network
+    // *****************************************************************************
+    struct StationConfig {
+        const char     *hostname        ;
+        const char     *ssid            ;
+        const char     *pwd             ;
+        const uint8_t  *bssid           ; // nullptr if unknown
+        int32_t         channel         ; // 0 if unknown
+        IPAddress       ip              ; // Unset for DHCP
+        IPAddress       gateway         ;
+        IPAddress       subnet          ;
+        IPAddress       dns             ;
+    };
+
+    class NetworkManager {
+        public:
+            enum State {
+                NET_IDLE,
+                NET_ACCESS_POINT,
+                NET_CONNECTING,
+                NET_ONLINE,
+                NET_OFFLINE
+            };
+
+        private:
+            WiFiEventHandler connectedHandler;
+            WiFiEventHandler gotIpHandler    ;
+            WiFiEventHandler disconnectedHandler;
+
+            volatile bool  connectedPending = false;
+            volatile bool  gotIpPending     = false;
+            volatile bool  disconnectPending = false;
+
+            char           ssid             [33];
+            char           pwd              [65];
+            bool           isFastConnect    = false;
+            uint8_t        bssid            [6];
+            int32_t        channel          = 0;
+            unsigned long  connectCount     = 0ul;
+            unsigned long  connectStartMillis = 0ul;
+            unsigned long  associatedMillis = 0ul; // When last associated
+            unsigned long  gotIpMillis      = 0ul; // When last got an IP
+            bool           lastWasFastConnect = false;
+
+            State          state            = NET_IDLE;
+            IPAddress      ipAddress        ;
+            IPAddress      subnetMask       ;
+            IPAddress      bcastAddress     ;
+            unsigned long  stateMillis      = 0ul; // When current state was entered
+            unsigned long  backoffMillis    = NET_MIN_BACKOFF_MILLIS;
+            unsigned long  reconnectCount   = 0ul;
+            bool           addressChanged   = false;
+
+            void           enterState        (State newState, unsigned long nowMillis);
+            void           setAddress        (IPAddress ip, IPAddress mask);
+            void           fallBackToScan    (unsigned long nowMillis);
+
+        public:
+            NetworkManager();
+
+            void           beginStation      (const StationConfig &config);
+            void           beginAccessPoint  (const char *hostname, const char *ssid, const char *pwd, IPAddress ip, IPAddress gateway, IPAddress subnet);
+            bool           update            (unsigned long nowMillis);
+
+            State          getState          ()                       ;
+            const char*    getStateName      ()                       ;
+            bool           isOnline          ()                       ;
+            IPAddress      getIpAddress      ()                       ;
+            IPAddress      getBcastAddress   ()                       ;
+            unsigned long  getReconnectCount ()                       ;
+            unsigned long  getConnectCount   ()                       ;
+            const uint8_t* getBssid          ()                       ;
+            int32_t        getChannel        ()                       ;
+            unsigned long  getAssociatedMillis()                      ;
+            unsigned long  getGotIpMillis    ()                       ;
+            unsigned long  getLastConnectDuration()                   ;
+            bool           getLastWasFastConnect()                    ;
+    };
+
+#endif
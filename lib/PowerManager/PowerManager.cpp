@@ -0,0 +1,170 @@
+/*
+    PowerManager - A class used to decide how long the device may sleep
+    between passes of the main loop and how fast the CPU should run.
+
+    Written by: Scott Griffis
+    Date: 10-19-2026
+*/
+
+#include "PowerManager.h"
+
+/**
+ * #### CLASS CONSTRUCTOR ####
+ * Allows for external instantiation of
+ * the class into an object.
+ *
+ * @param maxSleepMillis The longest sleep between passes as uint32_t.
+ * @param boostHoldMillis How long full speed is kept after being busy as uint32_t.
+*/
+PowerManager::PowerManager(uint32_t maxSleepMillis, uint32_t boostHoldMillis) {
+    this->maxSleepMillis = maxSleepMillis;
+    this->boostHoldMillis = boostHoldMillis;
+}
+
+/**
+ * Used to tell the manager which sleep the WiFi is using while idle,
+ * which is only used to estimate the energy used.
+ *
+ * @param isLightSleep True for light sleep, false for modem sleep as bool.
+*/
+void PowerManager::setLightSleep(bool isLightSleep) {
+    this->isLightSleep = isLightSleep;
+}
+
+bool PowerManager::getIsLightSleep() {
+
+    return isLightSleep;
+}
+
+/**
+ * Used to mark the start of a pass of the loop, after which the
+ * tasks say when they are next due.
+ *
+ * @param nowMillis The current millis() as unsigned long.
+*/
+void PowerManager::beginPass(unsigned long nowMillis) {
+    passMillis = nowMillis;
+    sleepBudget = maxSleepMillis;
+    isBusy = false;
+}
+
+/**
+ * Used by a task to say when it next needs to run. The earliest
+ * time given during the pass limits the sleep after it.
+ *
+ * @param dueMillis The millis() at which the task is next due as unsigned long.
+*/
+void PowerManager::wakeBy(unsigned long dueMillis) {
+    long remaining = (long) (dueMillis - passMillis); // Signed difference handles rollover
+    if (remaining <= 0) { // Due already...
+        sleepBudget = 0;
+    } else if ((unsigned long) remaining < sleepBudget) { // Sooner than any other...
+        sleepBudget = (uint32_t) remaining;
+    }
+}
+
+/**
+ * Used to flag heavy work, under way or waiting, which rules out
+ * sleeping and wants the CPU at full speed.
+ *
+ * @param nowMillis The current millis() as unsigned long.
+*/
+void PowerManager::noteBusy(unsigned long nowMillis) {
+    isBusy = true;
+    hasBeenBusy = true;
+    busyMillis = nowMillis;
+}
+
+/**
+ * Used to get how long to sleep at the end of the pass, which is
+ * none at all while busy or within the hold time after.
+ *
+ * @param nowMillis The current millis() as unsigned long.
+ *
+ * @return Returns the time to sleep, 0 for none, as uint32_t.
+*/
+uint32_t PowerManager::getSleepMillis(unsigned long nowMillis) {
+
+    return (isBoostWanted(nowMillis) ? 0 : sleepBudget);
+}
+
+/**
+ * Used to tell if the CPU should run at full speed, which is while
+ * busy and for a hold time after, so a burst of requests isn't
+ * handled at alternating speeds.
+ *
+ * @param nowMillis The current millis() as unsigned long.
+ *
+ * @return Returns true for full speed otherwise false as bool.
+*/
+bool PowerManager::isBoostWanted(unsigned long nowMillis) {
+
+    return (isBusy || (hasBeenBusy && (nowMillis - busyMillis) < boostHoldMillis)); // Unsigned math handles rollover
+}
+
+/**
+ * Records how a pass of the loop was spent, for the duty cycle and
+ * the energy estimate.
+ *
+ * @param awakeMicros Time spent working as uint32_t.
+ * @param sleptMicros Time spent sleeping as uint32_t.
+ * @param cpuMHz The speed the CPU ran at while working as uint8_t.
+*/
+void PowerManager::record(uint32_t awakeMicros, uint32_t sleptMicros, uint8_t cpuMHz) {
+    uint64_t awakeMa = (cpuMHz > 80 ? POWER_AWAKE_160_MA : POWER_AWAKE_80_MA);
+    uint64_t sleepMa = (isLightSleep ? POWER_LIGHT_SLEEP_MA : POWER_MODEM_SLEEP_MA);
+    // mA x V x us gives nJ; The volts are in tenths...
+    uint64_t used = ((awakeMa * awakeMicros) + (sleepMa * sleptMicros)) * POWER_VOLTS_X10 / 10;
+
+    this->awakeMicros += awakeMicros;
+    this->sleptMicros += sleptMicros;
+    nanoJoules += used;
+    sampleNanoJoules += used;
+    sampleAwake += awakeMicros;
+    sampleSlept += sleptMicros;
+}
+
+/**
+ * Used to mark that a sample was taken, closing off the energy and
+ * duty cycle of the time since the one before.
+*/
+void PowerManager::noteSample() {
+    lastSampleNanoJoules = sampleNanoJoules;
+    uint64_t total = sampleAwake + sampleSlept;
+    lastSampleDuty = (total > 0 ? (uint8_t) ((sampleAwake * 100ull) / total) : 100);
+    sampleNanoJoules = 0ull;
+    sampleAwake = 0ull;
+    sampleSlept = 0ull;
+    sampleCount++;
+}
+
+uint8_t PowerManager::getDutyPercent() {
+    uint64_t total = awakeMicros + sleptMicros;
+
+    return (total > 0 ? (uint8_t) ((awakeMicros * 100ull) / total) : 100);
+}
+
+uint8_t PowerManager::getLastSampleDuty() {
+
+    return lastSampleDuty;
+}
+
+uint32_t PowerManager::getLastSampleMicroJoules() {
+
+    return (uint32_t) (lastSampleNanoJoules / 1000ull);
+}
+
+uint32_t PowerManager::getAverageMicroJoulesPerSample() {
+
+    return (sampleCount > 0 ? (uint32_t) ((nanoJoules / sampleCount) / 1000ull) : 0);
+}
+
+uint64_t PowerManager::getTotalMicroJoules() {
+
+    return nanoJoules / 1000ull;
+}
+
+unsigned long PowerManager::getSampleCount() {
+
+    return sampleCount;
+}
@@ -0,0 +1,84 @@
+/*
+    PowerManager - A class used to decide how long the device may sleep
+    between passes of the main loop and how fast the CPU should run, and
+    to keep track of the power that saves. Running flat out with the WiFi
+    always awake burns power and warms the board, which in turn throws off
+    the temperature read.
+
+    Each pass starts with beginPass(), then each task says when it next
+    needs to run with wakeBy(), and heavy work, such as a TLS handshake,
+    is flagged with noteBusy(). getSleepMillis() then gives the time until
+    the earliest task, up to the most allowed. While busy, and for a short
+    hold after, there is no sleep and the CPU is wanted at full speed, so
+    the rest of a request isn't held up. Otherwise the CPU may drop to half
+    speed.
+
+    The energy used is estimated from the time spent awake at each speed
+    and asleep, using typical currents for the module, so it's a guide
+    rather than a measurement. It's kept per sample so the cost of each
+    reading can be seen.
+
+    The class keeps no hardware state and takes the time from its caller,
+    so the decisions can be exercised away from the device.
+
+    Written by: Scott Griffis
+    Date: 10-19-2026
+*/
+
+#ifndef PowerManager_h
+    #define PowerManager_h
+
+    #include <stdint.h>
+
+    #define POWER_VOLTS_X10 33 // Supply of 3.3V
+    #define POWER_AWAKE_80_MA 56 // Typical current awake at 80MHz with the WiFi receiving
+    #define POWER_AWAKE_160_MA 70 // Typical current awake at 160MHz with the WiFi receiving
+    #define POWER_MODEM_SLEEP_MA 16 // Typical current idle with the WiFi in modem sleep
+    #define POWER_LIGHT_SLEEP_MA 3 // Typical current idle in light sleep, averaged with beacon wake ups
+
+    class PowerManager {
+        private:
+            uint32_t       maxSleepMillis   ;
+            uint32_t       boostHoldMillis  ; // Full speed kept this long after being busy
+            bool           isLightSleep     = false;
+
+            unsigned long  passMillis       = 0ul; // When the current pass began
+            uint32_t       sleepBudget      = 0; // Least time until a task is due this pass
+            bool           isBusy           = false; // Heavy work this pass
+            bool           hasBeenBusy      = false;
+            unsigned long  busyMillis       = 0ul; // Last time heavy work was seen
+
+            uint64_t       awakeMicros      = 0ull;
+            uint64_t       sleptMicros      = 0ull;
+            uint64_t       nanoJoules       = 0ull;
+            uint64_t       sampleNanoJoules = 0ull; // Since the last sample
+            uint64_t       sampleAwake      = 0ull;
+            uint64_t       sampleSlept      = 0ull;
+            uint64_t       lastSampleNanoJoules = 0ull; // Used by the last sample
+            uint8_t        lastSampleDuty   = 100; // Percent awake over the last sample
+            unsigned long  sampleCount      = 0ul;
+
+        public:
+            PowerManager(uint32_t maxSleepMillis, uint32_t boostHoldMillis);
+
+            void           setLightSleep     (bool isLightSleep)      ;
+            bool           getIsLightSleep   ()                       ;
+
+            void           beginPass         (unsigned long nowMillis);
+            void           wakeBy            (unsigned long dueMillis);
+            void           noteBusy          (unsigned long nowMillis);
+            uint32_t       getSleepMillis    (unsigned long nowMillis);
+            bool           isBoostWanted     (unsigned long nowMillis);
+
+            void           record            (uint32_t awakeMicros, uint32_t sleptMicros, uint8_t cpuMHz);
+            void           noteSample        ()                       ;
+
+            uint8_t        getDutyPercent    ()                       ; // Since boot
+            uint8_t        getLastSampleDuty ()                       ;
+            uint32_t       getLastSampleMicroJoules()                 ;
+            uint32_t       getAverageMicroJoulesPerSample()           ;
+            uint64_t       getTotalMicroJoules()                      ;
+            unsigned long  getSampleCount    ()                       ;
+    };
+
+#endif
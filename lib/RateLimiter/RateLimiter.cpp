@@ -0,0 +1,132 @@
+/*
+    RateLimiter - A class used to decide if an incoming web request should be
+    admitted or turned away. Each client IP Address gets its own token bucket
+    so that one misbehaving client can't starve the others, and all clients
+    together share a global token bucket so that the single threaded loop
+    always has time left for sensor reads and broadcasts.
+
+    Written by: Scott Griffis
+    Date: 10-19-2026
+*/
+
+#include "RateLimiter.h"
+
+/**
+ * #### CLASS CONSTRUCTOR ####
+ * Allows for external instantiation of
+ * the class into an object.
+ * 
+ * @param clientRate The number of requests per second each client may sustain as uint32_t.
+ * @param clientBurst The number of requests a client may make back to back as uint32_t.
+ * @param globalRate The number of requests per second all clients together may sustain as uint32_t.
+ * @param globalBurst The number of requests all clients together may make back to back as uint32_t.
+*/
+RateLimiter::RateLimiter(uint32_t clientRate, uint32_t clientBurst, uint32_t globalRate, uint32_t globalBurst) {
+    this->clientRate = clientRate;
+    this->clientBurst = clientBurst;
+    this->globalRate = globalRate;
+    this->globalBurst = globalBurst;
+
+    for (int i = 0; i < RATE_LIMITER_MAX_CLIENTS; i++) {
+        clientBuckets[i] = {0u, clientBurst * 1000u, 0ul};
+    }
+    globalBucket = {0u, globalBurst * 1000u, 0ul};
+}
+
+/**
+ * Decides if a request from the given client should be admitted. A request
+ * is admitted only if both the client's bucket and the global bucket have a
+ * token to spend.
+ * 
+ * @param ip The client's IPv4 Address as uint32_t.
+ * @param nowMillis The current time in milliseconds as unsigned long.
+ * 
+ * @return Returns the decision as Admission.
+*/
+RateLimiter::Admission RateLimiter::admit(uint32_t ip, unsigned long nowMillis) {
+    Bucket *bucket = findBucket(ip, nowMillis);
+    if (!takeToken(*bucket, clientRate, clientBurst, nowMillis)) { // Client is too chatty...
+        rateLimitedCount++;
+
+        return CLIENT_RATE_EXCEEDED;
+    }
+    if (!takeToken(globalBucket, globalRate, globalBurst, nowMillis)) { // Server is too busy...
+        busyCount++;
+
+        return SERVER_BUSY;
+    }
+    admittedCount++;
+
+    return ADMITTED;
+}
+
+unsigned long RateLimiter::getAdmittedCount() {
+
+    return admittedCount;
+}
+
+unsigned long RateLimiter::getRateLimitedCount() {
+
+    return rateLimitedCount;
+}
+
+unsigned long RateLimiter::getBusyCount() {
+
+    return busyCount;
+}
+
+/*
+=================================================================
+Private Functions
+=================================================================
+*/
+
+/**
+ * #### PRIVATE ####
+ * Finds the bucket belonging to the given client. If the client
+ * isn't being tracked yet then the bucket of the client which was
+ * least recently seen is handed over to it with a full burst.
+ * 
+ * @param ip The client's IPv4 Address as uint32_t.
+ * @param nowMillis The current time in milliseconds as unsigned long.
+ * 
+ * @return Returns a pointer to the client's bucket as Bucket*.
+*/
+RateLimiter::Bucket* RateLimiter::findBucket(uint32_t ip, unsigned long nowMillis) {
+    Bucket *oldest = &clientBuckets[0];
+    for (int i = 0; i < RATE_LIMITER_MAX_CLIENTS; i++) {
+        if (clientBuckets[i].ip == ip) { // Found it...
+            
+            return &clientBuckets[i];
+        }
+        if ((nowMillis - clientBuckets[i].lastMillis) > (nowMillis - oldest->lastMillis)) { // Seen less recently...
+            oldest = &clientBuckets[i];
+        }
+    }
+    *oldest = {ip, clientBurst * 1000u, nowMillis};
+
+    return oldest;
+}
+
+/**
+ * #### PRIVATE ####
+ * Refills the given bucket based on the time elapsed since it was 
+ * last used and then takes a token from it if one is available.
+ * 
+ * @return Returns true if a token was taken otherwise false as bool.
+*/
+bool RateLimiter::takeToken(Bucket &bucket, uint32_t rate, uint32_t burst, unsigned long nowMillis) {
+    unsigned long elapsed = nowMillis - bucket.lastMillis; // Rollover safe as unsigned
+    uint32_t max = burst * 1000u;
+    uint32_t refill = (elapsed >= (max / (rate > 0u ? rate : 1u))) ? max : (uint32_t) (elapsed * rate);
+
+    bucket.milliTokens = ((max - bucket.milliTokens) <= refill) ? max : (bucket.milliTokens + refill);
+    bucket.lastMillis = nowMillis;
+    if (bucket.milliTokens < 1000u) { // Less than a whole token...
+
+        return false;
+    }
+    bucket.milliTokens -= 1000u;
+
+    return true;
+}
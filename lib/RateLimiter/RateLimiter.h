@@ -0,0 +1,61 @@
+/*
+    RateLimiter - A class used to decide if an incoming web request should be
+    admitted or turned away. Each client IP Address gets its own token bucket
+    so that one misbehaving client can't starve the others, and all clients
+    together share a global token bucket so that the single threaded loop
+    always has time left for sensor reads and broadcasts. Rejections are
+    counted so that they may be reported.
+
+    Tokens are tracked in thousandths of a token so that refilling can be done
+    with integer math based on elapsed milliseconds.
+
+    Written by: Scott Griffis
+    Date: 10-19-2026
+*/
+
+#ifndef RateLimiter_h
+    #define RateLimiter_h
+
+    #include <stdint.h>
+
+    #define RATE_LIMITER_MAX_CLIENTS 8 // Number of client IPs tracked at once
+
+    class RateLimiter {
+        public:
+            enum Admission {
+                ADMITTED,
+                CLIENT_RATE_EXCEEDED,
+                SERVER_BUSY
+            };
+
+        private:
+            struct Bucket {
+                uint32_t       ip               ;
+                uint32_t       milliTokens      ;
+                unsigned long  lastMillis       ;
+            };
+
+            Bucket         clientBuckets    [RATE_LIMITER_MAX_CLIENTS];
+            Bucket         globalBucket     ;
+            uint32_t       clientRate       ; // Tokens per second
+            uint32_t       clientBurst      ;
+            uint32_t       globalRate       ; // Tokens per second
+            uint32_t       globalBurst      ;
+            unsigned long  admittedCount    = 0ul;
+            unsigned long  rateLimitedCount = 0ul;
+            unsigned long  busyCount        = 0ul;
+
+            Bucket* findBucket(uint32_t ip, unsigned long nowMillis);
+            bool takeToken(Bucket &bucket, uint32_t rate, uint32_t burst, unsigned long nowMillis);
+
+        public:
+            RateLimiter(uint32_t clientRate, uint32_t clientBurst, uint32_t globalRate, uint32_t globalBurst);
+
+            Admission      admit             (uint32_t ip, unsigned long nowMillis);
+
+            unsigned long  getAdmittedCount  ()                       ;
+            unsigned long  getRateLimitedCount()                      ;
+            unsigned long  getBusyCount      ()                       ;
+    };
+
+#endif
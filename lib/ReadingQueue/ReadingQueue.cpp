@@ -0,0 +1,134 @@
+/*
+    ReadingQueue - A class used to hold on to readings which couldn't be sent
+    while the device was offline.
+
+    Written by: Scott Griffis
+    Date: 10-19-2026
+*/
+
+#include "ReadingQueue.h"
+
+/**
+ * #### CLASS CONSTRUCTOR ####
+ * Allows for external instantiation of
+ * the class into an object.
+ *
+ * @param batchMillis The least time between batches as uint32_t.
+*/
+ReadingQueue::ReadingQueue(uint32_t batchMillis) {
+    this->batchMillis = batchMillis;
+}
+
+/**
+ * Adds a reading to the back of the queue. If the queue is full
+ * the oldest reading is dropped to make room. A reading already at
+ * the back of the queue isn't added again.
+ *
+ * @param reading The reading to add as const QueuedReading&.
+*/
+void ReadingQueue::push(const QueuedReading &reading) {
+    if (count > 0 && readings[(head + count - 1) % READING_QUEUE_SIZE].sequence == reading.sequence) { // Already queued...
+
+        return;
+    }
+    if (count == READING_QUEUE_SIZE) { // Full; Drop the oldest...
+        head = (head + 1) % READING_QUEUE_SIZE;
+        count--;
+        droppedCount++;
+    }
+    readings[(head + count) % READING_QUEUE_SIZE] = reading;
+    count++;
+    queuedCount++;
+}
+
+/**
+ * Removes the newest reading if it has the given sequence number,
+ * for when it was queued while offline but then went out live. It
+ * isn't counted as dropped or sent.
+ *
+ * @param sequence The sequence number of the reading sent live as uint32_t.
+ *
+ * @return Returns true if removed otherwise false as bool.
+*/
+bool ReadingQueue::dropNewest(uint32_t sequence) {
+    if (count == 0 || readings[(head + count - 1) % READING_QUEUE_SIZE].sequence != sequence) { // Not queued...
+
+        return false;
+    }
+    count--;
+
+    return true;
+}
+
+/**
+ * Used to tell if a batch should be sent now, which is when there
+ * is something queued and enough time has passed since the last.
+ *
+ * @param nowMillis The current millis() as unsigned long.
+ *
+ * @return Returns true if a batch is due otherwise false as bool.
+*/
+bool ReadingQueue::isBatchDue(unsigned long nowMillis) {
+    if (count == 0) { // Nothing to send...
+
+        return false;
+    }
+
+    return (!hasSentBatch || (nowMillis - lastBatchMillis) >= batchMillis); // Unsigned math handles rollover
+}
+
+/**
+ * Copies the oldest readings, up to READING_BATCH_SIZE of them, into
+ * the given batch without removing them, so they stay queued should
+ * sending fail.
+ *
+ * @param batch Where to copy the readings; Must fit READING_BATCH_SIZE as QueuedReading*.
+ *
+ * @return Returns the number of readings copied as uint8_t.
+*/
+uint8_t ReadingQueue::peekBatch(QueuedReading *batch) {
+    uint8_t batchCount = (count < READING_BATCH_SIZE ? count : READING_BATCH_SIZE);
+    for (uint8_t i = 0; i < batchCount; i++) {
+        batch[i] = readings[(head + i) % READING_QUEUE_SIZE];
+    }
+
+    return batchCount;
+}
+
+/**
+ * Removes the readings of a sent batch from the front of the queue
+ * and starts the wait before the next batch.
+ *
+ * @param batchCount The number of readings sent, as given by peekBatch() as uint8_t.
+ * @param nowMillis The current millis() as unsigned long.
+*/
+void ReadingQueue::markBatchSent(uint8_t batchCount, unsigned long nowMillis) {
+    if (batchCount > count) { // Can't remove more than is queued...
+        batchCount = (uint8_t) count;
+    }
+    head = (head + batchCount) % READING_QUEUE_SIZE;
+    count -= batchCount;
+    sentCount += batchCount;
+    lastBatchMillis = nowMillis;
+    hasSentBatch = true;
+}
+
+uint16_t ReadingQueue::getCount() {
+
+    return count;
+}
+
+unsigned long ReadingQueue::getQueuedCount() {
+
+    return queuedCount;
+}
+
+unsigned long ReadingQueue::getDroppedCount() {
+
+    return droppedCount;
+}
+
+unsigned long ReadingQueue::getSentCount() {
+
+    return sentCount;
+}
@@ -0,0 +1,64 @@
+/*
+    ReadingQueue - A class used to hold on to readings which couldn't be sent
+    while the device was offline, so that they can be forwarded once the
+    network is back rather than being lost. Readings are held in RAM in a
+    ring and, should an outage outlast the ring, the oldest are dropped and
+    counted.
+
+    Once back online the queue is drained oldest first in batches, with a
+    minimum time between batches, so that a long backlog goes out at a
+    steady rate rather than flooding the network all at once. Each reading
+    keeps the sequence number it was taken with so a receiver can tell that
+    nothing is missing. The newest reading is taken back out should it go
+    out live after all, so that it isn't sent twice.
+
+    Written by: Scott Griffis
+    Date: 10-19-2026
+*/
+
+#ifndef ReadingQueue_h
+    #define ReadingQueue_h
+
+    #include <stdint.h>
+
+    #define READING_QUEUE_SIZE 120 // One hour of readings at one every 30 seconds
+    #define READING_BATCH_SIZE 8 // Most readings sent in one batch
+
+    // *****************************************************************************
+    // A single reading along with the sequence number it was taken with
+    // *****************************************************************************
+    struct QueuedReading {
+        uint64_t       timestamp        ; // Millis since the Unix epoch; 0 if unsynced
+        uint32_t       sequence         ;
+        float          temperature      ; // Celsius
+        float          humidity         ; // Percent
+    };
+
+    class ReadingQueue {
+        private:
+            QueuedReading  readings         [READING_QUEUE_SIZE];
+            uint16_t       head             = 0; // Oldest
+            uint16_t       count            = 0;
+            uint32_t       batchMillis      ; // Least time between batches
+            unsigned long  lastBatchMillis  = 0ul;
+            bool           hasSentBatch     = false;
+            unsigned long  queuedCount      = 0ul;
+            unsigned long  droppedCount     = 0ul;
+            unsigned long  sentCount        = 0ul;
+
+        public:
+            ReadingQueue(uint32_t batchMillis);
+
+            void           push              (const QueuedReading& reading);
+            bool           dropNewest        (uint32_t sequence)      ;
+            bool           isBatchDue        (unsigned long nowMillis);
+            uint8_t        peekBatch         (QueuedReading* batch)   ;
+            void           markBatchSent     (uint8_t batchCount, unsigned long nowMillis);
+
+            uint16_t       getCount          ()                       ;
+            unsigned long  getQueuedCount    ()                       ;
+            unsigned long  getDroppedCount   ()                       ;
+            unsigned long  getSentCount      ()                       ;
+    };
+
+#endif
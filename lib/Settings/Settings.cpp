@@ -12,6 +12,49 @@
 
 #include <Settings.h>
 
+// Describes one NonVolatileSettings member; Keeps each table line short...
+#define SETTING_FIELD(member, name, label, group, type, flags, options) \
+    { name, label, group, offsetof(NonVolatileSettings, member), sizeof(NonVolatileSettings::member), type, flags, options }
+
+/*
+    The schema of the persisted settings. Everything that handles settings 
+    generically (admin page form, its JSON, validation, change detection, 
+    rollback and the integrity hash) works off of this table, so adding a 
+    setting only takes a member in NonVolatileSettings, its factory default 
+    and a line here. Fields are shown on the admin page in table order.
+*/
+static constexpr SettingField SETTING_FIELDS[] = {
+    SETTING_FIELD(ssid,          "ssid",          "SSID",           "WiFi",        SETTING_TEXT,     SETTING_NETWORK | SETTING_NEW_NETWORK, nullptr),
+    SETTING_FIELD(pwd,           "pwd",           "Password",       "WiFi",        SETTING_TEXT,     SETTING_NETWORK,  nullptr),
+    SETTING_FIELD(staticIp,      "staticip",      "Static IP",      "WiFi",        SETTING_IPV4,     SETTING_NETWORK,  nullptr),
+    SETTING_FIELD(staticGateway, "staticgateway", "Gateway",        "WiFi",        SETTING_IPV4,     SETTING_NETWORK,  nullptr),
+    SETTING_FIELD(staticSubnet,  "staticsubnet",  "Subnet",         "WiFi",        SETTING_IPV4,     SETTING_NETWORK,  nullptr),
+    SETTING_FIELD(staticDns,     "staticdns",     "DNS",            "WiFi",        SETTING_IPV4,     SETTING_NETWORK,  nullptr),
+    SETTING_FIELD(title,         "title",         "Title",          "Application", SETTING_TEXT,     0,                nullptr),
+    SETTING_FIELD(heading,       "heading",       "Heading",        "Application", SETTING_TEXT,     0,                nullptr),
+    SETTING_FIELD(isCelsius,     "units",         "Units",          "Application", SETTING_CHOICE,   0,                "Celsius|Fahrenheit"),
+    SETTING_FIELD(ntpServer,     "ntpserver",     "NTP Server",     "Application", SETTING_TEXT,     SETTING_TIME_SOURCE, nullptr),
+    SETTING_FIELD(adminUser,     "adminuser",     "Admin User",     "Admin",       SETTING_TEXT,     SETTING_LOGIN,    nullptr),
+    SETTING_FIELD(adminPwd,      "adminpwd",      "Admin Password", "Admin",       SETTING_TEXT,     SETTING_LOGIN,    nullptr),
+    SETTING_FIELD(mqttHost,      "mqtthost",      "Broker",         "MQTT",        SETTING_OPTIONAL_TEXT, SETTING_MQTT, nullptr),
+    SETTING_FIELD(mqttPort,      "mqttport",      "Port",           "MQTT",        SETTING_NUMBER,   SETTING_MQTT,     nullptr),
+    SETTING_FIELD(mqttUser,      "mqttuser",      "User",           "MQTT",        SETTING_OPTIONAL_TEXT, SETTING_MQTT, nullptr),
+    SETTING_FIELD(mqttPwd,       "mqttpwd",       "Password",       "MQTT",        SETTING_OPTIONAL_TEXT, SETTING_MQTT, nullptr),
+    SETTING_FIELD(mqttTopic,     "mqtttopic",     "Topic Prefix",   "MQTT",        SETTING_TEXT,     SETTING_MQTT,     nullptr),
+    SETTING_FIELD(isMqttQos1,    "mqttqos",       "Readings QoS",   "MQTT",        SETTING_CHOICE,   0,                "1|0"),
+    SETTING_FIELD(isLightSleep,  "sleepmode",     "Idle Sleep",     "Power",       SETTING_CHOICE,   SETTING_POWER,    "Light|Modem"),
+    SETTING_FIELD(isBatteryMode, "batterymode",   "Battery Mode",   "Power",       SETTING_CHOICE,   0,                "Yes|No"),
+    SETTING_FIELD(batterySleepSecs, "batterysleep", "Sleep Seconds", "Power",      SETTING_NUMBER,   0,                nullptr),
+    SETTING_FIELD(isBroadcastOn, "broadcast",     "UDP Broadcast",  "Discovery",   SETTING_CHOICE,   0,                "Yes|No"),
+    SETTING_FIELD(isHubMode,     "hubmode",       "Hub Mode",       "Discovery",   SETTING_CHOICE,   SETTING_HUB,      "Yes|No"),
+    SETTING_FIELD(lastBssid,     "lastbssid",     "",               "",            SETTING_INTERNAL, SETTING_NETWORK,  nullptr),
+    SETTING_FIELD(lastChannel,   "lastchannel",   "",               "",            SETTING_INTERNAL, SETTING_NETWORK,  nullptr),
+    SETTING_FIELD(lastIp,        "lastip",        "",               "",            SETTING_INTERNAL, SETTING_NETWORK,  nullptr),
+    SETTING_FIELD(lastGateway,   "lastgateway",   "",               "",            SETTING_INTERNAL, SETTING_NETWORK,  nullptr),
+    SETTING_FIELD(lastSubnet,    "lastsubnet",    "",               "",            SETTING_INTERNAL, SETTING_NETWORK,  nullptr),
+    SETTING_FIELD(lastDns,       "lastdns",       "",               "",            SETTING_INTERNAL, SETTING_NETWORK,  nullptr)
+};
+
 /**
  * #### CLASS CONSTRUCTOR ####
  * Allows for external instantiation of
@@ -20,6 +63,7 @@
 Settings::Settings() {
     // Initially default the settings...
     defaultSettings();
+    setDeviceId("");
 }
 
 /**
@@ -32,6 +76,7 @@ Settings::Settings() {
 */
 bool Settings::factoryDefault() {
     defaultSettings();
+    findNewestSlot(); // Settings may never have been loaded this boot; The defaults must outrank both slots
     bool ok = saveSettings();
 
     return ok;
@@ -39,53 +84,134 @@ bool Settings::factoryDefault() {
 
 /**
  * Used to load the settings from flash memory.
- * After the settings are loaded from flash memory the sentinel value is 
- * checked to ensure the integrity of the loaded data. If the sentinel 
- * value is wrong then the contents of the memory are deemed invalid and
- * the memory is wiped and then a factory default is instead performed.
+ * The settings are stored in two slots, each behind a header holding a 
+ * magic number, the version and length of the settings, a CRC32 of their 
+ * raw bytes and the sequence number of the save, which are all checked 
+ * to ensure the integrity of the loaded data. Of the slots found intact
+ * the one saved last is loaded. Settings stored by an older version are 
+ * migrated, with anything added since taking its factory default. When
+ * neither slot was ever written settings stored through the EEPROM 
+ * library, as versions 2 to 7 did, and by firmware from before the 
+ * header are looked for and migrated. If there is something stored but
+ * it can't be made sense of then a factory default is performed.
  * 
- * @return Returns true if data was loaded from memory and the sentinel 
- * value was valid.
+ * @return Returns true if valid settings were loaded from memory
+ * otherwise false as bool.
 */
 bool Settings::loadSettings() {
     bool ok = false;
-    // Setup EEPROM for loading and saving...
-    EEPROM.begin(sizeof(NonVolatileSettings));
+    bool isStored = false;
+    bool isMigrated = false;
+    struct SettingsHeader header;
+    struct NonVolatileSettings loaded;
 
     // Persist default settings or load settings...
     delay(15);
 
-    /* Load from EEPROM if applicable... */
-    if (EEPROM.percentUsed() >= 0) { // Something is stored from prior...
-        EEPROM.get(0, nvSettings);
-        if (strcmp(nvSettings.sentinel, Utils::hashNvSettings(nvSettings).c_str()) != 0) { // Memory is corrupt...
-            EEPROM.wipe();
-            factoryDefault();
-        } else { // Memory seems ok...
+    /* Load the newest intact slot... */
+    for (uint8_t slot = 0; isSlotSpace() && slot < SETTINGS_SLOT_COUNT; slot++) {
+        if (!readFlash(getSlotAddress(slot), &header, sizeof(SettingsHeader))) { // Flash not readable...
+
+            continue;
+        }
+        isStored |= (header.magic != 0xFFFFFFFFul); // Written to since erased...
+        uint16_t length = getStoredLength(header);
+        if (
+            length > 0
+            && (!ok || (int32_t) (header.sequence - storedState.sequence) > 0)
+            && readFlash(getSlotAddress(slot) + sizeof(SettingsHeader), &loaded, length)
+            && header.crc == crc32(&loaded, length)
+        ) { // Intact and newer than any found so far...
+            defaultSettings();
+            memcpy(&nvSettings, &loaded, length);
+            storedState.isKnown = (header.version == SETTINGS_VERSION);
+            storedState.crc = header.crc;
+            storedState.sequence = header.sequence;
+            storedState.slot = slot;
+            isMigrated = !storedState.isKnown;
             ok = true;
         }
     }
-    EEPROM.end();
+
+    /* Otherwise load what the EEPROM library holds, which is older than anything in the slots... */
+    if (!isStored) {
+        EEPROM.begin(SETTINGS_EEPROM_SIZE);
+        if (EEPROM.percentUsed() >= 0) { // Something is stored from prior...
+            isStored = true;
+            EEPROM.get(0, header);
+            EEPROM.get(sizeof(SettingsHeader), loaded);
+            uint16_t length = getStoredLength(header);
+            if (length > 0 && header.crc == crc32(&loaded, length)) { // Memory seems ok...
+                defaultSettings();
+                memcpy(&nvSettings, &loaded, length);
+                storedState.sequence = header.sequence;
+                isMigrated = true;
+                ok = true;
+            }
+        }
+        EEPROM.end();
+    }
+
+    if (isMigrated) { // Keep in current format...
+        saveSettings();
+    } else if (!isStored && loadLegacySettings()) { // Stored by older firmware; Keep in current format...
+        ok = true;
+        saveSettings();
+    } else if (!ok && isStored) { // Memory is corrupt...
+        factoryDefault();
+    }
 
     return ok;
 }
 
 /**
  * Used to save or persist the current value of the non-volatile settings
- * into flash memory.
+ * into flash memory, preceded by a header describing them. Nothing is
+ * written when the settings are the same as the stored copy.
+ * 
+ * Saves alternate between the two slots, each a flash sector of its own,
+ * so the slot written is never the one holding the last copy saved. The
+ * header is written last, so should power be lost part way through the
+ * slot fails its checks and the copy in the other slot is what gets 
+ * loaded on the next boot.
  *
  * @return Returns a true if save was successful otherwise a false as bool.
 */
 bool Settings::saveSettings() {
-    strcpy(nvSettings.sentinel, Utils::hashNvSettings(nvSettings).c_str()); // Ensure accurate Sentinel Value.
-    EEPROM.begin(sizeof(NonVolatileSettings));
+    static_assert(sizeof(SettingsHeader) + sizeof(NonVolatileSettings) <= SETTINGS_SLOT_SIZE, "Settings outgrew their slot");
+    uint32_t crc = crc32(&nvSettings, sizeof(NonVolatileSettings));
+    if (storedState.isKnown && storedState.crc == crc) { // Nothing changed...
 
-    EEPROM.wipe(); // usage seemd to grow without this.
-    EEPROM.put(0, nvSettings);
-    
-    bool ok = EEPROM.commit();
+        return true;
+    }
 
-    EEPROM.end();
+    if (!isSlotSpace()) { // Nowhere to keep them...
+
+        return false;
+    }
+
+    struct SettingsHeader header = {
+        SETTINGS_MAGIC, 
+        SETTINGS_VERSION, 
+        sizeof(NonVolatileSettings), 
+        crc, 
+        storedState.sequence + 1
+    };
+    uint8_t slot = (storedState.slot + 1) % SETTINGS_SLOT_COUNT;
+    uint32_t address = getSlotAddress(slot);
+
+    bool ok = (
+        ESP.flashEraseSector(address / FLASH_SECTOR_SIZE)
+        && writeFlash(address + sizeof(SettingsHeader), &nvSettings, sizeof(NonVolatileSettings))
+        && writeFlash(address, &header, sizeof(SettingsHeader))
+    );
+    storedState.writeCount++;
+    if (ok) { // Stored copy now matches...
+        storedState.isKnown = true;
+        storedState.crc = crc;
+        storedState.sequence = header.sequence;
+        storedState.slot = slot;
+    }
     
     return ok;
 }
@@ -97,7 +223,7 @@ bool Settings::saveSettings() {
 */
 bool Settings::isFactoryDefault() {
     
-    return (strcmp(Utils::hashNvSettings(nvSettings).c_str(), Utils::hashNvSettings(factorySettings).c_str()) == 0);
+    return (memcmp(&nvSettings, &factorySettings, sizeof(NonVolatileSettings)) == 0);
 }
 
 /**
@@ -107,7 +233,7 @@ bool Settings::isFactoryDefault() {
  * @return Returns true if the settings have been changed from default, otherwise returns false as bool.
 */
 bool Settings::isNetworkSet() {
-    if (getSsid().equals(String(factorySettings.ssid)) || getPwd().equals(String(factorySettings.pwd))) {
+    if (strcmp(nvSettings.ssid, factorySettings.ssid) == 0 || strcmp(nvSettings.pwd, factorySettings.pwd) == 0) {
         
         return false;
     }
@@ -115,96 +241,319 @@ bool Settings::isNetworkSet() {
     return true;
 }
 
+/**
+ * Used to get the number of times the settings were written to 
+ * flash since boot. Saves that changed nothing aren't counted.
+ * 
+ * @return Returns the number of writes as unsigned long.
+*/
+unsigned long Settings::getFlashWriteCount() {
+
+    return storedState.writeCount;
+}
+
+/**
+ * Used to get the sequence number of the stored settings, which is
+ * the number of times they were saved over the life of the device.
+ * 
+ * @return Returns the sequence number or 0 if never saved as uint32_t.
+*/
+uint32_t Settings::getSaveSequence() {
+
+    return storedState.sequence;
+}
+
+/**
+ * Used to set the ID of the device, from which the hostname and the
+ * SSID used when in AP Mode are derived. These are worked out once
+ * here rather than each time they are asked for.
+ * 
+ * @param deviceId The ID of the device as const char*.
+*/
+void Settings::setDeviceId(const char *deviceId) {
+    snprintf(vSettings.hostname, sizeof(vSettings.hostname), "%s%s", constSettings.hostname, deviceId);
+    snprintf(vSettings.apSsid, sizeof(vSettings.apSsid), "%s%s", constSettings.apSsid, deviceId);
+}
+
 /*
 =================================================================
-Getter and Setter Functions
+Settings Schema Functions
 =================================================================
 */
 
-String Settings::getHostname(String deviceId) {
-    String temp = constSettings.hostname;
-    temp.concat(deviceId);
+/**
+ * Used to get the number of fields in the settings schema.
+ * 
+ * @return Returns the number of fields as size_t.
+*/
+size_t Settings::getFieldCount() {
 
-    return temp;
+    return sizeof(SETTING_FIELDS) / sizeof(SETTING_FIELDS[0]);
 }
 
+/**
+ * Used to get a field of the settings schema by its position.
+ * 
+ * @param index The position of the field, less than getFieldCount() as size_t.
+ * 
+ * @return Returns the field as const SettingField&.
+*/
+const SettingField& Settings::getField(size_t index) {
 
-String Settings::getSsid() {
-  
-    return String(nvSettings.ssid);
+    return SETTING_FIELDS[index];
 }
 
-void Settings::setSsid(const char *ssid) {
-    if (sizeof(ssid) <= sizeof(nvSettings.ssid)) {
-        strcpy(nvSettings.ssid, ssid);
+/**
+ * Used to look up a field of the settings schema by its form/JSON name.
+ * 
+ * @param name The name of the field as const char*.
+ * 
+ * @return Returns the field or nullptr if there is no such field as const SettingField*.
+*/
+const SettingField* Settings::findField(const char *name) {
+    for (size_t i = 0; i < getFieldCount(); i++) {
+        if (strcmp(SETTING_FIELDS[i].name, name) == 0) { // Found it...
+
+            return &SETTING_FIELDS[i];
+        }
     }
+
+    return nullptr;
 }
 
+/**
+ * Used to get the stored value of the given field. The value is
+ * not copied, so it's only good until the field is next changed.
+ * Choices are given as "true" or "false".
+ * 
+ * @param field The field to get the value of as const SettingField&.
+ * 
+ * @return Returns the stored value as const char*.
+*/
+const char* Settings::getFieldValue(const SettingField &field) {
+    const char *stored = ((const char *) &nvSettings) + field.offset;
+    if (field.type == SETTING_CHOICE) { // Stored as bool...
 
-String Settings::getPwd() {
+        return (*((const bool *) stored) ? "true" : "false");
+    }
 
-    return String(nvSettings.pwd);
+    return stored;
 }
 
-void Settings::setPwd(const char *pwd) {
-    if (sizeof(pwd) <= sizeof(nvSettings.pwd)) {
-        strcpy(nvSettings.pwd, pwd);
+/**
+ * Used to validate an incoming value for the given field without
+ * changing anything. Text must not be empty unless optional, numbers
+ * must be all digits, IPv4 Addresses may be empty and choices are
+ * matched by either option, or its first letter, ignoring case.
+ * Internal fields are never accepted.
+ * 
+ * @param field The field to check the value of as const SettingField&.
+ * @param value The null terminated incoming value as const char*.
+ * @param length The length of the incoming value as size_t.
+ * 
+ * @return Returns whether the value would change the field, leave it
+ * alone or is rejected as SettingUpdate.
+*/
+SettingUpdate Settings::checkField(const SettingField &field, const char *value, size_t length) {
+    const char *stored = ((const char *) &nvSettings) + field.offset;
+    if (field.type == SETTING_CHOICE) { // Stored as bool...
+        int choice = matchChoice(field.options, value, length);
+        if (choice < 0) { // Not one of the options...
+
+            return SETTING_INVALID;
+        }
+
+        return (*((const bool *) stored) == (choice == 1) ? SETTING_UNCHANGED : SETTING_CHANGED);
+    }
+
+    if (length >= field.size || strlen(value) != length) { // Too long or holds a null...
+
+        return SETTING_INVALID;
     }
+    uint32_t address = 0;
+    if ((field.type == SETTING_TEXT || field.type == SETTING_NUMBER) && length == 0) { // Required...
+
+        return SETTING_INVALID;
+    } else if (field.type == SETTING_NUMBER && strspn(value, "0123456789") != length) { // Not a whole number...
+
+        return SETTING_INVALID;
+    } else if (field.type == SETTING_IPV4 && length > 0 && IpUtils::parseIPv4(value, length, address) != IP_PARSE_OK) { // Not an address...
+
+        return SETTING_INVALID;
+    } else if (field.type == SETTING_INTERNAL) { // Not accepted from outside...
+
+        return SETTING_INVALID;
+    }
+
+    return (strcmp(stored, value) == 0 ? SETTING_UNCHANGED : SETTING_CHANGED);
 }
 
+/**
+ * Used to validate an incoming value for the given field, as
+ * checkField() does, and if it is valid and different copy it in 
+ * place of the stored value.
+ * 
+ * @param field The field to update as const SettingField&.
+ * @param value The null terminated incoming value as const char*.
+ * @param length The length of the incoming value as size_t.
+ * 
+ * @return Returns whether the field was changed, left alone or the
+ * value was rejected as SettingUpdate.
+*/
+SettingUpdate Settings::updateField(const SettingField &field, const char *value, size_t length) {
+    SettingUpdate update = checkField(field, value, length);
+    if (update != SETTING_CHANGED) { // Nothing to copy...
 
-String Settings::getAdminUser() {
+        return update;
+    }
+    char *stored = ((char *) &nvSettings) + field.offset;
+    if (field.type == SETTING_CHOICE) { // Stored as bool...
+        *((bool *) stored) = (matchChoice(field.options, value, length) == 1);
+    } else {
+        strncpy(stored, value, field.size); // Zero fills the rest so equal settings have equal bytes
+    }
 
-    return String(nvSettings.adminUser);
+    return SETTING_CHANGED;
 }
 
-void Settings::setAdminUser(const char *user) {
+/**
+ * Used to check the static addressing as a whole, as it would be once
+ * the incoming values were put in place. A static IP Address needs a
+ * gateway and subnet to go with it, while a blank one means DHCP (see
+ * settleStaticAddressing()). Each value is checked on its own by
+ * checkField().
+ * 
+ * @param ip The incoming static IP Address or nullptr to keep the stored one as const char*.
+ * @param gateway The incoming gateway or nullptr to keep the stored one as const char*.
+ * @param subnet The incoming subnet mask or nullptr to keep the stored one as const char*.
+ * @param missing Receives the fields needed but left blank, up to 2, as const SettingField*[].
+ * 
+ * @return Returns the number of fields needed but left blank as size_t.
+*/
+size_t Settings::checkStaticAddressing(const char *ip, const char *gateway, const char *subnet, const SettingField *missing[]) {
+    size_t count = 0;
+    if (*(ip != nullptr ? ip : nvSettings.staticIp) == '\0') { // DHCP; The rest don't matter...
 
-    if (sizeof(user) <= sizeof(nvSettings.adminUser)) {
-        strcpy(nvSettings.adminUser, user);
+        return count;
     }
+    if (*(gateway != nullptr ? gateway : nvSettings.staticGateway) == '\0') {
+        missing[count++] = findField("staticgateway");
+    }
+    if (*(subnet != nullptr ? subnet : nvSettings.staticSubnet) == '\0') {
+        missing[count++] = findField("staticsubnet");
+    }
+
+    return count;
 }
 
+/**
+ * Used to clear the gateway, subnet and DNS when the static IP Address
+ * is blank, as they mean nothing without it. Meant to be called once
+ * the incoming values have been put in place.
+ * 
+ * @return Returns SETTING_CHANGED if any were cleared otherwise
+ * SETTING_UNCHANGED as SettingUpdate.
+*/
+SettingUpdate Settings::settleStaticAddressing() {
+    if (nvSettings.staticIp[0] != '\0' || (nvSettings.staticGateway[0] == '\0' && nvSettings.staticSubnet[0] == '\0' && nvSettings.staticDns[0] == '\0')) { // In use, or already clear...
 
-String Settings::getAdminPwd() {
+        return SETTING_UNCHANGED;
+    }
+    memset(nvSettings.staticGateway, 0, sizeof(nvSettings.staticGateway));
+    memset(nvSettings.staticSubnet, 0, sizeof(nvSettings.staticSubnet));
+    memset(nvSettings.staticDns, 0, sizeof(nvSettings.staticDns));
 
-    return String(nvSettings.adminPwd);
+    return SETTING_CHANGED;
 }
 
-void Settings::setAdminPwd(const char *pwd) {
-    if (sizeof(pwd) <= sizeof(nvSettings.adminPwd)) {
-        strcpy(nvSettings.adminPwd, pwd);
+/**
+ * Used to take a copy of the current settings, for example to be
+ * able to roll back a change with restoreFields().
+ * 
+ * @param snapshot The structure to copy the settings into as NonVolatileSettings&.
+*/
+void Settings::getSnapshot(struct NonVolatileSettings &snapshot) {
+    memcpy(&snapshot, &nvSettings, sizeof(NonVolatileSettings));
+}
+
+/**
+ * Used to put back the values of the fields having any of the given
+ * flags from a snapshot taken earlier by getSnapshot(). The restored
+ * values are not persisted until saveSettings() is called.
+ * 
+ * @param snapshot The snapshot to restore from as const NonVolatileSettings&.
+ * @param flags The flags of the fields to restore as uint8_t.
+*/
+void Settings::restoreFields(const struct NonVolatileSettings &snapshot, uint8_t flags) {
+    for (size_t i = 0; i < getFieldCount(); i++) {
+        const SettingField &field = SETTING_FIELDS[i];
+        if ((field.flags & flags) != 0) { // One to restore...
+            memcpy(((char *) &nvSettings) + field.offset, ((const char *) &snapshot) + field.offset, field.size);
+        }
     }
 }
 
+/*
+=================================================================
+Getter and Setter Functions
+=================================================================
+*/
+
+const char* Settings::getHostname() {
+
+    return vSettings.hostname;
+}
+
 
-String Settings::getApSsid(String deviceId) {
-    String temp = constSettings.apSsid;
-    temp.concat(deviceId);
-    
-    return temp;
+const char* Settings::getSsid() {
+  
+    return nvSettings.ssid;
+}
+
+
+const char* Settings::getPwd() {
+
+    return nvSettings.pwd;
+}
+
+
+const char* Settings::getAdminUser() {
+
+    return nvSettings.adminUser;
+}
+
+
+const char* Settings::getAdminPwd() {
+
+    return nvSettings.adminPwd;
+}
+
+
+const char* Settings::getApSsid() {
+
+    return vSettings.apSsid;
 }
 
 
-String Settings::getApPwd() {
+const char* Settings::getApPwd() {
 
     return constSettings.apPwd;
 }
 
 
-String Settings::getApNetIp() {
+const char* Settings::getApNetIp() {
 
     return constSettings.apNetIp;
 }
 
 
-String Settings::getApSubnet() {
+const char* Settings::getApSubnet() {
 
     return constSettings.apSubnet;
 }
 
 
-String Settings::getApGateway() {
+const char* Settings::getApGateway() {
 
     return constSettings.apGateway;
 }
@@ -216,37 +565,222 @@ int Settings::getBcastPort() {
 }
 
 
-String Settings::getHeading() {
+const char* Settings::getHeading() {
 
-    return String(nvSettings.heading);
+    return nvSettings.heading;
 }
 
-void Settings::setHeading(const char *heading) {
-    if (sizeof(heading) <= sizeof(nvSettings.heading)) {
-        strcpy(nvSettings.heading, heading);
-    }
+
+const char* Settings::getTitle() {
+
+    return nvSettings.title;
+}
+
+
+bool Settings::getIsCelsius() {
+
+    return nvSettings.isCelsius;
+}
+
+
+const char* Settings::getNtpServer() {
+
+    return nvSettings.ntpServer;
+}
+
+
+const char* Settings::getStaticIp() {
+
+    return nvSettings.staticIp;
+}
+
+
+const char* Settings::getStaticGateway() {
+
+    return nvSettings.staticGateway;
 }
 
 
-String Settings::getTitle() {
+const char* Settings::getStaticSubnet() {
 
-    return String(nvSettings.title);
+    return nvSettings.staticSubnet;
 }
 
-void Settings::setTitle(const char *title) {
-    if (sizeof(title) <= sizeof(nvSettings.title)) {
-        strcpy(nvSettings.title, title);
+
+const char* Settings::getStaticDns() {
+
+    return nvSettings.staticDns;
+}
+
+
+/**
+ * Used to determine if the device is configured to use a static
+ * IP Address rather than DHCP.
+ * 
+ * @return Returns true if a static IP is set otherwise false as bool.
+*/
+bool Settings::isStaticIpSet() {
+
+    return (nvSettings.staticIp[0] != '\0');
+}
+
+/**
+ * Used to remember the details of the last good connection to the
+ * WiFi network, so that the next connection can skip the scan for
+ * the access point. Values which don't fit are stored as empty.
+ * 
+ * @param bssid The MAC Address of the access point as const char*.
+ * @param channel The WiFi channel of the access point as int.
+ * @param ip The IP Address that was leased as const char*.
+ * @param gateway The gateway that was leased as const char*.
+ * @param subnet The subnet mask that was leased as const char*.
+ * @param dns The DNS server that was leased as const char*.
+*/
+void Settings::setLastConnection(const char *bssid, int channel, const char *ip, const char *gateway, const char *subnet, const char *dns) {
+    strncpy(nvSettings.lastBssid, bssid, sizeof(nvSettings.lastBssid) - 1);
+    nvSettings.lastBssid[sizeof(nvSettings.lastBssid) - 1] = '\0';
+    char channelText[sizeof(nvSettings.lastChannel)];
+    snprintf(channelText, sizeof(channelText), "%d", channel);
+    strncpy(nvSettings.lastChannel, channelText, sizeof(nvSettings.lastChannel));
+    strncpy(nvSettings.lastIp, ip, sizeof(nvSettings.lastIp) - 1);
+    nvSettings.lastIp[sizeof(nvSettings.lastIp) - 1] = '\0';
+    strncpy(nvSettings.lastGateway, gateway, sizeof(nvSettings.lastGateway) - 1);
+    nvSettings.lastGateway[sizeof(nvSettings.lastGateway) - 1] = '\0';
+    strncpy(nvSettings.lastSubnet, subnet, sizeof(nvSettings.lastSubnet) - 1);
+    nvSettings.lastSubnet[sizeof(nvSettings.lastSubnet) - 1] = '\0';
+    strncpy(nvSettings.lastDns, dns, sizeof(nvSettings.lastDns) - 1);
+    nvSettings.lastDns[sizeof(nvSettings.lastDns) - 1] = '\0';
+}
+
+
+const char* Settings::getLastBssid() {
+
+    return nvSettings.lastBssid;
+}
+
+
+int Settings::getLastChannel() {
+
+    return atoi(nvSettings.lastChannel);
+}
+
+
+const char* Settings::getLastIp() {
+
+    return nvSettings.lastIp;
+}
+
+
+const char* Settings::getLastGateway() {
+
+    return nvSettings.lastGateway;
+}
+
+
+const char* Settings::getLastSubnet() {
+
+    return nvSettings.lastSubnet;
+}
+
+
+const char* Settings::getLastDns() {
+
+    return nvSettings.lastDns;
+}
+
+/**
+ * Used to tell if an MQTT broker is set, which is what turns on
+ * publishing over MQTT.
+ * 
+ * @return Returns true if a broker is set otherwise false as bool.
+*/
+bool Settings::isMqttSet() {
+
+    return (nvSettings.mqttHost[0] != '\0');
+}
+
+
+const char* Settings::getMqttHost() {
+
+    return nvSettings.mqttHost;
+}
+
+/**
+ * Used to get the port of the MQTT broker. A port out of range
+ * gives the standard MQTT port instead.
+ * 
+ * @return Returns the port as uint16_t.
+*/
+uint16_t Settings::getMqttPort() {
+    long port = atol(nvSettings.mqttPort);
+
+    return ((port > 0 && port <= 65535) ? (uint16_t) port : 1883);
+}
+
+
+const char* Settings::getMqttUser() {
+
+    return nvSettings.mqttUser;
+}
+
+
+const char* Settings::getMqttPwd() {
+
+    return nvSettings.mqttPwd;
+}
+
+
+const char* Settings::getMqttTopic() {
+
+    return nvSettings.mqttTopic;
+}
+
+
+bool Settings::getIsMqttQos1() {
+
+    return nvSettings.isMqttQos1;
+}
+
+
+bool Settings::getIsLightSleep() {
+
+    return nvSettings.isLightSleep;
+}
+
+
+bool Settings::getIsBatteryMode() {
+
+    return nvSettings.isBatteryMode;
+}
+
+/**
+ * Used to get how long to stay in deep sleep between readings while
+ * in battery mode. The time is kept between 10 seconds and the
+ * longest the device can sleep for, about 3 hours.
+ * 
+ * @return Returns the time in seconds as uint32_t.
+*/
+uint32_t Settings::getBatterySleepSecs() {
+    long secs = atol(nvSettings.batterySleepSecs);
+    if (secs < 10l) { // Too short to be worth the wake up...
+        secs = 10l;
+    } else if (secs > 10800l) { // Beyond what the sleep timer allows...
+        secs = 10800l;
     }
+
+    return (uint32_t) secs;
 }
 
 
-bool Settings::getIsCelsius() {
+bool Settings::getIsBroadcastOn() {
 
-    return ((String(nvSettings.isCelsius).equalsIgnoreCase("true")) ? true : false);
+    return nvSettings.isBroadcastOn;
 }
 
-void Settings::setIsCelsius(bool isCelsius) {
-    strcpy(nvSettings.isCelsius, (isCelsius ? "true" : "false"));
+
+bool Settings::getIsHubMode() {
+
+    return nvSettings.isHubMode;
 }
 
 /*
@@ -263,14 +797,253 @@ Private Functions
 */
 void Settings::defaultSettings() {
     // Default the settings..
-    strcpy(nvSettings.ssid, factorySettings.ssid);
-    strcpy(nvSettings.pwd, factorySettings.pwd);
-    strcpy(nvSettings.adminUser, factorySettings.adminUser);
-    strcpy(nvSettings.adminPwd, factorySettings.adminPwd);
-    strcpy(nvSettings.title, factorySettings.title);
-    strcpy(nvSettings.heading, factorySettings.heading);
-    strcpy(nvSettings.isCelsius, factorySettings.isCelsius);
-    strcpy(nvSettings.sentinel, Utils::hashNvSettings(factorySettings).c_str());
+    memcpy(&nvSettings, &factorySettings, sizeof(NonVolatileSettings));
 
     // Note: Volatile settings would be setup here if needed.
-}
\ No newline at end of file
+}
+
+/**
+ * #### PRIVATE ####
+ * Used to match an incoming value against the options of a choice 
+ * field. Either the whole option or just its first letter will do,
+ * ignoring case.
+ * 
+ * @param options The options as "TrueOption|FalseOption" as const char*.
+ * @param value The incoming value as const char*.
+ * @param length The length of the incoming value as size_t.
+ * 
+ * @return Returns 1 for the true option, 0 for the false option or -1 if
+ * no option matched as int.
+*/
+int Settings::matchChoice(const char *options, const char *value, size_t length) {
+    const char *falseOption = strchr(options, '|') + 1;
+    size_t trueLength = falseOption - options - 1;
+
+    if (
+        (length == trueLength && strncasecmp(options, value, length) == 0)
+        || (length == 1 && tolower(value[0]) == tolower(options[0]))
+    ) { // The true option...
+
+        return 1;
+    }
+    if (
+        (length == strlen(falseOption) && strncasecmp(falseOption, value, length) == 0)
+        || (length == 1 && tolower(value[0]) == tolower(falseOption[0]))
+    ) { // The false option...
+
+        return 0;
+    }
+
+    return -1;
+}
+
+/**
+ * #### PRIVATE ####
+ * Used to get the address in flash of a settings slot. The slots are
+ * the last two sectors of the filesystem area, which this firmware
+ * doesn't use, so each can be erased without touching the other.
+ * 
+ * @param slot The slot from zero as uint8_t.
+ * 
+ * @return Returns the address of the start of the slot as uint32_t.
+*/
+uint32_t Settings::getSlotAddress(uint8_t slot) {
+
+    return FS_PHYS_ADDR + FS_PHYS_SIZE - ((uint32_t) (SETTINGS_SLOT_COUNT - slot) * FLASH_SECTOR_SIZE);
+}
+
+/**
+ * #### PRIVATE ####
+ * Used to find the slot holding the newest save from its header alone,
+ * whether or not the settings behind it are intact, so the next save is
+ * numbered after everything stored and goes into the other slot.
+*/
+void Settings::findNewestSlot() {
+    struct SettingsHeader header;
+    bool isFound = false;
+    for (uint8_t slot = 0; isSlotSpace() && slot < SETTINGS_SLOT_COUNT; slot++) {
+        if (
+            readFlash(getSlotAddress(slot), &header, sizeof(SettingsHeader))
+            && header.magic == SETTINGS_MAGIC
+            && (!isFound || (int32_t) (header.sequence - storedState.sequence) > 0)
+        ) { // Written and newer than any found so far...
+            storedState.sequence = header.sequence;
+            storedState.slot = slot;
+            isFound = true;
+        }
+    }
+}
+
+/**
+ * #### PRIVATE ####
+ * Used to check the flash layout has a filesystem area big enough to
+ * hold the slots, as the 4MB layouts with a filesystem do.
+ * 
+ * @return Returns true if the slots fit otherwise false as bool.
+*/
+bool Settings::isSlotSpace() {
+
+    return (FS_PHYS_SIZE >= (uint32_t) SETTINGS_SLOT_COUNT * FLASH_SECTOR_SIZE);
+}
+
+/**
+ * #### PRIVATE ####
+ * Used to check a stored header describes settings this firmware can
+ * load, either of the current version or of an older one which is the
+ * front of the current settings. The CRC is left for the caller.
+ * 
+ * @param header The stored header as const SettingsHeader&.
+ * 
+ * @return Returns the length of the settings to load, or 0 if they
+ * can't be loaded as uint16_t.
+*/
+uint16_t Settings::getStoredLength(const struct SettingsHeader &header) {
+    if (header.magic != SETTINGS_MAGIC) { // Not settings...
+
+        return 0;
+    }
+    if (header.version == SETTINGS_VERSION && header.length == sizeof(NonVolatileSettings)) { // Current...
+
+        return header.length;
+    }
+    if (header.version >= 2 && header.version < SETTINGS_VERSION && header.length < sizeof(NonVolatileSettings)) { // Older; Members are only ever added at the end...
+
+        return header.length;
+    }
+
+    return 0;
+}
+
+/**
+ * #### PRIVATE ####
+ * Used to read from flash into a structure of any alignment and size,
+ * since the flash is only read in whole, aligned words.
+ * 
+ * @param address The address in flash to read from as uint32_t.
+ * @param data Receives what was read as void*.
+ * @param size The number of bytes to read as size_t.
+ * 
+ * @return Returns true if read otherwise false as bool.
+*/
+bool Settings::readFlash(uint32_t address, void *data, size_t size) {
+    uint32_t words[8];
+    for (size_t at = 0; at < size; at += sizeof(words)) {
+        size_t length = (size - at < sizeof(words) ? size - at : sizeof(words));
+        if (!ESP.flashRead(address + at, words, (length + 3) & ~3u)) {
+
+            return false;
+        }
+        memcpy(((uint8_t *) data) + at, words, length);
+    }
+
+    return true;
+}
+
+/**
+ * #### PRIVATE ####
+ * Used to write a structure of any alignment and size to erased flash,
+ * since the flash is only written in whole, aligned words. A part word
+ * at the end is filled out with erased bytes.
+ * 
+ * @param address The address in flash to write at as uint32_t.
+ * @param data What to write as const void*.
+ * @param size The number of bytes to write as size_t.
+ * 
+ * @return Returns true if written otherwise false as bool.
+*/
+bool Settings::writeFlash(uint32_t address, const void *data, size_t size) {
+    uint32_t words[8];
+    for (size_t at = 0; at < size; at += sizeof(words)) {
+        size_t length = (size - at < sizeof(words) ? size - at : sizeof(words));
+        memset(words, 0xFF, sizeof(words));
+        memcpy(words, ((const uint8_t *) data) + at, length);
+        if (!ESP.flashWrite(address + at, words, (length + 3) & ~3u)) {
+
+            return false;
+        }
+    }
+
+    return true;
+}
+
+/**
+ * #### PRIVATE ####
+ * Used to look for settings stored by firmware from before the settings
+ * header was introduced, which were checked by a MD5 hash of their text 
+ * held in a sentinel field. Valid settings found are migrated into the 
+ * current settings but not persisted.
+ * 
+ * @return Returns true if valid older settings were found and migrated
+ * otherwise false as bool.
+*/
+bool Settings::loadLegacySettings() {
+    bool ok = false;
+    struct LegacySettingsV1 legacy;
+    EEPROM.begin(sizeof(LegacySettingsV1));
+    delay(15);
+
+    if (EEPROM.percentUsed() >= 0) { // Something stored in that size...
+        EEPROM.get(0, legacy);
+        legacy.sentinel[sizeof(legacy.sentinel) - 1] = '\0';
+
+        // The hash covers the text of every field but the sentinel...
+        const char *fields[] = {
+            legacy.ssid, legacy.pwd, legacy.adminUser, legacy.adminPwd, 
+            legacy.title, legacy.heading, legacy.isCelsius
+        };
+        const size_t sizes[] = {
+            sizeof(legacy.ssid), sizeof(legacy.pwd), sizeof(legacy.adminUser), sizeof(legacy.adminPwd), 
+            sizeof(legacy.title), sizeof(legacy.heading), sizeof(legacy.isCelsius)
+        };
+        MD5Builder builder = MD5Builder();
+        builder.begin();
+        for (size_t i = 0; i < (sizeof(sizes) / sizeof(sizes[0])); i++) {
+            builder.add((const uint8_t *) fields[i], strnlen(fields[i], sizes[i]));
+        }
+        builder.calculate();
+        if (builder.toString().equals(legacy.sentinel)) { // Intact...
+            migrateFromV1(legacy);
+            ok = true;
+        }
+    }
+    EEPROM.end();
+
+    return ok;
+}
+
+/**
+ * #### PRIVATE ####
+ * Migrates version 1 settings into the current settings. Anything that
+ * version didn't have keeps its factory default value.
+ * 
+ * @param legacy The version 1 settings as const LegacySettingsV1&.
+*/
+void Settings::migrateFromV1(const struct LegacySettingsV1 &legacy) {
+    defaultSettings();
+    copyText(nvSettings.ssid, sizeof(nvSettings.ssid), legacy.ssid, sizeof(legacy.ssid));
+    copyText(nvSettings.pwd, sizeof(nvSettings.pwd), legacy.pwd, sizeof(legacy.pwd));
+    copyText(nvSettings.adminUser, sizeof(nvSettings.adminUser), legacy.adminUser, sizeof(legacy.adminUser));
+    copyText(nvSettings.adminPwd, sizeof(nvSettings.adminPwd), legacy.adminPwd, sizeof(legacy.adminPwd));
+    copyText(nvSettings.title, sizeof(nvSettings.title), legacy.title, sizeof(legacy.title));
+    copyText(nvSettings.heading, sizeof(nvSettings.heading), legacy.heading, sizeof(legacy.heading));
+    nvSettings.isCelsius = (strncasecmp(legacy.isCelsius, "true", sizeof(legacy.isCelsius)) == 0);
+}
+
+/**
+ * #### PRIVATE ####
+ * Used to copy text which may not be null terminated, such as a field
+ * read from flash, into a field of the settings. The copy is cut short
+ * if need be so it is always null terminated, and the rest of the field
+ * is zero filled so equal settings have equal bytes.
+ * 
+ * @param to The field to copy into as char*.
+ * @param toSize The size of the field to copy into as size_t.
+ * @param from The text to copy as const char*.
+ * @param fromSize The most that may be read of the text as size_t.
+*/
+void Settings::copyText(char *to, size_t toSize, const char *from, size_t fromSize) {
+    size_t length = strnlen(from, fromSize);
+    length = (length < toSize ? length : toSize - 1);
+    memcpy(to, from, length);
+    memset(to + length, 0, toSize - length);
+}
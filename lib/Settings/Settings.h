@@ -15,11 +15,33 @@
 
     #include <string.h> // NEEDED by ESP_EEPROM and MUST appear before WString
     #include <ESP_EEPROM.h>
+    #include <Arduino.h>
+    #include <flash_hal.h>
     #include <WString.h>
     #include <core_esp8266_features.h>
+    #include <stddef.h>
     #include <MD5Builder.h>
+    #include <IpUtils.h>
+    #include <coredecls.h>
     #include <Utils.h>
 
+    #define SETTINGS_MAGIC           0x54425354ul // "TBST"
+    #define SETTINGS_VERSION         7 // Bump whenever NonVolatileSettings changes; New members only ever go at the end
+    #define SETTINGS_SLOT_SIZE       640 // Fixed so the settings may grow without resizing storage
+    #define SETTINGS_SLOT_COUNT      2 // Saves alternate between the slots, each a flash sector of its own
+    #define SETTINGS_EEPROM_SIZE     640 // As stored through the EEPROM library by versions 2 to 7
+
+    // *****************************************************************************
+    // Structure stored in flash just ahead of the settings, describing them
+    // *****************************************************************************
+    struct SettingsHeader {
+        uint32_t       magic                  ;
+        uint16_t       version                ;
+        uint16_t       length                 ; // Of the settings that follow
+        uint32_t       crc                    ; // CRC32 of the settings that follow
+        uint32_t       sequence               ; // Count of saves over the life of the device
+    };
+
     // *****************************************************************************
     // Structure used for storing of settings related data and persisted into flash
     // *****************************************************************************
@@ -30,10 +52,83 @@
         char           adminPwd         [13]  ;
         char           title            [51]  ;
         char           heading          [51]  ;
+        bool           isCelsius              ;
+        char           ntpServer        [65]  ;
+        char           staticIp         [16]  ; // Empty for DHCP
+        char           staticGateway    [16]  ;
+        char           staticSubnet     [16]  ;
+        char           staticDns        [16]  ;
+        char           lastBssid        [18]  ; // Last good connection; Empty if none
+        char           lastChannel      [4]   ;
+        char           lastIp           [16]  ;
+        char           lastGateway      [16]  ;
+        char           lastSubnet       [16]  ;
+        char           lastDns          [16]  ;
+        char           mqttHost         [41]  ; // Empty to not use MQTT; Added in version 3
+        char           mqttPort         [6]   ;
+        char           mqttUser         [25]  ; // Empty for no login
+        char           mqttPwd          [25]  ;
+        char           mqttTopic        [41]  ; // Prefix of every topic
+        bool           isMqttQos1             ; // Readings sent at least once, otherwise at most once
+        bool           isLightSleep           ; // Idle in light sleep, otherwise modem sleep; Added in version 4
+        bool           isBatteryMode          ; // Deep sleep between readings; Added in version 5
+        char           batterySleepSecs [6]   ; // Time in deep sleep between readings
+        bool           isBroadcastOn          ; // Periodic UDP broadcast of readings; Added in version 6
+        bool           isHubMode              ; // Collect the broadcasts of other units; Added in version 7
+    };
+
+    // *****************************************************************************
+    // Settings as stored by firmware before the header; Version 1, kept for migration
+    // *****************************************************************************
+    struct LegacySettingsV1 {
+        char           ssid             [33]  ;
+        char           pwd              [64]  ;
+        char           adminUser        [13]  ;
+        char           adminPwd         [13]  ;
+        char           title            [51]  ;
+        char           heading          [51]  ;
         char           isCelsius        [6]   ;
         char           sentinel         [33]  ; // Holds a 32 MD5 hash + 1
     };
 
+    // *****************************************************************************
+    // Describes a single persisted setting so that it can be handled generically
+    // *****************************************************************************
+    enum SettingType : uint8_t {
+        SETTING_TEXT, // <------------- Free text; Must not be empty
+        SETTING_OPTIONAL_TEXT, // <---- Free text; Empty allowed
+        SETTING_NUMBER, // <----------- Whole number as text; Must not be empty
+        SETTING_IPV4, // <------------- Dotted IPv4 Address; Empty allowed
+        SETTING_CHOICE, // <----------- Stored as bool; options are "TrueOption|FalseOption"
+        SETTING_INTERNAL // <---------- Maintained by the device; Not on the admin page
+    };
+
+    enum SettingUpdate : uint8_t {
+        SETTING_UNCHANGED,
+        SETTING_CHANGED,
+        SETTING_INVALID
+    };
+
+    // Side effects of changing a setting, used as SettingField flags...
+    #define SETTING_NETWORK       0x01 // Used to join the network; Rolled back if the change fails
+    #define SETTING_NEW_NETWORK   0x02 // Remembered access point no longer applies
+    #define SETTING_LOGIN         0x04 // Admin sessions must be revoked
+    #define SETTING_TIME_SOURCE   0x08 // Clock must be resynced
+    #define SETTING_MQTT          0x10 // MQTT client must reconnect
+    #define SETTING_POWER         0x20 // Sleep mode must be applied
+    #define SETTING_HUB           0x40 // Hub listener must be started or stopped
+
+    struct SettingField {
+        const char    *name             ; // Form and JSON key
+        const char    *label            ;
+        const char    *group            ; // Admin page section
+        uint16_t       offset           ; // Into NonVolatileSettings
+        uint8_t        size             ; // Including the null for text
+        SettingType    type             ;
+        uint8_t        flags            ;
+        const char    *options          ; // SETTING_CHOICE only
+    };
+
     class Settings {
         private:
             struct NonVolatileSettings nvSettings;
@@ -44,32 +139,58 @@
                 "admin", // <---------------- adminPwd
                 "TempBuddy Sensor", // <----- title
                 "Temp Info", // <------------ heading
-                "false", // <---------------- isCelsius
-                "NA" // <-------------------- sentinel
+                false, // <------------------ isCelsius
+                "pool.ntp.org", // <--------- ntpServer
+                "", // <--------------------- staticIp
+                "", // <--------------------- staticGateway
+                "", // <--------------------- staticSubnet
+                "", // <--------------------- staticDns
+                "", // <--------------------- lastBssid
+                "", // <--------------------- lastChannel
+                "", // <--------------------- lastIp
+                "", // <--------------------- lastGateway
+                "", // <--------------------- lastSubnet
+                "", // <--------------------- lastDns
+                "", // <--------------------- mqttHost
+                "1883", // <----------------- mqttPort
+                "", // <--------------------- mqttUser
+                "", // <--------------------- mqttPwd
+                "tempbuddy", // <------------ mqttTopic
+                true, // <------------------- isMqttQos1
+                false, // <------------------ isLightSleep
+                false, // <------------------ isBatteryMode
+                "300", // <------------------ batterySleepSecs
+                true, // <------------------- isBroadcastOn
+                false // <------------------- isHubMode
             };
 
             // ******************************************************************
             // Structure used for storing of settings related data NOT persisted
             // ******************************************************************
 
-            /*
-                PLEASE NOTE: Just below is an example of what I would use if there
-                were also some settings which were not constant but also not persisted
-                to storage. I left this block here as a reminder incase I want to use 
-                it later.
-            */
+            struct VolatileSettings {
+                char           hostname         [24]  ; // Derived from the device ID, so cached
+                char           apSsid           [33]  ;
+            } vSettings;
 
-            // struct VolatileSettings {
-            //     bool           unused            ;
-            // } vSettings;
+            // ******************************************************************
+            // What is known of the copy of the settings stored in flash
+            // ******************************************************************
+            struct StoredState {
+                bool           isKnown           ; // Stored copy was loaded or saved this boot
+                uint32_t       crc               ;
+                uint32_t       sequence          ;
+                uint8_t        slot              ; // Holding the last copy saved; The other is written next
+                unsigned long  writeCount        ; // Flash commits since boot
+            } storedState = {false, 0ul, 0ul, SETTINGS_SLOT_COUNT - 1, 0ul};
 
             struct ConstantSettings {
-                String         hostname          ;
-                String         apSsid            ;
-                String         apPwd             ;
-                String         apNetIp           ;
-                String         apSubnet          ;
-                String         apGateway         ;
+                const char    *hostname          ;
+                const char    *apSsid            ;
+                const char    *apPwd             ;
+                const char    *apNetIp           ;
+                const char    *apSubnet          ;
+                const char    *apGateway         ;
                 int            bcastPort         ;
             } constSettings = {
                 "TempBuddy", // <----------- hostname (*later ID is added)
@@ -82,6 +203,16 @@
             };
             
             void defaultSettings();
+            bool loadLegacySettings();
+            void migrateFromV1(const struct LegacySettingsV1& legacy);
+            static void copyText(char* to, size_t toSize, const char* from, size_t fromSize);
+            void findNewestSlot();
+            static bool isSlotSpace();
+            static uint32_t getSlotAddress(uint8_t slot);
+            static uint16_t getStoredLength(const struct SettingsHeader& header);
+            static bool readFlash(uint32_t address, void* data, size_t size);
+            static bool writeFlash(uint32_t address, const void* data, size_t size);
+            int matchChoice(const char* options, const char* value, size_t length);
 
 
         public:
@@ -92,34 +223,75 @@
             bool saveSettings();
             bool isFactoryDefault();
             bool isNetworkSet();
+            unsigned long getFlashWriteCount();
+            uint32_t getSaveSequence();
+            void setDeviceId(const char* deviceId);
+
+            /*
+            =========================================================
+                                  Settings Schema 
+            =========================================================
+            */
+            static size_t               getFieldCount  ()                       ;
+            static const SettingField&  getField       (size_t index)          ;
+            static const SettingField*  findField      (const char* name)      ;
+            const char*                 getFieldValue  (const SettingField& field);
+            SettingUpdate               checkField     (const SettingField& field, const char* value, size_t length);
+            SettingUpdate               updateField    (const SettingField& field, const char* value, size_t length);
+            size_t                      checkStaticAddressing(const char* ip, const char* gateway, const char* subnet, const SettingField* missing[]);
+            SettingUpdate               settleStaticAddressing();
+            void                        getSnapshot    (struct NonVolatileSettings& snapshot);
+            void                        restoreFields  (const struct NonVolatileSettings& snapshot, uint8_t flags);
 
             /*
             =========================================================
                                 Getters and Setters 
             =========================================================
+                Text is returned in place, without a copy, so it's
+                only good until the setting is next changed.
             */
-            void           setSsid           (const char* ssid)       ;
-            String         getSsid           ()                       ;
-            void           setPwd            (const char* pwd)        ;
-            String         getPwd            ()                       ;
-            void           setAdminUser      (const char* user)       ;
-            String         getAdminUser      ()                       ;
-            void           setAdminPwd       (const char* pwd)        ;
-            String         getAdminPwd       ()                       ;     
-
-            void           setTitle          (const char* title)      ;
-            String         getTitle          ()                       ;
-            void           setHeading        (const char* heading)    ;
-            String         getHeading        ()                       ;
-            void           setIsCelsius      (bool isCelsius)         ;
+            const char*    getSsid           ()                       ;
+            const char*    getPwd            ()                       ;
+            const char*    getAdminUser      ()                       ;
+            const char*    getAdminPwd       ()                       ;     
+
+            const char*    getTitle          ()                       ;
+            const char*    getHeading        ()                       ;
             bool           getIsCelsius      ()                       ;
+            const char*    getNtpServer      ()                       ;
+            const char*    getStaticIp       ()                       ;
+            const char*    getStaticGateway  ()                       ;
+            const char*    getStaticSubnet   ()                       ;
+            const char*    getStaticDns      ()                       ;
+            bool           isStaticIpSet     ()                       ;
+            
+            void           setLastConnection (const char* bssid, int channel, const char* ip, const char* gateway, const char* subnet, const char* dns);
+            const char*    getLastBssid      ()                       ;
+            int            getLastChannel    ()                       ;
+            const char*    getLastIp         ()                       ;
+            const char*    getLastGateway    ()                       ;
+            const char*    getLastSubnet     ()                       ;
+            const char*    getLastDns        ()                       ;
+
+            bool           isMqttSet         ()                       ;
+            const char*    getMqttHost       ()                       ;
+            uint16_t       getMqttPort       ()                       ;
+            const char*    getMqttUser       ()                       ;
+            const char*    getMqttPwd        ()                       ;
+            const char*    getMqttTopic      ()                       ;
+            bool           getIsMqttQos1     ()                       ;
+            bool           getIsLightSleep   ()                       ;
+            bool           getIsBatteryMode  ()                       ;
+            uint32_t       getBatterySleepSecs()                      ;
+            bool           getIsBroadcastOn  ()                       ;
+            bool           getIsHubMode      ()                       ;
             
-            String         getHostname       (String deviceId)        ;
-            String         getApSsid         (String deviceId)        ;
-            String         getApPwd          ()                       ;
-            String         getApNetIp        ()                       ;
-            String         getApSubnet       ()                       ;    
-            String         getApGateway      ()                       ;
+            const char*    getHostname       ()                       ;
+            const char*    getApSsid         ()                       ;
+            const char*    getApPwd          ()                       ;
+            const char*    getApNetIp        ()                       ;
+            const char*    getApSubnet       ()                       ;    
+            const char*    getApGateway      ()                       ;
             int            getBcastPort      ()                       ;
     };
     
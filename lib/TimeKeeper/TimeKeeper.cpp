@@ -0,0 +1,156 @@
+/*
+    TimeKeeper - A class used to keep track of the wall clock time so that
+    readings can be stamped with the time they were taken. The time is set
+    via SNTP and kept as a 64-bit count of microseconds since the Unix epoch.
+
+    Written by: Scott Griffis
+    Date: 10-19-2026
+*/
+
+#include "TimeKeeper.h"
+
+#include <Arduino.h>
+#include <coredecls.h>
+#include <sys/time.h>
+
+/**
+ * #### CLASS CONSTRUCTOR ####
+ * Allows for external instantiation of
+ * the class into an object.
+*/
+TimeKeeper::TimeKeeper() {
+    server[0] = '\0';
+}
+
+/**
+ * Starts or restarts the syncing of the clock with the given 
+ * NTP server. Time is kept in UTC.
+ * 
+ * @param ntpServer The host name or IP Address of the NTP server as const char*.
+*/
+void TimeKeeper::begin(const char *ntpServer) {
+    // SNTP keeps a pointer to the name so it must outlive this call...
+    strncpy(server, ntpServer, TIME_KEEPER_MAX_SERVER_LEN);
+    server[TIME_KEEPER_MAX_SERVER_LEN] = '\0';
+
+    settimeofday_cb([this]() { handleTimeSet(); });
+    configTime(0, 0, server);
+}
+
+/**
+ * Starts the clock from an estimate of the time, such as one carried
+ * across a deep sleep, so readings taken before the first sync aren't
+ * left without a time. The first sync replaces the estimate, and the 
+ * estimate is ignored if the clock is already synced.
+ * 
+ * @param epochMillis The estimated time in millis since the Unix epoch as uint64_t.
+*/
+void TimeKeeper::resume(uint64_t epochMillis) {
+    if (synced || epochMillis == 0ull) { // Have better or nothing...
+
+        return;
+    }
+    anchorLocalMicros = micros64();
+    anchorEpochMicros = epochMillis * 1000ull;
+    isEstimated = true;
+}
+
+/**
+ * Used to determine if the clock has been set from
+ * the NTP server at least once.
+ * 
+ * @return Returns true if synced otherwise false as bool.
+*/
+bool TimeKeeper::isSynced() {
+
+    return synced;
+}
+
+unsigned long TimeKeeper::getSyncCount() {
+
+    return syncCount;
+}
+
+long TimeKeeper::getDriftPpm() {
+
+    return driftPpm;
+}
+
+/**
+ * Gets the current time as the number of microseconds since the
+ * Unix epoch. The value never decreases between calls.
+ * 
+ * @return Returns the time or zero if not yet synced or estimated as uint64_t.
+*/
+uint64_t TimeKeeper::getEpochMicros() {
+    if (!synced && !isEstimated) { // Time not known...
+
+        return 0ull;
+    }
+    uint64_t elapsed = micros64() - anchorLocalMicros;
+    int64_t correction = ((int64_t) elapsed * driftPpm) / 1000000ll;
+    uint64_t now = anchorEpochMicros + elapsed + correction;
+    if (now < lastEpochMicros) { // Would run backwards; Hold still...
+        now = lastEpochMicros;
+    }
+    lastEpochMicros = now;
+
+    return now;
+}
+
+/**
+ * Gets the current time as the number of milliseconds since the
+ * Unix epoch. The value never decreases between calls.
+ * 
+ * @return Returns the time or zero if not yet synced as uint64_t.
+*/
+uint64_t TimeKeeper::getEpochMillis() {
+
+    return (getEpochMicros() / 1000ull);
+}
+
+/**
+ * Gets the time since the device booted without the
+ * rollover of the 32-bit millis() counter.
+ * 
+ * @return Returns the uptime in milliseconds as uint64_t.
+*/
+uint64_t TimeKeeper::getUptimeMillis() {
+
+    return (micros64() / 1000ull);
+}
+
+/*
+=================================================================
+Private Functions
+=================================================================
+*/
+
+/**
+ * #### PRIVATE ####
+ * Called whenever SNTP sets the system time. Re-anchors the clock
+ * to the new time and, if there was a prior sync long enough ago, 
+ * measures how far the local counter drifted since then.
+*/
+void TimeKeeper::handleTimeSet() {
+    struct timeval tv;
+    gettimeofday(&tv, nullptr);
+    uint64_t syncEpochMicros = ((uint64_t) tv.tv_sec * 1000000ull) + (uint64_t) tv.tv_usec;
+    uint64_t localMicros = micros64();
+
+    if (synced) { // Can measure drift since last sync...
+        uint64_t localSpan = localMicros - anchorLocalMicros;
+        if (localSpan >= TIME_KEEPER_MIN_DRIFT_SPAN_MICROS) { // Long enough to be meaningful...
+            int64_t error = (int64_t) (syncEpochMicros - anchorEpochMicros) - (int64_t) localSpan;
+            long measured = (long) ((error * 1000000ll) / (int64_t) localSpan);
+            measured = constrain(measured, -TIME_KEEPER_MAX_DRIFT_PPM, TIME_KEEPER_MAX_DRIFT_PPM);
+            driftPpm = (driftPpm == 0l) ? measured : ((driftPpm + measured) / 2l); // Smooth out jitter
+        }
+    }
+
+    anchorLocalMicros = localMicros;
+    anchorEpochMicros = syncEpochMicros;
+    synced = true;
+    isEstimated = false;
+    syncCount++;
+}
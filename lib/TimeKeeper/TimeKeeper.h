@@ -0,0 +1,52 @@
+/*
+    TimeKeeper - A class used to keep track of the wall clock time so that
+    readings can be stamped with the time they were taken. The time is set
+    via SNTP and kept as a 64-bit count of microseconds since the Unix epoch
+    which is anchored to the 64-bit microsecond counter of the device. This
+    avoids the 49 day rollover of the 32-bit millis() counter.
+
+    Between syncs the clock is corrected for the drift of the device's crystal
+    as measured across prior syncs. The clock never runs backwards; if a sync
+    finds it ahead of the true time, it holds still until the true time has
+    caught up.
+
+    Written by: Scott Griffis
+    Date: 10-19-2026
+*/
+
+#ifndef TimeKeeper_h
+    #define TimeKeeper_h
+
+    #include <stdint.h>
+
+    #define TIME_KEEPER_MAX_SERVER_LEN 64
+    #define TIME_KEEPER_MAX_DRIFT_PPM 500l // Anything beyond is not a crystal's doing
+    #define TIME_KEEPER_MIN_DRIFT_SPAN_MICROS 60000000ull // Min time between syncs to measure drift
+
+    class TimeKeeper {
+        private:
+            char           server           [TIME_KEEPER_MAX_SERVER_LEN + 1];
+            bool           synced           = false;
+            bool           isEstimated      = false; // Running from an estimate until synced
+            unsigned long  syncCount        = 0ul;
+            long           driftPpm         = 0l;
+            uint64_t       anchorLocalMicros = 0ull;
+            uint64_t       anchorEpochMicros = 0ull;
+            uint64_t       lastEpochMicros  = 0ull;
+
+            void           handleTimeSet     ()                       ;
+
+        public:
+            TimeKeeper();
+
+            void           begin             (const char *ntpServer)  ;
+            void           resume            (uint64_t epochMillis)   ;
+            bool           isSynced          ()                       ;
+            unsigned long  getSyncCount      ()                       ;
+            long           getDriftPpm       ()                       ;
+            uint64_t       getEpochMicros    ()                       ;
+            uint64_t       getEpochMillis    ()                       ;
+            uint64_t       getUptimeMillis   ()                       ;
+    };
+
+#endif
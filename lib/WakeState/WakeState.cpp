@@ -0,0 +1,324 @@
+/*
+    WakeState - A class used to carry what the device needs to know from one
+    wake to the next while in battery mode.
+
+    Written by: Scott Griffis
+    Date: 10-19-2026
+*/
+
+#include "WakeState.h"
+#include <string.h>
+#include <PowerManager.h>
+
+static_assert(sizeof(WakeRecord) <= (512 - (WAKE_RTC_BLOCK * 4)), "Wake state outgrew the RTC user memory");
+static_assert((sizeof(WakeRecord) % 4) == 0, "RTC memory is read and written in 4 byte blocks");
+
+/**
+ * #### CLASS CONSTRUCTOR ####
+ * Allows for external instantiation of
+ * the class into an object.
+*/
+WakeState::WakeState() {
+    reset();
+}
+
+/**
+ * Used to get the bytes of the record so the caller can read them
+ * from, or write them to, the RTC memory.
+ *
+ * @return Returns the start of the record as uint8_t*.
+*/
+uint8_t* WakeState::getData() {
+
+    return (uint8_t *) &record;
+}
+
+size_t WakeState::getSize() {
+
+    return sizeof(WakeRecord);
+}
+
+/**
+ * Used to check the record just read into getData(). Anything other
+ * than a valid record is replaced by a fresh state. It's read on every
+ * boot, so a wake from deep sleep is counted by noteWake() instead.
+ *
+ * @return Returns true if a valid record was found otherwise false as bool.
+*/
+bool WakeState::load() {
+    if (
+        record.magic != WAKE_STATE_MAGIC
+        || record.crc != calcCrc()
+        || record.historyCount > WAKE_HISTORY_SIZE
+        || record.historyHead >= WAKE_HISTORY_SIZE
+    ) { // Not ours or corrupt...
+        reset();
+        isResumed = false;
+
+        return false;
+    }
+    if (record.unsentCount > record.historyCount) { // Can't be more than held...
+        record.unsentCount = record.historyCount;
+    }
+    isResumed = true;
+
+    return true;
+}
+
+/**
+ * Used to count a wake from deep sleep.
+*/
+void WakeState::noteWake() {
+    record.wakeCount++;
+}
+
+/**
+ * Used to stamp the record with its CRC, which must be done just
+ * before it is written to the RTC memory.
+*/
+void WakeState::seal() {
+    record.magic = WAKE_STATE_MAGIC;
+    record.crc = calcCrc();
+}
+
+/**
+ * Used to start the state afresh, forgetting everything held.
+*/
+void WakeState::reset() {
+    memset(&record, 0, sizeof(WakeRecord));
+    record.magic = WAKE_STATE_MAGIC;
+}
+
+/**
+ * Used to tell if the state was carried over from a prior wake
+ * rather than started afresh.
+ *
+ * @return Returns true if carried over otherwise false as bool.
+*/
+bool WakeState::getIsResumed() {
+
+    return isResumed;
+}
+
+/**
+ * Adds a reading to the history as not yet delivered. When the history
+ * is full the oldest reading makes room, even if it was never delivered.
+ *
+ * @param reading The reading to add as const QueuedReading&.
+*/
+void WakeState::addReading(const QueuedReading& reading) {
+    uint8_t tail = (record.historyHead + record.historyCount) % WAKE_HISTORY_SIZE;
+    record.history[tail] = reading;
+    if (record.historyCount < WAKE_HISTORY_SIZE) { // Room left...
+        record.historyCount++;
+    } else { // Full; Oldest goes...
+        record.historyHead = (record.historyHead + 1) % WAKE_HISTORY_SIZE;
+    }
+    if (record.unsentCount < record.historyCount) { // One more to deliver...
+        record.unsentCount++;
+    }
+}
+
+uint8_t WakeState::getHistoryCount() {
+
+    return record.historyCount;
+}
+
+/**
+ * Used to get a reading from the history, oldest first.
+ *
+ * @param index The position in the history, 0 being the oldest, as uint8_t.
+ *
+ * @return Returns the reading as const QueuedReading&.
+*/
+const QueuedReading& WakeState::getReading(uint8_t index) {
+
+    return record.history[(record.historyHead + index) % WAKE_HISTORY_SIZE];
+}
+
+/**
+ * Used to get how many of the newest readings in the history are yet
+ * to be delivered, which are the last that many returned by getReading().
+ *
+ * @return Returns the count as uint8_t.
+*/
+uint8_t WakeState::getUnsentCount() {
+
+    return record.unsentCount;
+}
+
+void WakeState::setUnsentCount(uint8_t count) {
+    record.unsentCount = (count > record.historyCount ? record.historyCount : count);
+}
+
+/**
+ * Used to take note of the wake just ending, before going into deep
+ * sleep. The time is kept so the clock can be estimated on the next
+ * wake, and the lease ages by the time awake and asleep.
+ *
+ * @param epochMillis The current time in millis since the Unix epoch, 0 if unknown, as uint64_t.
+ * @param awakeMillis The time spent awake as uint32_t.
+ * @param sleepMillis The time about to be spent in deep sleep as uint32_t.
+ * @param timings The timings of the wake as const WakeTimings&.
+*/
+void WakeState::beginSleep(uint64_t epochMillis, uint32_t awakeMillis, uint32_t sleepMillis, const WakeTimings& timings) {
+    record.epochMillis = epochMillis;
+    record.sleepMillis = sleepMillis;
+    uint64_t leaseAge = (uint64_t) record.leaseAgeMillis + awakeMillis + sleepMillis;
+    record.leaseAgeMillis = (leaseAge > 0xFFFFFFFFull ? 0xFFFFFFFFul : (uint32_t) leaseAge);
+    record.last = timings;
+}
+
+/**
+ * Used to estimate the time at the end of the last deep sleep. The
+ * sleep timer runs off an RC oscillator which can be several percent
+ * out, so this is only a stand in until the clock is synced.
+ *
+ * @return Returns the time in millis since the Unix epoch, 0 if unknown, as uint64_t.
+*/
+uint64_t WakeState::getEpochMillisAtWake() {
+    if (!isResumed || record.epochMillis == 0ull) { // Time not known...
+
+        return 0ull;
+    }
+
+    return record.epochMillis + record.sleepMillis;
+}
+
+/**
+ * Used to note that a new lease was just handed out by DHCP.
+*/
+void WakeState::noteFreshLease() {
+    record.isLeaseKnown = 1;
+    record.leaseAgeMillis = 0;
+}
+
+/**
+ * Used to stop the cached lease being used, such as when joining
+ * the network with it didn't work out.
+*/
+void WakeState::forgetLease() {
+    record.isLeaseKnown = 0;
+}
+
+/**
+ * Used to tell if the cached lease may be used in place of DHCP,
+ * which is while it is known to be good and young enough that the
+ * DHCP server shouldn't have handed the address to anyone else.
+ *
+ * @return Returns true if usable otherwise false as bool.
+*/
+bool WakeState::isLeaseUsable() {
+
+    return (record.isLeaseKnown != 0 && record.leaseAgeMillis < WAKE_LEASE_MAX_AGE_MILLIS);
+}
+
+uint32_t WakeState::getWakeCount() {
+
+    return record.wakeCount;
+}
+
+uint32_t WakeState::getSequence() {
+
+    return record.sequence;
+}
+
+void WakeState::setSequence(uint32_t sequence) {
+    record.sequence = sequence;
+}
+
+bool WakeState::getIsSensorFailing() {
+
+    return (record.isSensorFailing != 0);
+}
+
+void WakeState::setIsSensorFailing(bool isFailing) {
+    record.isSensorFailing = (isFailing ? 1 : 0);
+}
+
+uint16_t WakeState::getFailedWakes() {
+
+    return record.failedWakes;
+}
+
+/**
+ * Used to note whether the wake managed to deliver its readings,
+ * keeping count of the wakes in a row that didn't.
+ *
+ * @param isDelivered True if everything went out as bool.
+*/
+void WakeState::noteDelivered(bool isDelivered) {
+    if (isDelivered) { // Back to normal...
+        record.failedWakes = 0;
+    } else if (record.failedWakes < 0xFFFF) { // Another miss...
+        record.failedWakes++;
+    }
+}
+
+const WakeTimings& WakeState::getLastTimings() {
+
+    return record.last;
+}
+
+/**
+ * Estimates the average current drawn over a wake and the deep sleep
+ * after it, from typical currents for the module at 80MHz with the
+ * WiFi on and in deep sleep. It shows how much the time awake costs
+ * against the time asleep when choosing how long to sleep.
+ *
+ * @param awakeMillis The time spent awake as uint32_t.
+ * @param sleepMillis The time spent in deep sleep as uint32_t.
+ *
+ * @return Returns the average current in microamps as uint32_t.
+*/
+uint32_t WakeState::estimateAverageMicroAmps(uint32_t awakeMillis, uint32_t sleepMillis) {
+    uint64_t total = (uint64_t) awakeMillis + sleepMillis;
+    if (total == 0ull) { // Nothing to average...
+
+        return 0;
+    }
+    uint64_t charge = ((uint64_t) awakeMillis * POWER_AWAKE_80_MA * 1000ull) + ((uint64_t) sleepMillis * WAKE_DEEP_SLEEP_UA);
+
+    return (uint32_t) (charge / total);
+}
+
+/*
+=================================================================
+Private Functions
+=================================================================
+*/
+
+/**
+ * #### PRIVATE ####
+ * Used to work out the CRC of the record, covering everything after
+ * the CRC itself.
+ *
+ * @return Returns the CRC as uint32_t.
+*/
+uint32_t WakeState::calcCrc() {
+    const uint8_t *start = (const uint8_t *) &record.wakeCount;
+
+    return crc32(start, sizeof(WakeRecord) - (start - (const uint8_t *) &record));
+}
+
+/**
+ * #### PRIVATE ####
+ * A plain bitwise CRC32 (IEEE), small and quick enough for a record
+ * of a few hundred bytes written once per wake.
+ *
+ * @param data The bytes to check as const uint8_t*.
+ * @param length The number of bytes as size_t.
+ *
+ * @return Returns the CRC as uint32_t.
+*/
+uint32_t WakeState::crc32(const uint8_t* data, size_t length) {
+    uint32_t crc = 0xFFFFFFFFul;
+    for (size_t i = 0; i < length; i++) {
+        crc ^= data[i];
+        for (uint8_t bit = 0; bit < 8; bit++) {
+            crc = (crc >> 1) ^ (0xEDB88320ul & (0ul - (crc & 1ul)));
+        }
+    }
+
+    return ~crc;
+}
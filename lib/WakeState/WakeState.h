@@ -0,0 +1,114 @@
+/*
+    WakeState - A class used to carry what the device needs to know from one
+    wake to the next while in battery mode, where it spends nearly all of
+    its time in deep sleep. Deep sleep ends in a reset, so everything in RAM
+    is lost; The only memory that survives is the RTC memory of the ESP8266,
+    which holds 512 bytes for the user, the first 128 of which are left to
+    the OTA updater.
+
+    The state holds the sequence number of the last reading, whether the
+    sensor was failing, an estimate of the wall clock time, how old the
+    cached DHCP lease is and the timings of the last wake. It also holds a
+    short history of the latest readings, the newest of which may not have
+    been delivered yet, so they can be sent again on the next wake.
+
+    The state is kept behind a magic number and a CRC32 so that RTC memory
+    holding anything else, such as after power is first applied, is caught
+    and the state started fresh. The class never touches the RTC memory
+    itself; The caller reads and writes the bytes given by getData(), so the
+    state handling can be exercised away from the device.
+
+    Written by: Scott Griffis
+    Date: 10-19-2026
+*/
+
+#ifndef WakeState_h
+    #define WakeState_h
+
+    #include <stdint.h>
+    #include <stddef.h>
+    #include <ReadingQueue.h>
+
+    #define WAKE_STATE_MAGIC 0x54425753ul // "TBWS"
+    #define WAKE_RTC_BLOCK 32 // Where the record starts in RTC user memory, in 4 byte blocks; Skips the OTA area
+    #define WAKE_HISTORY_SIZE 12 // Latest readings kept across wakes
+    #define WAKE_LEASE_MAX_AGE_MILLIS 3600000ul // Cached lease trusted this long before DHCP is used again
+    #define WAKE_DEEP_SLEEP_UA 20 // Typical current in deep sleep, in microamps
+
+    // *****************************************************************************
+    // Timings of a single wake in millis since the reset; Zero if not reached
+    // *****************************************************************************
+    struct WakeTimings {
+        uint16_t       sensorReady      ;
+        uint16_t       associated       ;
+        uint16_t       ipAcquired       ;
+        uint16_t       delivered        ; // Everything sent
+        uint16_t       asleep           ; // Going into deep sleep
+    };
+
+    // *****************************************************************************
+    // The record as held in RTC memory; Size must be a multiple of 4 bytes
+    // *****************************************************************************
+    struct WakeRecord {
+        uint32_t       magic            ;
+        uint32_t       crc              ; // Of everything after it
+        uint32_t       wakeCount        ; // Wakes from deep sleep
+        uint32_t       sequence         ; // Of the last good reading
+        uint64_t       epochMillis      ; // Estimated time deep sleep began; 0 if unknown
+        uint32_t       sleepMillis      ; // Length of the deep sleep
+        uint32_t       leaseAgeMillis   ; // Time since the lease came from DHCP
+        uint16_t       failedWakes      ; // In a row without delivering
+        uint8_t        isSensorFailing  ;
+        uint8_t        isLeaseKnown     ;
+        WakeTimings    last             ; // Timings of the last wake
+        uint8_t        historyHead      ; // Oldest
+        uint8_t        historyCount     ;
+        uint8_t        unsentCount      ; // Newest readings not yet delivered
+        uint8_t        reserved         ;
+        QueuedReading  history          [WAKE_HISTORY_SIZE];
+    };
+
+    class WakeState {
+        private:
+            WakeRecord     record           ;
+            bool           isResumed        = false; // Valid record found on load
+
+            static uint32_t crc32(const uint8_t* data, size_t length);
+            uint32_t       calcCrc           ()                       ;
+
+        public:
+            WakeState();
+
+            uint8_t*       getData           ()                       ;
+            size_t         getSize           ()                       ;
+            bool           load              ()                       ;
+            void           noteWake          ()                       ;
+            void           seal              ()                       ;
+            void           reset             ()                       ;
+            bool           getIsResumed      ()                       ;
+
+            void           addReading        (const QueuedReading& reading);
+            uint8_t        getHistoryCount   ()                       ;
+            const QueuedReading& getReading  (uint8_t index)          ;
+            uint8_t        getUnsentCount    ()                       ;
+            void           setUnsentCount    (uint8_t count)          ;
+
+            void           beginSleep        (uint64_t epochMillis, uint32_t awakeMillis, uint32_t sleepMillis, const WakeTimings& timings);
+            uint64_t       getEpochMillisAtWake()                     ;
+            void           noteFreshLease    ()                       ;
+            void           forgetLease       ()                       ;
+            bool           isLeaseUsable     ()                       ;
+
+            uint32_t       getWakeCount      ()                       ;
+            uint32_t       getSequence       ()                       ;
+            void           setSequence       (uint32_t sequence)      ;
+            bool           getIsSensorFailing()                       ;
+            void           setIsSensorFailing(bool isFailing)         ;
+            uint16_t       getFailedWakes    ()                       ;
+            void           noteDelivered     (bool isDelivered)       ;
+            const WakeTimings& getLastTimings()                       ;
+
+            static uint32_t estimateAverageMicroAmps(uint32_t awakeMillis, uint32_t sleepMillis);
+    };
+
+#endif
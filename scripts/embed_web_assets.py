@@ -0,0 +1,136 @@
+"""
+  Embed Web Assets - A PlatformIO pre-build script which takes the static
+  files found in the project's web folder, strips the indentation from them,
+  gzip compresses them and writes them out as PROGMEM byte arrays to the
+  generated header include/WebAssets.h.
+
+  Both the compressed and the plain bytes are kept so that the firmware can
+  serve clients that don't accept gzip encoding. Each asset also gets an ETag
+  derived from its content so browsers can cache it and revalidate cheaply.
+  The size of each asset before and after compression is printed during the
+  build.
+
+  The script may also be run by hand from the project root:
+    > python3 scripts/embed_web_assets.py
+
+  Written by: Scott Griffis
+  Date: 10-19-2026
+"""
+
+import gzip
+import hashlib
+import os
+import re
+
+try:
+    Import("env")  # noqa: F821 - Provided by PlatformIO/SCons
+    PROJECT_DIR = env.subst("$PROJECT_DIR")  # noqa: F821
+except NameError:
+    PROJECT_DIR = os.path.dirname(os.path.dirname(os.path.abspath(__file__)))
+
+WEB_DIR = os.path.join(PROJECT_DIR, "web")
+OUT_FILE = os.path.join(PROJECT_DIR, "include", "WebAssets.h")
+
+MIME_TYPES = {
+    ".html": "text/html",
+    ".css": "text/css",
+    ".js": "application/javascript",
+    ".json": "application/json",
+    ".svg": "image/svg+xml",
+}
+
+
+def minify(data):
+    """Drops indentation and blank lines; Safe for our html, css and js."""
+    lines = (line.strip() for line in data.decode("utf-8").splitlines())
+
+    return "\n".join(line for line in lines if line).encode("utf-8")
+
+
+def c_name(file_name):
+    return "WEB_ASSET_" + re.sub(r"[^A-Za-z0-9]", "_", file_name).upper()
+
+
+def c_bytes(data):
+    rows = []
+    for i in range(0, len(data), 20):
+        rows.append("        " + ", ".join("0x%02x" % b for b in data[i:i + 20]))
+
+    return ",\n".join(rows)
+
+
+def main():
+    files = sorted(
+        f for f in os.listdir(WEB_DIR)
+        if os.path.splitext(f)[1] in MIME_TYPES
+    )
+
+    out = [
+        "// ********************************************************************",
+        "// GENERATED FILE - DO NOT EDIT!!!",
+        "// Created by scripts/embed_web_assets.py from the files in web/",
+        "// ********************************************************************",
+        "#ifndef WebAssets_h",
+        "    #define WebAssets_h",
+        "",
+        "    #include <stddef.h>",
+        "    #include <stdint.h>",
+        "    #include <pgmspace.h>",
+        "",
+        "    struct WebAsset {",
+        "        const char     *path       ;",
+        "        const char     *mimeType   ;",
+        "        const char     *etag       ;",
+        "        const uint8_t  *gzData     ;",
+        "        size_t          gzLength   ;",
+        "        const uint8_t  *rawData    ;",
+        "        size_t          rawLength  ;",
+        "    };",
+        "",
+    ]
+
+    total_raw = 0
+    total_gz = 0
+    for file_name in files:
+        with open(os.path.join(WEB_DIR, file_name), "rb") as f:
+            original = f.read()
+        raw = minify(original)
+        gz = gzip.compress(raw, compresslevel=9, mtime=0)
+        name = c_name(file_name)
+        mime = MIME_TYPES[os.path.splitext(file_name)[1]]
+        etag = hashlib.sha1(raw).hexdigest()[:16]
+
+        out += [
+            "    const uint8_t %s_RAW[] PROGMEM = {" % name,
+            c_bytes(raw),
+            "    };",
+            "",
+            "    const uint8_t %s_GZ[] PROGMEM = {" % name,
+            c_bytes(gz),
+            "    };",
+            "",
+            "    const WebAsset %s = {" % name,
+            "        \"/%s\", \"%s\", \"\\\"%s\\\"\", %s_GZ, sizeof(%s_GZ), %s_RAW, sizeof(%s_RAW)"
+            % (file_name, mime, etag, name, name, name, name),
+            "    };",
+            "",
+        ]
+
+        total_raw += len(original)
+        total_gz += len(gz)
+        print("WebAssets: %-12s %6d bytes -> %6d minified -> %6d gzip" % (file_name, len(original), len(raw), len(gz)))
+
+    print("WebAssets: total        %6d bytes -> %6d gzip" % (total_raw, total_gz))
+    out.append("#endif")
+    content = "\n".join(out) + "\n"
+
+    # Only touch the header when it changes so it doesn't force a rebuild...
+    if os.path.exists(OUT_FILE):
+        with open(OUT_FILE, "r") as f:
+            if f.read() == content:
+                return
+    with open(OUT_FILE, "w") as f:
+        f.write(content)
+
+
+main()
@@ -69,19 +69,67 @@
 #include <ESP8266WiFi.h>
 #include <AHT10.h>
 #include <ESP8266WebServerSecure.h>
+#include <ESP8266mDNS.h>
 
 #include <Utils.h>
 #include <IpUtils.h>
 #include <Settings.h>
+#include <RateLimiter.h>
+#include <AdminSession.h>
+#include <TimeKeeper.h>
+#include <NetworkManager.h>
+#include <HeapMonitor.h>
+#include <Metrics.h>
+#include <LoopProfiler.h>
+#include <ReadingQueue.h>
+#include <MqttClient.h>
+#include <PowerManager.h>
+#include <WakeState.h>
+#include <FleetTable.h>
+#include <BroadcastPacket.h>
 #include <ExampleSecrets.h>
 #include <Secrets.h>
 #include <HtmlContent.h>
+#include <WebAssets.h>
 
 #include <WiFiUdp.h>
+#include <coredecls.h>
+#include <user_interface.h>
 
 #define FIRMWARE_VERSION "3.0.1"
 #define LED_PIN 2 // Output used for flashing out IP Address
 #define RESTORE_PIN 13 // Input used for factory reset button; Normally Low
+#define CLIENT_REQ_PER_SEC 2 // Sustained web requests allowed per client
+#define CLIENT_REQ_BURST 10 // Back to back web requests allowed per client
+#define GLOBAL_REQ_PER_SEC 6 // Sustained web requests allowed for all clients together
+#define GLOBAL_REQ_BURST 16 // Back to back web requests allowed for all clients together
+#define NET_CHANGE_DELAY_MILLIS 2000ul // Time given for the update result page to reach the client
+#define NET_TRIAL_MILLIS 60000ul // Time new network settings get to prove themselves before rollback
+#define BACKLOG_BATCH_MILLIS 250ul // Least time between batches of readings forwarded after an outage
+#define MQTT_BATCH_MILLIS 250ul // Least time between MQTT publishes of readings
+#define MQTT_TOPIC_SIZE 64
+#define POWER_MAX_SLEEP_MILLIS 250ul // Longest sleep between passes of the loop
+#define POWER_BOOST_HOLD_MILLIS 2000ul // Time kept at 160MHz after web activity
+#define POWER_POLL_MILLIS 25ul // How often a sleep checks for incoming connections and data
+#define BATTERY_AWAKE_LIMIT_MILLIS 8000ul // Longest a battery wake may last before going back to sleep
+#define BATTERY_SETUP_WINDOW_MILLIS 300000ul // Time after a reset, or the last web request, before battery mode sleeps
+#define BATTERY_POLL_MILLIS 2ul
+#define HUB_MAX_PACKETS_PER_PASS 32 // Packets taken from the hub listener each pass; The rest wait for the next
+#define HUB_POLL_MILLIS 20ul // Longest a hub sleeps before checking for packets; Kept inside the socket buffer
+#define HEADER_ACCEPT_ENCODING 0 // Indexes into the headers collected for handlers
+#define HEADER_IF_NONE_MATCH 1
+#define HEADER_COOKIE 2
+#define SECTION_NETWORK 0 // Indexes into LOOP_SECTIONS for the loop profiler
+#define SECTION_REMEMBER 1
+#define SECTION_TRIAL 2
+#define SECTION_SENSOR 3
+#define SECTION_BROADCAST 4
+#define SECTION_IP_DISPLAY 5
+#define SECTION_WEB_SERVER 6
+#define SECTION_BACKLOG 7
+#define SECTION_MQTT 8
+#define SECTION_MDNS 9
+#define SECTION_HUB 10
 
 // ************************************************************************************
 // Setup of Services
@@ -91,15 +139,70 @@ AHT10 tempSensor = AHT10();
 BearSSL::ESP8266WebServerSecure webServer(/*Port*/443);
 BearSSL::ServerSessions serverCache(/*Sessions*/4);
 WiFiUDP udpService;
+AdminSession adminSession;
+TimeKeeper timeKeeper;
+NetworkManager network;
+RateLimiter rateLimiter(CLIENT_REQ_PER_SEC, CLIENT_REQ_BURST, GLOBAL_REQ_PER_SEC, GLOBAL_REQ_BURST);
+HeapMonitor heapMonitor;
+Metrics metrics;
+const char *LOOP_SECTIONS[] = {"network", "remember", "trial", "sensor", "broadcast", "ipdisplay", "webserver", "backlog", "mqtt", "mdns", "hub"};
+LoopProfiler loopProfiler(LOOP_SECTIONS, 11);
+ReadingQueue backlog(BACKLOG_BATCH_MILLIS);
+WiFiClient mqttSocket;
+MqttClient mqtt(mqttSocket);
+ReadingQueue mqttBacklog(MQTT_BATCH_MILLIS); // Readings not yet handed to the broker
+PowerManager power(POWER_MAX_SLEEP_MILLIS, POWER_BOOST_HOLD_MILLIS);
+WakeState wakeState; // Carried across deep sleeps in RTC memory
+WiFiUDP hubService; // Listens for the broadcasts of other units in hub mode
+FleetTable fleet; // Latest reading of every unit heard in hub mode
 
 // ************************************************************************************
 // Global worker variables
 // ************************************************************************************
-String ipAddr = "0.0.0.0";
-String deviceId = "";
+char ipAddr[IPV4_TEXT_SIZE] = "0.0.0.0";
+char deviceId[7] = ""; // 6 chars + null
 float lastTempRead = MAXFLOAT;
 float lastHumidityRead = MAXFLOAT;
+uint64_t lastReadTimestamp = 0ull; // Epoch millis of last read; Zero if time unknown
+bool hasReading = false; // False until the first good reading is taken
+bool isSensorFailing = false;
+bool isBatteryWake = false; // Woke from deep sleep to take a reading; The web server isn't started
+bool isLeaseReused = false; // Joined using the lease cached from an earlier wake rather than DHCP
+unsigned long lastRequestMillis = 0ul; // Keeps battery mode awake while the web pages are in use
+
+struct MqttTopics {
+  char           status           [MQTT_TOPIC_SIZE]; // Retained
+  char           readings         [MQTT_TOPIC_SIZE];
+  char           alerts           [MQTT_TOPIC_SIZE];
+  char           willMessage      [48];
+  bool           isStatusDue      ; // Status goes out after each connect
+  unsigned long  statusConnectCount;
+  const char    *pendingAlert     ; // Latest alert not yet published; nullptr if none
+} mqttTopics = {"", "", "", "", false, 0ul, nullptr};
+unsigned long readCount = 0ul; // Number of good readings taken
 IPAddress bcastAddress;
+MDNSResponder::hMDNSService mdnsService = nullptr; // The _tempbuddy._tcp service; Its TXT record carries the reading
+
+// ************************************************************************************
+// Boot phase timings in millis since boot; Zero if phase not yet reached
+// ************************************************************************************
+struct BootTimings {
+  unsigned long  settingsLoaded   ;
+  unsigned long  sensorReady      ;
+  unsigned long  serverUp         ;
+  unsigned long  associated       ;
+  unsigned long  ipAcquired       ;
+} bootTimings = {0ul, 0ul, 0ul, 0ul, 0ul};
+
+// ************************************************************************************
+// Network settings to fall back to should newly applied ones not work out
+// ************************************************************************************
+struct NetworkTrial {
+  bool           isPending        ; // Change saved but not yet applied
+  bool           isActive         ; // Change applied and on trial
+  unsigned long  sinceMillis      ;
+  struct NonVolatileSettings previous; // Known good; Only SETTING_NETWORK fields get restored
+} networkTrial = {false, false, 0ul, {}};
 
 void resetOrLoadSettings();
 void doStartAHT10();
@@ -108,18 +211,53 @@ void checkIpDisplayRequest();
 void endpointHandlerRoot();
 void endpointHandlerAdmin();
 void endpointHandlerApiInfo();
+void endpointHandlerAdminSettings();
+void endpointHandlerApiDiag();
+void endpointHandlerApiBoot();
+void endpointHandlerApiHeap();
+void endpointHandlerApiMetrics();
+void endpointHandlerApiProfile();
+void endpointHandlerApiFleet();
+void appendChunk(char *chunk, size_t size, size_t &length, const char *text);
+void onMeasured(const char *uri, std::function<void()> handler);
 void notFoundHandler();
 void fileUploadHandler();
+void appendFieldName(String &names, const SettingField &field);
 bool handleAdminPageUpdates();
-void signalIpAddress(String ipAddress, bool quick);
+bool isAdminAuthenticated();
+void signalIpAddress(const char *ipAddress, bool quick);
 void sendHtmlPageUsingTemplate(int code, String title, String heading, String &content);
+void sendWebAsset(const WebAsset &asset);
+bool clientAcceptsGzip();
+BearSSL::ESP8266WebServerSecure::ClientFuture admitRequest(WiFiClient *client);
 void displayOctet(int octet);
 void displayNextDigitIndicator();
 bool displayDigit(int digit);
 void displayNextOctetIndicator();
 void displayDone();
 void doReadSensorData();
+bool takeReading();
 void doBroadcast();
+void doForwardBacklog();
+bool sendBroadcast(const char *packet, size_t length);
+void doStartMqtt();
+void doStartMdns();
+void doStartHub();
+void doHub();
+void doMqtt();
+void doRememberConnection();
+void doJoinNetwork();
+void doNetworkTrial();
+void checkSerialCommand();
+void doApplyPowerSettings();
+void doManageCpuSpeed();
+void doSleep(uint32_t passStartMicros);
+bool isWakeWanted();
+void doBatteryWake();
+void checkBatterySleep();
+void doDeepSleep(WakeTimings &timings, bool isDelivered);
+bool isMqttDone();
+uint16_t toTiming(unsigned long millisSinceReset);
 
 /***************************** 
  * SETUP() - REQUIRED FUNCTION
@@ -133,11 +271,37 @@ void setup() {
   pinMode(RESTORE_PIN, INPUT);
 
   /* Generate Device ID Based On MAC Address */
-  deviceId = Utils::genDeviceIdFromMacAddr(WiFi.macAddress());
+  strncpy(deviceId, Utils::genDeviceIdFromMacAddr(WiFi.macAddress()).c_str(), sizeof(deviceId) - 1);
+  settings.setDeviceId(deviceId);
+  adminSession.revokeAll(); // Generates session key
 
   resetOrLoadSettings();
-  doStartAHT10(); // Temp/Humidity device
+  bootTimings.settingsLoaded = millis();
+
+  /* Battery Mode Wakes Only Take and Send a Reading */
+  ESP.rtcUserMemoryRead(WAKE_RTC_BLOCK, (uint32_t *) wakeState.getData(), wakeState.getSize());
+  wakeState.load();
+  isBatteryWake = (
+    settings.getIsBatteryMode() 
+    && settings.isNetworkSet() 
+    && ESP.getResetInfoPtr()->reason == REASON_DEEP_SLEEP_AWAKE
+  );
+  if (isBatteryWake) { // Woke from deep sleep...
+    wakeState.noteWake();
+    doBatteryWake(); // Ends in deep sleep
+  }
+  readCount = wakeState.getSequence(); // Sequence carries on from battery mode
+  
+  /* 
+    Network comes first since joining WiFi happens in the background,
+    then the sensor takes its first reading while that is under way. 
+    The reading is broadcast from loop() as soon as the network is up.
+  */
   doStartNetwork();
+  bootTimings.serverUp = millis();
+  doStartAHT10(); // Temp/Humidity device
+  doReadSensorData();
+  bootTimings.sensorReady = millis();
 
   yield();
 }
@@ -149,12 +313,33 @@ void setup() {
  * Here is where all functionality happens or starts to happen.
  */
 void loop() {
-  doReadSensorData();
-  doBroadcast();
-  checkIpDisplayRequest();
-  webServer.handleClient();
+  uint32_t passStartMicros = micros();
+  power.beginPass(millis());
+  heapMonitor.beginLoop();
+  PROFILE_LOOP_BEGIN(loopProfiler);
+  PROFILE_SECTION(loopProfiler, SECTION_NETWORK, 
+    if (network.update(millis())) { // Addressing changed...
+      IpUtils::formatIPv4(network.getIpAddress(), ipAddr, sizeof(ipAddr));
+      bcastAddress = network.getBcastAddress();
+    }
+  );
+  PROFILE_SECTION(loopProfiler, SECTION_REMEMBER, doRememberConnection());
+  PROFILE_SECTION(loopProfiler, SECTION_TRIAL, doNetworkTrial());
+  PROFILE_SECTION(loopProfiler, SECTION_SENSOR, doReadSensorData());
+  PROFILE_SECTION(loopProfiler, SECTION_BROADCAST, doBroadcast());
+  PROFILE_SECTION(loopProfiler, SECTION_BACKLOG, doForwardBacklog());
+  PROFILE_SECTION(loopProfiler, SECTION_MQTT, doMqtt());
+  PROFILE_SECTION(loopProfiler, SECTION_IP_DISPLAY, checkIpDisplayRequest());
+  PROFILE_SECTION(loopProfiler, SECTION_MDNS, MDNS.update());
+  PROFILE_SECTION(loopProfiler, SECTION_HUB, doHub());
+  doManageCpuSpeed();
+  PROFILE_SECTION(loopProfiler, SECTION_WEB_SERVER, webServer.handleClient());
+  PROFILE_LOOP_END(loopProfiler);
+  heapMonitor.endLoop(millis());
+  checkSerialCommand();
+  checkBatterySleep();
 
-  yield();
+  doSleep(passStartMicros);
 }
 
 /**
@@ -184,11 +369,36 @@ void checkIpDisplayRequest() {
  * SSID and Password.
  */
 void connectToNetwork() {
+  struct StationConfig config = {
+    settings.getHostname(), settings.getSsid(), settings.getPwd(), 
+    nullptr, 0, 
+    IPAddress(0, 0, 0, 0), IPAddress(0, 0, 0, 0), IPAddress(0, 0, 0, 0), IPAddress(0, 0, 0, 0)
+  };
+
+  /* Use Known Access Point If Any */
+  uint8_t bssid[6];
+  if (Utils::parseMacAddress(settings.getLastBssid(), bssid) && settings.getLastChannel() > 0) { // Have a last good connection...
+    config.bssid = bssid;
+    config.channel = settings.getLastChannel();
+  }
+
+  /* Use Static Addressing If Set */
+  isLeaseReused = false;
+  if (settings.isStaticIpSet()) {
+    config.ip = IpUtils::toIPAddress(settings.getStaticIp());
+    config.gateway = IpUtils::toIPAddress(settings.getStaticGateway());
+    config.subnet = IpUtils::toIPAddress(settings.getStaticSubnet());
+    config.dns = IpUtils::toIPAddress(settings.getStaticDns());
+  } else if (isBatteryWake && wakeState.isLeaseUsable()) { // Lease from an earlier wake still good; Skips DHCP...
+    isLeaseReused = true;
+    config.ip = IpUtils::toIPAddress(settings.getLastIp());
+    config.gateway = IpUtils::toIPAddress(settings.getLastGateway());
+    config.subnet = IpUtils::toIPAddress(settings.getLastSubnet());
+    config.dns = IpUtils::toIPAddress(settings.getLastDns());
+  }
+
   // Connect to WiFi network...
-  WiFi.setOutputPower(20.5F);
-  WiFi.setHostname(settings.getHostname(deviceId).c_str());
-  WiFi.mode(WiFiMode::WIFI_STA);
-  WiFi.begin(settings.getSsid(), settings.getPwd());
+  network.beginStation(config);
 }
 
 /**
@@ -197,16 +407,14 @@ void connectToNetwork() {
  * the device.
  */
 void activateAPMode() {
-  WiFi.setOutputPower(20.5F);
-  WiFi.setHostname(settings.getHostname(deviceId).c_str());
-  WiFi.mode(WiFiMode::WIFI_AP);
-  WiFi.softAPConfig(
-    IpUtils::stringIPv4ToIPAddress(settings.getApNetIp()), 
-    IpUtils::stringIPv4ToIPAddress(settings.getApGateway()), 
-    IpUtils::stringIPv4ToIPAddress(settings.getApSubnet())
+  network.beginAccessPoint(
+    settings.getHostname(), 
+    settings.getApSsid(), 
+    settings.getApPwd(), 
+    IpUtils::toIPAddress(settings.getApNetIp()), 
+    IpUtils::toIPAddress(settings.getApGateway()), 
+    IpUtils::toIPAddress(settings.getApSubnet())
   );
-
-  WiFi.softAP(settings.getApSsid(deviceId), settings.getApPwd());
 }
 
 /**
@@ -227,17 +435,26 @@ void resetOrLoadSettings() {
 }
 
 /**
- * Used to startup the network related services.
  * Starts the device in AP mode or connects to 
- * existing WiFi based on settings.
+ * existing WiFi based on settings. May be called
+ * again at any time to apply changed settings.
  */
-void doStartNetwork() {
+void doJoinNetwork() {
   // Connect to wireless or enable AP Mode...
   if (!settings.isNetworkSet()) { // Network settings weren't set...
     activateAPMode();
   } else { // Normal mode connects to WiFi...
     connectToNetwork();
   }
+}
+
+/**
+ * Used to startup the network related services.
+ * Starts the device in AP mode or connects to 
+ * existing WiFi based on settings.
+ */
+void doStartNetwork() {
+  doJoinNetwork();
   
   #ifndef Secrets_h
     webServer.getServer().setRSACert(new BearSSL::X509List(SAMPLE_SERVER_CERT), new BearSSL::PrivateKey(SAMPLE_SERVER_KEY));
@@ -245,24 +462,46 @@ void doStartNetwork() {
     webServer.getServer().setRSACert(new BearSSL::X509List(server_cert), new BearSSL::PrivateKey(server_key));
   #endif
   webServer.getServer().setCache(&serverCache);
+  Metrics::watchSessionCache(serverCache.getCache());
+
+  /* Headers Needed By Handlers; Order matches the HEADER_ indexes */
+  const char *headerKeys[] = {"Accept-Encoding", "If-None-Match", "Cookie"};
+  webServer.collectHeaders(headerKeys, 3);
+
+  /* Turn Away Excess Requests Before Their Headers Are Parsed */
+  webServer.addHook(
+    [](const String &method, const String &url, WiFiClient *client, BearSSL::ESP8266WebServerSecure::ContentTypeFunction contentType) {
+      
+      return admitRequest(client);
+    }
+  );
 
   /* Setup Endpoint Handlers */
-  webServer.on(F("/"), endpointHandlerRoot);
-  webServer.on(F("/admin"), endpointHandlerAdmin);
-  webServer.on(F("/api/info"), endpointHandlerApiInfo);
+  onMeasured("/", endpointHandlerRoot);
+  onMeasured("/admin", endpointHandlerAdmin);
+  onMeasured("/admin/settings", endpointHandlerAdminSettings);
+  onMeasured("/api/info", endpointHandlerApiInfo);
+  onMeasured("/api/diag", endpointHandlerApiDiag);
+  onMeasured("/api/boot", endpointHandlerApiBoot);
+  onMeasured("/api/heap", endpointHandlerApiHeap);
+  onMeasured("/api/metrics", endpointHandlerApiMetrics);
+  onMeasured("/api/profile", endpointHandlerApiProfile);
+  onMeasured("/api/fleet", endpointHandlerApiFleet);
+  onMeasured("/style.css", []() { sendWebAsset(WEB_ASSET_STYLE_CSS); });
   
   webServer.onNotFound(notFoundHandler);
   webServer.onFileUpload(fileUploadHandler);
 
   webServer.begin();
   Serial.println(F("\nServer started."));
+
+  timeKeeper.begin(settings.getNtpServer());
+  doStartMqtt();
+  doApplyPowerSettings();
+  doStartMdns();
+  doStartHub();
   
-  ipAddr = (
-    (WiFi.getMode() == WiFiMode_t::WIFI_AP) 
-        ? WiFi.softAPIP().toString() 
-        : WiFi.localIP().toString()
-  );
-  bcastAddress = IpUtils::deriveNetworkBroadcastAddress(ipAddr, WiFi.subnetMask().toString());
+  // Note: ipAddr and bcastAddress are kept current from loop() as the network comes and goes.
 }
 
 /**
@@ -280,23 +519,93 @@ void doStartAHT10() {
  * client in the form of JSON.
 */
 void endpointHandlerApiInfo() {
-  String content = INFO_JSON;
-  
-  content.replace("${deviceid}", deviceId.c_str());
-  content.replace("${humidity}", String(lastHumidityRead).c_str());
-  content.replace("${title}", settings.getTitle().c_str());
-  content.replace("${heading}", settings.getHeading().c_str());
-  content.replace("${hostname}", settings.getHostname(deviceId).c_str());
+  static char content[512]; // Reused; Clients poll this so it shouldn't churn the heap
+  char title[(sizeof(NonVolatileSettings::title) * 2) - 1]; // Room for every char escaped
+  char heading[(sizeof(NonVolatileSettings::heading) * 2) - 1];
+  char timestamp[UINT64_TEXT_SIZE];
+  char tempValue[16] = "null"; // No data yet...
+  char humidity[16] = "null";
 
-  if (settings.getIsCelsius()) {
-    content.replace("${tempvalue}", String(lastTempRead).c_str());
-    content.replace("${tempunit}", "C");
-  } else {
-    content.replace("${tempvalue}", String(((lastTempRead * 9/5) + 32)).c_str());
-    content.replace("${tempunit}", "F");
+  Utils::jsonEscape(settings.getTitle(), title, sizeof(title));
+  Utils::jsonEscape(settings.getHeading(), heading, sizeof(heading));
+  Utils::formatUint64(lastReadTimestamp, timestamp, sizeof(timestamp));
+  if (hasReading) { // Have data...
+    snprintf(tempValue, sizeof(tempValue), "%.2f", (settings.getIsCelsius() ? lastTempRead : ((lastTempRead * 9/5) + 32)));
+    snprintf(humidity, sizeof(humidity), "%.2f", lastHumidityRead);
   }
 
-  webServer.send(200, "application/json", content);
+  int length = snprintf_P(
+    content, sizeof(content), INFO_JSON, 
+    title, heading, deviceId, settings.getHostname(), 
+    tempValue, (settings.getIsCelsius() ? "C" : "F"), humidity, 
+    timestamp, (timeKeeper.isSynced() ? "true" : "false")
+  );
+  if (length < 0 || (size_t) length >= sizeof(content)) { // Cut short; Shouldn't happen...
+    length = strlen(content);
+  }
+
+  webServer.sendHeader(F("Cache-Control"), F("no-store"));
+  webServer.send(200, "application/json", content, (size_t) length);
+  yield();
+}
+
+/**
+ * #### API-DIAG JSON ####
+ * This function handles an endpoint which sends diagnostic
+ * information about the device to the client in the form
+ * of JSON.
+*/
+void endpointHandlerApiDiag() {
+  static char content[1280]; // Reused; Polled by monitoring so it shouldn't churn the heap
+  int length = snprintf_P(
+    content, sizeof(content), DIAG_JSON, 
+    rateLimiter.getAdmittedCount(), rateLimiter.getRateLimitedCount(), rateLimiter.getBusyCount(), 
+    network.getStateName(), network.getReconnectCount(), 
+    settings.getFlashWriteCount(), (unsigned long) settings.getSaveSequence(), 
+    (unsigned long) backlog.getCount(), backlog.getQueuedCount(), backlog.getDroppedCount(), backlog.getSentCount(), 
+    mqtt.getStateName(), mqtt.getConnectCount(), mqtt.getPublishCount(), mqtt.getAckCount(), mqtt.getResendCount(), 
+    (unsigned long) mqtt.getLastRefusal(), (unsigned long) mqttBacklog.getCount(), mqttBacklog.getDroppedCount(), 
+    (settings.getIsBroadcastOn() ? "true" : "false"), (MDNS.isRunning() ? "true" : "false"), 
+    (settings.getIsHubMode() ? "true" : "false"), (unsigned long) fleet.getCount(), 
+    (unsigned long) ESP.getCpuFreqMHz(), (power.getIsLightSleep() ? "light" : "modem"), 
+    (unsigned long) power.getDutyPercent(), (unsigned long) power.getLastSampleDuty(), 
+    (unsigned long) power.getLastSampleMicroJoules(), (unsigned long) power.getAverageMicroJoulesPerSample(), 
+    (unsigned long) (power.getTotalMicroJoules() / 1000ull)
+  );
+  if (length < 0 || (size_t) length >= sizeof(content)) { // Cut short; Shouldn't happen...
+    length = strlen(content);
+  }
+
+  webServer.sendHeader(F("Cache-Control"), F("no-store"));
+  webServer.send(200, "application/json", content, (size_t) length);
+  yield();
+}
+
+/**
+ * #### API-BOOT JSON ####
+ * This function handles an endpoint which sends the timings
+ * of the device's boot phases and of its last connection to
+ * the network to the client in the form of JSON.
+*/
+void endpointHandlerApiBoot() {
+  static char content[768]; // Reused; Keeps the request off the heap
+  const WakeTimings &wake = wakeState.getLastTimings();
+  int length = snprintf_P(
+    content, sizeof(content), BOOT_JSON, 
+    bootTimings.settingsLoaded, bootTimings.sensorReady, bootTimings.serverUp, 
+    bootTimings.associated, bootTimings.ipAcquired, 
+    network.getLastConnectDuration(), (network.getLastWasFastConnect() ? "true" : "false"), network.getConnectCount(), 
+    (settings.getIsBatteryMode() ? "true" : "false"), (unsigned long) wakeState.getWakeCount(), 
+    (unsigned long) wakeState.getFailedWakes(), (unsigned long) wake.sensorReady, (unsigned long) wake.ipAcquired, 
+    (unsigned long) wake.delivered, (unsigned long) wake.asleep, 
+    (unsigned long) WakeState::estimateAverageMicroAmps(wake.asleep, settings.getBatterySleepSecs() * 1000ul)
+  );
+  if (length < 0 || (size_t) length >= sizeof(content)) { // Cut short; Shouldn't happen...
+    length = strlen(content);
+  }
+
+  webServer.sendHeader(F("Cache-Control"), F("no-store"));
+  webServer.send(200, "application/json", content, (size_t) length);
   yield();
 }
 
@@ -304,153 +613,500 @@ void endpointHandlerApiInfo() {
  * INFO/ROOT PAGE
  * ****************************************************
  * This function shows the info page to a given client.
+ * The page is static and cacheable, it fills in its values
+ * by polling the /api/info endpoint once loaded by the
+ * browser, updating them in place.
  */
 void endpointHandlerRoot() {
-  // Build and send Information Page...
-  String content = ROOT_PAGE;
-  if (settings.getIsCelsius()) {
-    content.replace("${temp}", String(lastTempRead).c_str());
-    content.replace("${unit}", "C");
-  } else {
-    content.replace("${temp}", String(((lastTempRead * 9/5) + 32)).c_str());
-    content.replace("${unit}", "F");
+  sendWebAsset(WEB_ASSET_INDEX_HTML);
+}
+
+/**
+ * #### API-HEAP JSON ####
+ * This function handles an endpoint which sends the state of the
+ * heap, its history and the allocations made by the loop and by
+ * each handler to the client in the form of JSON. The lists are
+ * streamed out in chunks as they're written so none of it is held
+ * on the heap.
+*/
+void endpointHandlerApiHeap() {
+  HeapSample current = heapMonitor.getCurrent();
+  const HeapSample &worst = heapMonitor.getWorst();
+  char chunk[768];
+  size_t length = 0;
+
+  webServer.sendHeader(F("Cache-Control"), F("no-store"));
+  webServer.setContentLength(CONTENT_LENGTH_UNKNOWN);
+  webServer.send(200, "application/json", emptyString);
+
+  length = snprintf_P(
+    chunk, sizeof(chunk), HEAP_JSON, 
+    (HeapMonitor::isCounting() ? "true" : "false"), (unsigned long) HeapMonitor::getAllocCount(), (unsigned long) HeapMonitor::getAllocBytes(), 
+    (unsigned long) current.freeBytes, (unsigned long) current.maxBlock, (unsigned long) current.fragmentation, 
+    (unsigned long) worst.freeBytes, (unsigned long) worst.maxBlock, (unsigned long) worst.fragmentation, 
+    heapMonitor.getLoopCount(), heapMonitor.getAllocLoopCount(), (unsigned long) heapMonitor.getLastLoopAllocs(), 
+    (unsigned long) heapMonitor.getLastLoopBytes(), (unsigned long) heapMonitor.getMaxLoopAllocs()
+  );
+  length = min(length, sizeof(chunk) - 1); // Cut short; Shouldn't happen...
+  for (uint8_t i = 0; i < heapMonitor.getHandlerCount(); i++) {
+    const HandlerHeapStats &stats = heapMonitor.getHandler(i);
+    char entry[160];
+    snprintf(
+      entry, sizeof(entry), 
+      "%s{\"uri\": \"%s\", \"calls\": %lu, \"last_allocs\": %u, \"last_alloc_bytes\": %u, \"max_allocs\": %u}", 
+      ((i > 0) ? ", " : ""), stats.name, stats.calls, 
+      (unsigned int) stats.lastAllocs, (unsigned int) stats.lastBytes, (unsigned int) stats.maxAllocs
+    );
+    appendChunk(chunk, sizeof(chunk), length, entry);
+  }
+  appendChunk(chunk, sizeof(chunk), length, "], \"history\": [");
+  for (uint8_t i = 0; i < heapMonitor.getHistoryCount(); i++) {
+    const HeapSample &sample = heapMonitor.getHistory(i);
+    char entry[112];
+    snprintf(
+      entry, sizeof(entry), 
+      "%s{\"uptime_ms\": %lu, \"free_bytes\": %u, \"max_block_bytes\": %u, \"fragmentation_percent\": %u}", 
+      ((i > 0) ? ", " : ""), sample.millis, 
+      (unsigned int) sample.freeBytes, (unsigned int) sample.maxBlock, (unsigned int) sample.fragmentation
+    );
+    appendChunk(chunk, sizeof(chunk), length, entry);
+  }
+  appendChunk(chunk, sizeof(chunk), length, "]}");
+  webServer.sendContent(chunk, length);
+  webServer.sendContent(emptyString);
+  yield();
+}
+
+/**
+ * #### API-METRICS TEXT ####
+ * This function handles an endpoint which sends the runtime telemetry
+ * of the device in the Prometheus text exposition format. The text is
+ * streamed out in chunks as it's written so none of it is held on the
+ * heap.
+*/
+void endpointHandlerApiMetrics() {
+  HeapSample heap = heapMonitor.getCurrent();
+  MetricsWriter writer([](const char *data, size_t length) { webServer.sendContent(data, length); });
+
+  webServer.sendHeader(F("Cache-Control"), F("no-store"));
+  webServer.setContentLength(CONTENT_LENGTH_UNKNOWN);
+  webServer.send(200, "text/plain; version=0.0.4", emptyString);
+
+  metrics.writeTo(writer);
+
+  writer.family("tempbuddy_uptime_seconds", "gauge", "Time since boot.");
+  writer.sample("tempbuddy_uptime_seconds", nullptr, (uint64_t) (millis() / 1000ul));
+  writer.family("tempbuddy_heap_free_bytes", "gauge", "Free heap.");
+  writer.sample("tempbuddy_heap_free_bytes", nullptr, (uint64_t) heap.freeBytes);
+  writer.family("tempbuddy_heap_max_block_bytes", "gauge", "Largest allocation the heap can give.");
+  writer.sample("tempbuddy_heap_max_block_bytes", nullptr, (uint64_t) heap.maxBlock);
+  writer.family("tempbuddy_heap_fragmentation_percent", "gauge", "Fragmentation of the heap.");
+  writer.sample("tempbuddy_heap_fragmentation_percent", nullptr, (uint64_t) heap.fragmentation);
+
+  writer.family("tempbuddy_wifi_connected", "gauge", "Whether the device is online.");
+  writer.sample("tempbuddy_wifi_connected", nullptr, (uint64_t) (network.isOnline() ? 1 : 0));
+  if (network.isOnline()) { // RSSI only means something while connected...
+    writer.family("tempbuddy_wifi_rssi_dbm", "gauge", "Signal strength of the access point.");
+    writer.sample("tempbuddy_wifi_rssi_dbm", nullptr, (int32_t) WiFi.RSSI());
   }
-  content.replace("${deviceid}", deviceId.c_str());
-  content.replace("${humidity}", String(lastHumidityRead).c_str());
-   
-  sendHtmlPageUsingTemplate(200, settings.getTitle(), settings.getHeading(), content);
+  writer.family("tempbuddy_wifi_reconnects_total", "counter", "Times the network was rejoined after being lost.");
+  writer.sample("tempbuddy_wifi_reconnects_total", nullptr, (uint64_t) network.getReconnectCount());
+
+  writer.family("tempbuddy_http_admitted_total", "counter", "Connections admitted by the rate limiter.");
+  writer.sample("tempbuddy_http_admitted_total", nullptr, (uint64_t) rateLimiter.getAdmittedCount());
+  writer.family("tempbuddy_http_rejected_total", "counter", "Connections turned away by reason.");
+  writer.sample("tempbuddy_http_rejected_total", "reason=\"rate_limited\"", (uint64_t) rateLimiter.getRateLimitedCount());
+  writer.sample("tempbuddy_http_rejected_total", "reason=\"busy\"", (uint64_t) rateLimiter.getBusyCount());
+
+  writer.family("tempbuddy_backlog_readings", "gauge", "Readings waiting to be forwarded after an outage.");
+  writer.sample("tempbuddy_backlog_readings", nullptr, (uint64_t) backlog.getCount());
+  writer.family("tempbuddy_backlog_dropped_total", "counter", "Readings dropped because an outage outlasted the backlog.");
+  writer.sample("tempbuddy_backlog_dropped_total", nullptr, (uint64_t) backlog.getDroppedCount());
+  writer.family("tempbuddy_backlog_forwarded_total", "counter", "Readings forwarded after an outage.");
+  writer.sample("tempbuddy_backlog_forwarded_total", nullptr, (uint64_t) backlog.getSentCount());
+
+  writer.family("tempbuddy_mqtt_connected", "gauge", "Whether the device is connected to its MQTT broker.");
+  writer.sample("tempbuddy_mqtt_connected", nullptr, (uint64_t) (mqtt.isConnected() ? 1 : 0));
+  writer.family("tempbuddy_mqtt_published_total", "counter", "Messages published over MQTT.");
+  writer.sample("tempbuddy_mqtt_published_total", nullptr, (uint64_t) mqtt.getPublishCount());
+  writer.family("tempbuddy_mqtt_backlog_readings", "gauge", "Readings waiting to be published over MQTT.");
+  writer.sample("tempbuddy_mqtt_backlog_readings", nullptr, (uint64_t) mqttBacklog.getCount());
+
+  writer.family("tempbuddy_flash_writes_total", "counter", "Writes of the settings to flash since boot.");
+  writer.sample("tempbuddy_flash_writes_total", nullptr, (uint64_t) settings.getFlashWriteCount());
+
+  writer.family("tempbuddy_cpu_mhz", "gauge", "Speed the CPU is running at.");
+  writer.sample("tempbuddy_cpu_mhz", nullptr, (uint64_t) ESP.getCpuFreqMHz());
+  writer.family("tempbuddy_awake_percent", "gauge", "Share of time spent awake since boot.");
+  writer.sample("tempbuddy_awake_percent", nullptr, (uint64_t) power.getDutyPercent());
+  writer.family("tempbuddy_sample_energy_microjoules", "gauge", "Estimated energy used over the last sample interval.");
+  writer.sample("tempbuddy_sample_energy_microjoules", nullptr, (uint64_t) power.getLastSampleMicroJoules());
+
+  if (settings.getIsHubMode()) { // Only a hub has a fleet...
+    writer.family("tempbuddy_fleet_sensors", "gauge", "Units held in the fleet table.");
+    writer.sample("tempbuddy_fleet_sensors", nullptr, (uint64_t) fleet.getCount());
+    writer.family("tempbuddy_fleet_packets_total", "counter", "Broadcast packets taken by the hub listener.");
+    writer.sample("tempbuddy_fleet_packets_total", nullptr, (uint64_t) fleet.getPacketCount());
+    writer.family("tempbuddy_fleet_rejected_total", "counter", "Packets the hub couldn't make sense of.");
+    writer.sample("tempbuddy_fleet_rejected_total", nullptr, (uint64_t) fleet.getRejectedCount());
+    writer.family("tempbuddy_fleet_evicted_total", "counter", "Units pushed out of a full fleet table.");
+    writer.sample("tempbuddy_fleet_evicted_total", nullptr, (uint64_t) fleet.getEvictedCount());
+  }
+
+  if (hasReading) { // Only report readings actually taken...
+    writer.family("tempbuddy_temperature_celsius", "gauge", "Last temperature read.");
+    writer.sample("tempbuddy_temperature_celsius", nullptr, lastTempRead);
+    writer.family("tempbuddy_humidity_percent", "gauge", "Last relative humidity read.");
+    writer.sample("tempbuddy_humidity_percent", nullptr, lastHumidityRead);
+  }
+
+  writer.flush();
+  webServer.sendContent(emptyString);
+  yield();
+}
+
+/**
+ * #### API-PROFILE JSON ####
+ * This function handles an endpoint which sends the timings kept by
+ * the loop profiler for each section of the loop, and for the slowest
+ * loop seen, to the client in the form of JSON. The sections are
+ * streamed out in chunks as they're written so none of it is held
+ * on the heap.
+*/
+void endpointHandlerApiProfile() {
+  char chunk[512];
+  size_t length = 0;
+
+  webServer.sendHeader(F("Cache-Control"), F("no-store"));
+  webServer.setContentLength(CONTENT_LENGTH_UNKNOWN);
+  webServer.send(200, "application/json", emptyString);
+
+  length = snprintf_P(
+    chunk, sizeof(chunk), PROFILE_JSON, 
+    (LoopProfiler::isEnabled() ? "true" : "false"), (unsigned long) ESP.getCpuFreqMHz(), 
+    (unsigned long) loopProfiler.getLoopCount(), (unsigned long) loopProfiler.getMaxLoopMicros(), 
+    (unsigned long) loopProfiler.getWorstMillis()
+  );
+  length = min(length, sizeof(chunk) - 1); // Cut short; Shouldn't happen...
+  for (uint8_t i = 0; i < loopProfiler.getSectionCount(); i++) {
+    const SectionProfile &profile = loopProfiler.getSection(i);
+    char entry[176];
+    snprintf(
+      entry, sizeof(entry), 
+      "%s{\"name\": \"%s\", \"runs\": %lu, \"avg_us\": %lu, \"max_us\": %lu, \"worst_loop_us\": %lu, \"buckets\": [", 
+      ((i > 0) ? ", " : ""), loopProfiler.getSectionName(i), (unsigned long) profile.count, (unsigned long) loopProfiler.getAverageMicros(i), 
+      (unsigned long) profile.maxMicros, (unsigned long) loopProfiler.getWorstMicros(i)
+    );
+    appendChunk(chunk, sizeof(chunk), length, entry);
+    for (uint8_t b = 0; b < PROFILER_BUCKET_COUNT; b++) {
+      snprintf(entry, sizeof(entry), "%s%lu", ((b > 0) ? "," : ""), (unsigned long) profile.buckets[b]);
+      appendChunk(chunk, sizeof(chunk), length, entry);
+    }
+    appendChunk(chunk, sizeof(chunk), length, "]}");
+  }
+  appendChunk(chunk, sizeof(chunk), length, "]}");
+  webServer.sendContent(chunk, length);
+  webServer.sendContent(emptyString);
+  yield();
+}
+
+/**
+ * #### API-FLEET JSON ####
+ * This function handles an endpoint which sends the latest reading of
+ * every unit heard by the hub to the client in the form of JSON. With
+ * a large fleet the list runs to many kilobytes, so it is streamed out
+ * in chunks as it's written rather than built up on the heap.
+*/
+void endpointHandlerApiFleet() {
+  char chunk[512];
+  size_t length = 0;
+  unsigned long nowMillis = millis();
+
+  webServer.sendHeader(F("Cache-Control"), F("no-store"));
+  webServer.setContentLength(CONTENT_LENGTH_UNKNOWN);
+  webServer.send(200, "application/json", emptyString);
+
+  length = snprintf(
+    chunk, sizeof(chunk), 
+    "{\"hub\": %s, \"sensors\": %u, \"capacity\": %u, \"packets\": %lu, \"rejected\": %lu, \"evicted\": %lu, \"readings\": [", 
+    (settings.getIsHubMode() ? "true" : "false"), (unsigned int) fleet.getCount(), (unsigned int) FLEET_MAX_SENSORS, 
+    fleet.getPacketCount(), fleet.getRejectedCount(), fleet.getEvictedCount()
+  );
+  for (uint16_t i = 0; i < fleet.getCount(); i++) {
+    const FleetEntry &entry = fleet.getEntry(i);
+    char ip[IPV4_TEXT_SIZE];
+    char timestamp[UINT64_TEXT_SIZE];
+    IpUtils::formatIPv4(IPAddress(entry.ip), ip, sizeof(ip));
+    Utils::formatUint64(entry.timestamp, timestamp, sizeof(timestamp));
+    char line[224];
+    snprintf(
+      line, sizeof(line), 
+      "%s{\"id\": \"%06lX\", \"ip\": \"%s\", \"temperature\": %.2f, \"humidity\": %.2f, \"timestamp\": %s, \"sequence\": %lu, "
+      "\"age_s\": %lu, \"stale\": %s, \"heard\": %u, \"missed\": %u}", 
+      ((i > 0) ? ", " : ""), (unsigned long) entry.id, ip, entry.centiCelsius / 100.0f, entry.centiHumidity / 100.0f, timestamp, 
+      (unsigned long) entry.sequence, (nowMillis - entry.lastSeenMillis) / 1000ul, (fleet.isStale(entry, nowMillis) ? "true" : "false"), 
+      (unsigned int) entry.heard, (unsigned int) entry.missed
+    );
+    appendChunk(chunk, sizeof(chunk), length, line);
+  }
+  webServer.sendContent(chunk, length);
+  webServer.sendContent("]}");
+  webServer.sendContent(emptyString);
+  yield();
+}
+
+/**
+ * Adds text to a response being sent in chunks, first sending what is
+ * held should there not be room for it.
+ * 
+ * @param chunk The chunk being filled as char*.
+ * @param size The size of the chunk as size_t.
+ * @param length The length held, updated as text is added as size_t&.
+ * @param text The text to add as const char*.
+ */
+void appendChunk(char *chunk, size_t size, size_t &length, const char *text) {
+  size_t textLength = strlen(text);
+  if (length + textLength >= size) { // No room left; Send what's held...
+    webServer.sendContent(chunk, length);
+    length = 0;
+  }
+  if (textLength >= size) { // Won't ever fit; Send it as is...
+    webServer.sendContent(text, textLength);
+
+    return;
+  }
+  memcpy(&chunk[length], text, textLength);
+  length += textLength;
+}
+
+/**
+ * Registers a handler for the given URI with the web server such that
+ * the heap allocations it makes are recorded by the heap monitor and
+ * its requests and latency are recorded by the metrics.
+ * 
+ * @param uri The URI to handle, also the name recorded under as const char*.
+ * @param handler The handler as std::function<void()>.
+ */
+void onMeasured(const char *uri, std::function<void()> handler) {
+  webServer.on(uri, [uri, handler]() { 
+    uint32_t startMicros = micros();
+    lastRequestMillis = millis();
+    heapMonitor.measure(uri, handler); 
+    metrics.observeRequest(uri, micros() - startMicros);
+  });
 }
 
 /****************************************************
  * ADMIN PAGE
  * **************************************************
  * This function shows the admin page for the device.
+ * The page is static and fills in its form from the
+ * /admin/settings endpoint once loaded by the browser.
  */
 void endpointHandlerAdmin() {
   /* Ensure user authenticated */
-  if (!webServer.authenticate(settings.getAdminUser().c_str(), settings.getAdminPwd().c_str())) { // User not authenticated...
+  if (!isAdminAuthenticated()) { // User not authenticated...
     
     return webServer.requestAuthentication(DIGEST_AUTH, "AdminRealm", "Authentication failed!");
   }
   
-  String content = ADMIN_PAGE;
-
-  content.replace("${ssid}", settings.getSsid());
-  content.replace("${pwd}", settings.getPwd());
-  content.replace("${title}", settings.getTitle());
-  content.replace("${heading}", settings.getHeading());
-  content.replace("${adminuser}", settings.getAdminUser());
-  content.replace("${adminpwd}", settings.getAdminPwd());
-  if (settings.getIsCelsius()) { // Units are in Celsius...
-    content.replace("${unitcchecked}", "checked");
-    content.replace("${unitfchecked}", "");
-  } else { // Units are in Fahrenheit...
-    content.replace("${unitcchecked}", "");
-    content.replace("${unitfchecked}", "checked");
-  }
-  
   if (!handleAdminPageUpdates()) { // Client response not yet handled...
-    sendHtmlPageUsingTemplate(200, settings.getTitle(), "Device Settings", content);
+    sendWebAsset(WEB_ASSET_ADMIN_HTML);
   }
 }
 
+/**
+ * #### ADMIN-SETTINGS JSON ####
+ * This function handles an endpoint which sends the current
+ * device settings to the admin page in the form of JSON.
+*/
+void endpointHandlerAdminSettings() {
+  /* Ensure user authenticated */
+  if (!isAdminAuthenticated()) { // User not authenticated...
+    
+    return webServer.requestAuthentication(DIGEST_AUTH, "AdminRealm", "Authentication failed!");
+  }
+
+  String content;
+  content.reserve(1536);
+  content.concat(F("{\"fields\": ["));
+  bool isFirst = true;
+  for (size_t i = 0; i < Settings::getFieldCount(); i++) {
+    const SettingField &field = Settings::getField(i);
+    if (field.type == SETTING_INTERNAL) { // Not for the admin page...
+      continue;
+    }
+    if (!isFirst) { // Separate from the previous...
+      content.concat(F(", "));
+    }
+    isFirst = false;
+    content.concat(F("{\"name\": \""));
+    content.concat(field.name);
+    content.concat(F("\", \"label\": \""));
+    content.concat(field.label);
+    content.concat(F("\", \"group\": \""));
+    content.concat(field.group);
+    content.concat(F("\", \"type\": \""));
+    content.concat(
+      (field.type == SETTING_IPV4) ? F("ipv4") : (field.type == SETTING_CHOICE) ? F("choice") : (field.type == SETTING_NUMBER) ? F("number") : F("text")
+    );
+    content.concat(F("\", \"max\": "));
+    content.concat(field.size - 1);
+    if (field.options != nullptr) { // Choice field...
+      content.concat(F(", \"options\": \""));
+      content.concat(field.options);
+      content.concat('"');
+    }
+    content.concat(F(", \"value\": \""));
+    Utils::appendJsonEscaped(content, settings.getFieldValue(field));
+    content.concat(F("\"}"));
+  }
+  content.concat(F("]}"));
+
+  webServer.sendHeader(F("Cache-Control"), F("no-store"));
+  webServer.send(200, "application/json", content);
+  yield();
+}
+
+/**
+ * Used to determine if the client of the current request is allowed into the
+ * admin pages. A client holding a valid session cookie is let in right away,
+ * otherwise the client must pass the digest authentication after which it is
+ * issued a session cookie so it can skip the digest challenge for a while.
+ * 
+ * @return Returns true if the client is authenticated otherwise false as bool.
+ */
+bool isAdminAuthenticated() {
+  if (adminSession.isValid(webServer.header(HEADER_COOKIE), millis())) { // Has a valid session...
+
+    return true;
+  }
+  if (webServer.authenticate(settings.getAdminUser(), settings.getAdminPwd())) { // Passed digest auth...
+    webServer.sendHeader(F("Set-Cookie"), adminSession.issueCookie(millis()));
+
+    return true;
+  }
+
+  return false;
+}
+
+/**
+ * Used to add the name of a setting, as shown on the admin page, to a
+ * list of names separated by commas.
+ * 
+ * @param names The list to add to as String&.
+ * @param field The setting as const SettingField&.
+ */
+void appendFieldName(String &names, const SettingField &field) {
+  if (!names.isEmpty()) {
+    names.concat(F(", "));
+  }
+  names.concat(field.group);
+  names.concat(' ');
+  names.concat(field.label);
+}
+
 /**
  * Used to handle update requests as well as show a pages that 
- * indicate the results of the requested updates.
+ * indicate the results of the requested updates. Every value is
+ * checked before any is set, so a form with a value that isn't
+ * accepted changes nothing and gets a 400 naming what was wrong.
  * 
  * @return Returns true if the response to client was handles by this
  * function, otherwise returns false as bool.
  */
 bool handleAdminPageUpdates() {
-  /* Get Incoming Settings */
-  struct NonVolatileSettings example;
-  String ssid = webServer.arg("ssid");
-  String pwd = webServer.arg("pwd");
-  String title = webServer.arg("title");
-  String heading = webServer.arg("heading");
-  String units = webServer.arg("units");
-  String adminUser = webServer.arg("adminuser");
-  String adminPwd = webServer.arg("adminpwd");
+  if (webServer.args() == 0) { // Nothing submitted...
 
-  bool isUpdate = false;
-  bool needReboot = false;
+    return false;
+  }
 
-  /* Verify and Set SSID */
-  if (!ssid.isEmpty() && ssid.length() < sizeof(example.ssid)) { // Not empty and under size limit...
-    if (!settings.getSsid().equals(ssid)) { // Incoming is different than existing...
-      isUpdate = true;
-      needReboot = true;
-      settings.setSsid(ssid.c_str());
-    }
+  /* Current Network Settings In Case Of Rollback */
+  if (!networkTrial.isPending && !networkTrial.isActive) { // Current settings are known good...
+    settings.getSnapshot(networkTrial.previous);
   }
-  /* Verify and Set PWD */
-  if (!pwd.isEmpty() && pwd.length() < sizeof(example.pwd)) { // Not empty and under size limit...
-    if (!settings.getPwd().equals(pwd)) { // Incoming is different than existing...
-      isUpdate = true;
-      needReboot = true;
-      settings.setPwd(pwd.c_str());
+
+  /* Verify Every Known Field Before Any Is Set; Nothing changes if one is rejected */
+  String rejected;
+  for (int i = 0; i < webServer.args(); i++) {
+    const SettingField *field = Settings::findField(webServer.argName(i).c_str());
+    const String &value = webServer.arg(i);
+    if (field != nullptr && settings.checkField(*field, value.c_str(), value.length()) == SETTING_INVALID) { // Rejected...
+      appendFieldName(rejected, *field);
     }
   }
-  /* Verify and Set Title */
-  if (!title.isEmpty() && title.length() < sizeof(example.title)) { // Not empty and under size limit...
-    if (!settings.getTitle().equals(title)) { // Incoming is different than existing...
-      isUpdate = true;
-      settings.setTitle(title.c_str());
-    }
+  const SettingField *missing[2];
+  size_t missingCount = settings.checkStaticAddressing(
+    (webServer.hasArg(F("staticip")) ? webServer.arg(F("staticip")).c_str() : nullptr),
+    (webServer.hasArg(F("staticgateway")) ? webServer.arg(F("staticgateway")).c_str() : nullptr),
+    (webServer.hasArg(F("staticsubnet")) ? webServer.arg(F("staticsubnet")).c_str() : nullptr),
+    missing
+  );
+  for (size_t i = 0; i < missingCount; i++) { // Static IP needs these too...
+    appendFieldName(rejected, *missing[i]);
   }
-  /* Verify and Set Heading */
-  if (!heading.isEmpty() && heading.length() < sizeof(example.heading)) { // Not empty and under size limit...
-    if (!settings.getHeading().equals(heading)) { // Incoming is different than existing...
-      isUpdate = true;
-      settings.setHeading(heading.c_str());
-    }
+  if (!rejected.isEmpty()) {
+    String content = F("<h3>Settings Not Updated!</h3><h4>These settings were not accepted: ");
+    content.concat(rejected);
+    content.concat(F("</h4><a href='/admin'><h4>Back to Admin Page</h4></a>"));
+    sendHtmlPageUsingTemplate(400, settings.getTitle(), "400 - Bad Request", content);
+
+    return true;
   }
-  /* Verify and Set isCelsius */
-  if (!units.isEmpty()) { // Not empty...
-    if (
-      (
-        units.equalsIgnoreCase("fahrenheit") 
-        || units.equalsIgnoreCase("f")
-      ) && settings.getIsCelsius() == true
-    ) { // Incoming is understood and different than existing...
-      isUpdate = true;
-      settings.setIsCelsius(false);
-    } else if (
-      (
-        units.equalsIgnoreCase("celsius")
-        || units.equalsIgnoreCase("c")
-      ) && settings.getIsCelsius() == false
-    ) { // Incoming is understood and different than existing...
-      isUpdate = true;
-      settings.setIsCelsius(true);
+
+  /* Set Each Known Field; Values are copied in place */
+  bool isUpdate = false;
+  uint8_t changeFlags = 0;
+  for (int i = 0; i < webServer.args(); i++) {
+    const SettingField *field = Settings::findField(webServer.argName(i).c_str());
+    if (field == nullptr) { // Not a setting...
+      continue;
     }
-  }
-  /* Verify and Set AdminUser */
-  if (!adminUser.isEmpty() && adminUser.length() < sizeof(example.adminUser)) { // Not empty and under size limit...
-    if (!settings.getAdminUser().equals(adminUser)) { // Incoming is different than existing...
+    const String &value = webServer.arg(i);
+    if (settings.updateField(*field, value.c_str(), value.length()) == SETTING_CHANGED) { // Different than existing...
       isUpdate = true;
-      settings.setAdminUser(adminUser.c_str());
+      changeFlags |= field->flags;
     }
   }
-  /* Verify and Set AdminPwd */
-  if (!adminPwd.isEmpty() && adminPwd.length() < sizeof(example.adminPwd)) { // Not empty and under size limit...
-    if (!settings.getAdminPwd().equals(adminPwd)) { // Incoming is different than existing...
-      isUpdate = true;
-      settings.setAdminPwd(adminPwd.c_str());
-    }
+  if (settings.settleStaticAddressing() == SETTING_CHANGED) { // Back to DHCP; Rest of the static addressing cleared...
+    isUpdate = true;
+    changeFlags |= SETTING_NETWORK;
+  }
+  if ((changeFlags & SETTING_NEW_NETWORK) != 0) { // Remembered access point belongs to the old network...
+    settings.setLastConnection("", 0, "", "", "", "");
   }
 
   /* Persist Data If Updated */
   if (isUpdate) {
     if (settings.saveSettings()) { // Successful...
-      if (needReboot) { // Needs to reboot...
-        String content = "<h3>Settings update Successful!</h3><h4>Device will reboot now...</h4>";
+      if ((changeFlags & SETTING_LOGIN) != 0) { // Sessions of the old login are no longer welcome...
+        adminSession.revokeAll();
+      }
+      if ((changeFlags & SETTING_TIME_SOURCE) != 0) { // Sync with the new server...
+        timeKeeper.begin(settings.getNtpServer());
+      }
+      if ((changeFlags & SETTING_MQTT) != 0) { // Connect to the new broker...
+        doStartMqtt();
+      }
+      if ((changeFlags & SETTING_POWER) != 0) { // Sleep differently...
+        doApplyPowerSettings();
+      }
+      if ((changeFlags & SETTING_HUB) != 0) { // Start or stop listening...
+        doStartHub();
+      }
+      if ((changeFlags & SETTING_NETWORK) != 0) { // Needs to rejoin the network...
+        networkTrial.isPending = true;
+        networkTrial.sinceMillis = millis();
+
+        String content = F(
+          "<h3>Settings update Successful!</h3>"
+          "<h4>Device will now join the network using the new settings. "
+          "If that doesn't work out within a minute the previous settings will be restored.</h4>"
+        );
         sendHtmlPageUsingTemplate(200, settings.getTitle(), "Update Result", content);
-        yield();
-        delay(5000);
 
-        ESP.restart();
-      } else { // No reboot needed; Send to home page...
+        return true;
+      } else { // No reconnect needed; Send to home page...
         String content = "<h3>Settings update Successful!</h3><a href='/'><h4>Home Page</h4></a>";
         sendHtmlPageUsingTemplate(200, settings.getTitle(), "Update Result", content);
 
@@ -509,32 +1165,91 @@ void sendHtmlPageUsingTemplate(int code, String title, String heading, String &c
   yield();
 }
 
+/**
+ * Sends one of the static web assets which were embedded into the
+ * firmware at build time. If the client accepts gzip encoding then the
+ * pre-compressed bytes are sent as is, otherwise the plain bytes are sent.
+ * Assets are sent with long lived cache headers and an ETag, so when the
+ * client already has the current asset only a bodiless 304 is sent.
+ * 
+ * @param asset The asset to send as WebAsset.
+ */
+void sendWebAsset(const WebAsset &asset) {
+  webServer.sendHeader(F("ETag"), asset.etag);
+  webServer.sendHeader(F("Cache-Control"), F("max-age=604800"));
+  webServer.sendHeader(F("Vary"), F("Accept-Encoding"));
+  if (webServer.header(HEADER_IF_NONE_MATCH).equals(asset.etag)) { // Client's copy is current...
+    webServer.send(304);
+
+    return;
+  }
+
+  if (clientAcceptsGzip()) { // Send compressed...
+    webServer.sendHeader(F("Content-Encoding"), F("gzip"));
+    webServer.send_P(200, asset.mimeType, (PGM_P) asset.gzData, asset.gzLength);
+  } else { // Send plain...
+    webServer.send_P(200, asset.mimeType, (PGM_P) asset.rawData, asset.rawLength);
+  }
+  yield();
+}
+
+/**
+ * Used to determine if the client of the current request is able to
+ * handle a gzip encoded response body.
+ * 
+ * @return Returns true if gzip is accepted otherwise false as bool.
+ */
+bool clientAcceptsGzip() {
+
+  return (strstr(webServer.header(HEADER_ACCEPT_ENCODING).c_str(), "gzip") != nullptr);
+}
+
+/**
+ * Called by the web server for every incoming request before its headers
+ * are parsed. Requests from clients which exceed their rate get a 429 and
+ * requests beyond what the device as a whole is willing to handle get a 503.
+ * Either way a short canned response is written directly to the client so
+ * no handler or page template is ever run for them.
+ * 
+ * @param client The client making the request as WiFiClient*.
+ * 
+ * @return Returns how the web server should proceed with the request as ClientFuture.
+ */
+BearSSL::ESP8266WebServerSecure::ClientFuture admitRequest(WiFiClient *client) {
+  switch (rateLimiter.admit((uint32_t) client->remoteIP(), millis())) {
+    case RateLimiter::CLIENT_RATE_EXCEEDED:
+      client->print(F("HTTP/1.1 429 Too Many Requests\r\nRetry-After: 1\r\nContent-Length: 0\r\nConnection: close\r\n\r\n"));
+      
+      return BearSSL::ESP8266WebServerSecure::CLIENT_MUST_STOP;
+    case RateLimiter::SERVER_BUSY:
+      client->print(F("HTTP/1.1 503 Service Unavailable\r\nRetry-After: 1\r\nContent-Length: 0\r\nConnection: close\r\n\r\n"));
+      
+      return BearSSL::ESP8266WebServerSecure::CLIENT_MUST_STOP;
+    default:
+      
+      return BearSSL::ESP8266WebServerSecure::CLIENT_REQUEST_CAN_CONTINUE;
+  }
+}
+
 /**
  * Function handles flashing of the LED for signaling the given IP Address
  * entirely or simply its last octet as determined by the passed boolean 
  * refered to as quick. If quick is TRUE then last Octet is signaled, if 
  * FALSE then entire IP is signaled.
  */
-void signalIpAddress(String ipAddress, bool quick) {
-  if (!quick) { // Whole IP Requested...
-    int octet[3];
-    
-    int index = ipAddress.indexOf('.');
-    int index2 = ipAddress.indexOf('.', index + 1);
-    int index3 = ipAddress.lastIndexOf('.');
-    octet[0] = ipAddress.substring(0, index).toInt();
-    octet[1] = ipAddress.substring(index + 1, index2).toInt();
-    octet[2] = ipAddress.substring(index2 + 1, index3).toInt();
+void signalIpAddress(const char *ipAddress, bool quick) {
+  uint32_t address = 0;
+  IpUtils::parseIPv4(ipAddress, strlen(ipAddress), address);
 
+  if (!quick) { // Whole IP Requested...
     for (int i = 0; i < 3; i++) { // Iterate first 3 octets and signal...
-      displayOctet(octet[i]);
+      displayOctet(IpUtils::getOctet(address, i));
       displayNextOctetIndicator();
     }
   }
 
   // Signals 4th octet regardless of quick or not
-  int fourth = ipAddress.substring(ipAddress.lastIndexOf('.') + 1).toInt();
-  displayOctet(fourth);
+  displayOctet(IpUtils::getOctet(address, 3));
   displayDone(); // Fast blink...
 } 
 
@@ -612,31 +1327,634 @@ void displayDone() {
   }
 }
 
+/**
+ * Checks for a single character command sent over serial. Sending
+ * 'p' prints the loop profiler's report.
+ */
+void checkSerialCommand() {
+  if (Serial.available() <= 0) { // Nothing sent...
+
+    return;
+  }
+  if (Serial.read() == 'p') { // Profiler report...
+    loopProfiler.printReport(Serial);
+  }
+}
+
+/**
+ * Takes a reading from the sensor when one is due. The very first
+ * call always takes a reading, after that readings are taken every
+ * 30 seconds, or every second until a first good reading is had.
+ */
 void doReadSensorData() {
+  static bool isFirstCall = true;
   static ulong lastReadMillis = 0ul;
-  if ((millis() < lastReadMillis ? (__LONG_MAX__ - lastReadMillis + millis()) : (millis() - lastReadMillis)) >= 30000ul) {
-    // Time to do routine with accounting for rollover
-    lastTempRead = tempSensor.readTemperature();
-    lastHumidityRead = tempSensor.readHumidity();
+  ulong interval = (hasReading ? 30000ul : 1000ul);
+  if (isFirstCall || (millis() - lastReadMillis) >= interval) { // Time to do routine; Unsigned math handles rollover...
+    isFirstCall = false;
     lastReadMillis = millis();
+    if (takeReading()) { // Good reading...
+      if (settings.getIsBroadcastOn() && !network.isOnline()) { // Can't be broadcast; Hold on to it...
+        backlog.push({lastReadTimestamp, (uint32_t) readCount, lastTempRead, lastHumidityRead});
+      }
+      if (settings.isMqttSet()) { // Published from doMqtt()...
+        mqttBacklog.push({lastReadTimestamp, (uint32_t) readCount, lastTempRead, lastHumidityRead});
+      }
+      if (settings.getIsHubMode()) { // The hub is part of its own fleet...
+        fleet.record(deviceId, (uint32_t) network.getIpAddress(), {lastReadTimestamp, (uint32_t) readCount, lastTempRead, lastHumidityRead}, millis());
+      }
+      power.noteSample();
+    }
+  }
+  power.wakeBy(lastReadMillis + (hasReading ? 30000ul : 1000ul));
+}
+
+/**
+ * Takes a single reading from the sensor. A good reading replaces the
+ * last values and is counted; A failed one keeps the last values. An
+ * alert is raised when the sensor starts or stops failing.
+ * 
+ * @return Returns true if a good reading was taken otherwise false as bool.
+ */
+bool takeReading() {
+  // One conversion serves both values...
+  uint32_t startMicros = micros();
+  float temp = tempSensor.readTemperature(AHT10_FORCE_READ_DATA);
+  float humidity = tempSensor.readHumidity(AHT10_USE_READ_DATA);
+  bool isOk = (temp != AHT10_ERROR && humidity != AHT10_ERROR);
+  metrics.observeSensorRead(isOk, micros() - startMicros);
+  if (!isOk) { // Sensor didn't answer; Keep the last good values...
+    if (!isSensorFailing) { // Just started failing...
+      isSensorFailing = true;
+      mqttTopics.pendingAlert = "sensor_failed";
+    }
+
+    return false;
+  }
+  if (isSensorFailing) { // Answering again...
+    isSensorFailing = false;
+    mqttTopics.pendingAlert = "sensor_recovered";
+  }
+  lastTempRead = temp;
+  lastHumidityRead = humidity;
+  lastReadTimestamp = timeKeeper.getEpochMillis();
+  hasReading = true;
+  readCount++;
+
+  return true;
+}
+
+/**
+ * Takes note of each new connection to the network. The first one
+ * completes the boot timings, and the access point and lease of
+ * each one are saved (only when they differ from what's saved) so
+ * the next connection can be made directly.
+ */
+void doRememberConnection() {
+  static unsigned long lastConnectCount = 0ul;
+  if (network.getConnectCount() == lastConnectCount) { // Nothing new...
+
+    return;
+  }
+  lastConnectCount = network.getConnectCount();
+
+  if (bootTimings.ipAcquired == 0ul) { // First connection since boot...
+    bootTimings.associated = network.getAssociatedMillis();
+    bootTimings.ipAcquired = network.getGotIpMillis();
+  }
+
+  const uint8_t *bssid = network.getBssid();
+  char bssidText[18];
+  snprintf(
+    bssidText, sizeof(bssidText), "%02X:%02X:%02X:%02X:%02X:%02X", 
+    bssid[0], bssid[1], bssid[2], bssid[3], bssid[4], bssid[5]
+  );
+  char lastIp[IPV4_TEXT_SIZE];
+  char lastGateway[IPV4_TEXT_SIZE];
+  char lastSubnet[IPV4_TEXT_SIZE];
+  char lastDns[IPV4_TEXT_SIZE];
+  IpUtils::formatIPv4(WiFi.localIP(), lastIp, sizeof(lastIp));
+  IpUtils::formatIPv4(WiFi.gatewayIP(), lastGateway, sizeof(lastGateway));
+  IpUtils::formatIPv4(WiFi.subnetMask(), lastSubnet, sizeof(lastSubnet));
+  IpUtils::formatIPv4(WiFi.dnsIP(), lastDns, sizeof(lastDns));
+  if (
+    strcmp(settings.getLastBssid(), bssidText) != 0 
+    || settings.getLastChannel() != network.getChannel()
+    || strcmp(lastIp, settings.getLastIp()) != 0
+    || strcmp(lastGateway, settings.getLastGateway()) != 0
+    || strcmp(lastSubnet, settings.getLastSubnet()) != 0
+    || strcmp(lastDns, settings.getLastDns()) != 0
+  ) { // Differs from what's saved...
+    settings.setLastConnection(bssidText, network.getChannel(), lastIp, lastGateway, lastSubnet, lastDns);
+    settings.saveSettings();
+  }
+}
+
+/**
+ * Applies changed network settings without a reboot. Once the update
+ * result page has had time to reach the client the network is rejoined
+ * using the new settings, which then have a minute to get the device
+ * online. If they don't, the previous settings are restored, saved and
+ * the network is rejoined using them. The web server and sensor keep on
+ * running throughout.
+ */
+void doNetworkTrial() {
+  if (networkTrial.isPending) { // Change waiting to be applied...
+    if ((millis() - networkTrial.sinceMillis) >= NET_CHANGE_DELAY_MILLIS) { // Result page delivered...
+      networkTrial.isPending = false;
+      networkTrial.isActive = true;
+      networkTrial.sinceMillis = millis();
+      doJoinNetwork();
+    }
+
+    return;
+  }
+  if (!networkTrial.isActive) { // Nothing on trial...
+
+    return;
+  }
+
+  if (network.isOnline()) { // New settings work...
+    networkTrial.isActive = false;
+  } else if ((millis() - networkTrial.sinceMillis) >= NET_TRIAL_MILLIS) { // New settings failed; Roll back...
+    networkTrial.isActive = false;
+    settings.restoreFields(networkTrial.previous, SETTING_NETWORK);
+    settings.saveSettings();
+    doJoinNetwork();
   }
 }
 
 void doBroadcast() {
   static ulong lastBCastMillis = 0ul;
-  if ((millis() < lastBCastMillis ? (__LONG_MAX__ - lastBCastMillis + millis()) : (millis() - lastBCastMillis)) >= 10000UL) { // Broadcast every 10 seconds...
-    udpService.begin(settings.getBcastPort());
-    udpService.beginPacket(bcastAddress, settings.getBcastPort());
-    udpService.printf(
-      "TempBuddy-Sensor::%s::%s::T_%f::H_%f", 
-      ipAddr.c_str(), 
-      deviceId.c_str(), 
-      lastTempRead,
-      lastHumidityRead
-    );
-    udpService.endPacket();
-    udpService.stop();
+  static unsigned long lastBCastReadCount = 0ul;
+  if (!settings.getIsBroadcastOn() || !network.isOnline() || !hasReading) { // Turned off, nowhere to send it or nothing to send...
+    
+    return;
+  }
+  if (
+    readCount != lastBCastReadCount 
+    || (millis() - lastBCastMillis) >= 10000UL
+  ) { // New reading or 10 seconds since last broadcast; Unsigned math handles rollover...
+    bool isNewReading = (readCount != lastBCastReadCount);
+    lastBCastReadCount = readCount;
+    QueuedReading reading = {lastReadTimestamp, (uint32_t) readCount, lastTempRead, lastHumidityRead};
+    char packet[BROADCAST_LIVE_PACKET_SIZE];
+    size_t length = BroadcastPacket::formatLive(packet, sizeof(packet), ipAddr, deviceId, reading);
+    if (sendBroadcast(packet, length)) { // Out live; No need to forward it should it have been queued while offline...
+      backlog.dropNewest(reading.sequence);
+      metrics.countBroadcast();
+    } else if (isNewReading) { // Never went out; Hold on to it...
+      backlog.push(reading);
+    }
 
     lastBCastMillis = millis();
   }
-}
\ No newline at end of file
+  power.wakeBy(lastBCastMillis + 10000UL);
+}
+
+/**
+ * Forwards readings held while the device was offline once it is back
+ * online. They go out oldest first, a batch at a time, with at least
+ * BACKLOG_BATCH_MILLIS between batches so a long backlog doesn't flood
+ * the network. A batch that fails to go out stays queued for the next try.
+ */
+void doForwardBacklog() {
+  if (!settings.getIsBroadcastOn() || !network.isOnline() || backlog.getCount() == 0) { // Turned off, nowhere to send it or nothing to send...
+
+    return;
+  }
+  power.wakeBy(millis() + BACKLOG_BATCH_MILLIS);
+  if (!backlog.isBatchDue(millis())) { // Not time yet...
+
+    return;
+  }
+  QueuedReading batch[READING_BATCH_SIZE];
+  uint8_t batchCount = backlog.peekBatch(batch);
+
+  char packet[BROADCAST_BACKLOG_PACKET_SIZE];
+  size_t length = BroadcastPacket::formatBacklog(packet, sizeof(packet), ipAddr, deviceId, batch, batchCount);
+  bool isSent = sendBroadcast(packet, length);
+  backlog.markBatchSent((isSent ? batchCount : 0), millis());
+}
+
+/**
+ * Sends a packet to the broadcast port. The socket is opened on the
+ * first send, on a port of the stack's choosing so the broadcasts of
+ * other units aren't queued up on it, and is kept open from then on;
+ * Opening and closing it for each packet cost an allocation each time.
+ *
+ * @param packet The packet to send as const char*.
+ * @param length The length of the packet; 0 sends nothing as size_t.
+ *
+ * @return Returns true if sent otherwise false as bool.
+ */
+bool sendBroadcast(const char *packet, size_t length) {
+  static bool isOpen = false;
+  if (length == 0) { // Didn't fit its buffer...
+
+    return false;
+  }
+  if (!isOpen) { // First send...
+    isOpen = (udpService.begin(0) == 1);
+  }
+  if (!isOpen || !udpService.beginPacket(bcastAddress, settings.getBcastPort())) { // No socket to send from...
+
+    return false;
+  }
+  udpService.write((const uint8_t*) packet, length);
+
+  return (udpService.endPacket() == 1);
+}
+
+/**
+ * Points the MQTT client at the broker in the settings, or turns it
+ * off when none is set. Topics are the topic prefix followed by the
+ * Device ID and then status, readings or alerts. The status topic is
+ * retained and set to offline by the broker, as the last will, should
+ * the device drop off.
+ */
+void doStartMqtt() {
+  snprintf(mqttTopics.status, sizeof(mqttTopics.status), "%s/%s/status", settings.getMqttTopic(), deviceId);
+  snprintf(mqttTopics.readings, sizeof(mqttTopics.readings), "%s/%s/readings", settings.getMqttTopic(), deviceId);
+  snprintf(mqttTopics.alerts, sizeof(mqttTopics.alerts), "%s/%s/alerts", settings.getMqttTopic(), deviceId);
+  snprintf(mqttTopics.willMessage, sizeof(mqttTopics.willMessage), "{\"state\": \"offline\", \"device_id\": \"%s\"}", deviceId);
+  mqttTopics.isStatusDue = false;
+  mqtt.configure(
+    settings.getMqttHost(), 
+    settings.getMqttPort(), 
+    settings.getHostname(), 
+    settings.getMqttUser(), 
+    settings.getMqttPwd(), 
+    mqttTopics.status, 
+    mqttTopics.willMessage
+  );
+}
+
+/**
+ * Advertises the device over mDNS (DNS-SD) as _tempbuddy._tcp and
+ * _https._tcp, so it can be found by name rather than by listening for
+ * the broadcast. The responder only speaks when asked, apart from the
+ * announcements mDNS makes as the device joins a network. The TXT record
+ * of _tempbuddy._tcp carries the device ID and firmware version, and
+ * the latest reading is added each time the record is sent.
+ */
+void doStartMdns() {
+  if (!MDNS.begin(settings.getHostname())) { // Responder didn't start...
+
+    return;
+  }
+  MDNSResponder::hMDNSService httpsService = MDNS.addService(nullptr, "https", "tcp", 443);
+  MDNS.addServiceTxt(httpsService, "path", "/");
+
+  mdnsService = MDNS.addService(nullptr, "tempbuddy", "tcp", 443);
+  MDNS.addServiceTxt(mdnsService, "id", deviceId);
+  MDNS.addServiceTxt(mdnsService, "fw", FIRMWARE_VERSION);
+  MDNS.addServiceTxt(mdnsService, "api", "/api/info");
+  MDNS.setDynamicServiceTxtCallback([](const MDNSResponder::hMDNSService service) {
+    if (service != mdnsService || !hasReading) { // Not ours or nothing to add...
+
+      return;
+    }
+    char value[UINT64_TEXT_SIZE];
+    snprintf(value, sizeof(value), "%.2f", lastTempRead);
+    MDNS.addDynamicServiceTxt(service, "t", value);
+    snprintf(value, sizeof(value), "%.2f", lastHumidityRead);
+    MDNS.addDynamicServiceTxt(service, "h", value);
+    Utils::formatUint64(lastReadTimestamp, value, sizeof(value));
+    MDNS.addDynamicServiceTxt(service, "ts", value);
+    snprintf(value, sizeof(value), "%lu", readCount);
+    MDNS.addDynamicServiceTxt(service, "seq", value);
+  });
+}
+
+/**
+ * Starts listening on the broadcast port when in hub mode, or stops
+ * listening when not, so the readings broadcast by other units can be
+ * collected into the fleet table.
+ */
+void doStartHub() {
+  if (settings.getIsHubMode()) { // Collect the fleet...
+    hubService.begin(settings.getBcastPort());
+  } else { // Not a hub...
+    hubService.stop();
+  }
+}
+
+/**
+ * Takes the packets waiting on the hub listener and adds the readings
+ * in them to the fleet table. Each packet is read into the same static
+ * buffer and parsed in place, so a burst from a large fleet costs no
+ * allocations. At most HUB_MAX_PACKETS_PER_PASS are taken each pass so
+ * the web server isn't held up; The rest wait in the socket for the
+ * next pass, which comes straight away.
+ */
+void doHub() {
+  if (!settings.getIsHubMode()) { // Not a hub...
+
+    return;
+  }
+  static char packet[FLEET_MAX_PACKET_SIZE];
+  uint8_t taken = 0;
+  while (taken < HUB_MAX_PACKETS_PER_PASS && hubService.parsePacket() > 0) {
+    int length = hubService.read(packet, sizeof(packet));
+    if (length > 0) { // Something to parse; Longer packets are cut short...
+      fleet.handlePacket(packet, (size_t) length, (uint32_t) hubService.remoteIP(), millis());
+    }
+    hubService.flush();
+    taken++;
+  }
+  fleet.expire(millis());
+  power.wakeBy(millis() + (taken == HUB_MAX_PACKETS_PER_PASS ? 0ul : HUB_POLL_MILLIS));
+}
+
+/**
+ * Looks after publishing over MQTT. After each connect the retained
+ * status is published, then any alert, then readings not yet handed
+ * to the broker. Readings go out oldest first, several to a message
+ * when catching up, with at least MQTT_BATCH_MILLIS between messages.
+ * Nothing here waits on the broker; anything not taken is tried again
+ * on a later pass.
+ */
+void doMqtt() {
+  mqtt.loop(millis());
+  if (!mqtt.isConnected()) { // Nothing can be published...
+
+    return;
+  }
+  if (mqttTopics.isStatusDue || mqttTopics.pendingAlert != nullptr || mqttBacklog.getCount() > 0) { // More to publish soon...
+    power.wakeBy(millis() + MQTT_BATCH_MILLIS);
+  }
+  uint8_t qos = (settings.getIsMqttQos1() ? 1 : 0);
+  char payload[MQTT_MAX_PACKET_SIZE - MQTT_TOPIC_SIZE - 8];
+
+  if (mqtt.getConnectCount() != mqttTopics.statusConnectCount) { // New connection...
+    mqttTopics.statusConnectCount = mqtt.getConnectCount();
+    mqttTopics.isStatusDue = true;
+  }
+  if (mqttTopics.isStatusDue && mqtt.canPublish(1)) { // Announce...
+    int length = (isBatteryWake 
+      ? snprintf(
+        payload, sizeof(payload), 
+        "{\"state\": \"battery\", \"device_id\": \"%s\", \"ip\": \"%s\", \"firmware\": \"%s\", "
+        "\"wakes\": %lu, \"last_wake_ms\": %u, \"failed_wakes\": %u, \"sleep_secs\": %lu}", 
+        deviceId, ipAddr, FIRMWARE_VERSION, 
+        (unsigned long) wakeState.getWakeCount(), wakeState.getLastTimings().asleep, 
+        wakeState.getFailedWakes(), (unsigned long) settings.getBatterySleepSecs()
+      )
+      : snprintf(
+        payload, sizeof(payload), 
+        "{\"state\": \"online\", \"device_id\": \"%s\", \"ip\": \"%s\", \"firmware\": \"%s\"}", 
+        deviceId, ipAddr, FIRMWARE_VERSION
+      )
+    );
+    if (mqtt.publish(mqttTopics.status, payload, length, 1, true)) { // Taken...
+      mqttTopics.isStatusDue = false;
+    }
+  }
+  if (mqttTopics.pendingAlert != nullptr && mqtt.canPublish(1)) { // Alert waiting...
+    int length = snprintf(
+      payload, sizeof(payload), "{\"alert\": \"%s\", \"device_id\": \"%s\"}", mqttTopics.pendingAlert, deviceId
+    );
+    if (mqtt.publish(mqttTopics.alerts, payload, length, 1, false)) { // Taken...
+      mqttTopics.pendingAlert = nullptr;
+    }
+  }
+  if (!mqttBacklog.isBatchDue(millis()) || !mqtt.canPublish(qos)) { // Nothing to send or not now...
+
+    return;
+  }
+
+  QueuedReading batch[READING_BATCH_SIZE];
+  uint8_t batchCount = mqttBacklog.peekBatch(batch);
+  int length = snprintf(payload, sizeof(payload), "{\"device_id\": \"%s\", \"readings\": [", deviceId);
+  uint8_t sentCount = 0;
+  for (; sentCount < batchCount && (sizeof(payload) - length) > 80; sentCount++) { // Room for another and the close...
+    const QueuedReading &reading = batch[sentCount];
+    char timestamp[UINT64_TEXT_SIZE];
+    Utils::formatUint64(reading.timestamp, timestamp, sizeof(timestamp));
+    length += snprintf(
+      &payload[length], sizeof(payload) - length, 
+      "%s{\"seq\":%lu,\"t\":%.2f,\"h\":%.2f,\"ts\":%s}", 
+      ((sentCount > 0) ? "," : ""), (unsigned long) reading.sequence, reading.temperature, reading.humidity, timestamp
+    );
+  }
+  length += snprintf(&payload[length], sizeof(payload) - length, "]}");
+  bool isTaken = mqtt.publish(mqttTopics.readings, payload, length, qos, false);
+  mqttBacklog.markBatchSent((isTaken ? sentCount : 0), millis());
+}
+
+/**
+ * Applies the idle sleep chosen on the admin page. Modem sleep turns
+ * the radio off between beacons from the access point, while light
+ * sleep also pauses the CPU, saving more but answering a little slower.
+ */
+void doApplyPowerSettings() {
+  bool isLightSleep = settings.getIsLightSleep();
+  WiFi.setSleepMode((isLightSleep ? WIFI_LIGHT_SLEEP : WIFI_MODEM_SLEEP), (isLightSleep ? 3 : 0));
+  power.setLightSleep(isLightSleep);
+}
+
+/**
+ * Runs the CPU at 160MHz while a web client is waiting or being served,
+ * where the TLS handshake is the heaviest work the device does, and
+ * at 80MHz the rest of the time.
+ */
+void doManageCpuSpeed() {
+  if (webServer.getServer().hasClient()) { // Handshake coming up...
+    power.noteBusy(millis());
+  }
+  uint8_t wantedMHz = (power.isBoostWanted(millis()) ? SYS_CPU_160MHZ : SYS_CPU_80MHZ);
+  if (ESP.getCpuFreqMHz() != wantedMHz) { // Switch...
+    system_update_cpu_freq(wantedMHz);
+  }
+}
+
+/**
+ * Sleeps until the next task is due, as worked out by the power
+ * manager from what the tasks said during the pass. The sleep ends
+ * early when a web client connects, the MQTT broker sends something
+ * or the button is pressed. How the pass was spent is recorded for
+ * the duty cycle and the energy estimate.
+ *
+ * @param passStartMicros The micros() at the start of the pass as uint32_t.
+ */
+void doSleep(uint32_t passStartMicros) {
+  uint32_t sleepMillis = power.getSleepMillis(millis());
+  uint32_t sleepStartMicros = micros();
+  if (sleepMillis > 0) { // Nothing due yet...
+    esp_delay(sleepMillis, []() { return !isWakeWanted(); }, POWER_POLL_MILLIS);
+  } else { // Straight on to the next pass...
+    yield();
+  }
+  power.record(sleepStartMicros - passStartMicros, micros() - sleepStartMicros, ESP.getCpuFreqMHz());
+}
+
+/**
+ * Used to tell if something needs the loop before the sleep is over.
+ *
+ * @return Returns true to wake otherwise false as bool.
+ */
+bool isWakeWanted() {
+
+  return (webServer.getServer().hasClient() || mqttSocket.available() > 0 || digitalRead(RESTORE_PIN) == HIGH);
+}
+
+/**
+ * Runs a whole battery mode wake, from just after the settings are
+ * loaded through to deep sleep, in place of the usual setup and loop.
+ * The join starts straight away, using the access point and lease of
+ * the last good connection, and the sensor is read while that is under
+ * way. Once online the reading is broadcast, along with any readings
+ * earlier wakes couldn't deliver, and published over MQTT if set. The
+ * web server is never started. Whatever happens the wake is cut off
+ * after BATTERY_AWAKE_LIMIT_MILLIS, and anything not delivered waits in
+ * RTC memory for the next wake.
+ */
+void doBatteryWake() {
+  WakeTimings timings = {0, 0, 0, 0, 0};
+  readCount = wakeState.getSequence();
+  isSensorFailing = wakeState.getIsSensorFailing();
+  timeKeeper.resume(wakeState.getEpochMillisAtWake());
+
+  doJoinNetwork();
+  timeKeeper.begin(settings.getNtpServer());
+  doStartMqtt();
+  doStartAHT10();
+  bool isNewReading = takeReading();
+  if (isNewReading) { // Keep it until it's delivered...
+    wakeState.addReading({lastReadTimestamp, (uint32_t) readCount, lastTempRead, lastHumidityRead});
+  }
+  timings.sensorReady = toTiming(millis());
+
+  /* Queue What Earlier Wakes Couldn't Deliver; The New Reading Goes Out Live */
+  uint8_t historyCount = wakeState.getHistoryCount();
+  for (uint8_t i = historyCount - wakeState.getUnsentCount(); i < historyCount; i++) {
+    const QueuedReading &reading = wakeState.getReading(i);
+    if (settings.getIsBroadcastOn() && (!isNewReading || i != (historyCount - 1))) { // Not the live one...
+      backlog.push(reading);
+    }
+    if (settings.isMqttSet()) { // Published from doMqtt()...
+      mqttBacklog.push(reading);
+    }
+  }
+
+  /* Send It All, Then Sleep */
+  bool isBroadcast = (!hasReading || !settings.getIsBroadcastOn()); // Nothing to broadcast live
+  bool isDelivered = false;
+  while (millis() < BATTERY_AWAKE_LIMIT_MILLIS && !isDelivered) {
+    if (network.update(millis())) { // Addressing changed...
+      IpUtils::formatIPv4(network.getIpAddress(), ipAddr, sizeof(ipAddr));
+      bcastAddress = network.getBcastAddress();
+    }
+    if (network.isOnline()) { // Can send...
+      doRememberConnection();
+      if (!isBroadcast) { // Live reading first...
+        doBroadcast();
+        isBroadcast = true;
+      }
+      doForwardBacklog();
+      doMqtt();
+      isDelivered = (backlog.getCount() == 0 && isMqttDone());
+    }
+    delay(BATTERY_POLL_MILLIS); // Lets the WiFi stack run
+  }
+  timings.associated = toTiming(bootTimings.associated);
+  timings.ipAcquired = toTiming(bootTimings.ipAcquired);
+  if (isDelivered) { // All out...
+    timings.delivered = toTiming(millis());
+  }
+
+  /* Hold On To Anything Not Delivered; Queues Drain Oldest First So These Are the Newest */
+  uint16_t udpUnsent = backlog.getCount() + (isBroadcast ? 0 : 1);
+  uint16_t mqttUnsent = (settings.isMqttSet() ? mqttBacklog.getCount() : 0);
+  wakeState.setUnsentCount((uint8_t) min(max(udpUnsent, mqttUnsent), (uint16_t) WAKE_HISTORY_SIZE));
+  if (network.isOnline() && !isLeaseReused && !settings.isStaticIpSet()) { // DHCP just handed out a lease...
+    wakeState.noteFreshLease();
+  } else if (!network.isOnline() && isLeaseReused) { // Cached lease may be why; Use DHCP next time...
+    wakeState.forgetLease();
+  }
+
+  doDeepSleep(timings, isDelivered);
+}
+
+/**
+ * Sends the device into deep sleep when in battery mode once no web
+ * request has come in for BATTERY_SETUP_WINDOW_MILLIS. This is what
+ * ends the normal running after a reset or power up, which is kept
+ * so the admin page can be reached, such as to turn battery mode off.
+ */
+void checkBatterySleep() {
+  if (
+    !settings.getIsBatteryMode() 
+    || !settings.isNetworkSet() 
+    || networkTrial.isPending 
+    || networkTrial.isActive
+    || (millis() - lastRequestMillis) < BATTERY_SETUP_WINDOW_MILLIS
+  ) { // Not in battery mode or still in use...
+
+    return;
+  }
+  WakeTimings timings = {
+    toTiming(bootTimings.sensorReady), toTiming(bootTimings.associated), toTiming(bootTimings.ipAcquired), 0, 0
+  };
+  wakeState.setUnsentCount(0); // Already sent while running normally
+  if (network.isOnline() && !settings.isStaticIpSet()) { // Lease from DHCP...
+    wakeState.noteFreshLease();
+  }
+  doDeepSleep(timings, true);
+}
+
+/**
+ * Saves the wake state to RTC memory and goes into deep sleep for the
+ * time set on the admin page. The device resets when the sleep ends,
+ * which needs GPIO16 wired to RST.
+ *
+ * @param timings The timings of the wake, completed here, as WakeTimings&.
+ * @param isDelivered True if everything was sent as bool.
+ */
+void doDeepSleep(WakeTimings &timings, bool isDelivered) {
+  uint32_t sleepMillis = settings.getBatterySleepSecs() * 1000ul;
+  mqtt.disconnect();
+
+  timings.asleep = toTiming(millis());
+  wakeState.setSequence((uint32_t) readCount);
+  wakeState.setIsSensorFailing(isSensorFailing);
+  wakeState.noteDelivered(isDelivered);
+  wakeState.beginSleep(timeKeeper.getEpochMillis(), millis(), sleepMillis, timings);
+  wakeState.seal();
+  ESP.rtcUserMemoryWrite(WAKE_RTC_BLOCK, (uint32_t *) wakeState.getData(), wakeState.getSize());
+
+  ESP.deepSleep((uint64_t) sleepMillis * 1000ull, WAKE_RF_DEFAULT);
+}
+
+/**
+ * Used to tell if MQTT has nothing left to send, or isn't set.
+ *
+ * @return Returns true if done otherwise false as bool.
+ */
+bool isMqttDone() {
+  if (!settings.isMqttSet()) { // Not used...
+
+    return true;
+  }
+
+  return (
+    mqttBacklog.getCount() == 0 
+    && mqttTopics.pendingAlert == nullptr 
+    && !mqttTopics.isStatusDue 
+    && !mqtt.hasInflight()
+  );
+}
+
+/**
+ * Used to fit a time since the reset into the 16 bits kept for each
+ * wake timing.
+ *
+ * @param millisSinceReset The time to fit as unsigned long.
+ *
+ * @return Returns the time, capped at 65535, as uint16_t.
+ */
+uint16_t toTiming(unsigned long millisSinceReset) {
+
+  return (uint16_t) min(millisSinceReset, 65535ul);
+}
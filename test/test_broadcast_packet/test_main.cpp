@@ -0,0 +1,239 @@
+/*
+    Tests of BroadcastPacket - Writes live and backlog packets, reads
+    them back and checks the readings come through whole. Then sends
+    them over and over through one socket kept open, as the firmware
+    does, through the emulator's stand in for the UDP socket, counting
+    the heap allocations made, which must be none, and checks a listener
+    on the broadcast port gets every one.
+
+    Run with: pio test -e native -f test_broadcast_packet
+
+    Written by: Scott Griffis
+    Date: 10-19-2026
+*/
+
+#include <unity.h>
+#include <new>
+#include <stdlib.h>
+#include <Emulator.h>
+#include <ESP8266WiFi.h>
+#include <WiFiUdp.h>
+#include <BroadcastPacket.h>
+
+#define BCAST_PORT 4211
+#define ROUNDS 100
+#define IP_ADDR "127.1.0.1"
+#define DEVICE_ID "A4C372"
+
+unsigned long allocationCount = 0ul;
+uint64_t clockNanos = 0ull;
+DeviceConfig device;
+
+void* operator new(size_t size) {
+    allocationCount++;
+    void *block = malloc(size == 0 ? 1 : size);
+    if (block == nullptr) {
+        throw std::bad_alloc();
+    }
+
+    return block;
+}
+
+void* operator new[](size_t size) {
+
+    return operator new(size);
+}
+
+__attribute__((noinline)) void operator delete(void *block) noexcept { // Out of line, else GCC takes its free() as mismatched with new
+    free(block);
+}
+
+void operator delete[](void *block) noexcept {
+    operator delete(block);
+}
+
+void operator delete(void *block, size_t size) noexcept {
+    operator delete(block);
+}
+
+void operator delete[](void *block, size_t size) noexcept {
+    operator delete(block);
+}
+
+uint64_t readClock() {
+
+    return clockNanos;
+}
+
+bool passTime(uint64_t micros) {
+    clockNanos += micros * 1000ull;
+
+    return true;
+}
+
+bool isStopping() {
+
+    return false;
+}
+
+void setUp() {
+    memset(&device, 0, sizeof(device));
+    device.ip = (uint32_t) IPAddress(127, 1, 0, 1);
+    device.sleep = passTime;
+    device.isStopping = isStopping;
+    device.clockNanos = readClock;
+    Emulator::attach(&device);
+}
+
+void tearDown() {}
+
+/**
+ * Joins the stand in's network, so that packets go out.
+*/
+void joinNetwork() {
+    WiFi.setApInRange(true);
+    WiFi.begin("TestNet", "secret");
+    for (int i = 0; i < 500 && WiFi.status() != WL_CONNECTED; i++) {
+        delay(10);
+    }
+    TEST_ASSERT_EQUAL(WL_CONNECTED, WiFi.status());
+}
+
+QueuedReading makeReading(uint32_t sequence) {
+    QueuedReading reading = {1792410856123ull + (sequence * 30000ull), sequence, 15.61f + (sequence % 7), 34.52f + (sequence % 11)};
+
+    return reading;
+}
+
+void assertSameReading(const QueuedReading &expected, const QueuedReading &actual) {
+    TEST_ASSERT_EQUAL_UINT64(expected.timestamp, actual.timestamp);
+    TEST_ASSERT_EQUAL_UINT32(expected.sequence, actual.sequence);
+    TEST_ASSERT_FLOAT_WITHIN(0.006f, expected.temperature, actual.temperature);
+    TEST_ASSERT_FLOAT_WITHIN(0.006f, expected.humidity, actual.humidity);
+}
+
+void test_live_packet_reads_back() {
+    char packet[BROADCAST_LIVE_PACKET_SIZE];
+    QueuedReading sent = makeReading(411);
+    size_t length = BroadcastPacket::formatLive(packet, sizeof(packet), IP_ADDR, DEVICE_ID, sent);
+    TEST_ASSERT_EQUAL_size_t(strlen(packet), length);
+    TEST_ASSERT_EQUAL_STRING_LEN("TempBuddy-Sensor::127.1.0.1::A4C372::T_", packet, 39);
+
+    BroadcastPacket parsed;
+    QueuedReading received;
+    TEST_ASSERT_TRUE(parsed.begin(packet, length));
+    TEST_ASSERT_TRUE(parsed.getIsLive());
+    TEST_ASSERT_EQUAL_HEX32(0xA4C372, parsed.getDeviceId());
+    TEST_ASSERT_TRUE(parsed.nextReading(received));
+    assertSameReading(sent, received);
+    TEST_ASSERT_FALSE(parsed.nextReading(received));
+}
+
+void test_backlog_packet_reads_back_in_order() {
+    QueuedReading batch[READING_BATCH_SIZE];
+    for (uint8_t i = 0; i < READING_BATCH_SIZE; i++) {
+        batch[i] = makeReading(400 + i);
+    }
+    char packet[BROADCAST_BACKLOG_PACKET_SIZE];
+    size_t length = BroadcastPacket::formatBacklog(packet, sizeof(packet), IP_ADDR, DEVICE_ID, batch, READING_BATCH_SIZE);
+    TEST_ASSERT_NOT_EQUAL(0, length);
+
+    BroadcastPacket parsed;
+    QueuedReading received;
+    TEST_ASSERT_TRUE(parsed.begin(packet, length));
+    TEST_ASSERT_FALSE(parsed.getIsLive());
+    for (uint8_t i = 0; i < READING_BATCH_SIZE; i++) {
+        TEST_ASSERT_TRUE(parsed.nextReading(received));
+        assertSameReading(batch[i], received);
+    }
+    TEST_ASSERT_FALSE(parsed.nextReading(received));
+}
+
+void test_widest_readings_fit_their_buffers() {
+    QueuedReading widest = {0xFFFFFFFFFFFFFFFFull, 0xFFFFFFFFul, -40.0f, 100.0f}; // Sensor's range; Longest numbers
+    QueuedReading batch[READING_BATCH_SIZE];
+    for (uint8_t i = 0; i < READING_BATCH_SIZE; i++) {
+        batch[i] = widest;
+    }
+    char live[BROADCAST_LIVE_PACKET_SIZE];
+    char backlog[BROADCAST_BACKLOG_PACKET_SIZE];
+
+    TEST_ASSERT_NOT_EQUAL(0, BroadcastPacket::formatLive(live, sizeof(live), "255.255.255.255", DEVICE_ID, widest));
+    TEST_ASSERT_NOT_EQUAL(0, BroadcastPacket::formatBacklog(backlog, sizeof(backlog), "255.255.255.255", DEVICE_ID, batch, READING_BATCH_SIZE));
+}
+
+void test_packet_too_big_for_buffer_gives_zero() {
+    char packet[48];
+    QueuedReading batch[2] = {makeReading(1), makeReading(2)};
+
+    TEST_ASSERT_EQUAL(0, BroadcastPacket::formatLive(packet, sizeof(packet), IP_ADDR, DEVICE_ID, batch[0]));
+    TEST_ASSERT_EQUAL(0, BroadcastPacket::formatBacklog(packet, sizeof(packet), IP_ADDR, DEVICE_ID, batch, 2));
+}
+
+void test_counter_sees_allocations() {
+    unsigned long before = allocationCount;
+    String built = String("TempBuddy-Sensor::") + IP_ADDR + "::" + DEVICE_ID;
+
+    TEST_ASSERT_GREATER_THAN(before, allocationCount); // Otherwise the count proves nothing
+}
+
+void test_sending_through_open_socket_does_not_allocate() {
+    joinNetwork();
+    WiFiUDP listener;
+    WiFiUDP sender;
+    TEST_ASSERT_EQUAL(1, listener.begin(BCAST_PORT));
+    TEST_ASSERT_EQUAL(1, sender.begin(0)); // Opened once, as the firmware does
+    IPAddress bcastAddress(127, 255, 255, 255);
+    QueuedReading batch[READING_BATCH_SIZE];
+    for (uint8_t i = 0; i < READING_BATCH_SIZE; i++) {
+        batch[i] = makeReading(i);
+    }
+
+    unsigned long before = allocationCount;
+    int sentCount = 0;
+    for (uint32_t i = 0; i < ROUNDS; i++) {
+        char live[BROADCAST_LIVE_PACKET_SIZE];
+        size_t length = BroadcastPacket::formatLive(live, sizeof(live), IP_ADDR, DEVICE_ID, makeReading(i));
+        sender.beginPacket(bcastAddress, BCAST_PORT);
+        sender.write((const uint8_t *) live, length);
+        sentCount += sender.endPacket();
+
+        char backlog[BROADCAST_BACKLOG_PACKET_SIZE];
+        length = BroadcastPacket::formatBacklog(backlog, sizeof(backlog), IP_ADDR, DEVICE_ID, batch, READING_BATCH_SIZE);
+        sender.beginPacket(bcastAddress, BCAST_PORT);
+        sender.write((const uint8_t *) backlog, length);
+        sentCount += sender.endPacket();
+    }
+    TEST_ASSERT_EQUAL_UINT32(0, allocationCount - before);
+    TEST_ASSERT_EQUAL(ROUNDS * 2, sentCount);
+
+    int liveCount = 0;
+    int backlogCount = 0;
+    char packet[UDP_MAX_PACKET_SIZE];
+    while (listener.parsePacket() > 0) {
+        int length = listener.read(packet, sizeof(packet));
+        BroadcastPacket parsed;
+        QueuedReading received;
+        TEST_ASSERT_TRUE(parsed.begin(packet, length));
+        if (parsed.getIsLive()) {
+            TEST_ASSERT_TRUE(parsed.nextReading(received));
+            assertSameReading(makeReading(liveCount++), received);
+        } else {
+            backlogCount++;
+        }
+    }
+    TEST_ASSERT_EQUAL(ROUNDS, liveCount);
+    TEST_ASSERT_EQUAL(ROUNDS, backlogCount);
+}
+
+int main(int argc, char **argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_live_packet_reads_back);
+    RUN_TEST(test_backlog_packet_reads_back_in_order);
+    RUN_TEST(test_widest_readings_fit_their_buffers);
+    RUN_TEST(test_packet_too_big_for_buffer_gives_zero);
+    RUN_TEST(test_counter_sees_allocations);
+    RUN_TEST(test_sending_through_open_socket_does_not_allocate);
+
+    return UNITY_END();
+}
@@ -0,0 +1,321 @@
+/*
+    Tests of the admin login - Boots the firmware itself against the
+    emulator's stand ins, on a clock of the test's own, and loads the
+    admin page over real sockets as a browser would: First through the
+    digest challenge, which then hands out a session cookie, and after
+    that with the cookie alone. A cookie that was tampered with or has
+    outlived its 10 minutes must be challenged again.
+
+    Then times page loads each way, as a microbenchmark: The digest
+    login takes the 401 and a second request, while the cookie takes
+    the one. The figures are the host's; TLS isn't emulated, so the
+    handshake each extra connection costs on the device isn't in them.
+
+    Run with: pio test -e native -f test_firmware_admin
+
+    Written by: Scott Griffis
+    Date: 10-19-2026
+*/
+
+#include <unity.h>
+#include <chrono>
+#include <unistd.h>
+#include <fcntl.h>
+#include <arpa/inet.h>
+#include <sys/socket.h>
+#include <Emulator.h>
+#include <MD5Builder.h>
+#include "../../src/main.cpp" // The firmware under test; Its globals are this suite's
+
+#define TEST_IP "127.1.0.11"
+#define TEST_WEB_PORT 18445
+#define EEPROM_PATH "test_firmware_admin.bin"
+#define FLASH_PATH "test_firmware_admin_flash.bin"
+#define MAX_REQUEST_LOOPS 50
+#define RESPONSE_SIZE 32768
+#define PASS_MICROS 1000ull // Time each pass of the loop takes, as the clock is only moved on by sleeps
+#define ADMIN_USER "admin" // Factory default login
+#define ADMIN_PWD "admin"
+#define ADMIN_REALM "AdminRealm"
+#define BENCH_LOADS 50
+
+uint64_t clockNanos = 0ull;
+uint8_t rtcMemory[EMULATOR_RTC_SIZE];
+uint32_t readingCount = 0;
+DeviceConfig device;
+bool isBooted = false;
+char response[RESPONSE_SIZE];
+char cookie[64]; // As the browser holds it
+int requestCount = 0;
+
+uint64_t readClock() {
+
+    return clockNanos;
+}
+
+bool passTime(uint64_t micros) {
+    clockNanos += micros * 1000ull;
+
+    return true;
+}
+
+bool isStopping() {
+
+    return false;
+}
+
+/**
+ * Runs one pass of the loop.
+*/
+void runPass() {
+    loop();
+    clockNanos += PASS_MICROS * 1000ull;
+}
+
+/**
+ * Boots the firmware once for the whole suite, joined to a network as
+ * the emulator's units are, and runs it until it is online.
+*/
+void bootFirmware() {
+    memset(&device, 0, sizeof(device));
+    device.ip = inet_addr(TEST_IP);
+    device.mac[5] = 11;
+    device.webPort = TEST_WEB_PORT;
+    device.eepromPath = EEPROM_PATH;
+    device.flashPath = FLASH_PATH;
+    device.readingCount = &readingCount;
+    device.rtcMemory = rtcMemory;
+    device.sleep = passTime;
+    device.isStopping = isStopping;
+    device.clockNanos = readClock;
+    remove(EEPROM_PATH);
+    remove(FLASH_PATH);
+    Emulator::attach(&device);
+
+    Settings seed; // As the emulator's --set does
+    seed.loadSettings();
+    seed.updateField(*Settings::findField("ssid"), "TempBuddyLab", strlen("TempBuddyLab"));
+    seed.updateField(*Settings::findField("pwd"), "P@ssw0rd123", strlen("P@ssw0rd123"));
+    TEST_ASSERT_TRUE(seed.saveSettings());
+
+    setup();
+    for (int i = 0; i < 100 && !network.isOnline(); i++) {
+        runPass();
+    }
+    TEST_ASSERT_TRUE_MESSAGE(network.isOnline(), "Never joined");
+}
+
+void setUp() {
+    if (!isBooted) {
+        bootFirmware();
+        isBooted = true;
+    }
+    cookie[0] = '\0';
+}
+
+void tearDown() {}
+
+/**
+ * Runs the loop until the given time has passed.
+*/
+void runFor(unsigned long millisToRun) {
+    unsigned long startMillis = millis();
+    while ((millis() - startMillis) < millisToRun) {
+        runPass();
+    }
+}
+
+/**
+ * Makes a GET request of the firmware with the given headers, running
+ * the loop until it has answered and closed the connection.
+ *
+ * @return Returns the status code of the response, or 0 if none as int.
+*/
+int request(const char *path, const char *headers) {
+    int fd = socket(AF_INET, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    sockaddr_in address = {};
+    address.sin_family = AF_INET;
+    address.sin_port = htons(TEST_WEB_PORT);
+    address.sin_addr.s_addr = inet_addr(TEST_IP);
+    TEST_ASSERT_EQUAL(0, connect(fd, (sockaddr *) &address, sizeof(address)));
+    char line[512];
+    int lineLength = snprintf(line, sizeof(line), "GET %s HTTP/1.1\r\nHost: " TEST_IP "\r\nAccept-Encoding: gzip\r\n%s\r\n", path, headers);
+    TEST_ASSERT_EQUAL(lineLength, write(fd, line, lineLength));
+    fcntl(fd, F_SETFL, O_NONBLOCK);
+    requestCount++;
+
+    size_t length = 0;
+    for (int i = 0; i < MAX_REQUEST_LOOPS; i++) {
+        runPass();
+        ssize_t got = read(fd, &response[length], sizeof(response) - 1 - length);
+        if (got == 0) { // Answered and closed...
+            break;
+        }
+        length += (got > 0 ? got : 0);
+    }
+    response[length] = '\0';
+    close(fd);
+    int code = 0;
+    sscanf(response, "HTTP/1.1 %d", &code);
+
+    return code;
+}
+
+/**
+ * Gets a quoted parameter of the digest challenge in the last response.
+*/
+String getChallengeParam(const char *name) {
+    char key[32];
+    snprintf(key, sizeof(key), "%s=\"", name);
+    const char *start = strstr(response, key);
+    TEST_ASSERT_NOT_NULL_MESSAGE(start, name);
+    start += strlen(key);
+
+    return String(start).substring(0, strchr(start, '"') - start);
+}
+
+String md5Hex(const String &text) {
+    MD5Builder builder = MD5Builder();
+    builder.begin();
+    builder.add(text);
+    builder.calculate();
+
+    return builder.toString();
+}
+
+/**
+ * Loads the given admin path as a browser would: Uses the cookie if it
+ * holds one, otherwise answers the digest challenge and keeps the
+ * cookie that comes back.
+ *
+ * @return Returns the status code of the final response as int.
+*/
+int loadAdmin(const char *path) {
+    char headers[256];
+    if (cookie[0] != '\0') { // Logged in...
+        snprintf(headers, sizeof(headers), "Cookie: %s\r\n", cookie);
+
+        return request(path, headers);
+    }
+    int code = request(path, "");
+    if (code != 401) { // Not challenged...
+
+        return code;
+    }
+    String nonce = getChallengeParam("nonce");
+    String opaque = getChallengeParam("opaque");
+    String hashA1 = md5Hex(ADMIN_USER ":" ADMIN_REALM ":" ADMIN_PWD);
+    String hashA2 = md5Hex(String("GET:") + path);
+    String digest = md5Hex(hashA1 + ":" + nonce + ":00000001:0a4f113b:auth:" + hashA2);
+    snprintf(
+        headers, sizeof(headers),
+        "Authorization: Digest username=\"" ADMIN_USER "\", realm=\"" ADMIN_REALM "\", nonce=\"%s\", uri=\"%s\", qop=auth, nc=00000001, cnonce=\"0a4f113b\", response=\"%s\", opaque=\"%s\"\r\n",
+        nonce.c_str(), path, digest.c_str(), opaque.c_str()
+    );
+    code = request(path, headers);
+    const char *setCookie = strstr(response, "Set-Cookie: ");
+    if (setCookie != nullptr) { // Logged in; Keep the session...
+        sscanf(setCookie + strlen("Set-Cookie: "), "%63[^;\r]", cookie);
+    }
+
+    return code;
+}
+
+void test_digest_login_issues_cookie() {
+    runFor(2000ul); // Clear of the rate limit
+    TEST_ASSERT_EQUAL(401, request("/admin", ""));
+    TEST_ASSERT_NOT_NULL(strstr(response, "WWW-Authenticate: Digest realm=\"" ADMIN_REALM "\""));
+
+    requestCount = 0;
+    TEST_ASSERT_EQUAL(200, loadAdmin("/admin"));
+    TEST_ASSERT_EQUAL(2, requestCount);
+    TEST_ASSERT_EQUAL(0, strncmp(cookie, ADMIN_SESSION_COOKIE "=", strlen(ADMIN_SESSION_COOKIE) + 1));
+    TEST_ASSERT_EQUAL_size_t(strlen(ADMIN_SESSION_COOKIE) + 1 + ADMIN_SESSION_TOKEN_LEN, strlen(cookie));
+}
+
+void test_cookie_skips_digest() {
+    runFor(2000ul);
+    loadAdmin("/admin");
+
+    requestCount = 0;
+    TEST_ASSERT_EQUAL(200, loadAdmin("/admin"));
+    TEST_ASSERT_EQUAL(1, requestCount);
+    TEST_ASSERT_NULL(strstr(response, "Set-Cookie: ")); // Same session kept
+    TEST_ASSERT_EQUAL(200, loadAdmin("/admin/settings"));
+    TEST_ASSERT_NOT_NULL(strstr(response, "\"fields\": ["));
+}
+
+void test_tampered_cookie_is_challenged() {
+    runFor(2000ul);
+    loadAdmin("/admin");
+    char *last = &cookie[strlen(cookie) - 1];
+    *last = (*last == '0' ? '1' : '0');
+
+    TEST_ASSERT_EQUAL(401, request("/admin", (String("Cookie: ") + cookie + "\r\n").c_str()));
+    TEST_ASSERT_EQUAL(401, request("/admin", "Cookie: " ADMIN_SESSION_COOKIE "=\r\n"));
+}
+
+void test_expired_cookie_is_challenged() {
+    runFor(2000ul);
+    loadAdmin("/admin");
+    char headers[128];
+    snprintf(headers, sizeof(headers), "Cookie: %s\r\n", cookie);
+
+    runFor(ADMIN_SESSION_TTL_MILLIS - 1000ul);
+    TEST_ASSERT_EQUAL(200, request("/admin", headers));
+    runFor(1000ul);
+    TEST_ASSERT_EQUAL(401, request("/admin", headers));
+}
+
+/**
+ * Times admin page loads, with or without a session held, leaving the
+ * rate limit out of it.
+ *
+ * @return Returns microseconds per load on this host as double.
+*/
+double timeLoads(bool isSessionKept) {
+    double totalMicros = 0.0;
+    requestCount = 0;
+    for (int i = 0; i < BENCH_LOADS; i++) {
+        runFor(1000ul); // Clear of the rate limit; Not timed
+        if (!isSessionKept) { // Browser closed; Logs in again...
+            cookie[0] = '\0';
+        }
+        auto start = std::chrono::steady_clock::now();
+        TEST_ASSERT_EQUAL(200, loadAdmin("/admin"));
+        auto elapsed = std::chrono::steady_clock::now() - start;
+        totalMicros += (double) std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count() / 1000.0;
+    }
+
+    return (totalMicros / BENCH_LOADS);
+}
+
+void test_benchmark() {
+    double digestMicros = timeLoads(false);
+    int digestRequests = requestCount;
+    loadAdmin("/admin");
+    double cookieMicros = timeLoads(true);
+    int cookieRequests = requestCount;
+
+    char report[160];
+    snprintf(
+        report, sizeof(report), "Admin page by digest %.1f us over %.1f requests; By cookie %.1f us over %.1f requests; Per load on this host",
+        digestMicros, (double) digestRequests / BENCH_LOADS, cookieMicros, (double) cookieRequests / BENCH_LOADS
+    );
+    TEST_MESSAGE(report);
+    TEST_ASSERT_EQUAL(2 * BENCH_LOADS, digestRequests);
+    TEST_ASSERT_EQUAL(BENCH_LOADS, cookieRequests);
+}
+
+int main(int argc, char **argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_digest_login_issues_cookie);
+    RUN_TEST(test_cookie_skips_digest);
+    RUN_TEST(test_tampered_cookie_is_challenged);
+    RUN_TEST(test_expired_cookie_is_challenged);
+    RUN_TEST(test_benchmark);
+    remove(EEPROM_PATH);
+    remove(FLASH_PATH);
+
+    return UNITY_END();
+}
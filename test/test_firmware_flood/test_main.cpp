@@ -0,0 +1,278 @@
+/*
+    Tests of the firmware under a flood of web requests - Boots the
+    firmware itself against the emulator's stand ins, on a clock of the
+    test's own, and makes requests of it over real sockets from a number
+    of client addresses, each as fast as the device will answer them.
+
+    A client past its burst must be turned away with a 429 and clients
+    together past the device's burst with a 503, while what is admitted
+    stays within the sustained rates. Through a minute long flood the
+    loop must still take its readings and send its broadcasts, and every
+    request must get an answer. The counts served by /api/diag must
+    match the answers the clients got.
+
+    Run with: pio test -e native -f test_firmware_flood
+
+    Written by: Scott Griffis
+    Date: 10-19-2026
+*/
+
+#include <unity.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <arpa/inet.h>
+#include <sys/socket.h>
+#include <Emulator.h>
+#include "../../src/main.cpp" // The firmware under test; Its globals are this suite's
+
+#define TEST_IP "127.1.0.10"
+#define TEST_WEB_PORT 18444
+#define EEPROM_PATH "test_firmware_flood.bin"
+#define FLASH_PATH "test_firmware_flood_flash.bin"
+#define MAX_REQUEST_LOOPS 50
+#define RESPONSE_SIZE 16384
+#define PASS_MICROS 1000ull // Time each pass of the loop takes, as the clock is only moved on by sleeps
+#define CLIENT_COUNT 4
+#define FLOOD_MILLIS 60000ul
+#define REFILL_MILLIS 10000ul // Long enough for every bucket to fill again
+
+const char *CLIENT_IPS[CLIENT_COUNT] = {"127.2.0.1", "127.2.0.2", "127.2.0.3", "127.2.0.4"};
+
+uint64_t clockNanos = 0ull;
+uint8_t rtcMemory[EMULATOR_RTC_SIZE];
+uint32_t readingCount = 0;
+DeviceConfig device;
+bool isBooted = false;
+char response[RESPONSE_SIZE];
+
+uint64_t readClock() {
+
+    return clockNanos;
+}
+
+bool passTime(uint64_t micros) {
+    clockNanos += micros * 1000ull;
+
+    return true;
+}
+
+bool isStopping() {
+
+    return false;
+}
+
+/**
+ * Runs one pass of the loop.
+*/
+void runPass() {
+    loop();
+    clockNanos += PASS_MICROS * 1000ull;
+}
+
+/**
+ * Boots the firmware once for the whole suite, joined to a network as
+ * the emulator's units are, and runs it until it is online.
+*/
+void bootFirmware() {
+    memset(&device, 0, sizeof(device));
+    device.ip = inet_addr(TEST_IP);
+    device.mac[5] = 10;
+    device.webPort = TEST_WEB_PORT;
+    device.eepromPath = EEPROM_PATH;
+    device.flashPath = FLASH_PATH;
+    device.readingCount = &readingCount;
+    device.rtcMemory = rtcMemory;
+    device.sleep = passTime;
+    device.isStopping = isStopping;
+    device.clockNanos = readClock;
+    remove(EEPROM_PATH);
+    remove(FLASH_PATH);
+    Emulator::attach(&device);
+
+    Settings seed; // As the emulator's --set does
+    seed.loadSettings();
+    seed.updateField(*Settings::findField("ssid"), "TempBuddyLab", strlen("TempBuddyLab"));
+    seed.updateField(*Settings::findField("pwd"), "P@ssw0rd123", strlen("P@ssw0rd123"));
+    TEST_ASSERT_TRUE(seed.saveSettings());
+
+    setup();
+    for (int i = 0; i < 100 && !network.isOnline(); i++) {
+        runPass();
+    }
+    TEST_ASSERT_TRUE_MESSAGE(network.isOnline(), "Never joined");
+}
+
+void setUp() {
+    if (!isBooted) {
+        bootFirmware();
+        isBooted = true;
+    }
+}
+
+void tearDown() {}
+
+/**
+ * Runs the loop until the given time has passed.
+*/
+void runFor(unsigned long millisToRun) {
+    unsigned long startMillis = millis();
+    while ((millis() - startMillis) < millisToRun) {
+        runPass();
+    }
+}
+
+/**
+ * Joins the chunks of a chunked body back together in place, so what
+ * is checked doesn't depend on where the chunks happened to split.
+*/
+void joinChunks() {
+    char *body = strstr(response, "\r\n\r\n");
+    if (body == nullptr || strstr(response, "Transfer-Encoding: chunked") == nullptr) { // Sent whole...
+
+        return;
+    }
+    body += 4;
+    char *end = body + strlen(body);
+    char *next = body;
+    char *joined = body;
+    unsigned long size = 0;
+    while ((size = strtoul(next, &next, 16)) > 0 && strncmp(next, "\r\n", 2) == 0 && (next + 2 + size) <= end) {
+        memmove(joined, next + 2, size);
+        joined += size;
+        next += 2 + size + 2; // Past the chunk and its line end
+    }
+    *joined = '\0';
+}
+
+/**
+ * Makes a GET request of the firmware from the given client address,
+ * running the loop until it has answered and closed the connection.
+ *
+ * @return Returns the status code of the response, or 0 if none as int.
+*/
+int request(const char *clientIp, const char *path) {
+    int fd = socket(AF_INET, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    sockaddr_in client = {};
+    client.sin_family = AF_INET;
+    client.sin_addr.s_addr = inet_addr(clientIp);
+    TEST_ASSERT_EQUAL(0, bind(fd, (sockaddr *) &client, sizeof(client)));
+    sockaddr_in address = {};
+    address.sin_family = AF_INET;
+    address.sin_port = htons(TEST_WEB_PORT);
+    address.sin_addr.s_addr = inet_addr(TEST_IP);
+    TEST_ASSERT_EQUAL(0, connect(fd, (sockaddr *) &address, sizeof(address)));
+    char line[128];
+    int lineLength = snprintf(line, sizeof(line), "GET %s HTTP/1.1\r\nHost: " TEST_IP "\r\n\r\n", path);
+    TEST_ASSERT_EQUAL(lineLength, write(fd, line, lineLength));
+    fcntl(fd, F_SETFL, O_NONBLOCK);
+
+    size_t length = 0;
+    for (int i = 0; i < MAX_REQUEST_LOOPS; i++) {
+        runPass();
+        ssize_t got = read(fd, &response[length], sizeof(response) - 1 - length);
+        if (got == 0) { // Answered and closed...
+            break;
+        }
+        length += (got > 0 ? got : 0);
+    }
+    response[length] = '\0';
+    close(fd);
+    joinChunks();
+    int code = 0;
+    sscanf(response, "HTTP/1.1 %d", &code);
+
+    return code;
+}
+
+/**
+ * Gets a count from the last response, as served by /api/diag or
+ * /api/metrics.
+ *
+ * @return Returns the count as unsigned long.
+*/
+unsigned long getCount(const char *name) {
+    const char *found = strstr(response, name);
+    TEST_ASSERT_NOT_NULL_MESSAGE(found, name);
+    unsigned long count = 0ul;
+    sscanf(found + strlen(name), "%*[\": ]%lu", &count);
+
+    return count;
+}
+
+void test_client_past_burst_gets_429() {
+    runFor(REFILL_MILLIS);
+    for (int i = 0; i < CLIENT_REQ_BURST; i++) {
+        TEST_ASSERT_EQUAL(200, request(CLIENT_IPS[0], "/api/info"));
+    }
+    TEST_ASSERT_EQUAL(429, request(CLIENT_IPS[0], "/api/info"));
+    TEST_ASSERT_NOT_NULL(strstr(response, "Retry-After: 1\r\n"));
+    TEST_ASSERT_EQUAL(200, request(CLIENT_IPS[1], "/api/info")); // Others still served
+
+    runFor(1000ul / CLIENT_REQ_PER_SEC);
+    TEST_ASSERT_EQUAL(200, request(CLIENT_IPS[0], "/api/info")); // Earned another
+}
+
+void test_clients_past_device_burst_get_503() {
+    runFor(REFILL_MILLIS);
+    int served = 0;
+    int busy = 0;
+    for (int i = 0; i < CLIENT_COUNT * 6; i++) { // Each within its own burst; Not all together
+        int code = request(CLIENT_IPS[i % CLIENT_COUNT], "/api/info");
+        served += (code == 200);
+        busy += (code == 503);
+    }
+
+    TEST_ASSERT_EQUAL(GLOBAL_REQ_BURST, served);
+    TEST_ASSERT_EQUAL((CLIENT_COUNT * 6) - GLOBAL_REQ_BURST, busy);
+}
+
+void test_flood_leaves_device_working() {
+    runFor(REFILL_MILLIS);
+    TEST_ASSERT_EQUAL(200, request(CLIENT_IPS[0], "/api/metrics"));
+    unsigned long startBroadcasts = getCount("\ntempbuddy_broadcasts_total");
+    uint32_t startReadings = readingCount;
+    unsigned long startLimited = rateLimiter.getRateLimitedCount();
+    unsigned long startBusy = rateLimiter.getBusyCount();
+
+    unsigned long answers[600] = {0};
+    unsigned long requests = 0ul;
+    unsigned long startMillis = millis();
+    while ((millis() - startMillis) < FLOOD_MILLIS) {
+        int code = request(CLIENT_IPS[requests % CLIENT_COUNT], "/api/info");
+        answers[code < 600 && code > 0 ? code : 0]++;
+        requests++;
+    }
+    unsigned long elapsedSecs = (millis() - startMillis) / 1000ul;
+
+    char report[160];
+    snprintf(report, sizeof(report), "%lu requests in %lus; %lu served, %lu got 429, %lu got 503", requests, elapsedSecs, answers[200], answers[429], answers[503]);
+    TEST_MESSAGE(report);
+    TEST_ASSERT_EQUAL_UINT32(0, answers[0]); // Every request answered
+    TEST_ASSERT_EQUAL_UINT32(requests, answers[200] + answers[429] + answers[503]);
+    TEST_ASSERT_LESS_OR_EQUAL_UINT32(GLOBAL_REQ_BURST + (GLOBAL_REQ_PER_SEC * (elapsedSecs + 1)), answers[200]);
+    TEST_ASSERT_GREATER_OR_EQUAL_UINT32(GLOBAL_REQ_PER_SEC * (elapsedSecs - 1), answers[200]); // Kept serving at the sustained rate
+    TEST_ASSERT_GREATER_THAN_UINT32(0, answers[429]);
+    TEST_ASSERT_GREATER_THAN_UINT32(0, answers[503]);
+
+    TEST_ASSERT_GREATER_OR_EQUAL_UINT32(startReadings + (FLOOD_MILLIS / 30000ul), readingCount); // A reading every 30s
+    runFor(REFILL_MILLIS);
+    TEST_ASSERT_EQUAL(200, request(CLIENT_IPS[0], "/api/metrics"));
+    TEST_ASSERT_GREATER_OR_EQUAL_UINT32(startBroadcasts + (FLOOD_MILLIS / 10000ul), getCount("\ntempbuddy_broadcasts_total")); // A broadcast every 10s
+
+    TEST_ASSERT_EQUAL_UINT32(answers[429], rateLimiter.getRateLimitedCount() - startLimited);
+    TEST_ASSERT_EQUAL_UINT32(answers[503], rateLimiter.getBusyCount() - startBusy);
+    TEST_ASSERT_EQUAL(200, request(CLIENT_IPS[1], "/api/diag"));
+    TEST_ASSERT_EQUAL_UINT32(rateLimiter.getRateLimitedCount(), getCount("\"requests_rate_limited"));
+    TEST_ASSERT_EQUAL_UINT32(rateLimiter.getBusyCount(), getCount("\"requests_rejected_busy"));
+}
+
+int main(int argc, char **argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_client_past_burst_gets_429);
+    RUN_TEST(test_clients_past_device_burst_get_503);
+    RUN_TEST(test_flood_leaves_device_working);
+    remove(EEPROM_PATH);
+    remove(FLASH_PATH);
+
+    return UNITY_END();
+}
@@ -0,0 +1,313 @@
+/*
+    Tests of the firmware's heap use - Boots the firmware itself against
+    the emulator's stand ins, on a clock of the test's own, and counts
+    the heap allocations made through operator new, which is also how
+    the emulator's stand in for String gets its memory. The count is fed
+    to the firmware's HeapMonitor, so its own figures for each loop and
+    each handler are what gets checked.
+
+    Once online and past its first reading, the loop must run on through
+    readings and broadcasts without allocating, and each read-only API
+    request, /api/info among them, must be answered without its handler
+    allocating. Requests go through the emulator's web server over a real
+    socket, as a browser's would; What the stand in allocates to take a
+    connection and read the request is its own and isn't counted against
+    the handlers.
+
+    Run with: pio test -e native -f test_firmware_heap
+
+    Written by: Scott Griffis
+    Date: 10-19-2026
+*/
+
+#include <unity.h>
+#include <new>
+#include <stdlib.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <arpa/inet.h>
+#include <sys/socket.h>
+#include <Emulator.h>
+#include "../../src/main.cpp" // The firmware under test; Its globals are this suite's
+
+#define TEST_IP "127.1.0.9"
+#define TEST_WEB_PORT 18443
+#define EEPROM_PATH "test_firmware_heap.bin"
+#define FLASH_PATH "test_firmware_heap_flash.bin"
+#define MAX_REQUEST_LOOPS 50
+#define RESPONSE_SIZE 16384
+#define PASS_MICROS 1000ull // Time each pass of the loop takes, as the clock is only moved on by sleeps
+
+uint64_t clockNanos = 0ull;
+uint8_t rtcMemory[EMULATOR_RTC_SIZE];
+uint32_t readingCount = 0;
+DeviceConfig device;
+bool isBooted = false;
+char response[RESPONSE_SIZE];
+
+void* operator new(size_t size) {
+    HeapMonitor::noteAlloc(size);
+    void *block = malloc(size == 0 ? 1 : size);
+    if (block == nullptr) {
+        throw std::bad_alloc();
+    }
+
+    return block;
+}
+
+void* operator new[](size_t size) {
+
+    return operator new(size);
+}
+
+__attribute__((noinline)) void operator delete(void *block) noexcept { // Out of line, else GCC takes its free() as mismatched with new
+    free(block);
+}
+
+void operator delete[](void *block) noexcept {
+    operator delete(block);
+}
+
+void operator delete(void *block, size_t size) noexcept {
+    operator delete(block);
+}
+
+void operator delete[](void *block, size_t size) noexcept {
+    operator delete(block);
+}
+
+uint64_t readClock() {
+
+    return clockNanos;
+}
+
+bool passTime(uint64_t micros) {
+    clockNanos += micros * 1000ull;
+
+    return true;
+}
+
+bool isStopping() {
+
+    return false;
+}
+
+/**
+ * Runs one pass of the loop.
+*/
+void runPass() {
+    loop();
+    clockNanos += PASS_MICROS * 1000ull;
+}
+
+/**
+ * Boots the firmware once for the whole suite, joined to a network as
+ * the emulator's units are, and runs it until it is online.
+*/
+void bootFirmware() {
+    memset(&device, 0, sizeof(device));
+    device.ip = inet_addr(TEST_IP);
+    device.mac[5] = 9;
+    device.webPort = TEST_WEB_PORT;
+    device.eepromPath = EEPROM_PATH;
+    device.flashPath = FLASH_PATH;
+    device.readingCount = &readingCount;
+    device.rtcMemory = rtcMemory;
+    device.sleep = passTime;
+    device.isStopping = isStopping;
+    device.clockNanos = readClock;
+    remove(EEPROM_PATH);
+    remove(FLASH_PATH);
+    Emulator::attach(&device);
+
+    Settings seed; // As the emulator's --set does
+    seed.loadSettings();
+    seed.updateField(*Settings::findField("ssid"), "TempBuddyLab", strlen("TempBuddyLab"));
+    seed.updateField(*Settings::findField("pwd"), "P@ssw0rd123", strlen("P@ssw0rd123"));
+    TEST_ASSERT_TRUE(seed.saveSettings());
+
+    setup();
+    for (int i = 0; i < 100 && !network.isOnline(); i++) {
+        runPass();
+    }
+    TEST_ASSERT_TRUE_MESSAGE(network.isOnline(), "Never joined");
+}
+
+void setUp() {
+    if (!isBooted) {
+        bootFirmware();
+        isBooted = true;
+    }
+}
+
+void tearDown() {}
+
+/**
+ * Runs the loop until the given time has passed.
+*/
+void runFor(unsigned long millisToRun) {
+    unsigned long startMillis = millis();
+    while ((millis() - startMillis) < millisToRun) {
+        runPass();
+    }
+}
+
+/**
+ * Joins the chunks of a chunked body back together in place, so what
+ * is checked doesn't depend on where the chunks happened to split.
+*/
+void joinChunks() {
+    char *body = strstr(response, "\r\n\r\n");
+    if (body == nullptr || strstr(response, "Transfer-Encoding: chunked") == nullptr) { // Sent whole...
+
+        return;
+    }
+    body += 4;
+    char *end = body + strlen(body);
+    char *next = body;
+    char *joined = body;
+    unsigned long size = 0;
+    while ((size = strtoul(next, &next, 16)) > 0 && strncmp(next, "\r\n", 2) == 0 && (next + 2 + size) <= end) {
+        memmove(joined, next + 2, size);
+        joined += size;
+        next += 2 + size + 2; // Past the chunk and its line end
+    }
+    *joined = '\0';
+}
+
+/**
+ * Makes a GET request of the firmware, running the loop until it has
+ * answered and closed the connection.
+ *
+ * @return Returns the status code of the response, or 0 if none as int.
+*/
+int request(const char *path) {
+    int fd = socket(AF_INET, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    sockaddr_in address = {};
+    address.sin_family = AF_INET;
+    address.sin_port = htons(TEST_WEB_PORT);
+    address.sin_addr.s_addr = inet_addr(TEST_IP);
+    TEST_ASSERT_EQUAL(0, connect(fd, (sockaddr *) &address, sizeof(address)));
+    char line[128];
+    int lineLength = snprintf(line, sizeof(line), "GET %s HTTP/1.1\r\nHost: " TEST_IP "\r\n\r\n", path);
+    TEST_ASSERT_EQUAL(lineLength, write(fd, line, lineLength));
+    fcntl(fd, F_SETFL, O_NONBLOCK);
+
+    size_t length = 0;
+    for (int i = 0; i < MAX_REQUEST_LOOPS; i++) {
+        runPass();
+        ssize_t got = read(fd, &response[length], sizeof(response) - 1 - length);
+        if (got == 0) { // Answered and closed...
+            break;
+        }
+        length += (got > 0 ? got : 0);
+    }
+    response[length] = '\0';
+    close(fd);
+    joinChunks();
+    int code = 0;
+    sscanf(response, "HTTP/1.1 %d", &code);
+
+    return code;
+}
+
+/**
+ * Gets the allocations the heap monitor recorded for the last request
+ * to the given URI.
+ *
+ * @return Returns the allocations as uint32_t.
+*/
+uint32_t getHandlerAllocs(const char *uri) {
+    for (uint8_t i = 0; i < heapMonitor.getHandlerCount(); i++) {
+        if (strcmp(heapMonitor.getHandler(i).name, uri) == 0) {
+
+            return heapMonitor.getHandler(i).lastAllocs;
+        }
+    }
+    TEST_FAIL_MESSAGE("Handler never measured");
+
+    return 0;
+}
+
+/**
+ * Requests the given URI until the handler has run once to warm up,
+ * then again, checking the second run allocated nothing.
+*/
+void assertRequestAllocatesNothing(const char *uri) {
+    runFor(1000ul); // Clear of the rate limit
+    TEST_ASSERT_EQUAL_MESSAGE(200, request(uri), uri);
+    runFor(1000ul);
+    TEST_ASSERT_EQUAL_MESSAGE(200, request(uri), uri);
+    const char *body = strstr(response, "\r\n\r\n");
+    TEST_ASSERT_NOT_NULL(body);
+    TEST_ASSERT_NOT_NULL_MESSAGE(strchr(body, '{'), uri);
+    TEST_ASSERT_EQUAL_UINT32_MESSAGE(0, getHandlerAllocs(uri), uri);
+}
+
+void test_steady_loop_allocates_nothing() {
+    runFor(60000ul); // First readings and broadcasts sent
+    unsigned long startLoops = heapMonitor.getLoopCount();
+    unsigned long startAllocLoops = heapMonitor.getAllocLoopCount();
+    uint32_t startAllocs = HeapMonitor::getAllocCount();
+    uint32_t startReadings = readingCount;
+
+    runFor(5 * 60000ul);
+
+    TEST_ASSERT_GREATER_OR_EQUAL_UINT32(startReadings + 10, readingCount); // Readings taken and broadcast
+    TEST_ASSERT_GREATER_THAN(startLoops, heapMonitor.getLoopCount());
+    TEST_ASSERT_EQUAL_UINT32(startAllocLoops, heapMonitor.getAllocLoopCount());
+    TEST_ASSERT_EQUAL_UINT32(startAllocs, HeapMonitor::getAllocCount());
+}
+
+void test_info_allocates_nothing() {
+    assertRequestAllocatesNothing("/api/info");
+    TEST_ASSERT_NOT_NULL(strstr(response, "\"title_text\": \""));
+    TEST_ASSERT_NULL(strstr(response, "\"temp\": null")); // Readings taken, so they were formatted too
+}
+
+void test_diag_allocates_nothing() {
+    assertRequestAllocatesNothing("/api/diag");
+}
+
+void test_boot_allocates_nothing() {
+    assertRequestAllocatesNothing("/api/boot");
+}
+
+void test_heap_allocates_nothing() {
+    assertRequestAllocatesNothing("/api/heap");
+    TEST_ASSERT_NOT_NULL(strstr(response, "\"history\": [{"));
+    TEST_ASSERT_NOT_NULL(strstr(response, "}]}"));
+}
+
+void test_profile_allocates_nothing() {
+    assertRequestAllocatesNothing("/api/profile");
+    TEST_ASSERT_NOT_NULL(strstr(response, "\"sections\": [{\"name\": \"network\""));
+}
+
+void test_metrics_allocates_nothing() {
+    runFor(1000ul);
+    TEST_ASSERT_EQUAL(200, request("/api/metrics"));
+    runFor(1000ul);
+    TEST_ASSERT_EQUAL(200, request("/api/metrics"));
+    TEST_ASSERT_EQUAL_UINT32(0, getHandlerAllocs("/api/metrics"));
+}
+
+void test_fleet_allocates_nothing() {
+    assertRequestAllocatesNothing("/api/fleet");
+}
+
+int main(int argc, char **argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_steady_loop_allocates_nothing);
+    RUN_TEST(test_info_allocates_nothing);
+    RUN_TEST(test_diag_allocates_nothing);
+    RUN_TEST(test_boot_allocates_nothing);
+    RUN_TEST(test_heap_allocates_nothing);
+    RUN_TEST(test_profile_allocates_nothing);
+    RUN_TEST(test_metrics_allocates_nothing);
+    RUN_TEST(test_fleet_allocates_nothing);
+    remove(EEPROM_PATH);
+    remove(FLASH_PATH);
+
+    return UNITY_END();
+}
@@ -0,0 +1,276 @@
+/*
+    Tests of FleetTable - Feeds the table live and backlog packets as a
+    hub would take them off the broadcast port, and checks the readings
+    kept and the counts of what was heard and missed: New sensors,
+    repeats, gaps in the sequence, a sensor that restarts and readings
+    that turn up late in a backlog. Then fills the table and checks the
+    quietest sensor makes way, and that sensors gone quiet are marked
+    stale and then dropped. Last comes a burst from far more sensors than
+    the table holds, timed per packet.
+
+    Run with: pio test -e native -f test_fleet_table
+
+    Written by: Scott Griffis
+    Date: 10-19-2026
+*/
+
+#include <unity.h>
+#include <stdio.h>
+#include <string.h>
+#include <chrono>
+#include <FleetTable.h>
+
+#define IP_ADDR "192.168.123.31"
+#define IP_VALUE 0x1F7BA8C0ul // As IPAddress holds 192.168.123.31
+#define DEVICE_ID "A4C372"
+#define DEVICE_ID_VALUE 0xA4C372ul
+#define BURST_SENSORS 1000
+#define BURST_ROUNDS 20
+
+FleetTable *table;
+
+void setUp() {
+    table = new FleetTable();
+}
+
+void tearDown() {
+    delete table;
+}
+
+QueuedReading makeReading(uint32_t sequence) {
+    QueuedReading reading = {1792410856123ull + (sequence * 10000ull), sequence, 15.0f + (sequence / 100.0f), 34.52f};
+
+    return reading;
+}
+
+/**
+ * Sends the table a live broadcast of the given reading.
+ *
+ * @return Returns what handlePacket() did as bool.
+*/
+bool sendLive(const char *deviceId, uint32_t sequence, unsigned long nowMillis) {
+    char packet[BROADCAST_LIVE_PACKET_SIZE];
+    size_t length = BroadcastPacket::formatLive(packet, sizeof(packet), IP_ADDR, deviceId, makeReading(sequence));
+    TEST_ASSERT_NOT_EQUAL(0, length);
+
+    return table->handlePacket(packet, length, IP_VALUE, nowMillis);
+}
+
+/**
+ * Sends the table a backlog packet of the given readings.
+ *
+ * @return Returns what handlePacket() did as bool.
+*/
+bool sendBacklog(const uint32_t *sequences, uint8_t count, unsigned long nowMillis) {
+    QueuedReading batch[READING_BATCH_SIZE];
+    for (uint8_t i = 0; i < count; i++) {
+        batch[i] = makeReading(sequences[i]);
+    }
+    char packet[BROADCAST_BACKLOG_PACKET_SIZE];
+    size_t length = BroadcastPacket::formatBacklog(packet, sizeof(packet), IP_ADDR, DEVICE_ID, batch, count);
+    TEST_ASSERT_NOT_EQUAL(0, length);
+
+    return table->handlePacket(packet, length, IP_VALUE, nowMillis);
+}
+
+/**
+ * Finds the entry of the given sensor.
+ *
+ * @return Returns the entry or nullptr if not held as const FleetEntry*.
+*/
+const FleetEntry* findEntry(uint32_t id) {
+    for (uint16_t i = 0; i < table->getCount(); i++) {
+        if (table->getEntry(i).id == id) {
+
+            return &table->getEntry(i);
+        }
+    }
+
+    return nullptr;
+}
+
+void formatId(uint32_t id, char *text) {
+    snprintf(text, 7, "%06X", (unsigned) id);
+}
+
+void test_new_sensor_is_added() {
+    TEST_ASSERT_TRUE(sendLive(DEVICE_ID, 10, 5000ul));
+
+    TEST_ASSERT_EQUAL_UINT16(1, table->getCount());
+    const FleetEntry &entry = table->getEntry(0);
+    TEST_ASSERT_EQUAL_HEX32(DEVICE_ID_VALUE, entry.id);
+    TEST_ASSERT_EQUAL_HEX32(IP_VALUE, entry.ip);
+    TEST_ASSERT_EQUAL_UINT32(10, entry.sequence);
+    TEST_ASSERT_EQUAL_UINT64(makeReading(10).timestamp, entry.timestamp);
+    TEST_ASSERT_EQUAL_INT16(1510, entry.centiCelsius);
+    TEST_ASSERT_EQUAL_UINT16(3452, entry.centiHumidity);
+    TEST_ASSERT_EQUAL_UINT16(1, entry.heard);
+    TEST_ASSERT_EQUAL_UINT16(0, entry.missed);
+    TEST_ASSERT_EQUAL_UINT32(5000, entry.lastSeenMillis);
+}
+
+void test_repeat_is_heard_not_missed() {
+    sendLive(DEVICE_ID, 10, 5000ul);
+    sendLive(DEVICE_ID, 10, 5100ul); // Sent twice, as a retry would
+
+    const FleetEntry &entry = table->getEntry(0);
+    TEST_ASSERT_EQUAL_UINT16(1, table->getCount());
+    TEST_ASSERT_EQUAL_UINT32(10, entry.sequence);
+    TEST_ASSERT_EQUAL_UINT16(2, entry.heard);
+    TEST_ASSERT_EQUAL_UINT16(0, entry.missed);
+    TEST_ASSERT_EQUAL_UINT32(5100, entry.lastSeenMillis);
+}
+
+void test_gap_counts_missed() {
+    sendLive(DEVICE_ID, 10, 5000ul);
+    sendLive(DEVICE_ID, 11, 15000ul);
+    sendLive(DEVICE_ID, 15, 55000ul); // 12 to 14 never arrived
+
+    const FleetEntry &entry = table->getEntry(0);
+    TEST_ASSERT_EQUAL_UINT32(15, entry.sequence);
+    TEST_ASSERT_EQUAL_INT16(1515, entry.centiCelsius);
+    TEST_ASSERT_EQUAL_UINT16(3, entry.heard);
+    TEST_ASSERT_EQUAL_UINT16(3, entry.missed);
+}
+
+void test_live_restart_is_taken() {
+    sendLive(DEVICE_ID, 500, 5000ul);
+    sendLive(DEVICE_ID, 1, 15000ul); // Started over from power up
+
+    const FleetEntry &entry = table->getEntry(0);
+    TEST_ASSERT_EQUAL_UINT32(1, entry.sequence);
+    TEST_ASSERT_EQUAL_INT16(1501, entry.centiCelsius);
+    TEST_ASSERT_EQUAL_UINT16(0, entry.missed);
+
+    sendLive(DEVICE_ID, 2, 25000ul); // Carries on from the new start
+    TEST_ASSERT_EQUAL_UINT32(2, table->getEntry(0).sequence);
+    TEST_ASSERT_EQUAL_UINT16(0, table->getEntry(0).missed);
+}
+
+void test_late_backlog_arrivals() {
+    sendLive(DEVICE_ID, 10, 5000ul);
+    sendLive(DEVICE_ID, 15, 55000ul);
+    TEST_ASSERT_EQUAL_UINT16(4, table->getEntry(0).missed);
+
+    const uint32_t late[] = {11, 12, 13};
+    TEST_ASSERT_TRUE(sendBacklog(late, 3, 60000ul)); // Forwarded once back online
+
+    const FleetEntry &entry = table->getEntry(0);
+    TEST_ASSERT_EQUAL_UINT16(1, entry.missed); // Only 14 still missing
+    TEST_ASSERT_EQUAL_UINT32(15, entry.sequence); // Latest kept
+    TEST_ASSERT_EQUAL_INT16(1515, entry.centiCelsius);
+    TEST_ASSERT_EQUAL_UINT16(5, entry.heard);
+
+    const uint32_t newer[] = {16, 17};
+    sendBacklog(newer, 2, 61000ul); // Newer than held, so taken
+    TEST_ASSERT_EQUAL_UINT32(17, table->getEntry(0).sequence);
+    TEST_ASSERT_EQUAL_UINT16(1, table->getEntry(0).missed);
+}
+
+void test_bad_packets_are_rejected() {
+    const char *notOurs = "M-SEARCH * HTTP/1.1";
+    const char *badId = "TempBuddy-Sensor::192.168.123.31::A4C3ZZ::T_15.63::H_34.52::TS_1792410886123::SEQ_411";
+
+    TEST_ASSERT_FALSE(table->handlePacket(notOurs, strlen(notOurs), IP_VALUE, 5000ul));
+    TEST_ASSERT_FALSE(table->handlePacket(badId, strlen(badId), IP_VALUE, 5000ul));
+    TEST_ASSERT_TRUE(sendLive(DEVICE_ID, 10, 5000ul));
+    TEST_ASSERT_EQUAL_UINT16(1, table->getCount());
+    TEST_ASSERT_EQUAL_UINT32(3, table->getPacketCount());
+    TEST_ASSERT_EQUAL_UINT32(2, table->getRejectedCount());
+}
+
+void test_full_table_evicts_quietest() {
+    char id[7];
+    for (uint32_t i = 0; i < FLEET_MAX_SENSORS; i++) {
+        formatId(0x100000ul + i, id);
+        TEST_ASSERT_TRUE(sendLive(id, 1, 1000ul + i));
+    }
+    formatId(0x100000ul, id);
+    sendLive(id, 2, 2000ul); // Oldest heard again, so the second oldest is now the quietest
+    TEST_ASSERT_EQUAL_UINT16(FLEET_MAX_SENSORS, table->getCount());
+    TEST_ASSERT_EQUAL_UINT32(0, table->getEvictedCount());
+
+    TEST_ASSERT_TRUE(sendLive(DEVICE_ID, 1, 3000ul));
+    TEST_ASSERT_EQUAL_UINT16(FLEET_MAX_SENSORS, table->getCount());
+    TEST_ASSERT_EQUAL_UINT32(1, table->getEvictedCount());
+    TEST_ASSERT_NOT_NULL(findEntry(DEVICE_ID_VALUE));
+    TEST_ASSERT_NOT_NULL(findEntry(0x100000ul));
+    TEST_ASSERT_NULL(findEntry(0x100001ul));
+    TEST_ASSERT_EQUAL_UINT16(1, findEntry(DEVICE_ID_VALUE)->heard); // Starts afresh in the reused slot
+}
+
+void test_quiet_sensors_go_stale_then_expire() {
+    sendLive(DEVICE_ID, 1, 1000ul);
+    sendLive("B0B0B0", 1, 1000ul + FLEET_STALE_MILLIS);
+
+    TEST_ASSERT_FALSE(table->isStale(table->getEntry(0), 1000ul + FLEET_STALE_MILLIS - 1));
+    TEST_ASSERT_TRUE(table->isStale(table->getEntry(0), 1000ul + FLEET_STALE_MILLIS));
+
+    table->expire(1000ul + FLEET_EXPIRE_MILLIS - 1);
+    TEST_ASSERT_EQUAL_UINT16(2, table->getCount());
+    table->expire(1000ul + FLEET_EXPIRE_MILLIS);
+    TEST_ASSERT_EQUAL_UINT16(1, table->getCount()); // Heard a minute later, so kept
+    TEST_ASSERT_EQUAL_HEX32(0xB0B0B0ul, table->getEntry(0).id);
+    TEST_ASSERT_TRUE(table->isStale(table->getEntry(0), 1000ul + FLEET_EXPIRE_MILLIS));
+
+    table->expire(1000ul + FLEET_STALE_MILLIS + FLEET_EXPIRE_MILLIS);
+    TEST_ASSERT_EQUAL_UINT16(0, table->getCount());
+    TEST_ASSERT_EQUAL_UINT32(0, table->getEvictedCount()); // Expiry isn't eviction
+}
+
+void test_burst_of_distinct_ids() {
+    static char packets[BURST_SENSORS][BROADCAST_LIVE_PACKET_SIZE]; // Written ahead so only the table is timed
+    static size_t lengths[BURST_SENSORS];
+    char id[7];
+    for (uint32_t i = 0; i < BURST_SENSORS; i++) {
+        formatId(0x200000ul + i, id);
+        lengths[i] = BroadcastPacket::formatLive(packets[i], sizeof(packets[i]), IP_ADDR, id, makeReading(1));
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    unsigned long nowMillis = 1000ul;
+    for (int round = 0; round < BURST_ROUNDS; round++) {
+        for (uint32_t i = 0; i < BURST_SENSORS; i++) {
+            table->handlePacket(packets[i], lengths[i], IP_VALUE, nowMillis++);
+        }
+    }
+    auto elapsed = std::chrono::steady_clock::now() - start;
+    double burstNanos = (double) std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count() / (BURST_ROUNDS * BURST_SENSORS);
+
+    TEST_ASSERT_EQUAL_UINT16(FLEET_MAX_SENSORS, table->getCount());
+    TEST_ASSERT_EQUAL_UINT32(BURST_ROUNDS * BURST_SENSORS, table->getPacketCount());
+    TEST_ASSERT_EQUAL_UINT32(0, table->getRejectedCount());
+    TEST_ASSERT_EQUAL_UINT32((BURST_ROUNDS * BURST_SENSORS) - FLEET_MAX_SENSORS, table->getEvictedCount());
+    for (uint32_t i = BURST_SENSORS - FLEET_MAX_SENSORS; i < BURST_SENSORS; i++) { // The most recently heard are held
+        TEST_ASSERT_NOT_NULL(findEntry(0x200000ul + i));
+    }
+
+    start = std::chrono::steady_clock::now();
+    for (int round = 0; round < BURST_ROUNDS; round++) {
+        for (uint32_t i = BURST_SENSORS - FLEET_MAX_SENSORS; i < BURST_SENSORS; i++) {
+            table->handlePacket(packets[i], lengths[i], IP_VALUE, nowMillis++);
+        }
+    }
+    elapsed = std::chrono::steady_clock::now() - start;
+    double knownNanos = (double) std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count() / (BURST_ROUNDS * FLEET_MAX_SENSORS);
+
+    char report[160];
+    snprintf(report, sizeof(report), "%d sensors through a full table %.1f ns per packet; %d known sensors %.1f ns per packet; On this host", BURST_SENSORS, burstNanos, FLEET_MAX_SENSORS, knownNanos);
+    TEST_MESSAGE(report);
+    TEST_ASSERT_EQUAL_UINT32((BURST_ROUNDS * BURST_SENSORS) - FLEET_MAX_SENSORS, table->getEvictedCount()); // None pushed out by the known
+}
+
+int main(int argc, char **argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_new_sensor_is_added);
+    RUN_TEST(test_repeat_is_heard_not_missed);
+    RUN_TEST(test_gap_counts_missed);
+    RUN_TEST(test_live_restart_is_taken);
+    RUN_TEST(test_late_backlog_arrivals);
+    RUN_TEST(test_bad_packets_are_rejected);
+    RUN_TEST(test_full_table_evicts_quietest);
+    RUN_TEST(test_quiet_sensors_go_stale_then_expire);
+    RUN_TEST(test_burst_of_distinct_ids);
+
+    return UNITY_END();
+}
@@ -0,0 +1,305 @@
+/*
+    Tests of IpUtils - Checks parseIPv4() against a plain reference parser
+    over many generated and mutated inputs, round trips every kind of
+    address through formatIPv4(), and times both against sscanf() and
+    snprintf() as a microbenchmark. The parse is also checked at compile
+    time, since it is constexpr.
+
+    Run with: pio test -e native -f test_ip_utils
+
+    Written by: Scott Griffis
+    Date: 10-19-2026
+*/
+
+#include <unity.h>
+#include <stdio.h>
+#include <string.h>
+#include <chrono>
+#include <IpUtils.h>
+
+#define FUZZ_ROUNDS 200000
+#define BENCH_ROUNDS 1000000
+#define MAX_FUZZ_LENGTH 20
+
+/**
+ * Parses the given text at compile time.
+ *
+ * @return Returns the address, or 0xFFFFFFFF if it isn't one as uint32_t.
+*/
+constexpr uint32_t parseAtCompileTime(const char *text, size_t length) {
+    uint32_t address = 0;
+
+    return (IpUtils::parseIPv4(text, length, address) == IP_PARSE_OK ? address : 0xFFFFFFFFul);
+}
+
+static_assert(parseAtCompileTime("192.168.1.10", 12) == 0xC0A8010Aul, "Parses at compile time");
+static_assert(parseAtCompileTime("255.255.255.255", 15) == 0xFFFFFFFFul, "Top address");
+static_assert(parseAtCompileTime("0.0.0.0", 7) == 0ul, "Bottom address");
+static_assert(parseAtCompileTime("256.0.0.1", 9) == 0xFFFFFFFFul, "Octet over 255");
+static_assert(IpUtils::getOctet(0xC0A8010Aul, 0) == 192 && IpUtils::getOctet(0xC0A8010Aul, 3) == 10, "First octet in the high byte");
+
+uint32_t randomState = 0x2545F491ul;
+
+/**
+ * Gets the next of a repeatable run of pseudo random numbers, so a
+ * failure can be reproduced.
+*/
+uint32_t nextRandom() {
+    randomState ^= randomState << 13;
+    randomState ^= randomState >> 17;
+    randomState ^= randomState << 5;
+
+    return randomState;
+}
+
+void setUp() {
+    randomState = 0x2545F491ul;
+}
+
+void tearDown() {}
+
+/**
+ * Parses an address the plain way: Split on the dots, then check
+ * each part on its own.
+ *
+ * @return Returns true if an address, setting it, otherwise false as bool.
+*/
+bool referenceParse(const char *text, size_t length, uint32_t &address) {
+    uint32_t result = 0;
+    size_t start = 0;
+    int parts = 0;
+    for (size_t i = 0; i <= length; i++) {
+        if (i < length && text[i] != '.') {
+
+            continue;
+        }
+        size_t partLength = i - start;
+        if (partLength < 1 || partLength > 3 || ++parts > 4) {
+
+            return false;
+        }
+        unsigned value = 0;
+        for (size_t j = start; j < i; j++) {
+            if (text[j] < '0' || text[j] > '9') {
+
+                return false;
+            }
+            value = (value * 10) + (text[j] - '0');
+        }
+        if (value > 255) {
+
+            return false;
+        }
+        result = (result << 8) | value;
+        start = i + 1;
+    }
+    if (parts != 4) {
+
+        return false;
+    }
+    address = result;
+
+    return true;
+}
+
+/**
+ * Checks the parse agrees with the reference on the given text, and
+ * leaves the address alone when it isn't one.
+*/
+void checkAgainstReference(const char *text, size_t length) {
+    uint32_t expected = 0;
+    uint32_t actual = 0x5A5A5A5Aul;
+    bool isAddress = referenceParse(text, length, expected);
+    IpParseStatus status = IpUtils::parseIPv4(text, length, actual);
+
+    if (isAddress != (status == IP_PARSE_OK)) {
+        char message[80];
+        snprintf(message, sizeof(message), "Disagrees on '%.*s' (status %d)", (int) length, text, (int) status);
+        TEST_FAIL_MESSAGE(message);
+    }
+    TEST_ASSERT_EQUAL_HEX32((isAddress ? expected : 0x5A5A5A5Aul), actual);
+}
+
+/**
+ * Fills the buffer with a random address, each octet 0 to 255 with
+ * as many digits as it takes.
+ *
+ * @return Returns the length of the text as size_t.
+*/
+size_t makeAddress(char *buffer, size_t size, uint32_t &address) {
+    address = nextRandom();
+
+    return (size_t) snprintf(buffer, size, "%u.%u.%u.%u", (unsigned) (address >> 24), (unsigned) ((address >> 16) & 0xFF), (unsigned) ((address >> 8) & 0xFF), (unsigned) (address & 0xFF));
+}
+
+void test_known_inputs() {
+    const char *good[] = {"1.2.3.4", "10.0.0.1", "192.168.123.255", "255.255.255.255", "0.0.0.0", "001.002.003.004"};
+    for (const char *text : good) {
+        uint32_t address = 0;
+        TEST_ASSERT_EQUAL(IP_PARSE_OK, IpUtils::parseIPv4(text, strlen(text), address));
+    }
+
+    uint32_t address = 0;
+    TEST_ASSERT_EQUAL(IP_PARSE_EMPTY, IpUtils::parseIPv4("", 0, address));
+    TEST_ASSERT_EQUAL(IP_PARSE_BAD_CHAR, IpUtils::parseIPv4("1.2.3.a", 7, address));
+    TEST_ASSERT_EQUAL(IP_PARSE_BAD_CHAR, IpUtils::parseIPv4(" 1.2.3.4", 8, address));
+    TEST_ASSERT_EQUAL(IP_PARSE_BAD_CHAR, IpUtils::parseIPv4("-1.2.3.4", 8, address));
+    TEST_ASSERT_EQUAL(IP_PARSE_BAD_OCTET, IpUtils::parseIPv4("1..3.4", 6, address));
+    TEST_ASSERT_EQUAL(IP_PARSE_BAD_OCTET, IpUtils::parseIPv4("1.2.3.4.", 8, address));
+    TEST_ASSERT_EQUAL(IP_PARSE_BAD_OCTET, IpUtils::parseIPv4("1.2.3.0004", 10, address));
+    TEST_ASSERT_EQUAL(IP_PARSE_BAD_OCTET, IpUtils::parseIPv4("1.2.3.999", 9, address));
+    TEST_ASSERT_EQUAL(IP_PARSE_OCTET_COUNT, IpUtils::parseIPv4("1.2.3", 5, address));
+    TEST_ASSERT_EQUAL(IP_PARSE_OCTET_COUNT, IpUtils::parseIPv4("1.2.3.4.5", 9, address));
+}
+
+void test_length_bounds_the_parse() {
+    const char text[] = "192.168.1.10999";
+    uint32_t address = 0;
+
+    TEST_ASSERT_EQUAL(IP_PARSE_OK, IpUtils::parseIPv4(text, 12, address)); // Stops short of the trailing digits
+    TEST_ASSERT_EQUAL_HEX32(0xC0A8010Aul, address);
+    const char unterminated[4] = {'1', '.', '2', '.'};
+    TEST_ASSERT_EQUAL(IP_PARSE_OCTET_COUNT, IpUtils::parseIPv4(unterminated, 3, address));
+}
+
+void test_fuzz_random_text() {
+    const char alphabet[] = "0123456789....x 25";
+    char text[MAX_FUZZ_LENGTH];
+    for (int round = 0; round < FUZZ_ROUNDS; round++) {
+        size_t length = nextRandom() % (MAX_FUZZ_LENGTH + 1);
+        for (size_t i = 0; i < length; i++) {
+            uint32_t pick = nextRandom();
+            text[i] = ((pick & 0xF000) == 0 ? (char) (pick >> 16) : alphabet[pick % (sizeof(alphabet) - 1)]); // Now and then any byte at all
+        }
+        checkAgainstReference(text, length);
+    }
+}
+
+void test_fuzz_mutated_addresses() {
+    char text[MAX_FUZZ_LENGTH + 2];
+    int goodCount = 0;
+    for (int round = 0; round < FUZZ_ROUNDS; round++) {
+        uint32_t address = 0;
+        size_t length = makeAddress(text, sizeof(text), address);
+        size_t at = nextRandom() % (length + 1);
+        switch (nextRandom() % 4) {
+            case 0: // Change a character...
+                if (at < length) {
+                    text[at] = "0123456789.9"[nextRandom() % 12];
+                }
+                break;
+            case 1: // Drop a character...
+                if (at < length) {
+                    memmove(&text[at], &text[at + 1], length - at);
+                    length--;
+                }
+                break;
+            case 2: // Add a character...
+                memmove(&text[at + 1], &text[at], length - at + 1);
+                text[at] = "0123456789."[nextRandom() % 11];
+                length++;
+                break;
+            default: // Leave it be...
+                break;
+        }
+        uint32_t parsed = 0;
+        goodCount += (IpUtils::parseIPv4(text, length, parsed) == IP_PARSE_OK ? 1 : 0);
+        checkAgainstReference(text, length);
+    }
+    TEST_ASSERT_GREATER_THAN(FUZZ_ROUNDS / 4, goodCount); // Mutations stay close enough to be worth it
+}
+
+void test_format_round_trips() {
+    char text[IPV4_TEXT_SIZE];
+    char expected[IPV4_TEXT_SIZE];
+    for (int round = 0; round < FUZZ_ROUNDS; round++) {
+        uint32_t address = 0;
+        size_t expectedLength = makeAddress(expected, sizeof(expected), address);
+        IPAddress ip(IpUtils::getOctet(address, 0), IpUtils::getOctet(address, 1), IpUtils::getOctet(address, 2), IpUtils::getOctet(address, 3));
+
+        TEST_ASSERT_EQUAL_size_t(expectedLength, IpUtils::formatIPv4(ip, text, sizeof(text)));
+        TEST_ASSERT_EQUAL_STRING(expected, text);
+        IPAddress parsed;
+        TEST_ASSERT_EQUAL(IP_PARSE_OK, IpUtils::parseIPv4(text, parsed));
+        TEST_ASSERT_TRUE(parsed == ip);
+    }
+}
+
+void test_format_into_small_buffers() {
+    char text[IPV4_TEXT_SIZE];
+    IPAddress ip(192, 168, 123, 255);
+    for (size_t size = 0; size <= 15; size++) { // One short of room for the null, or worse
+        memset(text, '#', sizeof(text));
+        TEST_ASSERT_EQUAL_size_t(0, IpUtils::formatIPv4(ip, text, size));
+        if (size > 0) { // Left empty...
+            TEST_ASSERT_EQUAL_CHAR('\0', text[0]);
+        }
+        TEST_ASSERT_EQUAL_CHAR('#', text[size]); // Nothing written past the size
+    }
+    TEST_ASSERT_EQUAL_size_t(15, IpUtils::formatIPv4(ip, text, 16));
+}
+
+void test_broadcast_address() {
+    TEST_ASSERT_TRUE(IpUtils::deriveNetworkBroadcastAddress(IPAddress(192, 168, 123, 31), IPAddress(255, 255, 255, 0)) == IPAddress(192, 168, 123, 255));
+    TEST_ASSERT_TRUE(IpUtils::deriveNetworkBroadcastAddress(IPAddress(10, 1, 2, 3), IPAddress(255, 0, 0, 0)) == IPAddress(10, 255, 255, 255));
+    TEST_ASSERT_TRUE(IpUtils::deriveNetworkBroadcastAddress(IPAddress(172, 16, 5, 9), IPAddress(255, 255, 252, 0)) == IPAddress(172, 16, 7, 255));
+}
+
+/**
+ * Times the given work over the benchmark rounds.
+ *
+ * @return Returns nanoseconds per round as double.
+*/
+template<typename Work> double timePerRound(Work work) {
+    auto start = std::chrono::steady_clock::now();
+    for (int round = 0; round < BENCH_ROUNDS; round++) {
+        work(round);
+    }
+    auto elapsed = std::chrono::steady_clock::now() - start;
+
+    return (double) std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count() / BENCH_ROUNDS;
+}
+
+void test_benchmark() {
+    const char *texts[] = {"192.168.123.31", "10.0.0.1", "255.255.255.0", "172.16.254.199"};
+    volatile uint32_t sink = 0;
+
+    double parseNanos = timePerRound([&](int round) {
+        uint32_t address = 0;
+        const char *text = texts[round & 3];
+        IpUtils::parseIPv4(text, strlen(text), address);
+        sink = sink + address;
+    });
+    double sscanfNanos = timePerRound([&](int round) {
+        unsigned a = 0, b = 0, c = 0, d = 0;
+        sscanf(texts[round & 3], "%u.%u.%u.%u", &a, &b, &c, &d);
+        sink = sink + a + d;
+    });
+    char text[IPV4_TEXT_SIZE];
+    double formatNanos = timePerRound([&](int round) {
+        IPAddress ip(192, 168, (uint8_t) (round >> 8), (uint8_t) round);
+        sink = sink + IpUtils::formatIPv4(ip, text, sizeof(text));
+    });
+    double snprintfNanos = timePerRound([&](int round) {
+        sink = sink + snprintf(text, sizeof(text), "%u.%u.%u.%u", 192u, 168u, (unsigned) ((round >> 8) & 0xFF), (unsigned) (round & 0xFF));
+    });
+
+    char report[160];
+    snprintf(report, sizeof(report), "parseIPv4 %.1f ns (sscanf %.1f ns); formatIPv4 %.1f ns (snprintf %.1f ns); Per call on this host", parseNanos, sscanfNanos, formatNanos, snprintfNanos);
+    TEST_MESSAGE(report);
+    TEST_ASSERT_NOT_EQUAL(0, sink);
+}
+
+int main(int argc, char **argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_known_inputs);
+    RUN_TEST(test_length_bounds_the_parse);
+    RUN_TEST(test_fuzz_random_text);
+    RUN_TEST(test_fuzz_mutated_addresses);
+    RUN_TEST(test_format_round_trips);
+    RUN_TEST(test_format_into_small_buffers);
+    RUN_TEST(test_broadcast_address);
+    RUN_TEST(test_benchmark);
+
+    return UNITY_END();
+}
@@ -0,0 +1,141 @@
+/*
+    Tests of LoopProfiler - Records sections run at both CPU speeds on a
+    clock of the test's own and checks their times are those they ran
+    for, whatever the speed is when they are read back. Also checks runs
+    under a micro still add up, and that the slowest loop is timed whole
+    and kept section by section.
+
+    Run with: pio test -e native -f test_loop_profiler
+
+    Written by: Scott Griffis
+    Date: 10-19-2026
+*/
+
+#include <unity.h>
+#include <Emulator.h>
+#include <user_interface.h>
+#include <LoopProfiler.h>
+
+#define SECTION_A 0
+#define SECTION_B 1
+
+const char* const SECTION_NAMES[] = {"a", "b"};
+
+uint64_t clockNanos = 0ull;
+DeviceConfig device;
+LoopProfiler *profiler;
+
+uint64_t readClock() {
+
+    return clockNanos;
+}
+
+bool passTime(uint64_t micros) {
+    clockNanos += micros * 1000ull;
+
+    return true;
+}
+
+bool isStopping() {
+
+    return false;
+}
+
+void setUp() {
+    memset(&device, 0, sizeof(device));
+    device.sleep = passTime;
+    device.isStopping = isStopping;
+    device.clockNanos = readClock;
+    clockNanos = 0ull;
+    Emulator::attach(&device);
+    system_update_cpu_freq(SYS_CPU_160MHZ);
+
+    profiler = new LoopProfiler(SECTION_NAMES, 2);
+}
+
+void tearDown() {
+    delete profiler;
+}
+
+/**
+ * Runs a section for the given time at the speed the CPU is at,
+ * recording the cycles it took as PROFILE_SECTION does.
+*/
+void runSection(uint8_t section, uint32_t micros) {
+    uint32_t startCycles = ESP.getCycleCount();
+    clockNanos += micros * 1000ull;
+    profiler->record(section, ESP.getCycleCount() - startCycles);
+}
+
+void test_runs_at_both_speeds_are_timed_as_run() {
+    runSection(SECTION_A, 100);
+    system_update_cpu_freq(SYS_CPU_80MHZ);
+    runSection(SECTION_A, 100);
+    runSection(SECTION_A, 100);
+
+    const SectionProfile &profile = profiler->getSection(SECTION_A);
+    TEST_ASSERT_EQUAL_UINT32(3, profile.count);
+    TEST_ASSERT_EQUAL_UINT32(100, profiler->getAverageMicros(SECTION_A));
+    TEST_ASSERT_EQUAL_UINT32(100, profile.maxMicros);
+    TEST_ASSERT_EQUAL_UINT64(300000ull, profile.totalNanos);
+    TEST_ASSERT_EQUAL_UINT32(3, profile.buckets[6]); // 64 up to 128 micros
+}
+
+void test_times_stay_put_when_speed_changes_after() {
+    system_update_cpu_freq(SYS_CPU_80MHZ);
+    runSection(SECTION_A, 2500);
+    system_update_cpu_freq(SYS_CPU_160MHZ); // Sped up before the report is read
+
+    TEST_ASSERT_EQUAL_UINT32(2500, profiler->getAverageMicros(SECTION_A));
+    TEST_ASSERT_EQUAL_UINT32(2500, profiler->getSection(SECTION_A).maxMicros);
+    TEST_ASSERT_EQUAL_UINT32(1, profiler->getSection(SECTION_A).buckets[11]); // 2048 up to 4096 micros
+}
+
+void test_runs_under_a_micro_add_up() {
+    for (int i = 0; i < 1000; i++) {
+        profiler->record(SECTION_B, 80); // Half a micro at 160MHz
+    }
+
+    TEST_ASSERT_EQUAL_UINT64(500000ull, profiler->getSection(SECTION_B).totalNanos);
+    TEST_ASSERT_EQUAL_UINT32(1000, profiler->getSection(SECTION_B).buckets[0]);
+}
+
+void test_slowest_loop_is_kept_whole() {
+    profiler->beginLoop();
+    runSection(SECTION_A, 2000);
+    system_update_cpu_freq(SYS_CPU_80MHZ); // Dropped within the loop
+    clockNanos += 500000ull; // Not in any section
+    runSection(SECTION_B, 3000);
+    profiler->endLoop();
+    unsigned long worstMillis = millis();
+
+    profiler->beginLoop(); // Quicker, so not kept
+    runSection(SECTION_A, 10);
+    runSection(SECTION_B, 10);
+    profiler->endLoop();
+
+    TEST_ASSERT_EQUAL_UINT32(2, profiler->getLoopCount());
+    TEST_ASSERT_EQUAL_UINT32(5500, profiler->getMaxLoopMicros());
+    TEST_ASSERT_EQUAL_UINT32(2000, profiler->getWorstMicros(SECTION_A));
+    TEST_ASSERT_EQUAL_UINT32(3000, profiler->getWorstMicros(SECTION_B));
+    TEST_ASSERT_EQUAL_UINT32(worstMillis, profiler->getWorstMillis());
+}
+
+void test_unknown_section_is_ignored() {
+    profiler->record(PROFILER_MAX_SECTIONS, 1000);
+    profiler->record(2, 1000); // Past the sections given
+
+    TEST_ASSERT_EQUAL_UINT32(0, profiler->getSection(SECTION_A).count);
+    TEST_ASSERT_EQUAL_UINT32(0, profiler->getSection(SECTION_B).count);
+}
+
+int main(int argc, char **argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_runs_at_both_speeds_are_timed_as_run);
+    RUN_TEST(test_times_stay_put_when_speed_changes_after);
+    RUN_TEST(test_runs_under_a_micro_add_up);
+    RUN_TEST(test_slowest_loop_is_kept_whole);
+    RUN_TEST(test_unknown_section_is_ignored);
+
+    return UNITY_END();
+}
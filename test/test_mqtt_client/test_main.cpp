@@ -0,0 +1,350 @@
+/*
+    Tests of MqttClient - Runs the client against a broker faked behind
+    the Client interface, on a clock of the test's own, and checks the
+    bytes of the CONNECT it sends with and without a last will, that a
+    QoS 1 message is resent flagged DUP until acknowledged, including
+    across a reconnect, and that only the PUBACK carrying its packet ID
+    clears it.
+
+    Run with: pio test -e native -f test_mqtt_client
+
+    Written by: Scott Griffis
+    Date: 10-19-2026
+*/
+
+#include <unity.h>
+#include <Emulator.h>
+#include <MqttClient.h>
+
+#define MAX_WRITES 16
+
+uint64_t clockNanos = 0ull;
+DeviceConfig device;
+
+// ************************************************************************************
+// A broker connection faked behind the Client interface; Each write is kept
+// as a packet since the client writes whole packets only
+// ************************************************************************************
+class FakeClient : public Client {
+    public:
+        bool           isReachable      = true;
+        bool           isOpen           = false;
+        int            room             = 1024;
+        int            connectCount     = 0;
+        uint8_t        written          [MAX_WRITES][MQTT_MAX_PACKET_SIZE];
+        size_t         writtenLength    [MAX_WRITES];
+        int            writeCount       = 0;
+        uint8_t        incoming         [64];
+        size_t         incomingLength   = 0;
+        size_t         incomingOffset   = 0;
+
+        int connect(IPAddress ip, uint16_t port) override {
+
+            return connect("", port);
+        }
+
+        int connect(const char *host, uint16_t port) override {
+            connectCount++;
+            isOpen = isReachable;
+            incomingLength = 0;
+            incomingOffset = 0;
+
+            return (isOpen ? 1 : 0);
+        }
+
+        size_t write(uint8_t value) override {
+
+            return write(&value, 1);
+        }
+
+        size_t write(const uint8_t *buffer, size_t size) override {
+            if (!isOpen || writeCount == MAX_WRITES) {
+
+                return 0;
+            }
+            memcpy(written[writeCount], buffer, size);
+            writtenLength[writeCount++] = size;
+
+            return size;
+        }
+
+        int availableForWrite() override {
+
+            return (isOpen ? room : 0);
+        }
+
+        int available() override {
+
+            return (int) (incomingLength - incomingOffset);
+        }
+
+        int read() override {
+
+            return (incomingOffset < incomingLength ? incoming[incomingOffset++] : -1);
+        }
+
+        int read(uint8_t *buffer, size_t size) override {
+            size_t count = 0;
+            while (count < size && incomingOffset < incomingLength) {
+                buffer[count++] = incoming[incomingOffset++];
+            }
+
+            return (int) count;
+        }
+
+        int peek() override {
+
+            return (incomingOffset < incomingLength ? incoming[incomingOffset] : -1);
+        }
+
+        void flush() override {}
+
+        void stop() override {
+            isOpen = false;
+        }
+
+        uint8_t connected() override {
+
+            return (isOpen ? 1 : 0);
+        }
+
+        operator bool() override {
+
+            return isOpen;
+        }
+
+        /**
+         * Queues bytes from the broker to be read.
+        */
+        void receive(const uint8_t *data, size_t length) {
+            memcpy(&incoming[incomingLength], data, length);
+            incomingLength += length;
+        }
+};
+
+FakeClient *fake;
+MqttClient *mqtt;
+
+uint64_t readClock() {
+
+    return clockNanos;
+}
+
+bool passTime(uint64_t micros) {
+    clockNanos += micros * 1000ull;
+
+    return true;
+}
+
+bool isStopping() {
+
+    return false;
+}
+
+void setUp() {
+    memset(&device, 0, sizeof(device));
+    device.sleep = passTime;
+    device.isStopping = isStopping;
+    device.clockNanos = readClock;
+    clockNanos = 0ull;
+    Emulator::attach(&device);
+
+    fake = new FakeClient();
+    mqtt = new MqttClient(*fake);
+}
+
+void tearDown() {
+    delete mqtt;
+    delete fake;
+}
+
+/**
+ * Moves the clock on and runs a pass of the client.
+*/
+void runAfter(unsigned long millisToPass) {
+    clockNanos += millisToPass * 1000000ull;
+    mqtt->loop(millis());
+}
+
+void receiveConnack(uint8_t returnCode) {
+    const uint8_t connack[] = {0x20, 0x02, 0x00, returnCode};
+    fake->receive(connack, sizeof(connack));
+}
+
+void receivePuback(uint16_t packetId) {
+    const uint8_t puback[] = {0x40, 0x02, (uint8_t) (packetId >> 8), (uint8_t) (packetId & 0xFF)};
+    fake->receive(puback, sizeof(puback));
+}
+
+/**
+ * Connects to the fake broker with a last will and no login, leaving
+ * nothing written.
+*/
+void connectWithWill() {
+    mqtt->configure("broker.local", 1883, "TempBuddyA4C372", "", "", "tempbuddy/A4C372/status", "offline");
+    runAfter(0);
+    receiveConnack(0);
+    runAfter(10);
+    TEST_ASSERT_TRUE(mqtt->isConnected());
+    fake->writeCount = 0;
+}
+
+/**
+ * Reads the packet ID of a QoS 1 PUBLISH that was written.
+ *
+ * @return Returns the packet ID as uint16_t.
+*/
+uint16_t getPacketId(int writeIndex) {
+    const uint8_t *packet = fake->written[writeIndex];
+    size_t topicLength = (packet[2] << 8) | packet[3];
+
+    return (packet[4 + topicLength] << 8) | packet[5 + topicLength];
+}
+
+void test_connect_carries_will_and_login() {
+    mqtt->configure("broker.local", 1883, "TB1", "user", "pw", "t/s", "off");
+    runAfter(0);
+    TEST_ASSERT_EQUAL_STRING("connecting", mqtt->getStateName());
+    TEST_ASSERT_EQUAL(1, fake->writeCount);
+
+    const uint8_t expected[] = {
+        0x10, 35, // CONNECT, remaining length
+        0x00, 0x04, 'M', 'Q', 'T', 'T', 0x04, // Protocol name and level of 3.1.1
+        0xEE, // Login, will retained at QoS 1, clean session
+        0x00, MQTT_KEEP_ALIVE_SECS,
+        0x00, 0x03, 'T', 'B', '1',
+        0x00, 0x03, 't', '/', 's',
+        0x00, 0x03, 'o', 'f', 'f',
+        0x00, 0x04, 'u', 's', 'e', 'r',
+        0x00, 0x02, 'p', 'w'
+    };
+    TEST_ASSERT_EQUAL_size_t(sizeof(expected), fake->writtenLength[0]);
+    TEST_ASSERT_EQUAL_HEX8_ARRAY(expected, fake->written[0], sizeof(expected));
+
+    receiveConnack(0);
+    runAfter(10);
+    TEST_ASSERT_TRUE(mqtt->isConnected());
+    TEST_ASSERT_EQUAL_UINT32(1, mqtt->getConnectCount());
+}
+
+void test_connect_without_will_or_login() {
+    mqtt->configure("broker.local", 1883, "TB1", "", "", "", "");
+    runAfter(0);
+
+    const uint8_t expected[] = {0x10, 15, 0x00, 0x04, 'M', 'Q', 'T', 'T', 0x04, 0x02, 0x00, MQTT_KEEP_ALIVE_SECS, 0x00, 0x03, 'T', 'B', '1'};
+    TEST_ASSERT_EQUAL_size_t(sizeof(expected), fake->writtenLength[0]);
+    TEST_ASSERT_EQUAL_HEX8_ARRAY(expected, fake->written[0], sizeof(expected));
+}
+
+void test_refused_connect_backs_off() {
+    mqtt->configure("broker.local", 1883, "TB1", "user", "bad", "", "");
+    runAfter(0);
+    receiveConnack(5); // Not authorized
+    runAfter(10);
+    TEST_ASSERT_EQUAL_STRING("disconnected", mqtt->getStateName());
+    TEST_ASSERT_EQUAL_UINT8(5, mqtt->getLastRefusal());
+    TEST_ASSERT_FALSE(fake->isOpen);
+
+    runAfter((MQTT_RETRY_MIN_MILLIS * 2) - 20);
+    TEST_ASSERT_EQUAL(1, fake->connectCount); // Backed off past the least wait
+    runAfter(20);
+    TEST_ASSERT_EQUAL(2, fake->connectCount);
+}
+
+void test_qos1_resent_with_dup_until_acknowledged() {
+    connectWithWill();
+    TEST_ASSERT_TRUE(mqtt->publish("t/r", "21.5", 4, 1, false));
+    TEST_ASSERT_EQUAL(1, fake->writeCount);
+    TEST_ASSERT_EQUAL_HEX8(0x32, fake->written[0][0]); // PUBLISH at QoS 1
+    uint16_t packetId = getPacketId(0);
+    TEST_ASSERT_FALSE(mqtt->canPublish(1)); // One at a time
+    TEST_ASSERT_TRUE(mqtt->canPublish(0));
+
+    runAfter(MQTT_ACK_TIMEOUT_MILLIS - 10);
+    TEST_ASSERT_EQUAL(1, fake->writeCount);
+    runAfter(10);
+    TEST_ASSERT_EQUAL(2, fake->writeCount);
+    TEST_ASSERT_EQUAL_HEX8(0x3A, fake->written[1][0]); // Flagged DUP
+    TEST_ASSERT_EQUAL_UINT16(packetId, getPacketId(1));
+    TEST_ASSERT_EQUAL_MEMORY(&fake->written[0][1], &fake->written[1][1], fake->writtenLength[0] - 1);
+    TEST_ASSERT_EQUAL_UINT32(1, mqtt->getResendCount());
+
+    receivePuback(packetId);
+    runAfter(10);
+    TEST_ASSERT_FALSE(mqtt->hasInflight());
+    TEST_ASSERT_EQUAL_UINT32(1, mqtt->getAckCount());
+    runAfter(MQTT_ACK_TIMEOUT_MILLIS);
+    TEST_ASSERT_EQUAL_UINT32(1, mqtt->getResendCount()); // Not sent again
+}
+
+void test_qos1_resent_with_dup_after_reconnect() {
+    connectWithWill();
+    TEST_ASSERT_TRUE(mqtt->publish("t/r", "21.5", 4, 1, false));
+    uint16_t packetId = getPacketId(0);
+
+    fake->isOpen = false; // Broker drops off
+    runAfter(10);
+    TEST_ASSERT_EQUAL_STRING("disconnected", mqtt->getStateName());
+    TEST_ASSERT_TRUE(mqtt->hasInflight());
+
+    runAfter(MQTT_RETRY_MIN_MILLIS);
+    TEST_ASSERT_EQUAL_STRING("connecting", mqtt->getStateName());
+    TEST_ASSERT_EQUAL(2, fake->writeCount);
+    TEST_ASSERT_EQUAL_HEX8(0x10, fake->written[1][0]); // CONNECT, not the message, until accepted
+
+    receiveConnack(0);
+    runAfter(10);
+    TEST_ASSERT_EQUAL(3, fake->writeCount); // Resent straight away
+    TEST_ASSERT_EQUAL_HEX8(0x3A, fake->written[2][0]);
+    TEST_ASSERT_EQUAL_UINT16(packetId, getPacketId(2));
+
+    receivePuback(packetId);
+    runAfter(10);
+    TEST_ASSERT_FALSE(mqtt->hasInflight());
+    TEST_ASSERT_EQUAL_UINT32(2, mqtt->getConnectCount());
+}
+
+void test_only_matching_puback_clears_inflight() {
+    connectWithWill();
+    TEST_ASSERT_TRUE(mqtt->publish("t/r", "21.5", 4, 1, false));
+    uint16_t packetId = getPacketId(0);
+
+    receivePuback(packetId + 1);
+    runAfter(10);
+    TEST_ASSERT_TRUE(mqtt->hasInflight());
+    TEST_ASSERT_EQUAL_UINT32(0, mqtt->getAckCount());
+
+    receivePuback(packetId);
+    runAfter(10);
+    TEST_ASSERT_FALSE(mqtt->hasInflight());
+    TEST_ASSERT_EQUAL_UINT32(1, mqtt->getAckCount());
+
+    TEST_ASSERT_TRUE(mqtt->publish("t/r", "21.6", 4, 1, false));
+    TEST_ASSERT_EQUAL_UINT16(packetId + 1, getPacketId(1)); // Next ID
+    receivePuback(packetId); // Late repeat of the first
+    runAfter(10);
+    TEST_ASSERT_TRUE(mqtt->hasInflight());
+}
+
+void test_publish_turned_down_without_room() {
+    connectWithWill();
+    fake->room = 8;
+
+    TEST_ASSERT_FALSE(mqtt->publish("t/r", "21.5", 4, 1, false));
+    TEST_ASSERT_FALSE(mqtt->hasInflight());
+    TEST_ASSERT_EQUAL(0, fake->writeCount);
+    TEST_ASSERT_TRUE(mqtt->isConnected());
+}
+
+int main(int argc, char **argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_connect_carries_will_and_login);
+    RUN_TEST(test_connect_without_will_or_login);
+    RUN_TEST(test_refused_connect_backs_off);
+    RUN_TEST(test_qos1_resent_with_dup_until_acknowledged);
+    RUN_TEST(test_qos1_resent_with_dup_after_reconnect);
+    RUN_TEST(test_only_matching_puback_clears_inflight);
+    RUN_TEST(test_publish_turned_down_without_room);
+
+    return UNITY_END();
+}
@@ -0,0 +1,210 @@
+/*
+    Tests of NetworkManager - Runs the manager against the emulator's
+    stand in for the WiFi stack (tools/emulator/shims) on a clock of the
+    test's own, and checks the states it passes through as the events of
+    a join, a dropped connection and an access point out of range come
+    in, along with the addressing derived along the way.
+
+    Run with: pio test -e native -f test_network_manager
+
+    Written by: Scott Griffis
+    Date: 10-19-2026
+*/
+
+#include <unity.h>
+#include <Emulator.h>
+#include <NetworkManager.h>
+
+#define STEP_MILLIS 10ul
+#define SCAN_JOIN_MILLIS 1900ul // Scan and associate, then DHCP, as the stand in takes
+#define DIRECT_JOIN_MILLIS 700ul
+
+const uint8_t KNOWN_BSSID[6] = {0x02, 0x00, 0x00, 0x00, 0x00, 0x01}; // Access point of the stand in
+
+uint64_t clockNanos = 0ull;
+DeviceConfig device;
+NetworkManager *manager;
+String trace; // States entered, in order
+unsigned long enteredMillis[8]; // When each state of the trace was entered
+int traceCount;
+
+uint64_t readClock() {
+
+    return clockNanos;
+}
+
+bool passTime(uint64_t micros) {
+    clockNanos += micros * 1000ull;
+
+    return true;
+}
+
+bool isStopping() {
+
+    return false;
+}
+
+void setUp() {
+    memset(&device, 0, sizeof(device));
+    device.ip = (uint32_t) IPAddress(127, 1, 0, 1);
+    device.sleep = passTime;
+    device.isStopping = isStopping;
+    device.clockNanos = readClock;
+    Emulator::attach(&device);
+    WiFi.disconnect();
+    WiFi.setApInRange(true);
+    Emulator::attach(&device); // Drops the events of the last test
+
+    manager = new NetworkManager();
+    trace = "";
+    traceCount = 0;
+}
+
+void tearDown() {
+    delete manager;
+}
+
+StationConfig makeStation(const uint8_t *bssid, int32_t channel) {
+    StationConfig station = {"TempBuddyTest", "TestNet", "secret", bssid, channel, IPAddress(0, 0, 0, 0), IPAddress(0, 0, 0, 0), IPAddress(0, 0, 0, 0), IPAddress(0, 0, 0, 0)};
+
+    return station;
+}
+
+/**
+ * Runs the loop for the given time, as the firmware would, noting
+ * each state the manager enters.
+ *
+ * @return Returns true if the addressing changed along the way as bool.
+ */
+bool pump(unsigned long millisToRun) {
+    bool isChanged = false;
+    NetworkManager::State last = manager->getState();
+    for (unsigned long elapsed = 0ul; elapsed < millisToRun; elapsed += STEP_MILLIS) {
+        delay(STEP_MILLIS);
+        isChanged |= manager->update(millis());
+        if (manager->getState() != last) {
+            last = manager->getState();
+            trace += (trace.length() > 0 ? " " : "");
+            trace += manager->getStateName();
+            if (traceCount < 8) {
+                enteredMillis[traceCount++] = millis();
+            }
+        }
+    }
+
+    return isChanged;
+}
+
+void test_scan_join_comes_online() {
+    manager->beginStation(makeStation(nullptr, 0));
+    TEST_ASSERT_EQUAL_STRING("connecting", manager->getStateName());
+
+    TEST_ASSERT_TRUE(pump(SCAN_JOIN_MILLIS + 100ul));
+    TEST_ASSERT_EQUAL_STRING("online", trace.c_str());
+    TEST_ASSERT_TRUE(manager->isOnline());
+    TEST_ASSERT_TRUE(manager->getIpAddress() == IPAddress(127, 1, 0, 1));
+    TEST_ASSERT_TRUE(manager->getBcastAddress() == IPAddress(127, 255, 255, 255));
+    TEST_ASSERT_EQUAL_UINT32(1, manager->getConnectCount());
+    TEST_ASSERT_FALSE(manager->getLastWasFastConnect());
+    TEST_ASSERT_UINT32_WITHIN(STEP_MILLIS, SCAN_JOIN_MILLIS, manager->getLastConnectDuration());
+    TEST_ASSERT_EQUAL_MEMORY(KNOWN_BSSID, manager->getBssid(), sizeof(KNOWN_BSSID));
+    TEST_ASSERT_EQUAL_INT32(6, manager->getChannel());
+    TEST_ASSERT_FALSE(pump(1000ul)); // Nothing more to tell
+}
+
+void test_direct_join_skips_scan() {
+    manager->beginStation(makeStation(KNOWN_BSSID, 6));
+
+    pump(SCAN_JOIN_MILLIS);
+    TEST_ASSERT_EQUAL_STRING("online", trace.c_str());
+    TEST_ASSERT_TRUE(manager->getLastWasFastConnect());
+    TEST_ASSERT_UINT32_WITHIN(STEP_MILLIS, DIRECT_JOIN_MILLIS, manager->getLastConnectDuration());
+    TEST_ASSERT_LESS_THAN(manager->getGotIpMillis(), manager->getAssociatedMillis());
+}
+
+void test_failed_direct_join_falls_back_to_scan() {
+    WiFi.setApInRange(false);
+    manager->beginStation(makeStation(KNOWN_BSSID, 6));
+
+    pump(2000ul); // Direct join fails at 300ms, then a scan comes up empty
+    TEST_ASSERT_EQUAL_STRING("connecting", manager->getStateName());
+    WiFi.setApInRange(true);
+    pump(3000ul); // Found by the stack's next scan
+    TEST_ASSERT_EQUAL_STRING("online", trace.c_str());
+    TEST_ASSERT_FALSE(manager->getLastWasFastConnect());
+    TEST_ASSERT_EQUAL_UINT32(0, manager->getReconnectCount()); // Fell back within the one attempt
+}
+
+void test_dropped_connection_backs_off_and_recovers() {
+    manager->beginStation(makeStation(nullptr, 0));
+    pump(SCAN_JOIN_MILLIS + 100ul);
+    trace = "";
+    traceCount = 0;
+
+    WiFi.setApInRange(false);
+    unsigned long droppedMillis = millis();
+    TEST_ASSERT_TRUE(pump(100ul));
+    TEST_ASSERT_EQUAL_STRING("offline", manager->getStateName());
+    TEST_ASSERT_FALSE(manager->isOnline());
+    TEST_ASSERT_TRUE(manager->getIpAddress() == IPAddress(0, 0, 0, 0));
+
+    pump(70000ul); // Each attempt gives up after NET_CONNECT_TIMEOUT_MILLIS
+    TEST_ASSERT_EQUAL_STRING("offline connecting offline connecting offline connecting", trace.c_str());
+    TEST_ASSERT_UINT32_WITHIN(STEP_MILLIS, droppedMillis + NET_MIN_BACKOFF_MILLIS, enteredMillis[1]);
+    TEST_ASSERT_UINT32_WITHIN(STEP_MILLIS, NET_CONNECT_TIMEOUT_MILLIS + (2ul * NET_MIN_BACKOFF_MILLIS), enteredMillis[3] - enteredMillis[1]);
+    TEST_ASSERT_UINT32_WITHIN(STEP_MILLIS, NET_CONNECT_TIMEOUT_MILLIS + (4ul * NET_MIN_BACKOFF_MILLIS), enteredMillis[5] - enteredMillis[3]);
+    TEST_ASSERT_EQUAL_UINT32(3, manager->getReconnectCount());
+
+    WiFi.setApInRange(true);
+    TEST_ASSERT_TRUE(pump(SCAN_JOIN_MILLIS + 1600ul)); // Caught by the stack's next scan
+    TEST_ASSERT_EQUAL_STRING("online", manager->getStateName());
+    TEST_ASSERT_TRUE(manager->getIpAddress() == IPAddress(127, 1, 0, 1));
+    TEST_ASSERT_EQUAL_UINT32(2, manager->getConnectCount());
+
+    trace = "";
+    traceCount = 0;
+    WiFi.setApInRange(false); // Backoff starts over once back online
+    pump(100ul);
+    WiFi.setApInRange(true);
+    pump(NET_MIN_BACKOFF_MILLIS + SCAN_JOIN_MILLIS + 100ul);
+    TEST_ASSERT_EQUAL_STRING("offline connecting online", trace.c_str());
+}
+
+void test_static_address_is_kept() {
+    StationConfig station = makeStation(nullptr, 0);
+    station.ip = IPAddress(127, 1, 0, 50);
+    station.gateway = IPAddress(127, 0, 0, 1);
+    station.subnet = IPAddress(255, 0, 0, 0);
+    manager->beginStation(station);
+
+    pump(SCAN_JOIN_MILLIS);
+    TEST_ASSERT_EQUAL_STRING("online", trace.c_str());
+    TEST_ASSERT_TRUE(manager->getIpAddress() == IPAddress(127, 1, 0, 50));
+    TEST_ASSERT_TRUE(manager->getBcastAddress() == IPAddress(127, 255, 255, 255));
+}
+
+void test_access_point_ignores_station_events() {
+    manager->beginStation(makeStation(nullptr, 0));
+    manager->beginAccessPoint("TempBuddyTest", "TempBuddy_Sensor", "P@ssw0rd123", IPAddress(127, 1, 0, 1), IPAddress(127, 1, 0, 1), IPAddress(255, 255, 255, 0));
+    TEST_ASSERT_EQUAL_STRING("access_point", manager->getStateName());
+    TEST_ASSERT_TRUE(manager->isOnline());
+    TEST_ASSERT_TRUE(manager->getBcastAddress() == IPAddress(127, 1, 0, 255));
+
+    WiFi.begin("TestNet", "secret"); // Station joins behind the manager's back
+    pump(SCAN_JOIN_MILLIS + 100ul);
+    TEST_ASSERT_EQUAL_STRING("", trace.c_str());
+    TEST_ASSERT_EQUAL_UINT32(0, manager->getAssociatedMillis());
+    TEST_ASSERT_EQUAL_UINT32(0, manager->getConnectCount());
+}
+
+int main(int argc, char **argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_scan_join_comes_online);
+    RUN_TEST(test_direct_join_skips_scan);
+    RUN_TEST(test_failed_direct_join_falls_back_to_scan);
+    RUN_TEST(test_dropped_connection_backs_off_and_recovers);
+    RUN_TEST(test_static_address_is_kept);
+    RUN_TEST(test_access_point_ignores_station_events);
+
+    return UNITY_END();
+}
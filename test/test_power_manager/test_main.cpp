@@ -0,0 +1,151 @@
+/*
+    Tests of PowerManager - Hands the manager the time on a clock of the
+    test's own, as the loop would, and checks the sleep it allows between
+    passes, the hold on full speed after heavy work and the duty cycle and
+    energy worked out from how the passes were spent. Ends by running an
+    idle sensor for ten minutes, as the loop does, and checking how little
+    of that it spends awake.
+
+    Run with: pio test -e native -f test_power_manager
+
+    Written by: Scott Griffis
+    Date: 10-19-2026
+*/
+
+#include <unity.h>
+#include <limits.h>
+#include <PowerManager.h>
+
+#define MAX_SLEEP_MILLIS 1000ul
+#define BOOST_HOLD_MILLIS 2000ul
+
+PowerManager *power;
+
+void setUp() {
+    power = new PowerManager(MAX_SLEEP_MILLIS, BOOST_HOLD_MILLIS);
+}
+
+void tearDown() {
+    delete power;
+}
+
+void test_sleeps_until_earliest_task() {
+    power->beginPass(5000ul);
+    power->wakeBy(5300ul);
+    power->wakeBy(5120ul);
+    power->wakeBy(5900ul);
+
+    TEST_ASSERT_EQUAL_UINT32(120, power->getSleepMillis(5000ul));
+}
+
+void test_sleep_is_capped_and_due_tasks_allow_none() {
+    power->beginPass(5000ul);
+    power->wakeBy(90000ul);
+    TEST_ASSERT_EQUAL_UINT32(MAX_SLEEP_MILLIS, power->getSleepMillis(5000ul));
+
+    power->beginPass(6000ul);
+    power->wakeBy(5990ul); // Overdue
+    TEST_ASSERT_EQUAL_UINT32(0, power->getSleepMillis(6000ul));
+}
+
+void test_due_time_past_rollover() {
+    unsigned long nowMillis = ULONG_MAX - 49ul;
+    power->beginPass(nowMillis);
+    power->wakeBy(nowMillis + 250ul); // Wraps past zero
+
+    TEST_ASSERT_EQUAL_UINT32(250, power->getSleepMillis(nowMillis));
+}
+
+void test_busy_holds_full_speed() {
+    power->beginPass(10000ul);
+    power->wakeBy(10500ul);
+    power->noteBusy(10000ul);
+    TEST_ASSERT_TRUE(power->isBoostWanted(10000ul));
+    TEST_ASSERT_EQUAL_UINT32(0, power->getSleepMillis(10000ul));
+
+    power->beginPass(11000ul); // No longer busy but within the hold
+    power->wakeBy(11500ul);
+    TEST_ASSERT_TRUE(power->isBoostWanted(11000ul + BOOST_HOLD_MILLIS - 1001ul));
+    TEST_ASSERT_EQUAL_UINT32(0, power->getSleepMillis(11000ul));
+
+    power->beginPass(10000ul + BOOST_HOLD_MILLIS);
+    power->wakeBy(10000ul + BOOST_HOLD_MILLIS + 500ul);
+    TEST_ASSERT_FALSE(power->isBoostWanted(10000ul + BOOST_HOLD_MILLIS));
+    TEST_ASSERT_EQUAL_UINT32(500, power->getSleepMillis(10000ul + BOOST_HOLD_MILLIS));
+}
+
+void test_energy_follows_speed_and_sleep() {
+    power->record(1000000ul, 0ul, 160); // A second awake at full speed
+    TEST_ASSERT_EQUAL_UINT64(POWER_AWAKE_160_MA * 3300ull, power->getTotalMicroJoules());
+
+    power->record(1000000ul, 0ul, 80);
+    power->record(0ul, 2000000ul, 80); // Modem sleep
+    uint64_t expected = (POWER_AWAKE_160_MA + POWER_AWAKE_80_MA + (2 * POWER_MODEM_SLEEP_MA)) * 3300ull;
+    TEST_ASSERT_EQUAL_UINT64(expected, power->getTotalMicroJoules());
+    TEST_ASSERT_EQUAL_UINT8(50, power->getDutyPercent());
+
+    power->setLightSleep(true);
+    power->record(0ul, 1000000ul, 80);
+    TEST_ASSERT_EQUAL_UINT64(expected + (POWER_LIGHT_SLEEP_MA * 3300ull), power->getTotalMicroJoules());
+}
+
+void test_samples_close_off_their_share() {
+    power->record(100000ul, 900000ul, 80);
+    power->noteSample();
+    TEST_ASSERT_EQUAL_UINT8(10, power->getLastSampleDuty());
+    uint32_t firstSample = power->getLastSampleMicroJoules();
+    TEST_ASSERT_EQUAL_UINT32(((POWER_AWAKE_80_MA * 100000ull) + (POWER_MODEM_SLEEP_MA * 900000ull)) * 33ull / 10ull / 1000ull, firstSample);
+
+    power->record(500000ul, 500000ul, 160);
+    power->noteSample();
+    TEST_ASSERT_EQUAL_UINT8(50, power->getLastSampleDuty());
+    TEST_ASSERT_GREATER_THAN_UINT32(firstSample, power->getLastSampleMicroJoules());
+    TEST_ASSERT_EQUAL_UINT32(2, power->getSampleCount());
+    TEST_ASSERT_EQUAL_UINT32((uint32_t) (power->getTotalMicroJoules() / 2), power->getAverageMicroJoulesPerSample());
+}
+
+void test_idle_sensor_sleeps_most_of_the_time() {
+    unsigned long nowMillis = 0ul;
+    unsigned long nextReadMillis = 0ul;
+    unsigned long nextBroadcastMillis = 0ul;
+    const unsigned long endMillis = 10ul * 60000ul;
+    int passCount = 0;
+    while (nowMillis < endMillis) {
+        power->beginPass(nowMillis);
+        if (nowMillis >= nextReadMillis) { // Reading due...
+            nextReadMillis += 30000ul;
+            power->noteSample();
+        }
+        if (nowMillis >= nextBroadcastMillis) { // Broadcast due...
+            nextBroadcastMillis += 10000ul;
+        }
+        power->wakeBy(nextReadMillis);
+        power->wakeBy(nextBroadcastMillis);
+        unsigned long awakeMillis = 2ul; // Each pass takes a couple of millis
+        nowMillis += awakeMillis;
+        uint32_t sleepMillis = power->getSleepMillis(nowMillis);
+        TEST_ASSERT_LESS_OR_EQUAL_UINT32(MAX_SLEEP_MILLIS, sleepMillis);
+        nowMillis += sleepMillis;
+        power->record(awakeMillis * 1000ul, sleepMillis * 1000ul, 80);
+        passCount++;
+    }
+
+    TEST_ASSERT_LESS_THAN(1500, passCount); // Woken by the cap, not spinning
+    TEST_ASSERT_LESS_OR_EQUAL_UINT8(1, power->getDutyPercent());
+    TEST_ASSERT_EQUAL_UINT32(20, power->getSampleCount());
+    uint32_t idleMicroJoules = (uint32_t) (POWER_MODEM_SLEEP_MA * 30ull * 3300ull);
+    TEST_ASSERT_UINT32_WITHIN(idleMicroJoules / 10, idleMicroJoules, power->getLastSampleMicroJoules()); // Close to sleeping throughout
+}
+
+int main(int argc, char **argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_sleeps_until_earliest_task);
+    RUN_TEST(test_sleep_is_capped_and_due_tasks_allow_none);
+    RUN_TEST(test_due_time_past_rollover);
+    RUN_TEST(test_busy_holds_full_speed);
+    RUN_TEST(test_energy_follows_speed_and_sleep);
+    RUN_TEST(test_samples_close_off_their_share);
+    RUN_TEST(test_idle_sensor_sleeps_most_of_the_time);
+
+    return UNITY_END();
+}
@@ -0,0 +1,150 @@
+/*
+    Tests of RateLimiter - Floods the limiter as a misbehaving client
+    would and checks each bucket runs dry, refills and, once more
+    clients turn up than it tracks, hands over the bucket of the one
+    seen least recently.
+
+    Run with: pio test -e native -f test_rate_limiter
+
+    Written by: Scott Griffis
+    Date: 10-19-2026
+*/
+
+#include <unity.h>
+#include <RateLimiter.h>
+
+// Limits the firmware runs with (see main.cpp)
+#define CLIENT_RATE 2
+#define CLIENT_BURST 10
+#define GLOBAL_RATE 6
+#define GLOBAL_BURST 16
+
+#define CLIENT_A 0x0A00000Bu // 10.0.0.11
+#define CLIENT_B 0xC0A87B05u // 192.168.123.5
+#define START_MILLIS 1000ul
+
+RateLimiter *limiter;
+
+void setUp() {
+    limiter = new RateLimiter(CLIENT_RATE, CLIENT_BURST, GLOBAL_RATE, GLOBAL_BURST);
+}
+
+void tearDown() {
+    delete limiter;
+}
+
+/**
+ * Makes the given number of requests at the one time.
+ *
+ * @return Returns how many were admitted as int.
+ */
+int flood(uint32_t ip, int requests, unsigned long nowMillis) {
+    int admitted = 0;
+    for (int i = 0; i < requests; i++) {
+        if (limiter->admit(ip, nowMillis) == RateLimiter::ADMITTED) {
+            admitted++;
+        }
+    }
+
+    return admitted;
+}
+
+void test_client_burst_runs_dry() {
+    TEST_ASSERT_EQUAL(CLIENT_BURST, flood(CLIENT_A, 100, START_MILLIS));
+    TEST_ASSERT_EQUAL(RateLimiter::CLIENT_RATE_EXCEEDED, limiter->admit(CLIENT_A, START_MILLIS));
+    TEST_ASSERT_EQUAL_UINT32(CLIENT_BURST, limiter->getAdmittedCount());
+    TEST_ASSERT_EQUAL_UINT32(100 - CLIENT_BURST + 1, limiter->getRateLimitedCount());
+    TEST_ASSERT_EQUAL_UINT32(0, limiter->getBusyCount());
+}
+
+void test_flooding_client_leaves_others_alone() {
+    flood(CLIENT_A, 100, START_MILLIS);
+
+    TEST_ASSERT_EQUAL(RateLimiter::ADMITTED, limiter->admit(CLIENT_B, START_MILLIS));
+}
+
+void test_client_refills_at_its_rate() {
+    flood(CLIENT_A, CLIENT_BURST, START_MILLIS);
+
+    TEST_ASSERT_EQUAL(0, flood(CLIENT_A, 1, START_MILLIS + 499ul)); // Just short of a token
+    TEST_ASSERT_EQUAL(1, flood(CLIENT_A, 5, START_MILLIS + 500ul));
+    TEST_ASSERT_EQUAL(CLIENT_RATE * 3, flood(CLIENT_A, 100, START_MILLIS + 3500ul)); // 3s more
+    TEST_ASSERT_EQUAL(CLIENT_BURST, flood(CLIENT_A, 100, START_MILLIS + 60000ul)); // Refill stops at the burst
+}
+
+void test_sustained_flood_is_held_to_client_rate() {
+    int admitted = 0;
+    for (unsigned long ms = 0ul; ms < 60000ul; ms += 10ul) { // 100 requests a second for a minute
+        admitted += flood(CLIENT_A, 1, START_MILLIS + ms);
+    }
+
+    TEST_ASSERT_UINT32_WITHIN(1, CLIENT_BURST + (CLIENT_RATE * 60), admitted);
+}
+
+void test_global_burst_runs_dry() {
+    int admitted = 0;
+    for (uint32_t ip = 1u; ip <= 4u; ip++) { // More than the global burst between them
+        admitted += flood(CLIENT_A + ip, CLIENT_BURST, START_MILLIS);
+    }
+
+    TEST_ASSERT_EQUAL(GLOBAL_BURST, admitted);
+    TEST_ASSERT_EQUAL_UINT32((4 * CLIENT_BURST) - GLOBAL_BURST, limiter->getBusyCount());
+    TEST_ASSERT_EQUAL(RateLimiter::SERVER_BUSY, limiter->admit(CLIENT_B, START_MILLIS));
+}
+
+void test_global_refills_at_its_rate() {
+    for (uint32_t ip = 1u; ip <= 4u; ip++) {
+        flood(CLIENT_A + ip, CLIENT_BURST, START_MILLIS);
+    }
+
+    int admitted = 0;
+    for (uint32_t ip = 5u; ip <= 8u; ip++) { // Fresh clients, so only the global bucket holds them back
+        admitted += flood(CLIENT_A + ip, CLIENT_BURST, START_MILLIS + 1000ul);
+    }
+    TEST_ASSERT_EQUAL(GLOBAL_RATE, admitted);
+}
+
+void test_least_recently_seen_client_is_evicted() {
+    delete limiter;
+    limiter = new RateLimiter(CLIENT_RATE, CLIENT_BURST, 1000, 1000); // Only the client buckets in play
+    for (uint32_t ip = 0u; ip < RATE_LIMITER_MAX_CLIENTS; ip++) { // Fill every slot, emptying each bucket
+        flood(CLIENT_A + ip, CLIENT_BURST, START_MILLIS + (ip * 10ul));
+    }
+    flood(CLIENT_A, 1, START_MILLIS + 100ul); // First client seen again, now the most recent
+
+    TEST_ASSERT_EQUAL(RateLimiter::ADMITTED, limiter->admit(CLIENT_B + 100u, START_MILLIS + 100ul)); // Takes the slot of CLIENT_A + 1
+    TEST_ASSERT_EQUAL(RateLimiter::CLIENT_RATE_EXCEEDED, limiter->admit(CLIENT_A, START_MILLIS + 100ul)); // Kept its empty bucket
+    TEST_ASSERT_EQUAL(RateLimiter::CLIENT_RATE_EXCEEDED, limiter->admit(CLIENT_A + 2u, START_MILLIS + 100ul));
+    TEST_ASSERT_EQUAL(RateLimiter::ADMITTED, limiter->admit(CLIENT_A + 1u, START_MILLIS + 100ul)); // Evicted; Back with a full burst
+}
+
+void test_rotating_clients_cannot_exceed_global_limit() {
+    int admitted = 0;
+    for (unsigned long ms = 0ul; ms < 10000ul; ms += 10ul) { // A new address every request, as a spoofing flood would
+        admitted += flood(CLIENT_A + (uint32_t) ms, 1, START_MILLIS + ms);
+    }
+
+    TEST_ASSERT_UINT32_WITHIN(1, GLOBAL_BURST + (GLOBAL_RATE * 10), admitted);
+}
+
+void test_rollover_of_millis() {
+    unsigned long nearEnd = ~0ul - 200ul; // Wraps whatever the width of unsigned long
+    flood(CLIENT_A, CLIENT_BURST, nearEnd);
+
+    TEST_ASSERT_EQUAL(1, flood(CLIENT_A, 5, nearEnd + 500ul)); // Past the rollover of millis()
+}
+
+int main(int argc, char **argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_client_burst_runs_dry);
+    RUN_TEST(test_flooding_client_leaves_others_alone);
+    RUN_TEST(test_client_refills_at_its_rate);
+    RUN_TEST(test_sustained_flood_is_held_to_client_rate);
+    RUN_TEST(test_global_burst_runs_dry);
+    RUN_TEST(test_global_refills_at_its_rate);
+    RUN_TEST(test_least_recently_seen_client_is_evicted);
+    RUN_TEST(test_rotating_clients_cannot_exceed_global_limit);
+    RUN_TEST(test_rollover_of_millis);
+
+    return UNITY_END();
+}
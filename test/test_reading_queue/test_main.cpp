@@ -0,0 +1,265 @@
+/*
+    Tests of ReadingQueue - Simulates a unit through a network outage and
+    its recovery on a clock of the test's own. Readings are taken, sent
+    live or held, and forwarded in batches once back online as the
+    firmware's doReadSensorData(), doBroadcast() and doForwardBacklog()
+    do, with each packet written and read back by BroadcastPacket as a
+    collector would. Checks that no reading goes missing, none arrives
+    both live and forwarded, and the backlog drains in bounded time.
+
+    Run with: pio test -e native -f test_reading_queue
+
+    Written by: Scott Griffis
+    Date: 10-19-2026
+*/
+
+#include <unity.h>
+#include <string.h>
+#include <ReadingQueue.h>
+#include <BroadcastPacket.h>
+
+#define STEP_MILLIS 50ul
+#define READ_MILLIS 30000ul
+#define REPEAT_MILLIS 10000ul
+#define BATCH_MILLIS 250ul // As BACKLOG_BATCH_MILLIS of the firmware
+#define MAX_SEQUENCE 1000
+
+// ************************************************************************************
+// How each reading first reached the collector, by sequence number; A live
+// broadcast of a reading already had is the repeat every 10 seconds, which
+// isn't counted, while a reading forwarded again is
+// ************************************************************************************
+struct Collector {
+    uint8_t        liveCount        [MAX_SEQUENCE + 1];
+    uint8_t        forwardCount     [MAX_SEQUENCE + 1];
+};
+
+ReadingQueue *backlog;
+Collector collector;
+unsigned long nowMillis;
+uint32_t readCount;
+unsigned long lastReadMillis;
+unsigned long lastBCastMillis;
+uint32_t lastBCastReadCount;
+bool isOnline;
+int sendsToLose; // Sends that fail once online, as on a flaky link
+
+void setUp() {
+    backlog = new ReadingQueue(BATCH_MILLIS);
+    memset(&collector, 0, sizeof(collector));
+    nowMillis = 0ul;
+    readCount = 0;
+    lastReadMillis = 0ul;
+    lastBCastMillis = 0ul;
+    lastBCastReadCount = 0;
+    isOnline = false;
+    sendsToLose = 0;
+}
+
+void tearDown() {
+    delete backlog;
+}
+
+QueuedReading makeReading(uint32_t sequence) {
+    QueuedReading reading = {1792410856123ull + (sequence * READ_MILLIS), sequence, 20.0f + (sequence % 5), 40.0f + (sequence % 9)};
+
+    return reading;
+}
+
+/**
+ * Hands the packet to the collector, unless offline or lost.
+ *
+ * @return Returns true if it arrived as bool.
+*/
+bool send(const char *packet, size_t length) {
+    if (!isOnline || length == 0) {
+
+        return false;
+    }
+    if (sendsToLose > 0) {
+        sendsToLose--;
+
+        return false;
+    }
+    BroadcastPacket parsed;
+    QueuedReading reading;
+    TEST_ASSERT_TRUE(parsed.begin(packet, length));
+    while (parsed.nextReading(reading)) {
+        TEST_ASSERT_TRUE(reading.sequence > 0 && reading.sequence <= MAX_SEQUENCE);
+        TEST_ASSERT_EQUAL_UINT64(makeReading(reading.sequence).timestamp, reading.timestamp);
+        if (!parsed.getIsLive()) {
+            collector.forwardCount[reading.sequence]++;
+        } else if (collector.liveCount[reading.sequence] + collector.forwardCount[reading.sequence] == 0) { // Not a repeat...
+            collector.liveCount[reading.sequence]++;
+        }
+    }
+
+    return true;
+}
+
+/**
+ * Runs one pass of the loop, as the firmware does.
+*/
+void runPass() {
+    if (readCount == 0 || (nowMillis - lastReadMillis) >= READ_MILLIS) { // Reading due...
+        lastReadMillis = nowMillis;
+        readCount++;
+        if (!isOnline) { // Can't be broadcast; Hold on to it...
+            backlog->push(makeReading(readCount));
+        }
+    }
+
+    if (isOnline && (readCount != lastBCastReadCount || (nowMillis - lastBCastMillis) >= REPEAT_MILLIS)) { // Live broadcast due...
+        bool isNewReading = (readCount != lastBCastReadCount);
+        lastBCastReadCount = readCount;
+        QueuedReading reading = makeReading(readCount);
+        char packet[BROADCAST_LIVE_PACKET_SIZE];
+        size_t length = BroadcastPacket::formatLive(packet, sizeof(packet), "127.1.0.1", "A4C372", reading);
+        if (send(packet, length)) {
+            backlog->dropNewest(reading.sequence);
+        } else if (isNewReading) {
+            backlog->push(reading);
+        }
+        lastBCastMillis = nowMillis;
+    }
+
+    if (isOnline && backlog->isBatchDue(nowMillis)) { // Forward a batch...
+        QueuedReading batch[READING_BATCH_SIZE];
+        uint8_t batchCount = backlog->peekBatch(batch);
+        char packet[BROADCAST_BACKLOG_PACKET_SIZE];
+        size_t length = BroadcastPacket::formatBacklog(packet, sizeof(packet), "127.1.0.1", "A4C372", batch, batchCount);
+        backlog->markBatchSent((send(packet, length) ? batchCount : 0), nowMillis);
+    }
+}
+
+void runFor(unsigned long millisToRun) {
+    for (unsigned long elapsed = 0ul; elapsed < millisToRun; elapsed += STEP_MILLIS) {
+        runPass();
+        nowMillis += STEP_MILLIS;
+    }
+}
+
+/**
+ * Runs until the backlog is empty.
+ *
+ * @return Returns how long it took as unsigned long.
+*/
+unsigned long runUntilDrained(unsigned long limitMillis) {
+    unsigned long startMillis = nowMillis;
+    do {
+        runPass();
+        nowMillis += STEP_MILLIS;
+    } while (backlog->getCount() > 0 && (nowMillis - startMillis) < limitMillis);
+    TEST_ASSERT_EQUAL_UINT16(0, backlog->getCount());
+
+    return (nowMillis - startMillis);
+}
+
+/**
+ * Checks each reading from the first given arrived exactly once,
+ * either live or forwarded.
+*/
+void assertEachArrivedOnce(uint32_t firstSequence) {
+    for (uint32_t sequence = firstSequence; sequence <= readCount; sequence++) {
+        char message[48];
+        snprintf(message, sizeof(message), "SEQ_%lu", (unsigned long) sequence);
+        TEST_ASSERT_EQUAL_INT_MESSAGE(1, collector.liveCount[sequence] + collector.forwardCount[sequence], message);
+    }
+}
+
+void test_first_reading_before_network_is_sent_once() {
+    runFor(2000ul); // Reading taken while joining
+    TEST_ASSERT_EQUAL_UINT32(1, readCount);
+    TEST_ASSERT_EQUAL_UINT16(1, backlog->getCount());
+
+    isOnline = true;
+    runFor(REPEAT_MILLIS * 3);
+    TEST_ASSERT_EQUAL_UINT16(0, backlog->getCount());
+    TEST_ASSERT_EQUAL(1, collector.liveCount[1]);
+    TEST_ASSERT_EQUAL(0, collector.forwardCount[1]);
+    TEST_ASSERT_EQUAL_UINT32(0, backlog->getSentCount());
+}
+
+void test_outage_recovers_without_gaps() {
+    isOnline = true;
+    runFor(5 * 60000ul);
+    uint32_t lastBeforeOutage = readCount;
+
+    isOnline = false;
+    runFor((20 * 60000ul) + 10000ul); // Back between readings
+    uint16_t heldCount = backlog->getCount();
+    TEST_ASSERT_EQUAL_UINT16(readCount - lastBeforeOutage, heldCount);
+
+    isOnline = true;
+    unsigned long drainMillis = runUntilDrained(60000ul);
+    uint16_t forwardedCount = heldCount - 1; // The newest goes out live
+    unsigned long boundMillis = (((forwardedCount + READING_BATCH_SIZE - 1) / READING_BATCH_SIZE) * BATCH_MILLIS) + STEP_MILLIS;
+    TEST_ASSERT_LESS_OR_EQUAL_UINT32(boundMillis, drainMillis);
+    TEST_ASSERT_EQUAL_UINT32(forwardedCount, backlog->getSentCount());
+
+    runFor(5 * 60000ul);
+    assertEachArrivedOnce(1);
+    TEST_ASSERT_EQUAL(1, collector.liveCount[lastBeforeOutage + heldCount]);
+    TEST_ASSERT_EQUAL_UINT32(0, backlog->getDroppedCount());
+}
+
+void test_outage_longer_than_queue_drops_only_oldest() {
+    isOnline = true;
+    runFor(60000ul);
+    uint32_t lastBeforeOutage = readCount;
+
+    isOnline = false;
+    runFor(((READING_QUEUE_SIZE + 20) * READ_MILLIS) + 10000ul);
+    uint32_t takenCount = readCount - lastBeforeOutage;
+    TEST_ASSERT_EQUAL_UINT16(READING_QUEUE_SIZE, backlog->getCount());
+    TEST_ASSERT_EQUAL_UINT32(takenCount - READING_QUEUE_SIZE, backlog->getDroppedCount());
+
+    isOnline = true;
+    unsigned long drainMillis = runUntilDrained(60000ul);
+    TEST_ASSERT_LESS_OR_EQUAL_UINT32(((READING_QUEUE_SIZE / READING_BATCH_SIZE) + 1) * BATCH_MILLIS, drainMillis);
+
+    uint32_t firstKept = readCount - READING_QUEUE_SIZE + 1;
+    for (uint32_t sequence = lastBeforeOutage + 1; sequence < firstKept; sequence++) { // Dropped; The one gap allowed...
+        TEST_ASSERT_EQUAL(0, collector.liveCount[sequence] + collector.forwardCount[sequence]);
+    }
+    assertEachArrivedOnce(firstKept);
+}
+
+void test_flaky_recovery_sends_each_once() {
+    isOnline = true;
+    runFor(60000ul);
+    isOnline = false;
+    runFor((10 * 60000ul) + 10000ul);
+    uint16_t heldCount = backlog->getCount();
+
+    isOnline = true;
+    sendsToLose = 3; // The live broadcast and first batches are lost
+    runUntilDrained(60000ul);
+    TEST_ASSERT_EQUAL_UINT32(heldCount, backlog->getSentCount()); // The newest too, as it didn't go out live
+    TEST_ASSERT_EQUAL_UINT32(heldCount, backlog->getQueuedCount()); // A failed live send isn't queued twice
+
+    runFor(2 * 60000ul);
+    assertEachArrivedOnce(1);
+}
+
+void test_newest_only_dropped_if_it_matches() {
+    backlog->push(makeReading(1));
+    backlog->push(makeReading(2));
+
+    TEST_ASSERT_FALSE(backlog->dropNewest(1));
+    TEST_ASSERT_TRUE(backlog->dropNewest(2));
+    TEST_ASSERT_FALSE(backlog->dropNewest(2));
+    TEST_ASSERT_EQUAL_UINT16(1, backlog->getCount());
+    TEST_ASSERT_EQUAL_UINT32(0, backlog->getDroppedCount());
+}
+
+int main(int argc, char **argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_first_reading_before_network_is_sent_once);
+    RUN_TEST(test_outage_recovers_without_gaps);
+    RUN_TEST(test_outage_longer_than_queue_drops_only_oldest);
+    RUN_TEST(test_flaky_recovery_sends_each_once);
+    RUN_TEST(test_newest_only_dropped_if_it_matches);
+
+    return UNITY_END();
+}
@@ -0,0 +1,185 @@
+/*
+    Tests of the Settings getters - Counts the heap allocations made while
+    every getter is called, which must be none since the text is handed
+    back in place. The emulator's stand in for String keeps its text on
+    the heap through operator new, so any getter building a String would
+    be caught by the count. The handler serving them, /api/info, is
+    counted as a whole by test_firmware_heap.
+
+    Run with: pio test -e native -f test_settings_getters
+
+    Written by: Scott Griffis
+    Date: 10-19-2026
+*/
+
+#include <unity.h>
+#include <new>
+#include <stdlib.h>
+#include <Emulator.h>
+#include <Settings.h>
+
+#define EEPROM_PATH "test_settings_getters.bin"
+#define FLASH_PATH "test_settings_getters_flash.bin"
+#define ROUNDS 100
+
+unsigned long allocationCount = 0ul;
+DeviceConfig device;
+Settings *settings;
+
+void* operator new(size_t size) {
+    allocationCount++;
+    void *block = malloc(size == 0 ? 1 : size);
+    if (block == nullptr) {
+        throw std::bad_alloc();
+    }
+
+    return block;
+}
+
+void* operator new[](size_t size) {
+
+    return operator new(size);
+}
+
+__attribute__((noinline)) void operator delete(void *block) noexcept { // Out of line, else GCC takes its free() as mismatched with new
+    free(block);
+}
+
+void operator delete[](void *block) noexcept {
+    operator delete(block);
+}
+
+void operator delete(void *block, size_t size) noexcept {
+    operator delete(block);
+}
+
+void operator delete[](void *block, size_t size) noexcept {
+    operator delete(block);
+}
+
+bool passTime(uint64_t micros) {
+
+    return true;
+}
+
+bool isStopping() {
+
+    return false;
+}
+
+void setUp() {
+    memset(&device, 0, sizeof(device));
+    device.eepromPath = EEPROM_PATH;
+    device.flashPath = FLASH_PATH;
+    device.sleep = passTime;
+    device.isStopping = isStopping;
+    Emulator::attach(&device);
+    remove(EEPROM_PATH);
+    remove(FLASH_PATH);
+
+    settings = new Settings();
+    settings->setDeviceId("A4C372");
+}
+
+void tearDown() {
+    delete settings;
+    remove(EEPROM_PATH);
+    remove(FLASH_PATH);
+}
+
+/**
+ * Sets a field from the test, as the admin page would.
+*/
+void setField(const char *name, const char *value) {
+    const SettingField *field = Settings::findField(name);
+    TEST_ASSERT_NOT_NULL(field);
+    TEST_ASSERT_NOT_EQUAL(SETTING_INVALID, settings->updateField(*field, value, strlen(value)));
+}
+
+/**
+ * Calls every getter, folding what they return together so the
+ * calls can't be optimized away.
+ *
+ * @return Returns the fold of the values as unsigned long.
+*/
+unsigned long callGetters() {
+    const char *text[] = {
+        settings->getSsid(), settings->getPwd(), settings->getAdminUser(), settings->getAdminPwd(),
+        settings->getTitle(), settings->getHeading(), settings->getNtpServer(),
+        settings->getStaticIp(), settings->getStaticGateway(), settings->getStaticSubnet(), settings->getStaticDns(),
+        settings->getLastBssid(), settings->getLastIp(), settings->getLastGateway(), settings->getLastSubnet(), settings->getLastDns(),
+        settings->getMqttHost(), settings->getMqttUser(), settings->getMqttPwd(), settings->getMqttTopic(),
+        settings->getHostname(), settings->getApSsid(), settings->getApPwd(), settings->getApNetIp(), settings->getApSubnet(), settings->getApGateway()
+    };
+    unsigned long fold = 0ul;
+    for (size_t i = 0; i < (sizeof(text) / sizeof(text[0])); i++) {
+        fold += strlen(text[i]);
+    }
+    fold += settings->getIsCelsius() + settings->isStaticIpSet() + settings->getLastChannel();
+    fold += settings->isMqttSet() + settings->getMqttPort() + settings->getIsMqttQos1();
+    fold += settings->getIsLightSleep() + settings->getIsBatteryMode() + settings->getBatterySleepSecs();
+    fold += settings->getIsBroadcastOn() + settings->getIsHubMode() + settings->getBcastPort();
+    fold += settings->isNetworkSet() + settings->isFactoryDefault();
+
+    return fold;
+}
+
+void test_counter_sees_string_allocations() {
+    unsigned long before = allocationCount;
+    String built = String(settings->getTitle()) + " - " + settings->getHeading();
+
+    TEST_ASSERT_GREATER_THAN(before, allocationCount); // Otherwise the count proves nothing
+}
+
+void test_getters_do_not_allocate_with_defaults() {
+    unsigned long before = allocationCount;
+    unsigned long fold = 0ul;
+    for (int i = 0; i < ROUNDS; i++) {
+        fold += callGetters();
+    }
+
+    TEST_ASSERT_NOT_EQUAL(0ul, fold);
+    TEST_ASSERT_EQUAL_UINT32(0, allocationCount - before);
+}
+
+void test_getters_do_not_allocate_once_set() {
+    setField("ssid", "TestNet");
+    setField("pwd", "secret");
+    setField("staticip", "192.168.123.50");
+    setField("staticgateway", "192.168.123.1");
+    setField("staticsubnet", "255.255.255.0");
+    setField("mqtthost", "broker.local");
+    setField("units", "Celsius");
+    settings->setLastConnection("02:00:00:00:00:01", 6, "192.168.123.50", "192.168.123.1", "255.255.255.0", "192.168.123.1");
+    TEST_ASSERT_TRUE(settings->saveSettings());
+    TEST_ASSERT_TRUE(settings->loadSettings());
+
+    unsigned long before = allocationCount;
+    for (int i = 0; i < ROUNDS; i++) {
+        callGetters();
+    }
+    TEST_ASSERT_EQUAL_UINT32(0, allocationCount - before);
+    TEST_ASSERT_EQUAL_STRING("broker.local", settings->getMqttHost());
+    TEST_ASSERT_EQUAL_INT(6, settings->getLastChannel());
+}
+
+void test_text_is_returned_in_place() {
+    const char *title = settings->getTitle();
+    const char *hostname = settings->getHostname();
+
+    TEST_ASSERT_EQUAL_PTR(title, settings->getTitle());
+    TEST_ASSERT_EQUAL_PTR(hostname, settings->getHostname());
+    TEST_ASSERT_EQUAL_STRING("TempBuddyA4C372", hostname);
+    setField("title", "Garage");
+    TEST_ASSERT_EQUAL_STRING("Garage", title); // Same spot, new value
+}
+
+int main(int argc, char **argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_counter_sees_string_allocations);
+    RUN_TEST(test_getters_do_not_allocate_with_defaults);
+    RUN_TEST(test_getters_do_not_allocate_once_set);
+    RUN_TEST(test_text_is_returned_in_place);
+
+    return UNITY_END();
+}
@@ -0,0 +1,351 @@
+/*
+    Tests of the Settings migration - Stores the settings as each past
+    firmware left them in flash, the version 1 layout checked by an MD5
+    sentinel and then each version of the header, and checks they load
+    with what they held kept, anything added since at its factory
+    default and the result stored again in the current version, in
+    the first of the settings slots. Then times the check made of the
+    settings as they are loaded, the CRC32 behind the header against
+    the MD5 sentinel it replaced, as a microbenchmark.
+
+    Run with: pio test -e native -f test_settings_migration
+
+    Written by: Scott Griffis
+    Date: 10-19-2026
+*/
+
+#include <unity.h>
+#include <stdio.h>
+#include <stddef.h>
+#include <chrono>
+#include <Emulator.h>
+#include <Settings.h>
+
+#define EEPROM_PATH "test_settings_migration.bin"
+#define FLASH_PATH "test_settings_migration_flash.bin"
+#define FIXTURE_STORAGE_SIZE 640 // What versions 2 to 7 stored through the EEPROM library
+#define FIXTURE_SEQUENCE 41ul
+#define BENCH_ROUNDS 100000
+
+// Length of the settings as stored by each version, as that firmware had them...
+const uint16_t STORED_LENGTHS[] = {
+    0, 0, // No header before version 2
+    441, // Version 2 ends with lastDns
+    580, // Version 3 adds MQTT, ending with isMqttQos1
+    581, // Version 4 adds isLightSleep
+    588, // Version 5 adds isBatteryMode and batterySleepSecs
+    589, // Version 6 adds isBroadcastOn
+    590 // Version 7 adds isHubMode
+};
+
+DeviceConfig device;
+Settings *settings;
+
+bool passTime(uint64_t micros) {
+
+    return true;
+}
+
+bool isStopping() {
+
+    return false;
+}
+
+void setUp() {
+    memset(&device, 0, sizeof(device));
+    device.eepromPath = EEPROM_PATH;
+    device.flashPath = FLASH_PATH;
+    device.sleep = passTime;
+    device.isStopping = isStopping;
+    Emulator::attach(&device);
+    remove(EEPROM_PATH);
+    remove(FLASH_PATH);
+
+    settings = new Settings();
+}
+
+void tearDown() {
+    delete settings;
+    remove(EEPROM_PATH);
+    remove(FLASH_PATH);
+}
+
+/**
+ * Writes the given bytes as the whole of the device's flash, as the
+ * EEPROM library of past firmware left it.
+*/
+void storeFixture(const uint8_t *bytes, size_t size) {
+    FILE *file = fopen(EEPROM_PATH, "wb");
+    TEST_ASSERT_NOT_NULL(file);
+    TEST_ASSERT_EQUAL_size_t(size, fwrite(bytes, 1, size, file));
+    fclose(file);
+}
+
+/**
+ * Gets the settings a past version would have held, with a value in
+ * every member that version had.
+*/
+struct NonVolatileSettings makeStoredSettings() {
+    struct NonVolatileSettings stored;
+    memset(&stored, 0, sizeof(stored));
+    strcpy(stored.ssid, "GarageNet");
+    strcpy(stored.pwd, "hunter22");
+    strcpy(stored.adminUser, "scott");
+    strcpy(stored.adminPwd, "Tr0ub4dor");
+    strcpy(stored.title, "Garage Sensor");
+    strcpy(stored.heading, "Garage");
+    stored.isCelsius = true;
+    strcpy(stored.ntpServer, "time.local");
+    strcpy(stored.staticIp, "192.168.123.50");
+    strcpy(stored.staticGateway, "192.168.123.1");
+    strcpy(stored.staticSubnet, "255.255.255.0");
+    strcpy(stored.lastBssid, "02:00:00:00:00:01");
+    strcpy(stored.lastChannel, "6");
+    strcpy(stored.mqttHost, "broker.local");
+    strcpy(stored.mqttPort, "8883");
+    strcpy(stored.mqttTopic, "garage");
+    stored.isMqttQos1 = false;
+    stored.isLightSleep = true;
+    stored.isBatteryMode = true;
+    strcpy(stored.batterySleepSecs, "600");
+    stored.isBroadcastOn = false;
+    stored.isHubMode = true;
+
+    return stored;
+}
+
+/**
+ * Stores the settings behind a header of the given version, with only
+ * the members that version had.
+*/
+void storeVersion(uint16_t version) {
+    struct NonVolatileSettings stored = makeStoredSettings();
+    uint8_t flash[FIXTURE_STORAGE_SIZE];
+    memset(flash, 0xFF, sizeof(flash)); // Erased flash past the settings
+    struct SettingsHeader header = {SETTINGS_MAGIC, version, STORED_LENGTHS[version], crc32(&stored, STORED_LENGTHS[version]), FIXTURE_SEQUENCE};
+    memcpy(flash, &header, sizeof(header));
+    memcpy(flash + sizeof(header), &stored, STORED_LENGTHS[version]);
+    storeFixture(flash, sizeof(flash));
+}
+
+/**
+ * Checks the settings loaded hold what the given version stored, and
+ * the factory default for anything added since.
+*/
+void assertLoaded(uint16_t version) {
+    TEST_ASSERT_EQUAL_STRING("GarageNet", settings->getSsid());
+    TEST_ASSERT_EQUAL_STRING("hunter22", settings->getPwd());
+    TEST_ASSERT_EQUAL_STRING("Tr0ub4dor", settings->getAdminPwd());
+    TEST_ASSERT_EQUAL_STRING("Garage Sensor", settings->getTitle());
+    TEST_ASSERT_TRUE(settings->getIsCelsius());
+    TEST_ASSERT_EQUAL_STRING("time.local", settings->getNtpServer());
+    TEST_ASSERT_EQUAL_STRING("192.168.123.50", settings->getStaticIp());
+    TEST_ASSERT_EQUAL_STRING("", settings->getStaticDns());
+    TEST_ASSERT_EQUAL_INT(6, settings->getLastChannel());
+
+    TEST_ASSERT_EQUAL_STRING((version >= 3 ? "broker.local" : ""), settings->getMqttHost());
+    TEST_ASSERT_EQUAL_UINT16((version >= 3 ? 8883 : 1883), settings->getMqttPort());
+    TEST_ASSERT_EQUAL_STRING((version >= 3 ? "garage" : "tempbuddy"), settings->getMqttTopic());
+    TEST_ASSERT_EQUAL((version < 3), settings->getIsMqttQos1());
+    TEST_ASSERT_EQUAL((version >= 4), settings->getIsLightSleep());
+    TEST_ASSERT_EQUAL((version >= 5), settings->getIsBatteryMode());
+    TEST_ASSERT_EQUAL_UINT32((version >= 5 ? 600 : 300), settings->getBatterySleepSecs());
+    TEST_ASSERT_EQUAL((version < 6), settings->getIsBroadcastOn());
+    TEST_ASSERT_EQUAL((version >= 7), settings->getIsHubMode());
+}
+
+/**
+ * Loads a fixture of the given version, then loads again as the next
+ * boot would, which must find it in the current version.
+*/
+void checkVersion(uint16_t version) {
+    storeVersion(version);
+
+    TEST_ASSERT_TRUE(settings->loadSettings());
+    assertLoaded(version);
+    TEST_ASSERT_EQUAL_UINT32(FIXTURE_SEQUENCE + 1, settings->getSaveSequence());
+    TEST_ASSERT_EQUAL_UINT32(1, settings->getFlashWriteCount()); // Moved into a slot once
+
+    Settings nextBoot;
+    TEST_ASSERT_TRUE(nextBoot.loadSettings());
+    TEST_ASSERT_EQUAL_UINT32(0, nextBoot.getFlashWriteCount());
+    TEST_ASSERT_EQUAL_STRING(settings->getTitle(), nextBoot.getTitle());
+    TEST_ASSERT_EQUAL(settings->getIsHubMode(), nextBoot.getIsHubMode());
+}
+
+void test_stored_lengths_match_layout() {
+    TEST_ASSERT_EQUAL_size_t(STORED_LENGTHS[2], offsetof(NonVolatileSettings, mqttHost));
+    TEST_ASSERT_EQUAL_size_t(STORED_LENGTHS[3], offsetof(NonVolatileSettings, isLightSleep));
+    TEST_ASSERT_EQUAL_size_t(STORED_LENGTHS[4], offsetof(NonVolatileSettings, isBatteryMode));
+    TEST_ASSERT_EQUAL_size_t(STORED_LENGTHS[5], offsetof(NonVolatileSettings, isBroadcastOn));
+    TEST_ASSERT_EQUAL_size_t(STORED_LENGTHS[6], offsetof(NonVolatileSettings, isHubMode));
+    TEST_ASSERT_EQUAL_size_t(STORED_LENGTHS[SETTINGS_VERSION], sizeof(NonVolatileSettings)); // Add a fixture when bumping the version
+}
+
+void test_migrates_version_1() {
+    struct LegacySettingsV1 legacy;
+    memset(&legacy, 0, sizeof(legacy));
+    strcpy(legacy.ssid, "GarageNet");
+    strcpy(legacy.pwd, "hunter22");
+    strcpy(legacy.adminUser, "scott");
+    strcpy(legacy.adminPwd, "Tr0ub4dor");
+    strcpy(legacy.title, "Garage Sensor");
+    memcpy(legacy.heading, "Garage Heading Filling Every Byte Of The Old Field!", sizeof(legacy.heading)); // No null
+    strcpy(legacy.isCelsius, "true");
+    MD5Builder builder = MD5Builder();
+    builder.begin();
+    builder.add((const uint8_t *) "GarageNethunter22scottTr0ub4dorGarage Sensor", 44);
+    builder.add((const uint8_t *) legacy.heading, sizeof(legacy.heading));
+    builder.add((const uint8_t *) "true", 4);
+    builder.calculate();
+    strcpy(legacy.sentinel, builder.toString().c_str());
+    storeFixture((const uint8_t *) &legacy, sizeof(legacy));
+
+    TEST_ASSERT_TRUE(settings->loadSettings());
+    TEST_ASSERT_EQUAL_STRING("GarageNet", settings->getSsid());
+    TEST_ASSERT_EQUAL_STRING("Tr0ub4dor", settings->getAdminPwd());
+    TEST_ASSERT_EQUAL_STRING("Garage Sensor", settings->getTitle());
+    TEST_ASSERT_EQUAL_STRING_LEN(legacy.heading, settings->getHeading(), sizeof(legacy.heading) - 1); // Cut short to fit the null
+    TEST_ASSERT_EQUAL_size_t(sizeof(legacy.heading) - 1, strlen(settings->getHeading()));
+    TEST_ASSERT_TRUE(settings->getIsCelsius());
+    TEST_ASSERT_EQUAL_STRING("pool.ntp.org", settings->getNtpServer());
+    TEST_ASSERT_TRUE(settings->getIsBroadcastOn());
+    TEST_ASSERT_EQUAL_UINT32(1, settings->getSaveSequence());
+
+    Settings nextBoot;
+    TEST_ASSERT_TRUE(nextBoot.loadSettings());
+    TEST_ASSERT_EQUAL_STRING("GarageNet", nextBoot.getSsid());
+    TEST_ASSERT_EQUAL_UINT32(0, nextBoot.getFlashWriteCount());
+}
+
+void test_version_1_with_bad_sentinel_is_ignored() {
+    struct LegacySettingsV1 legacy;
+    memset(&legacy, 0, sizeof(legacy));
+    strcpy(legacy.ssid, "GarageNet");
+    strcpy(legacy.sentinel, "00000000000000000000000000000000");
+    storeFixture((const uint8_t *) &legacy, sizeof(legacy));
+
+    TEST_ASSERT_FALSE(settings->loadSettings());
+    TEST_ASSERT_TRUE(settings->isFactoryDefault());
+}
+
+void test_migrates_version_2() {
+    checkVersion(2);
+}
+
+void test_migrates_version_3() {
+    checkVersion(3);
+}
+
+void test_migrates_version_4() {
+    checkVersion(4);
+}
+
+void test_migrates_version_5() {
+    checkVersion(5);
+}
+
+void test_migrates_version_6() {
+    checkVersion(6);
+}
+
+void test_migrates_version_7() {
+    checkVersion(7);
+}
+
+void test_corrupt_version_is_defaulted() {
+    storeVersion(4);
+    FILE *file = fopen(EEPROM_PATH, "r+b");
+    fseek(file, sizeof(SettingsHeader) + 100, SEEK_SET);
+    fputc('#', file); // Flips bytes under the CRC
+    fclose(file);
+
+    TEST_ASSERT_FALSE(settings->loadSettings());
+    TEST_ASSERT_TRUE(settings->isFactoryDefault());
+}
+
+/**
+ * Times the given work over the benchmark rounds.
+ *
+ * @return Returns nanoseconds per round as double.
+*/
+template<typename Work> double timePerRound(Work work) {
+    auto start = std::chrono::steady_clock::now();
+    for (int round = 0; round < BENCH_ROUNDS; round++) {
+        work(round);
+    }
+    auto elapsed = std::chrono::steady_clock::now() - start;
+
+    return (double) std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count() / BENCH_ROUNDS;
+}
+
+/**
+ * Hashes the text of every field as the MD5 sentinel was made, before
+ * the header replaced it.
+ *
+ * @return Returns the hash as String.
+*/
+String hashFieldText(const struct NonVolatileSettings &stored) {
+    MD5Builder builder = MD5Builder();
+    builder.begin();
+    for (size_t i = 0; i < Settings::getFieldCount(); i++) {
+        const SettingField &field = Settings::getField(i);
+        const char *value = ((const char *) &stored) + field.offset;
+        size_t length = (field.type == SETTING_CHOICE) ? sizeof(bool) : strnlen(value, field.size);
+        builder.add((const uint8_t *) value, length);
+    }
+    builder.calculate();
+
+    return builder.toString();
+}
+
+void test_benchmark() {
+    struct NonVolatileSettings stored = makeStoredSettings();
+    uint8_t slot[SETTINGS_SLOT_SIZE]; // As held in RAM once read from flash
+    struct SettingsHeader header = {SETTINGS_MAGIC, SETTINGS_VERSION, sizeof(stored), crc32(&stored, sizeof(stored)), FIXTURE_SEQUENCE};
+    memcpy(slot, &header, sizeof(header));
+    memcpy(slot + sizeof(header), &stored, sizeof(stored));
+    char sentinel[33];
+    strcpy(sentinel, hashFieldText(stored).c_str());
+    volatile uint32_t sink = 0;
+
+    double crcNanos = timePerRound([&](int) {
+        struct SettingsHeader loadedHeader;
+        struct NonVolatileSettings loaded;
+        memcpy(&loadedHeader, slot, sizeof(loadedHeader));
+        memcpy(&loaded, slot + sizeof(loadedHeader), sizeof(loaded));
+        bool isValid = loadedHeader.magic == SETTINGS_MAGIC
+            && loadedHeader.version == SETTINGS_VERSION
+            && loadedHeader.length == sizeof(loaded)
+            && loadedHeader.crc == crc32(&loaded, sizeof(loaded));
+        sink = sink + isValid;
+    });
+    double md5Nanos = timePerRound([&](int) {
+        struct NonVolatileSettings loaded;
+        memcpy(&loaded, slot + sizeof(header), sizeof(loaded));
+        bool isValid = (strcmp(sentinel, hashFieldText(loaded).c_str()) == 0);
+        sink = sink + isValid;
+    });
+
+    char report[160];
+    snprintf(report, sizeof(report), "CRC32 load and check %.1f ns (MD5 sentinel %.1f ns); Over %u bytes of settings, per load on this host", crcNanos, md5Nanos, (unsigned) sizeof(stored));
+    TEST_MESSAGE(report);
+    TEST_ASSERT_EQUAL_UINT32(2 * BENCH_ROUNDS, sink); // Both found them valid every time
+}
+
+int main(int argc, char **argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_stored_lengths_match_layout);
+    RUN_TEST(test_migrates_version_1);
+    RUN_TEST(test_version_1_with_bad_sentinel_is_ignored);
+    RUN_TEST(test_migrates_version_2);
+    RUN_TEST(test_migrates_version_3);
+    RUN_TEST(test_migrates_version_4);
+    RUN_TEST(test_migrates_version_5);
+    RUN_TEST(test_migrates_version_6);
+    RUN_TEST(test_migrates_version_7);
+    RUN_TEST(test_corrupt_version_is_defaulted);
+    RUN_TEST(test_benchmark);
+
+    return UNITY_END();
+}
@@ -0,0 +1,253 @@
+/*
+    Tests of the Settings slots - Saves the settings over and over and
+    checks the saves alternate between the two slots and the last one
+    saved is what loads. Then cuts the power at every point of a save,
+    through the erase of the slot and each word written after it, and
+    checks the next boot always finds either the settings from before
+    the save or those from after it, never a factory default. Also checks
+    a factory default made before anything is loaded, as holding the
+    restore pin at boot does, isn't undone by an older save.
+
+    Run with: pio test -e native -f test_settings_slots
+
+    Written by: Scott Griffis
+    Date: 10-19-2026
+*/
+
+#include <unity.h>
+#include <stdio.h>
+#include <stddef.h>
+#include <Emulator.h>
+#include <Settings.h>
+
+#define EEPROM_PATH "test_settings_slots.bin"
+#define FLASH_PATH "test_settings_slots_flash.bin"
+#define SAVED_FLASH_PATH "test_settings_slots_saved.bin"
+#define SLOT_0_ADDRESS (FS_PHYS_ADDR + FS_PHYS_SIZE - (2 * FLASH_SECTOR_SIZE))
+#define SLOT_1_ADDRESS (FS_PHYS_ADDR + FS_PHYS_SIZE - FLASH_SECTOR_SIZE)
+#define TITLE_WORD_OFFSET ((sizeof(SettingsHeader) + offsetof(NonVolatileSettings, title) + 3) & ~3u) // First whole word of the title in a slot
+#define SAVE_BYTES (FLASH_SECTOR_SIZE + sizeof(SettingsHeader) + ((sizeof(NonVolatileSettings) + 3) & ~3u)) // Erase, then the settings and header
+
+DeviceConfig device;
+
+bool passTime(uint64_t micros) {
+
+    return true;
+}
+
+bool isStopping() {
+
+    return false;
+}
+
+void setUp() {
+    memset(&device, 0, sizeof(device));
+    device.eepromPath = EEPROM_PATH;
+    device.flashPath = FLASH_PATH;
+    device.sleep = passTime;
+    device.isStopping = isStopping;
+    Emulator::attach(&device);
+    ESP.cutPowerAfterFlash(-1);
+    remove(EEPROM_PATH);
+    remove(FLASH_PATH);
+}
+
+void tearDown() {
+    ESP.cutPowerAfterFlash(-1);
+    remove(EEPROM_PATH);
+    remove(FLASH_PATH);
+    remove(SAVED_FLASH_PATH);
+}
+
+/**
+ * Copies one file over another, to keep and put back the flash.
+*/
+void copyFile(const char *from, const char *to) {
+    FILE *in = fopen(from, "rb");
+    FILE *out = fopen(to, "wb");
+    TEST_ASSERT_NOT_NULL(in);
+    TEST_ASSERT_NOT_NULL(out);
+    char buffer[4096];
+    size_t length;
+    while ((length = fread(buffer, 1, sizeof(buffer), in)) > 0) {
+        fwrite(buffer, 1, length, out);
+    }
+    fclose(in);
+    fclose(out);
+}
+
+/**
+ * Boots, sets the title and saves, as a change from the admin page does.
+ *
+ * @return Returns what saveSettings() did as bool.
+*/
+bool saveTitle(const char *title) {
+    Settings settings;
+    settings.loadSettings();
+    const SettingField *field = Settings::findField("title");
+
+    TEST_ASSERT_EQUAL(SETTING_CHANGED, settings.updateField(*field, title, strlen(title)));
+
+    return settings.saveSettings();
+}
+
+SettingsHeader readHeader(uint32_t address) {
+    SettingsHeader header;
+    TEST_ASSERT_TRUE(ESP.flashRead(address, (uint32_t *) &header, sizeof(header)));
+
+    return header;
+}
+
+/**
+ * Puts a new sequence number on a slot, leaving the settings it holds
+ * intact, as if it had been saved that many times.
+*/
+void setSequence(uint32_t address, uint32_t sequence) {
+    uint32_t slot[(sizeof(SettingsHeader) + sizeof(NonVolatileSettings) + 3) / 4];
+    TEST_ASSERT_TRUE(ESP.flashRead(address, slot, sizeof(slot)));
+    ((SettingsHeader *) slot)->sequence = sequence;
+    TEST_ASSERT_TRUE(ESP.flashEraseSector(address / FLASH_SECTOR_SIZE));
+    TEST_ASSERT_TRUE(ESP.flashWrite(address, slot, sizeof(slot)));
+}
+
+void test_saves_alternate_between_slots() {
+    TEST_ASSERT_TRUE(saveTitle("First"));
+    TEST_ASSERT_EQUAL_UINT32(1, readHeader(SLOT_0_ADDRESS).sequence);
+    TEST_ASSERT_EQUAL_HEX32(0xFFFFFFFFul, readHeader(SLOT_1_ADDRESS).magic); // Untouched
+
+    TEST_ASSERT_TRUE(saveTitle("Second"));
+    TEST_ASSERT_EQUAL_UINT32(1, readHeader(SLOT_0_ADDRESS).sequence);
+    TEST_ASSERT_EQUAL_UINT32(2, readHeader(SLOT_1_ADDRESS).sequence);
+
+    TEST_ASSERT_TRUE(saveTitle("Third"));
+    TEST_ASSERT_EQUAL_UINT32(3, readHeader(SLOT_0_ADDRESS).sequence);
+    TEST_ASSERT_EQUAL_UINT32(2, readHeader(SLOT_1_ADDRESS).sequence);
+
+    Settings settings;
+    TEST_ASSERT_TRUE(settings.loadSettings());
+    TEST_ASSERT_EQUAL_STRING("Third", settings.getTitle());
+    TEST_ASSERT_EQUAL_UINT32(3, settings.getSaveSequence());
+}
+
+void test_unchanged_save_writes_nothing() {
+    saveTitle("First");
+    Settings settings;
+    settings.loadSettings();
+
+    TEST_ASSERT_TRUE(settings.saveSettings());
+    TEST_ASSERT_EQUAL_UINT32(0, settings.getFlashWriteCount());
+    TEST_ASSERT_EQUAL_HEX32(0xFFFFFFFFul, readHeader(SLOT_1_ADDRESS).magic);
+}
+
+void test_newer_slot_wins_across_sequence_rollover() {
+    saveTitle("Older");
+    saveTitle("Newer");
+    setSequence(SLOT_0_ADDRESS, 0xFFFFFFFFul);
+    setSequence(SLOT_1_ADDRESS, 0ul); // One save on, having wrapped
+
+    Settings settings;
+    TEST_ASSERT_TRUE(settings.loadSettings());
+    TEST_ASSERT_EQUAL_STRING("Newer", settings.getTitle());
+}
+
+void test_corrupt_slot_falls_back_to_other() {
+    saveTitle("Older");
+    saveTitle("Newer");
+    uint32_t flipped = 0x00000000ul; // Clears bits of the title, as a bad write would
+    TEST_ASSERT_TRUE(ESP.flashWrite(SLOT_1_ADDRESS + TITLE_WORD_OFFSET, &flipped, sizeof(flipped)));
+
+    Settings settings;
+    TEST_ASSERT_TRUE(settings.loadSettings());
+    TEST_ASSERT_EQUAL_STRING("Older", settings.getTitle());
+    TEST_ASSERT_EQUAL_UINT32(1, settings.getSaveSequence());
+    TEST_ASSERT_TRUE(saveTitle("Latest")); // Written over the corrupt slot
+    TEST_ASSERT_EQUAL_UINT32(2, readHeader(SLOT_1_ADDRESS).sequence);
+}
+
+void test_both_slots_corrupt_is_defaulted() {
+    saveTitle("Older");
+    saveTitle("Newer");
+    uint32_t flipped = 0x00000000ul;
+    ESP.flashWrite(SLOT_0_ADDRESS + TITLE_WORD_OFFSET, &flipped, sizeof(flipped));
+    ESP.flashWrite(SLOT_1_ADDRESS + TITLE_WORD_OFFSET, &flipped, sizeof(flipped));
+
+    Settings settings;
+    TEST_ASSERT_FALSE(settings.loadSettings());
+    TEST_ASSERT_TRUE(settings.isFactoryDefault());
+}
+
+void test_factory_default_outranks_both_slots() {
+    saveTitle("A");
+    saveTitle("B");
+    saveTitle("C");
+
+    Settings restorePinHeld; // Defaulted before anything is loaded, as at boot
+    TEST_ASSERT_TRUE(restorePinHeld.factoryDefault());
+    TEST_ASSERT_EQUAL_UINT32(4, readHeader(SLOT_1_ADDRESS).sequence); // Over "B", keeping "C" until done
+
+    Settings nextBoot;
+    TEST_ASSERT_TRUE(nextBoot.loadSettings());
+    TEST_ASSERT_TRUE(nextBoot.isFactoryDefault());
+    TEST_ASSERT_EQUAL_UINT32(4, nextBoot.getSaveSequence());
+}
+
+void test_power_cut_at_any_point_of_a_save() {
+    saveTitle("Before");
+    saveTitle("Kept"); // The slot holding "Before" is the one written next
+    copyFile(FLASH_PATH, SAVED_FLASH_PATH);
+
+    int afterCount = 0;
+    for (long cut = 0; cut <= (long) SAVE_BYTES; cut += (cut < FLASH_SECTOR_SIZE ? 256 : 4)) { // Through the erase, then word by word
+        copyFile(SAVED_FLASH_PATH, FLASH_PATH);
+        ESP.cutPowerAfterFlash(cut);
+        bool isSaved = saveTitle("After");
+        ESP.cutPowerAfterFlash(-1);
+
+        Settings nextBoot;
+        TEST_ASSERT_TRUE_MESSAGE(nextBoot.loadSettings(), "Settings lost");
+        TEST_ASSERT_EQUAL_STRING((isSaved ? "After" : "Kept"), nextBoot.getTitle());
+        TEST_ASSERT_EQUAL_UINT32((isSaved ? 3 : 2), nextBoot.getSaveSequence());
+        afterCount += (isSaved ? 1 : 0);
+    }
+    TEST_ASSERT_EQUAL(1, afterCount); // Only once every byte was written
+}
+
+void test_power_cut_during_first_save_keeps_older_copy() {
+    struct NonVolatileSettings stored;
+    Settings factory;
+    factory.getSnapshot(stored);
+    strcpy(stored.title, "From EEPROM");
+    uint8_t flash[SETTINGS_EEPROM_SIZE];
+    memset(flash, 0xFF, sizeof(flash));
+    SettingsHeader header = {SETTINGS_MAGIC, SETTINGS_VERSION, sizeof(NonVolatileSettings), crc32(&stored, sizeof(stored)), 7ul};
+    memcpy(flash, &header, sizeof(header));
+    memcpy(flash + sizeof(header), &stored, sizeof(stored));
+    FILE *file = fopen(EEPROM_PATH, "wb");
+    fwrite(flash, 1, sizeof(flash), file);
+    fclose(file);
+
+    ESP.cutPowerAfterFlash(FLASH_SECTOR_SIZE + 100); // Moving it into a slot is cut short
+    Settings settings;
+    TEST_ASSERT_TRUE(settings.loadSettings());
+    ESP.cutPowerAfterFlash(-1);
+    TEST_ASSERT_EQUAL_UINT32(1, settings.getFlashWriteCount());
+
+    Settings nextBoot;
+    TEST_ASSERT_TRUE(nextBoot.loadSettings());
+    TEST_ASSERT_EQUAL_STRING("From EEPROM", nextBoot.getTitle());
+    TEST_ASSERT_EQUAL_UINT32(8, nextBoot.getSaveSequence());
+}
+
+int main(int argc, char **argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_saves_alternate_between_slots);
+    RUN_TEST(test_unchanged_save_writes_nothing);
+    RUN_TEST(test_newer_slot_wins_across_sequence_rollover);
+    RUN_TEST(test_corrupt_slot_falls_back_to_other);
+    RUN_TEST(test_both_slots_corrupt_is_defaulted);
+    RUN_TEST(test_factory_default_outranks_both_slots);
+    RUN_TEST(test_power_cut_at_any_point_of_a_save);
+    RUN_TEST(test_power_cut_during_first_save_keeps_older_copy);
+
+    return UNITY_END();
+}
@@ -0,0 +1,194 @@
+/*
+    Tests of TimeKeeper - Runs the keeper against the emulator's stand in
+    for SNTP on a clock of the test's own, so the first sync comes a
+    second after begin() and the next each hour after, as they would on
+    the device. The time the syncs set is the test's too, through its own
+    gettimeofday(), and runs at a rate of its own against the device's
+    counter so the drift the keeper measures can be checked, along with
+    the smoothing of it, the hold after the time is stepped backwards and
+    the estimate resumed from before the first sync.
+
+    Run with: pio test -e native -f test_time_keeper
+
+    Written by: Scott Griffis
+    Date: 10-19-2026
+*/
+
+#include <unity.h>
+#include <sys/time.h>
+#include <Arduino.h>
+#include <Emulator.h>
+#include <TimeKeeper.h>
+
+#define FIRST_SYNC_MILLIS 1000ul // As the stand in for SNTP takes
+#define SYNC_INTERVAL_MILLIS 3600000ul
+#define SERVER_START_MICROS 1792410856000000ull
+#define DAY_MILLIS 86400000ull
+
+uint64_t clockNanos = 0ull;
+uint64_t serverNanos = 0ull; // The true time, as the SNTP server has it
+long serverPpm = 0l; // How much faster the true time runs than the device's counter
+DeviceConfig device;
+TimeKeeper *keeper;
+
+/**
+ * Stands in for the C library's, which the emulator takes as the true
+ * time, so the time a sync sets is the test's own.
+*/
+extern "C" int gettimeofday(struct timeval *tv, void *tz) noexcept {
+    tv->tv_sec = (time_t) (serverNanos / 1000000000ull);
+    tv->tv_usec = (suseconds_t) ((serverNanos / 1000ull) % 1000000ull);
+
+    return 0;
+}
+
+uint64_t readClock() {
+
+    return clockNanos;
+}
+
+bool passTime(uint64_t micros) {
+    int64_t nanos = (int64_t) (micros * 1000ull);
+    clockNanos += nanos;
+    serverNanos += nanos + ((nanos * serverPpm) / 1000000ll);
+
+    return true;
+}
+
+bool isStopping() {
+
+    return false;
+}
+
+void setUp() {
+    memset(&device, 0, sizeof(device));
+    device.sleep = passTime;
+    device.isStopping = isStopping;
+    device.clockNanos = readClock;
+    Emulator::attach(&device); // Drops the syncs of the last test
+    serverNanos = SERVER_START_MICROS * 1000ull;
+    serverPpm = 0l;
+
+    keeper = new TimeKeeper();
+}
+
+void tearDown() {
+    delete keeper;
+}
+
+uint64_t getServerMicros() {
+
+    return (serverNanos / 1000ull);
+}
+
+/**
+ * Lets the given time pass, raising the syncs that come due as delay()
+ * does on the device.
+*/
+void runFor(unsigned long millisToRun) {
+    delay(millisToRun);
+}
+
+void test_first_sync_sets_clock() {
+    keeper->begin("time.local");
+    TEST_ASSERT_EQUAL_UINT64(0ull, keeper->getEpochMicros());
+
+    runFor(FIRST_SYNC_MILLIS - 1);
+    TEST_ASSERT_FALSE(keeper->isSynced());
+    TEST_ASSERT_EQUAL_UINT64(0ull, keeper->getEpochMicros());
+
+    runFor(1);
+    TEST_ASSERT_TRUE(keeper->isSynced());
+    TEST_ASSERT_EQUAL_UINT32(1, keeper->getSyncCount());
+    TEST_ASSERT_EQUAL_UINT64(getServerMicros(), keeper->getEpochMicros());
+
+    runFor(SYNC_INTERVAL_MILLIS);
+    TEST_ASSERT_EQUAL_UINT32(2, keeper->getSyncCount());
+    TEST_ASSERT_EQUAL_INT32(0, keeper->getDriftPpm()); // None to measure
+    TEST_ASSERT_EQUAL_UINT64(getServerMicros(), keeper->getEpochMicros());
+}
+
+void test_drift_is_measured_and_smoothed() {
+    serverPpm = 100l; // The device's crystal runs slow
+    keeper->begin("time.local");
+    runFor(FIRST_SYNC_MILLIS);
+    runFor(SYNC_INTERVAL_MILLIS);
+    TEST_ASSERT_EQUAL_UINT32(2, keeper->getSyncCount());
+    TEST_ASSERT_INT_WITHIN(1, 100, keeper->getDriftPpm());
+
+    runFor(SYNC_INTERVAL_MILLIS / 2); // Corrected between syncs; 180ms adrift if not
+    TEST_ASSERT_UINT64_WITHIN(2000ull, getServerMicros(), keeper->getEpochMicros());
+
+    runFor(SYNC_INTERVAL_MILLIS / 2);
+    TEST_ASSERT_INT_WITHIN(1, 100, keeper->getDriftPpm()); // Same again
+
+    serverPpm = 300l;
+    runFor(SYNC_INTERVAL_MILLIS);
+    TEST_ASSERT_INT_WITHIN(1, 200, keeper->getDriftPpm()); // Halfway to what was measured
+
+    serverPpm = 2000l; // Beyond any crystal
+    runFor(SYNC_INTERVAL_MILLIS);
+    TEST_ASSERT_INT_WITHIN(1, (200 + TIME_KEEPER_MAX_DRIFT_PPM) / 2, keeper->getDriftPpm());
+    TEST_ASSERT_EQUAL_UINT32(5, keeper->getSyncCount());
+}
+
+void test_clock_holds_after_backward_step() {
+    keeper->begin("time.local");
+    runFor(FIRST_SYNC_MILLIS);
+    runFor(10000ul);
+    uint64_t before = keeper->getEpochMicros();
+
+    serverNanos -= 5000000000ull; // The server's time is stepped back 5s
+    keeper->begin("time2.local"); // As when the server is changed; Syncs a second later
+    runFor(FIRST_SYNC_MILLIS);
+    TEST_ASSERT_EQUAL_UINT32(2, keeper->getSyncCount());
+    TEST_ASSERT_EQUAL_INT32(0, keeper->getDriftPpm()); // Too soon after the last to measure
+    TEST_ASSERT_EQUAL_UINT64(before, keeper->getEpochMicros()); // Held rather than run back
+
+    runFor(3000ul);
+    TEST_ASSERT_EQUAL_UINT64(before, keeper->getEpochMicros()); // True time still behind
+
+    runFor(2000ul);
+    TEST_ASSERT_TRUE(getServerMicros() > before);
+    TEST_ASSERT_EQUAL_UINT64(getServerMicros(), keeper->getEpochMicros()); // Caught up; Runs again
+
+    runFor(SYNC_INTERVAL_MILLIS);
+    TEST_ASSERT_EQUAL_UINT32(3, keeper->getSyncCount()); // The first server's syncs were dropped
+}
+
+void test_resume_runs_until_synced() {
+    keeper->resume(0ull); // Nothing carried
+    TEST_ASSERT_EQUAL_UINT64(0ull, keeper->getEpochMillis());
+
+    uint64_t estimate = (getServerMicros() / 1000ull) - 2000ull; // Came back from sleep a little behind
+    keeper->resume(estimate);
+    TEST_ASSERT_FALSE(keeper->isSynced());
+    TEST_ASSERT_EQUAL_UINT64(estimate, keeper->getEpochMillis());
+    runFor(500ul);
+    TEST_ASSERT_EQUAL_UINT64(estimate + 500ull, keeper->getEpochMillis());
+
+    keeper->begin("time.local");
+    runFor(FIRST_SYNC_MILLIS);
+    TEST_ASSERT_TRUE(keeper->isSynced());
+    TEST_ASSERT_EQUAL_UINT64(getServerMicros(), keeper->getEpochMicros()); // Estimate replaced
+
+    keeper->resume(estimate); // Already has better
+    TEST_ASSERT_EQUAL_UINT64(getServerMicros(), keeper->getEpochMicros());
+}
+
+void test_uptime_passes_millis_rollover() {
+    clockNanos += 50ull * DAY_MILLIS * 1000000ull; // Past the 49.7 days of millis()
+
+    TEST_ASSERT_EQUAL_UINT64(50ull * DAY_MILLIS, keeper->getUptimeMillis());
+}
+
+int main(int argc, char **argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_first_sync_sets_clock);
+    RUN_TEST(test_drift_is_measured_and_smoothed);
+    RUN_TEST(test_clock_holds_after_backward_step);
+    RUN_TEST(test_resume_runs_until_synced);
+    RUN_TEST(test_uptime_passes_millis_rollover);
+
+    return UNITY_END();
+}
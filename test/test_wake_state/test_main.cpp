@@ -0,0 +1,250 @@
+/*
+    Tests of WakeState - Carries the state through a stand in for the RTC
+    memory from one simulated boot to the next, as setup() and the deep
+    sleep do, and checks what survives, that anything but a sealed record
+    is started afresh and that only wakes from deep sleep are counted.
+    Then runs a timing model of battery mode wakes and checks the clock
+    estimate, the ageing of the cached lease and the average current.
+
+    Run with: pio test -e native -f test_wake_state
+
+    Written by: Scott Griffis
+    Date: 10-19-2026
+*/
+
+#include <unity.h>
+#include <string.h>
+#include <PowerManager.h>
+#include <WakeState.h>
+
+#define RTC_USER_SIZE (512 - (WAKE_RTC_BLOCK * 4)) // What is left after the OTA area
+#define AWAKE_MILLIS 2000ul
+#define SLEEP_MILLIS 300000ul
+
+uint8_t rtcMemory[RTC_USER_SIZE]; // Survives the reset of a deep sleep, as on the device
+
+void setUp() {
+    memset(rtcMemory, 0xA5, sizeof(rtcMemory)); // Whatever power up leaves
+}
+
+void tearDown() {}
+
+/**
+ * Boots as setup() does, reading the state from the RTC memory and
+ * counting the wake if it ended a deep sleep.
+ *
+ * @return Returns what load() found as bool.
+*/
+bool boot(WakeState &state, bool isDeepSleepWake) {
+    memcpy(state.getData(), rtcMemory, state.getSize());
+    bool isValid = state.load();
+    if (isDeepSleepWake) {
+        state.noteWake();
+    }
+
+    return isValid;
+}
+
+/**
+ * Goes into deep sleep as doDeepSleep() does, sealing the state into
+ * the RTC memory.
+*/
+void deepSleep(WakeState &state, uint64_t epochMillis, uint32_t awakeMillis, uint32_t sleepMillis) {
+    WakeTimings timings = {120, 400, 700, 900, (uint16_t) awakeMillis};
+    state.beginSleep(epochMillis, awakeMillis, sleepMillis, timings);
+    state.seal();
+    memcpy(rtcMemory, state.getData(), state.getSize());
+}
+
+QueuedReading makeReading(uint32_t sequence) {
+    QueuedReading reading = {1792410856123ull + (sequence * SLEEP_MILLIS), sequence, 20.0f + sequence, 40.0f + sequence};
+
+    return reading;
+}
+
+void test_record_fits_rtc_memory() {
+    WakeState state;
+
+    TEST_ASSERT_LESS_OR_EQUAL(RTC_USER_SIZE, state.getSize());
+    TEST_ASSERT_EQUAL(0, state.getSize() % 4);
+}
+
+void test_power_up_starts_fresh() {
+    WakeState state;
+
+    TEST_ASSERT_FALSE(boot(state, false));
+    TEST_ASSERT_FALSE(state.getIsResumed());
+    TEST_ASSERT_EQUAL_UINT32(0, state.getSequence());
+    TEST_ASSERT_EQUAL_UINT8(0, state.getHistoryCount());
+    TEST_ASSERT_EQUAL_UINT64(0ull, state.getEpochMillisAtWake());
+    TEST_ASSERT_FALSE(state.isLeaseUsable());
+}
+
+void test_state_survives_deep_sleep() {
+    WakeState before;
+    boot(before, false);
+    before.setSequence(41);
+    before.setIsSensorFailing(true);
+    before.addReading(makeReading(40));
+    before.addReading(makeReading(41));
+    before.setUnsentCount(1);
+    before.noteFreshLease();
+    before.noteDelivered(false);
+    deepSleep(before, 1792410856123ull, AWAKE_MILLIS, SLEEP_MILLIS);
+
+    WakeState after;
+    TEST_ASSERT_TRUE(boot(after, true));
+    TEST_ASSERT_TRUE(after.getIsResumed());
+    TEST_ASSERT_EQUAL_UINT32(41, after.getSequence());
+    TEST_ASSERT_TRUE(after.getIsSensorFailing());
+    TEST_ASSERT_EQUAL_UINT8(2, after.getHistoryCount());
+    TEST_ASSERT_EQUAL_UINT8(1, after.getUnsentCount());
+    TEST_ASSERT_EQUAL_UINT32(41, after.getReading(1).sequence);
+    TEST_ASSERT_EQUAL_UINT64(makeReading(40).timestamp, after.getReading(0).timestamp);
+    TEST_ASSERT_EQUAL_UINT16(1, after.getFailedWakes());
+    TEST_ASSERT_TRUE(after.isLeaseUsable());
+    TEST_ASSERT_EQUAL_UINT16(AWAKE_MILLIS, after.getLastTimings().asleep);
+}
+
+void test_any_changed_byte_is_caught() {
+    WakeState before;
+    boot(before, false);
+    before.setSequence(7);
+    before.addReading(makeReading(7));
+    deepSleep(before, 0ull, AWAKE_MILLIS, SLEEP_MILLIS);
+    uint8_t sealed[RTC_USER_SIZE];
+    memcpy(sealed, rtcMemory, sizeof(sealed));
+
+    for (size_t i = 0; i < before.getSize(); i++) {
+        memcpy(rtcMemory, sealed, sizeof(sealed));
+        rtcMemory[i] ^= 0x10;
+        WakeState after;
+        TEST_ASSERT_FALSE_MESSAGE(boot(after, true), "Changed byte not caught");
+        TEST_ASSERT_EQUAL_UINT32(0, after.getSequence());
+    }
+}
+
+void test_only_deep_sleep_wakes_are_counted() {
+    WakeState state;
+    boot(state, false);
+    deepSleep(state, 0ull, AWAKE_MILLIS, SLEEP_MILLIS);
+
+    for (int i = 0; i < 5; i++) { // Battery mode wakes...
+        WakeState wake;
+        boot(wake, true);
+        deepSleep(wake, 0ull, AWAKE_MILLIS, SLEEP_MILLIS);
+    }
+    WakeState restarted; // Reset by hand, so not a wake; Still reads the state
+    TEST_ASSERT_TRUE(boot(restarted, false));
+    TEST_ASSERT_EQUAL_UINT32(5, restarted.getWakeCount());
+    deepSleep(restarted, 0ull, AWAKE_MILLIS, SLEEP_MILLIS); // Back into battery mode
+
+    WakeState next;
+    boot(next, true);
+    TEST_ASSERT_EQUAL_UINT32(6, next.getWakeCount());
+}
+
+void test_history_keeps_newest_and_caps_unsent() {
+    WakeState state;
+    boot(state, false);
+    for (uint32_t sequence = 1; sequence <= WAKE_HISTORY_SIZE + 3; sequence++) {
+        state.addReading(makeReading(sequence));
+    }
+
+    TEST_ASSERT_EQUAL_UINT8(WAKE_HISTORY_SIZE, state.getHistoryCount());
+    TEST_ASSERT_EQUAL_UINT8(WAKE_HISTORY_SIZE, state.getUnsentCount());
+    TEST_ASSERT_EQUAL_UINT32(4, state.getReading(0).sequence); // Oldest three made room
+    TEST_ASSERT_EQUAL_UINT32(WAKE_HISTORY_SIZE + 3, state.getReading(WAKE_HISTORY_SIZE - 1).sequence);
+    state.setUnsentCount(WAKE_HISTORY_SIZE + 5);
+    TEST_ASSERT_EQUAL_UINT8(WAKE_HISTORY_SIZE, state.getUnsentCount());
+}
+
+void test_clock_carries_across_sleep() {
+    WakeState before;
+    boot(before, false);
+    deepSleep(before, 1792410856123ull, AWAKE_MILLIS, SLEEP_MILLIS);
+
+    WakeState after;
+    boot(after, true);
+    TEST_ASSERT_EQUAL_UINT64(1792410856123ull + SLEEP_MILLIS, after.getEpochMillisAtWake());
+    deepSleep(after, 0ull, AWAKE_MILLIS, SLEEP_MILLIS); // Time never known this wake
+
+    WakeState unsynced;
+    boot(unsynced, true);
+    TEST_ASSERT_EQUAL_UINT64(0ull, unsynced.getEpochMillisAtWake());
+}
+
+void test_lease_ages_out_over_wakes() {
+    WakeState state;
+    boot(state, false);
+    state.noteFreshLease();
+    deepSleep(state, 0ull, AWAKE_MILLIS, SLEEP_MILLIS);
+
+    int usableWakes = 0;
+    for (int i = 0; i < 20; i++) {
+        WakeState wake;
+        boot(wake, true);
+        if (wake.isLeaseUsable()) {
+            usableWakes++;
+        }
+        deepSleep(wake, 0ull, AWAKE_MILLIS, SLEEP_MILLIS);
+    }
+    TEST_ASSERT_EQUAL(WAKE_LEASE_MAX_AGE_MILLIS / (AWAKE_MILLIS + SLEEP_MILLIS), usableWakes);
+
+    WakeState renewed;
+    boot(renewed, true);
+    renewed.noteFreshLease(); // DHCP used again
+    TEST_ASSERT_TRUE(renewed.isLeaseUsable());
+    renewed.forgetLease();
+    TEST_ASSERT_FALSE(renewed.isLeaseUsable());
+}
+
+void test_lease_age_saturates() {
+    WakeState state;
+    boot(state, false);
+    state.noteFreshLease();
+    for (int i = 0; i < 3; i++) {
+        state.beginSleep(0ull, 0xFFFFFFF0ul, 0xFFFFFFF0ul, state.getLastTimings());
+    }
+
+    TEST_ASSERT_FALSE(state.isLeaseUsable()); // Not wrapped back to young
+}
+
+void test_failed_wakes_count_up_and_clear() {
+    WakeState state;
+    boot(state, false);
+    for (int i = 0; i < 3; i++) {
+        state.noteDelivered(false);
+    }
+    TEST_ASSERT_EQUAL_UINT16(3, state.getFailedWakes());
+
+    state.noteDelivered(true);
+    TEST_ASSERT_EQUAL_UINT16(0, state.getFailedWakes());
+}
+
+void test_average_current_follows_time_awake() {
+    uint32_t expected = (uint32_t) (((AWAKE_MILLIS * POWER_AWAKE_80_MA * 1000ull) + ((SLEEP_MILLIS - AWAKE_MILLIS) * WAKE_DEEP_SLEEP_UA)) / SLEEP_MILLIS);
+    TEST_ASSERT_EQUAL_UINT32(expected, WakeState::estimateAverageMicroAmps(AWAKE_MILLIS, SLEEP_MILLIS - AWAKE_MILLIS));
+
+    uint32_t halfAwake = WakeState::estimateAverageMicroAmps(AWAKE_MILLIS / 2, SLEEP_MILLIS - AWAKE_MILLIS);
+    TEST_ASSERT_LESS_THAN(expected, halfAwake);
+    TEST_ASSERT_EQUAL_UINT32(WAKE_DEEP_SLEEP_UA, WakeState::estimateAverageMicroAmps(0, SLEEP_MILLIS));
+    TEST_ASSERT_EQUAL_UINT32(0, WakeState::estimateAverageMicroAmps(0, 0));
+}
+
+int main(int argc, char **argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_record_fits_rtc_memory);
+    RUN_TEST(test_power_up_starts_fresh);
+    RUN_TEST(test_state_survives_deep_sleep);
+    RUN_TEST(test_any_changed_byte_is_caught);
+    RUN_TEST(test_only_deep_sleep_wakes_are_counted);
+    RUN_TEST(test_history_keeps_newest_and_caps_unsent);
+    RUN_TEST(test_clock_carries_across_sleep);
+    RUN_TEST(test_lease_ages_out_over_wakes);
+    RUN_TEST(test_lease_age_saturates);
+    RUN_TEST(test_failed_wakes_count_up_and_clear);
+    RUN_TEST(test_average_current_follows_time_awake);
+
+    return UNITY_END();
+}
@@ -0,0 +1,279 @@
+/*
+    Bench - A class used to measure how many packets the collector can take
+    in, with a simulated fleet sending the same packets the firmware does.
+
+    Written by: Scott Griffis
+    Date: 10-19-2026
+*/
+
+#include "Bench.h"
+#include "Receiver.h"
+#include <stdio.h>
+#include <string.h>
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <thread>
+#include <unistd.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+
+#define BENCH_IDLE_MILLIS 250 // Receivers taken to be done once nothing arrives for this long
+
+/**
+ * #### CLASS CONSTRUCTOR ####
+ * Allows for external instantiation of
+ * the class into an object.
+ *
+ * @param devices The number of devices to simulate as uint32_t.
+ * @param rounds The number of broadcasts each device sends as uint32_t.
+ * @param historySize The most samples kept per device as uint32_t.
+*/
+Bench::Bench(uint32_t devices, uint32_t rounds, uint32_t historySize) {
+    this->devices = devices;
+    this->rounds = rounds;
+    this->historySize = historySize;
+}
+
+/**
+ * Runs the benchmark, printing the results.
+ *
+ * @param threads The threads to take packets in with as uint32_t.
+ *
+ * @return Returns the exit code for the process as int.
+*/
+int Bench::run(uint32_t threads) {
+    uint32_t cores = std::thread::hardware_concurrency();
+    cores = (cores > 0 && cores < threads ? cores : threads); // Threads beyond the cores share them
+    build();
+    uint64_t packetCount = offsets.size() - 1;
+    printf(
+        "Bench: %u devices, %u broadcasts each, %llu packets (%.1f MB), history of %u\n",
+        devices, rounds, (unsigned long long) packetCount, data.size() / 1048576.0, historySize
+    );
+
+    IngestCounts counts;
+    double seconds = runIngest(1, counts);
+    printf(
+        "  ingest    1 thread : %10.0f datagrams/sec, %10.0f per core (%llu stored, %llu repeats, %llu rejected)\n",
+        counts.packets / seconds, counts.packets / seconds,
+        (unsigned long long) counts.stored, (unsigned long long) counts.repeats, (unsigned long long) counts.rejected
+    );
+    if (threads > 1) {
+        seconds = runIngest(threads, counts);
+        printf(
+            "  ingest  %3u threads: %10.0f datagrams/sec, %10.0f per core\n",
+            threads, counts.packets / seconds, counts.packets / seconds / cores
+        );
+    }
+
+    uint64_t sent = 0;
+    uint32_t drops = 0;
+    seconds = runLoopback(threads, counts, sent, drops);
+    if (seconds <= 0.0) { // Couldn't open the sockets...
+
+        return 1;
+    }
+    printf(
+        "  loopback %2u threads: %10.0f datagrams/sec, %10.0f per core (%llu sent, %llu received, %u dropped by the kernel)\n",
+        threads, counts.packets / seconds, counts.packets / seconds / cores,
+        (unsigned long long) sent, (unsigned long long) counts.packets, drops
+    );
+
+    return 0;
+}
+
+/*
+=================================================================
+Private Functions
+=================================================================
+*/
+
+/**
+ * #### PRIVATE ####
+ * Used to make every packet the fleet sends, in the order sent: Each
+ * round has every device broadcast once. Readings wander a little from
+ * round to round and each device has its own starting point.
+*/
+void Bench::build() {
+    data.clear();
+    offsets.clear();
+    data.reserve((size_t) devices * rounds * 96);
+    offsets.reserve(((size_t) devices * rounds) + 1);
+    uint64_t startMillis = 1792410886123ull;
+    char packet[RECEIVER_PACKET_SIZE];
+    for (uint32_t round = 0; round < rounds; round++) {
+        uint32_t sequence = (round / 3) + 1; // New reading every third broadcast
+        for (uint32_t device = 0; device < devices; device++) {
+            float temperature = 15.0f + (device % 100) * 0.1f + (sequence % 7) * 0.01f;
+            float humidity = 30.0f + (device % 50) * 0.5f + (sequence % 5) * 0.02f;
+            uint32_t ip = ipOf(device);
+            int length = snprintf(
+                packet, sizeof(packet), "TempBuddy-Sensor::%u.%u.%u.%u::%06X::T_%f::H_%f::TS_%llu::SEQ_%u",
+                (ip >> 24) & 0xFF, (ip >> 16) & 0xFF, (ip >> 8) & 0xFF, ip & 0xFF, 0x100000 + device,
+                temperature, humidity, (unsigned long long) (startMillis + (sequence * 30000ull)), sequence
+            );
+            offsets.push_back((uint32_t) data.size());
+            data.insert(data.end(), packet, packet + length);
+        }
+    }
+    offsets.push_back((uint32_t) data.size());
+}
+
+/**
+ * #### PRIVATE ####
+ * Used to take every packet straight into a fresh store, with the given
+ * number of threads taking batches in turn as receivers would.
+ *
+ * @param threads The threads to use as uint32_t.
+ * @param total Receives the counts of all threads as IngestCounts&.
+ *
+ * @return Returns the time taken in seconds as double.
+*/
+double Bench::runIngest(uint32_t threads, IngestCounts& total) {
+    SeriesStore store(historySize, devices);
+    size_t packetCount = offsets.size() - 1;
+    std::atomic<size_t> next{0};
+    std::vector<IngestCounts> counts(threads);
+    std::vector<std::thread> workers;
+    memset(counts.data(), 0, sizeof(IngestCounts) * threads);
+
+    auto start = std::chrono::steady_clock::now();
+    for (uint32_t t = 0; t < threads; t++) {
+        workers.emplace_back([this, &store, &next, &counts, packetCount, t]() {
+            while (true) {
+                size_t first = next.fetch_add(RECEIVER_BATCH, std::memory_order_relaxed);
+                if (first >= packetCount) { // All taken...
+                    break;
+                }
+                size_t last = (first + RECEIVER_BATCH < packetCount ? first + RECEIVER_BATCH : packetCount);
+                int64_t now = Receiver::nowMillis();
+                for (size_t i = first; i < last; i++) {
+                    store.ingest(&data[offsets[i]], offsets[i + 1] - offsets[i], ipOf((uint32_t) (i % devices)), now, counts[t]);
+                }
+            }
+        });
+    }
+    for (std::thread &worker : workers) {
+        worker.join();
+    }
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+    memset(&total, 0, sizeof(total));
+    for (const IngestCounts &count : counts) {
+        SeriesStore::addCounts(total, count);
+    }
+
+    return elapsed.count();
+}
+
+/**
+ * #### PRIVATE ####
+ * Used to send every packet over UDP on the loopback interface to
+ * receivers as the collector runs them. The time runs from the first
+ * packet sent until the receivers go quiet, less the quiet time.
+ *
+ * @param threads The receivers to run as uint32_t.
+ * @param total Receives the counts of all receivers as IngestCounts&.
+ * @param sent Receives the number of packets sent as uint64_t&.
+ * @param drops Receives the number of packets dropped by the kernel as uint32_t&.
+ *
+ * @return Returns the time taken in seconds, 0 on failure, as double.
+*/
+double Bench::runLoopback(uint32_t threads, IngestCounts& total, uint64_t& sent, uint32_t& drops) {
+    memset(&total, 0, sizeof(total));
+    int receiveFd = Receiver::openSocket(INADDR_LOOPBACK, 0);
+    int sendFd = socket(AF_INET, SOCK_DGRAM | SOCK_CLOEXEC, 0);
+    int stopFd = eventfd(0, EFD_CLOEXEC);
+    sockaddr_in target;
+    socklen_t targetLength = sizeof(target);
+    if (receiveFd < 0 || sendFd < 0 || stopFd < 0 || getsockname(receiveFd, (sockaddr *) &target, &targetLength) != 0) {
+        perror("bench");
+
+        return 0.0;
+    }
+
+    SeriesStore store(historySize, devices);
+    std::vector<std::unique_ptr<Receiver>> receivers;
+    for (uint32_t t = 0; t < threads; t++) {
+        receivers.emplace_back(new Receiver(receiveFd, stopFd, store));
+        receivers.back()->start();
+    }
+
+    /* Send Everything, A Batch At A Time */
+    size_t packetCount = offsets.size() - 1;
+    iovec vectors[RECEIVER_BATCH];
+    mmsghdr messages[RECEIVER_BATCH];
+    sent = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (size_t first = 0; first < packetCount; first += RECEIVER_BATCH) {
+        size_t batch = (packetCount - first < RECEIVER_BATCH ? packetCount - first : RECEIVER_BATCH);
+        for (size_t i = 0; i < batch; i++) {
+            vectors[i].iov_base = &data[offsets[first + i]];
+            vectors[i].iov_len = offsets[first + i + 1] - offsets[first + i];
+            memset(&messages[i].msg_hdr, 0, sizeof(msghdr));
+            messages[i].msg_hdr.msg_name = &target;
+            messages[i].msg_hdr.msg_namelen = sizeof(target);
+            messages[i].msg_hdr.msg_iov = &vectors[i];
+            messages[i].msg_hdr.msg_iovlen = 1;
+        }
+        int done = sendmmsg(sendFd, messages, batch, 0);
+        if (done > 0) {
+            sent += done;
+        }
+    }
+
+    /* Wait For The Receivers To Go Quiet */
+    uint64_t lastTaken = UINT64_MAX;
+    auto lastChange = std::chrono::steady_clock::now();
+    while (true) {
+        uint64_t taken = 0;
+        for (std::unique_ptr<Receiver> &receiver : receivers) {
+            IngestCounts counts;
+            receiver->getCounts(counts);
+            taken += counts.packets;
+        }
+        if (taken != lastTaken) {
+            lastTaken = taken;
+            lastChange = std::chrono::steady_clock::now();
+        } else if (std::chrono::steady_clock::now() - lastChange >= std::chrono::milliseconds(BENCH_IDLE_MILLIS)) { // Done...
+            break;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    }
+    std::chrono::duration<double> elapsed = lastChange - start;
+
+    uint64_t wake = 1;
+    if (write(stopFd, &wake, sizeof(wake)) != sizeof(wake)) {
+        perror("write");
+    }
+    drops = 0;
+    for (std::unique_ptr<Receiver> &receiver : receivers) {
+        receiver->join();
+        IngestCounts counts;
+        receiver->getCounts(counts);
+        SeriesStore::addCounts(total, counts);
+        if (receiver->getKernelDrops() > drops) {
+            drops = receiver->getKernelDrops();
+        }
+    }
+    close(receiveFd);
+    close(sendFd);
+    close(stopFd);
+
+    return elapsed.count();
+}
+
+/**
+ * #### PRIVATE ####
+ * Used to give each simulated device an address of its own.
+ *
+ * @param device The device's number as uint32_t.
+ *
+ * @return Returns the address in host byte order as uint32_t.
+*/
+uint32_t Bench::ipOf(uint32_t device) {
+
+    return (10u << 24) | (device + 2);
+}
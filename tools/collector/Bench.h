@@ -0,0 +1,54 @@
+/*
+    Bench - A class used to measure how many packets the collector can take
+    in, with a simulated fleet sending the same packets the firmware does.
+
+    Each device sends a broadcast every 10 seconds and takes a new reading
+    every 30, so two in three packets repeat the reading before, as on a
+    real network. The packets are made up front and then taken in twice:
+
+        ingest      Straight into the store by each thread, in batches of
+                    RECEIVER_BATCH, leaving out the kernel. Run with one
+                    thread and then with all, to show how it scales.
+        loopback    Sent over UDP to 127.0.0.1 with sendmmsg() and taken in
+                    by the receivers as the collector would, so the socket
+                    costs are counted. Packets the kernel dropped because
+                    the receivers fell behind are reported.
+
+    The rate per core is the rate divided by the threads taking packets in,
+    or by the cores if there are fewer. The loopback sender runs on one of
+    those cores too, so its rate is a floor on what a real network gives.
+
+    Written by: Scott Griffis
+    Date: 10-19-2026
+*/
+
+#ifndef Bench_h
+    #define Bench_h
+
+    #include <stdint.h>
+    #include <vector>
+    #include "SeriesStore.h"
+
+    #define BENCH_DEFAULT_DEVICES 10000
+    #define BENCH_DEFAULT_ROUNDS 60 // Ten minutes of broadcasts
+
+    class Bench {
+        private:
+            std::vector<char>     data      ; // Every packet, one after the other
+            std::vector<uint32_t> offsets   ; // Start of each packet, plus the end of the last
+            uint32_t       devices          ;
+            uint32_t       rounds           ;
+            uint32_t       historySize      ;
+
+            void           build             ()                       ;
+            double         runIngest         (uint32_t threads, IngestCounts& total);
+            double         runLoopback       (uint32_t threads, IngestCounts& total, uint64_t& sent, uint32_t& drops);
+            static uint32_t ipOf             (uint32_t device)        ;
+
+        public:
+            Bench(uint32_t devices, uint32_t rounds, uint32_t historySize);
+
+            int            run               (uint32_t threads)       ;
+    };
+
+#endif
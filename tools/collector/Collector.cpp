@@ -0,0 +1,241 @@
+/*
+    TempBuddy Collector - A daemon for Linux which listens for the packets
+    TempBuddy units send on the broadcast port, both the live broadcast
+    and the backlog forwarded after an outage, and keeps a time series of
+    the readings of every unit in memory. The readings are served over
+    HTTP as JSON (see QueryServer.h). It is meant for a network with more
+    units than a hub can hold, into the thousands.
+
+    Packets are taken in by worker threads sharing one socket, in batches
+    with recvmmsg() (see Receiver.h), and parsed where they lie by the same
+    BroadcastPacket class the firmware's hub uses. The readings are kept in
+    a store sharded by Device ID (see SeriesStore.h), in which a reading
+    from a unit already known allocates nothing.
+
+    It is built with g++ from the project root, as shown in the README
+    under Collecting From A Large Fleet.
+
+    Usage:
+        tempbuddy-collector [--port 61549] [--http 8080] [--threads N] [--history 240] [--max-devices 65536]
+        tempbuddy-collector --bench [--devices 10000] [--rounds 60] [--threads N]
+
+    Written by: Scott Griffis
+    Date: 10-19-2026
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <signal.h>
+#include <unistd.h>
+#include <memory>
+#include <thread>
+#include <vector>
+#include <sys/eventfd.h>
+#include <netinet/in.h>
+#include "SeriesStore.h"
+#include "Receiver.h"
+#include "QueryServer.h"
+#include "Bench.h"
+
+#define COLLECTOR_DEFAULT_PORT 61549 // Broadcast port of the firmware's settings
+#define COLLECTOR_DEFAULT_HTTP 8080
+#define COLLECTOR_MAX_THREADS 64
+
+// ************************************************************************************
+// Options given on the command line
+// ************************************************************************************
+struct Options {
+    uint32_t       port             ;
+    uint32_t       httpPort         ;
+    uint32_t       threads          ;
+    uint32_t       historySize      ;
+    uint32_t       maxDevices       ;
+    bool           isBench          ;
+    uint32_t       benchDevices     ;
+    uint32_t       benchRounds      ;
+};
+
+bool parseOptions(int argc, char **argv, Options &options);
+bool parseNumber(const char *text, uint32_t low, uint32_t high, uint32_t &value);
+void printUsage(const char *name);
+int runCollector(const Options &options);
+
+/**
+ * Reads the options and either runs the collector until stopped
+ * or runs the benchmark.
+ */
+int main(int argc, char **argv) {
+    uint32_t cores = std::thread::hardware_concurrency();
+    Options options = {
+        COLLECTOR_DEFAULT_PORT,
+        COLLECTOR_DEFAULT_HTTP,
+        (cores > 0 ? (cores < 4 ? cores : 4) : 2),
+        STORE_DEFAULT_HISTORY,
+        STORE_DEFAULT_MAX_DEVICES,
+        false,
+        BENCH_DEFAULT_DEVICES,
+        BENCH_DEFAULT_ROUNDS
+    };
+    if (!parseOptions(argc, argv, options)) { // Bad options...
+        printUsage(argv[0]);
+
+        return 2;
+    }
+    if (options.isBench) {
+        Bench bench(options.benchDevices, options.benchRounds, options.historySize);
+
+        return bench.run(options.threads);
+    }
+
+    return runCollector(options);
+}
+
+/**
+ * Runs the receivers and the query server until SIGINT or SIGTERM
+ * is received. The signals are blocked in every thread and waited
+ * for here, so the other threads never see them.
+ *
+ * @param options The options as const Options&.
+ *
+ * @return Returns the exit code for the process as int.
+ */
+int runCollector(const Options &options) {
+    sigset_t signals;
+    sigemptyset(&signals);
+    sigaddset(&signals, SIGINT);
+    sigaddset(&signals, SIGTERM);
+    pthread_sigmask(SIG_BLOCK, &signals, nullptr);
+
+    int socketFd = Receiver::openSocket(INADDR_ANY, (uint16_t) options.port);
+    int stopFd = eventfd(0, EFD_CLOEXEC);
+    if (socketFd < 0 || stopFd < 0) {
+
+        return 1;
+    }
+
+    SeriesStore store(options.historySize, options.maxDevices);
+    std::vector<std::unique_ptr<Receiver>> receivers;
+    for (uint32_t i = 0; i < options.threads; i++) {
+        receivers.emplace_back(new Receiver(socketFd, stopFd, store));
+        receivers.back()->start();
+    }
+    QueryServer server(stopFd, store, receivers);
+    if (!server.start((uint16_t) options.httpPort)) { // Queries can't be answered...
+        uint64_t wake = 1;
+        if (write(stopFd, &wake, sizeof(wake)) != sizeof(wake)) {
+            perror("write");
+        }
+        for (std::unique_ptr<Receiver> &receiver : receivers) {
+            receiver->join();
+        }
+
+        return 1;
+    }
+    printf(
+        "Collecting on UDP port %u with %u threads; Queries on http://0.0.0.0:%u/api/devices\n",
+        options.port, options.threads, options.httpPort
+    );
+    fflush(stdout);
+
+    int received = 0;
+    sigwait(&signals, &received);
+    printf("Stopping...\n");
+    uint64_t wake = 1;
+    if (write(stopFd, &wake, sizeof(wake)) != sizeof(wake)) {
+        perror("write");
+    }
+    for (std::unique_ptr<Receiver> &receiver : receivers) {
+        receiver->join();
+    }
+    server.join();
+    close(socketFd);
+    close(stopFd);
+
+    return 0;
+}
+
+/**
+ * Reads the options from the command line, leaving the defaults
+ * for any not given.
+ *
+ * @param argc The number of arguments as int.
+ * @param argv The arguments as char**.
+ * @param options Receives the options as Options&.
+ *
+ * @return Returns true if the options were valid otherwise false as bool.
+ */
+bool parseOptions(int argc, char **argv, Options &options) {
+    for (int i = 1; i < argc; i++) {
+        const char *name = argv[i];
+        const char *value = (i + 1 < argc ? argv[i + 1] : nullptr);
+        bool isValid = true;
+        if (strcmp(name, "--bench") == 0) {
+            options.isBench = true;
+            continue;
+        } else if (strcmp(name, "--port") == 0) {
+            isValid = parseNumber(value, 1, 65535, options.port);
+        } else if (strcmp(name, "--http") == 0) {
+            isValid = parseNumber(value, 1, 65535, options.httpPort);
+        } else if (strcmp(name, "--threads") == 0) {
+            isValid = parseNumber(value, 1, COLLECTOR_MAX_THREADS, options.threads);
+        } else if (strcmp(name, "--history") == 0) {
+            isValid = parseNumber(value, 1, 1000000, options.historySize);
+        } else if (strcmp(name, "--max-devices") == 0) {
+            isValid = parseNumber(value, 1, 16777216, options.maxDevices);
+        } else if (strcmp(name, "--devices") == 0) {
+            isValid = parseNumber(value, 1, 0xFFFFF, options.benchDevices); // IDs given from 100000 up
+        } else if (strcmp(name, "--rounds") == 0) {
+            isValid = parseNumber(value, 1, 100000, options.benchRounds);
+        } else { // Not known...
+            fprintf(stderr, "Unknown option: %s\n", name);
+
+            return false;
+        }
+        if (!isValid) {
+            fprintf(stderr, "Bad value for %s\n", name);
+
+            return false;
+        }
+        i++; // Past the value
+    }
+
+    return true;
+}
+
+/**
+ * Used to parse a whole number within a range.
+ *
+ * @param text The number as const char*; nullptr if missing.
+ * @param low The lowest allowed as uint32_t.
+ * @param high The highest allowed as uint32_t.
+ * @param value Receives the number as uint32_t&.
+ *
+ * @return Returns true if valid otherwise false as bool.
+ */
+bool parseNumber(const char *text, uint32_t low, uint32_t high, uint32_t &value) {
+    if (text == nullptr || *text == '\0') { // Missing...
+
+        return false;
+    }
+    char *end;
+    unsigned long long number = strtoull(text, &end, 10);
+    if (*end != '\0' || number < low || number > high) { // Not a number or out of range...
+
+        return false;
+    }
+    value = (uint32_t) number;
+
+    return true;
+}
+
+void printUsage(const char *name) {
+    fprintf(
+        stderr,
+        "Usage:\n"
+        "  %s [--port %u] [--http %u] [--threads N] [--history %u] [--max-devices %u]\n"
+        "  %s --bench [--devices %u] [--rounds %u] [--threads N] [--history %u]\n",
+        name, COLLECTOR_DEFAULT_PORT, COLLECTOR_DEFAULT_HTTP, STORE_DEFAULT_HISTORY, STORE_DEFAULT_MAX_DEVICES,
+        name, BENCH_DEFAULT_DEVICES, BENCH_DEFAULT_ROUNDS, STORE_DEFAULT_HISTORY
+    );
+}
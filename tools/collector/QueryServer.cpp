@@ -0,0 +1,373 @@
+/*
+    QueryServer - A class used by the collector to answer queries about the
+    readings it holds over plain HTTP, in the form of JSON.
+
+    Written by: Scott Griffis
+    Date: 10-19-2026
+*/
+
+#include "QueryServer.h"
+#include <algorithm>
+#include <stdio.h>
+#include <stdarg.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <unistd.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <BroadcastPacket.h>
+
+/**
+ * #### CLASS CONSTRUCTOR ####
+ * Allows for external instantiation of
+ * the class into an object.
+ *
+ * @param stopFd An eventfd which is written to when it's time to stop as int.
+ * @param store Where the readings are held as SeriesStore&.
+ * @param receivers The receivers, for their counts, as std::vector<std::unique_ptr<Receiver>>&.
+*/
+QueryServer::QueryServer(int stopFd, SeriesStore& store, std::vector<std::unique_ptr<Receiver>>& receivers) : store(store), receivers(receivers) {
+    this->stopFd = stopFd;
+    this->startMillis = Receiver::nowMillis();
+}
+
+/**
+ * Starts listening on the given port and starts the thread which
+ * answers the requests.
+ *
+ * @param port The TCP port to listen on as uint16_t.
+ *
+ * @return Returns true if listening otherwise false as bool.
+*/
+bool QueryServer::start(uint16_t port) {
+    listenFd = socket(AF_INET, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (listenFd < 0) {
+        perror("socket");
+
+        return false;
+    }
+    int on = 1;
+    setsockopt(listenFd, SOL_SOCKET, SO_REUSEADDR, &on, sizeof(on));
+    sockaddr_in local;
+    memset(&local, 0, sizeof(local));
+    local.sin_family = AF_INET;
+    local.sin_addr.s_addr = htonl(INADDR_ANY);
+    local.sin_port = htons(port);
+    if (bind(listenFd, (sockaddr *) &local, sizeof(local)) != 0 || listen(listenFd, 16) != 0) {
+        perror("bind");
+        close(listenFd);
+        listenFd = -1;
+
+        return false;
+    }
+    worker = std::thread(&QueryServer::run, this);
+
+    return true;
+}
+
+/**
+ * Waits for the thread to finish, which it does once the stop
+ * eventfd is written to.
+*/
+void QueryServer::join() {
+    if (worker.joinable()) {
+        worker.join();
+    }
+    if (listenFd >= 0) {
+        close(listenFd);
+        listenFd = -1;
+    }
+}
+
+/*
+=================================================================
+Private Functions
+=================================================================
+*/
+
+/**
+ * #### PRIVATE ####
+ * The server thread. Waits for a connection or the stop eventfd,
+ * answering each connection in turn.
+*/
+void QueryServer::run() {
+    pollfd waiting[2] = {{listenFd, POLLIN, 0}, {stopFd, POLLIN, 0}};
+    while (true) {
+        if (poll(waiting, 2, -1) < 0 && errno != EINTR) { // Can't wait...
+            perror("poll");
+            break;
+        }
+        if ((waiting[1].revents & POLLIN) != 0) { // Time to go...
+            break;
+        }
+        if ((waiting[0].revents & POLLIN) != 0) { // Someone calling...
+            int clientFd = accept4(listenFd, nullptr, nullptr, SOCK_CLOEXEC);
+            if (clientFd >= 0) {
+                handle(clientFd);
+                close(clientFd);
+            }
+        }
+    }
+}
+
+/**
+ * #### PRIVATE ####
+ * Used to read a request from a client and send the answer. Only
+ * GET is understood.
+ *
+ * @param clientFd The connection as int.
+*/
+void QueryServer::handle(int clientFd) {
+    timeval timeout = {QUERY_TIMEOUT_SECS, 0};
+    setsockopt(clientFd, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+    setsockopt(clientFd, SOL_SOCKET, SO_SNDTIMEO, &timeout, sizeof(timeout));
+
+    /* Read Up To The End Of The Request Line */
+    char request[QUERY_REQUEST_SIZE];
+    size_t length = 0;
+    while (length < sizeof(request) - 1 && memchr(request, '\n', length) == nullptr) {
+        ssize_t got = recv(clientFd, &request[length], sizeof(request) - 1 - length, 0);
+        if (got <= 0) { // Gone or too slow...
+
+            return;
+        }
+        length += got;
+    }
+    request[length] = '\0';
+
+    int code = 200;
+    std::string body;
+    std::string target;
+    char *lineEnd = strpbrk(request, "\r\n");
+    if (lineEnd != nullptr) {
+        *lineEnd = '\0';
+    }
+    char *space = strchr(request, ' ');
+    if (strncmp(request, "GET ", 4) != 0 || space == nullptr) { // Only reads are answered...
+        code = 405;
+        body = "{\"error\": \"method not allowed\"}";
+    } else {
+        char *targetEnd = strchr(space + 1, ' ');
+        target.assign(space + 1, (targetEnd != nullptr ? targetEnd - space - 1 : strlen(space + 1)));
+    }
+
+    if (code == 200) {
+        size_t queryAt = target.find('?');
+        std::string path = target.substr(0, queryAt);
+        std::string query = (queryAt != std::string::npos ? target.substr(queryAt + 1) : "");
+        if (path == "/api/devices") {
+            writeDevices(body);
+        } else if (path == "/api/readings") {
+            if (!writeReadings(query, body)) { // Bad or unknown ID...
+                code = 404;
+                body = "{\"error\": \"unknown device\"}";
+            }
+        } else if (path == "/api/stats") {
+            writeStats(body);
+        } else { // Nothing here...
+            code = 404;
+            body = "{\"error\": \"not found\"}";
+        }
+    }
+
+    std::string response;
+    appendf(
+        response,
+        "HTTP/1.1 %d %s\r\nContent-Type: application/json\r\nContent-Length: %zu\r\nCache-Control: no-store\r\nConnection: close\r\n\r\n",
+        code, (code == 200 ? "OK" : (code == 404 ? "Not Found" : "Method Not Allowed")), body.size()
+    );
+    response.append(body);
+    size_t sent = 0;
+    while (sent < response.size()) {
+        ssize_t wrote = send(clientFd, response.data() + sent, response.size() - sent, MSG_NOSIGNAL);
+        if (wrote <= 0) { // Gone or too slow...
+            break;
+        }
+        sent += wrote;
+    }
+}
+
+/**
+ * #### PRIVATE ####
+ * Used to write the latest reading of every device, ordered by
+ * Device ID.
+ *
+ * @param body Receives the JSON as std::string&.
+*/
+void QueryServer::writeDevices(std::string& body) {
+    std::vector<DeviceSummary> summaries;
+    store.listDevices(summaries);
+    std::sort(summaries.begin(), summaries.end(), [](const DeviceSummary &a, const DeviceSummary &b) { return a.id < b.id; });
+    int64_t now = Receiver::nowMillis();
+
+    body.reserve(64 + (summaries.size() * 256));
+    appendf(body, "{\"devices\": %zu, \"readings\": [", summaries.size());
+    for (size_t i = 0; i < summaries.size(); i++) {
+        if (i > 0) {
+            body.append(", ");
+        }
+        writeSummary(summaries[i], now, body);
+    }
+    body.append("]}");
+}
+
+/**
+ * #### PRIVATE ####
+ * Used to write the history of the device named in the query.
+ *
+ * @param query The query part of the URL as const std::string&.
+ * @param body Receives the JSON as std::string&.
+ *
+ * @return Returns true if the device is known otherwise false as bool.
+*/
+bool QueryServer::writeReadings(const std::string& query, std::string& body) {
+    std::string value;
+    uint32_t id = 0;
+    if (!getParam(query, "id", value) || !BroadcastPacket::parseDeviceId(value.data(), value.size(), id)) { // No valid ID...
+
+        return false;
+    }
+    int64_t fromMillis = (getParam(query, "from", value) ? strtoll(value.c_str(), nullptr, 10) : INT64_MIN);
+    int64_t toMillis = (getParam(query, "to", value) ? strtoll(value.c_str(), nullptr, 10) : INT64_MAX);
+    size_t limit = (getParam(query, "limit", value) ? strtoull(value.c_str(), nullptr, 10) : 0);
+
+    DeviceSummary summary;
+    std::vector<Sample> samples;
+    if (!store.getSamples(id, fromMillis, toMillis, limit, summary, samples)) { // Never heard from...
+
+        return false;
+    }
+    body.reserve(320 + (samples.size() * 96));
+    body.append("{\"device\": ");
+    writeSummary(summary, Receiver::nowMillis(), body);
+    appendf(body, ", \"count\": %zu, \"samples\": [", samples.size());
+    for (size_t i = 0; i < samples.size(); i++) {
+        const Sample &sample = samples[i];
+        appendf(
+            body, "%s{\"timestamp\": %lld, \"sequence\": %u, \"temperature\": %.2f, \"humidity\": %.2f}",
+            (i > 0 ? ", " : ""), (long long) sample.timestamp, sample.sequence,
+            sample.centiCelsius / 100.0, sample.centiHumidity / 100.0
+        );
+    }
+    body.append("]}");
+
+    return true;
+}
+
+/**
+ * #### PRIVATE ####
+ * Used to write the counts kept by the receivers, in total and for
+ * each of them.
+ *
+ * @param body Receives the JSON as std::string&.
+*/
+void QueryServer::writeStats(std::string& body) {
+    IngestCounts total;
+    memset(&total, 0, sizeof(total));
+    uint32_t kernelDrops = 0;
+    std::string workers;
+    for (size_t i = 0; i < receivers.size(); i++) {
+        IngestCounts counts;
+        receivers[i]->getCounts(counts);
+        SeriesStore::addCounts(total, counts);
+        if (receivers[i]->getKernelDrops() > kernelDrops) { // Counted by the socket; Latest is the highest...
+            kernelDrops = receivers[i]->getKernelDrops();
+        }
+        appendf(
+            workers, "%s{\"packets\": %llu, \"batches\": %llu}",
+            (i > 0 ? ", " : ""), (unsigned long long) counts.packets, (unsigned long long) receivers[i]->getBatchCount()
+        );
+    }
+    appendf(
+        body,
+        "{\"uptime_s\": %lld, \"devices\": %u, \"history\": %u, \"packets\": %llu, \"rejected\": %llu, \"readings\": %llu, "
+        "\"stored\": %llu, \"repeats\": %llu, \"overflowed\": %llu, \"kernel_drops\": %u, \"workers\": [%s]}",
+        (long long) ((Receiver::nowMillis() - startMillis) / 1000), store.getDeviceCount(), store.getHistorySize(),
+        (unsigned long long) total.packets, (unsigned long long) total.rejected, (unsigned long long) total.readings,
+        (unsigned long long) total.stored, (unsigned long long) total.repeats, (unsigned long long) total.overflowed,
+        kernelDrops, workers.c_str()
+    );
+}
+
+/**
+ * #### PRIVATE ####
+ * Used to write a device's summary; Named as /api/fleet of a hub names
+ * the same things.
+ *
+ * @param summary The summary as const DeviceSummary&.
+ * @param nowMillis The current time in millis since the Unix epoch as int64_t.
+ * @param body Receives the JSON as std::string&.
+*/
+void QueryServer::writeSummary(const DeviceSummary& summary, int64_t nowMillis, std::string& body) {
+    appendf(
+        body,
+        "{\"id\": \"%06X\", \"ip\": \"%u.%u.%u.%u\", \"temperature\": %.2f, \"humidity\": %.2f, \"timestamp\": %lld, \"sequence\": %u, "
+        "\"age_s\": %lld, \"heard\": %llu, \"missed\": %llu, \"restarts\": %u, \"samples\": %u}",
+        summary.id, (summary.ip >> 24) & 0xFF, (summary.ip >> 16) & 0xFF, (summary.ip >> 8) & 0xFF, summary.ip & 0xFF,
+        summary.latest.centiCelsius / 100.0, summary.latest.centiHumidity / 100.0, (long long) summary.latest.timestamp,
+        summary.latest.sequence, (long long) ((nowMillis - summary.lastSeen) / 1000), (unsigned long long) summary.heard,
+        (unsigned long long) summary.missed, summary.restarts, summary.sampleCount
+    );
+}
+
+/**
+ * #### PRIVATE ####
+ * Used to get the value of a parameter from the query part of a URL.
+ * Values are taken as they are; None of those used need decoding.
+ *
+ * @param query The query as const std::string&.
+ * @param name The name of the parameter as const char*.
+ * @param value Receives the value as std::string&.
+ *
+ * @return Returns true if the parameter was given otherwise false as bool.
+*/
+bool QueryServer::getParam(const std::string& query, const char* name, std::string& value) {
+    size_t nameLength = strlen(name);
+    size_t at = 0;
+    while (at < query.size()) {
+        size_t next = query.find('&', at);
+        if (next == std::string::npos) {
+            next = query.size();
+        }
+        if (next - at > nameLength && query.compare(at, nameLength, name) == 0 && query[at + nameLength] == '=') { // Found...
+            value = query.substr(at + nameLength + 1, next - at - nameLength - 1);
+
+            return true;
+        }
+        at = next + 1;
+    }
+
+    return false;
+}
+
+/**
+ * #### PRIVATE ####
+ * Used to append formatted text to a string.
+ *
+ * @param text The string appended to as std::string&.
+ * @param format The printf() style format as const char*.
+*/
+void QueryServer::appendf(std::string& text, const char* format, ...) {
+    char buffer[512];
+    va_list args;
+    va_start(args, format);
+    int length = vsnprintf(buffer, sizeof(buffer), format, args);
+    va_end(args);
+    if (length < 0) { // Bad format...
+
+        return;
+    }
+    if ((size_t) length < sizeof(buffer)) { // Fit...
+        text.append(buffer, length);
+
+        return;
+    }
+    size_t at = text.size();
+    text.resize(at + length + 1);
+    va_start(args, format);
+    vsnprintf(&text[at], length + 1, format, args);
+    va_end(args);
+    text.resize(at + length);
+}
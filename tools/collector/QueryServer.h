@@ -0,0 +1,59 @@
+/*
+    QueryServer - A class used by the collector to answer queries about the
+    readings it holds over plain HTTP, in the form of JSON.
+
+    The server runs on its own thread and handles one request at a time,
+    closing the connection after each; Queries are few next to the packets
+    coming in, so it is kept simple and off the receivers' path. The
+    endpoints are:
+
+        /api/devices                    The latest reading of every device
+        /api/readings?id=A4C372         The history of a device; Also takes
+                                        from and to (millis since the Unix
+                                        epoch) and limit (newest that many)
+        /api/stats                      Counts kept by the receivers
+
+    Written by: Scott Griffis
+    Date: 10-19-2026
+*/
+
+#ifndef QueryServer_h
+    #define QueryServer_h
+
+    #include <stdint.h>
+    #include <string>
+    #include <thread>
+    #include <vector>
+    #include <memory>
+    #include "SeriesStore.h"
+    #include "Receiver.h"
+
+    #define QUERY_REQUEST_SIZE 2048 // Longer requests are refused
+    #define QUERY_TIMEOUT_SECS 2 // Time a client gets to send its request
+
+    class QueryServer {
+        private:
+            int            listenFd         = -1;
+            int            stopFd           ; // eventfd written to stop; Not owned
+            SeriesStore&   store            ;
+            std::vector<std::unique_ptr<Receiver>>& receivers;
+            std::thread    worker           ;
+            int64_t        startMillis      ;
+
+            void           run               ()                       ;
+            void           handle            (int clientFd)           ;
+            void           writeDevices      (std::string& body)      ;
+            bool           writeReadings     (const std::string& query, std::string& body);
+            void           writeStats        (std::string& body)      ;
+            static void    writeSummary      (const DeviceSummary& summary, int64_t nowMillis, std::string& body);
+            static bool    getParam          (const std::string& query, const char* name, std::string& value);
+            static void    appendf           (std::string& text, const char* format, ...);
+
+        public:
+            QueryServer(int stopFd, SeriesStore& store, std::vector<std::unique_ptr<Receiver>>& receivers);
+
+            bool           start             (uint16_t port)          ;
+            void           join              ()                       ;
+    };
+
+#endif
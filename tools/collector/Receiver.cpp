@@ -0,0 +1,239 @@
+/*
+    Receiver - A class used by the collector to take packets off the
+    broadcast port and hand them to the series store.
+
+    Written by: Scott Griffis
+    Date: 10-19-2026
+*/
+
+#include "Receiver.h"
+#include <stdio.h>
+#include <string.h>
+#include <errno.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/epoll.h>
+#include <netinet/in.h>
+
+static_assert(sizeof(IngestCounts) == 6 * sizeof(uint64_t), "Receiver publishes IngestCounts field by field");
+
+/**
+ * #### CLASS CONSTRUCTOR ####
+ * Allows for external instantiation of
+ * the class into an object.
+ *
+ * @param socketFd The socket bound to the broadcast port as int.
+ * @param stopFd An eventfd which is written to when it's time to stop as int.
+ * @param store Where the readings go as SeriesStore&.
+*/
+Receiver::Receiver(int socketFd, int stopFd, SeriesStore& store) : store(store) {
+    this->socketFd = socketFd;
+    this->stopFd = stopFd;
+    for (std::atomic<uint64_t> &count : published) {
+        count.store(0, std::memory_order_relaxed);
+    }
+}
+
+/**
+ * Starts the worker thread.
+*/
+void Receiver::start() {
+    worker = std::thread(&Receiver::run, this);
+}
+
+/**
+ * Waits for the worker thread to finish, which it does once the
+ * stop eventfd is written to.
+*/
+void Receiver::join() {
+    if (worker.joinable()) {
+        worker.join();
+    }
+}
+
+/**
+ * Used to get the counts of the packets this receiver has handled,
+ * as of its last batch.
+ *
+ * @param counts Receives the counts as IngestCounts&.
+*/
+void Receiver::getCounts(IngestCounts& counts) {
+    uint64_t *fields = (uint64_t *) &counts;
+    for (size_t i = 0; i < 6; i++) {
+        fields[i] = published[i].load(std::memory_order_relaxed);
+    }
+}
+
+uint64_t Receiver::getBatchCount() {
+
+    return batchCount.load(std::memory_order_relaxed);
+}
+
+uint32_t Receiver::getKernelDrops() {
+
+    return kernelDrops.load(std::memory_order_relaxed);
+}
+
+/**
+ * Used to open the socket the receivers share, bound to the given
+ * address and port with a large receive buffer and drop counting.
+ *
+ * @param address The address to bind to, in host byte order, as uint32_t.
+ * @param port The port to bind to, 0 for any, as uint16_t.
+ *
+ * @return Returns the socket, -1 if it couldn't be opened, as int.
+*/
+int Receiver::openSocket(uint32_t address, uint16_t port) {
+    int fd = socket(AF_INET, SOCK_DGRAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (fd < 0) {
+        perror("socket");
+
+        return -1;
+    }
+    int on = 1;
+    int size = RECEIVER_SOCKET_BUFFER;
+    setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &on, sizeof(on));
+    setsockopt(fd, SOL_SOCKET, SO_RXQ_OVFL, &on, sizeof(on));
+    if (setsockopt(fd, SOL_SOCKET, SO_RCVBUFFORCE, &size, sizeof(size)) != 0) { // Not privileged; Capped by net.core.rmem_max...
+        setsockopt(fd, SOL_SOCKET, SO_RCVBUF, &size, sizeof(size));
+    }
+
+    sockaddr_in local;
+    memset(&local, 0, sizeof(local));
+    local.sin_family = AF_INET;
+    local.sin_addr.s_addr = htonl(address);
+    local.sin_port = htons(port);
+    if (bind(fd, (sockaddr *) &local, sizeof(local)) != 0) {
+        perror("bind");
+        close(fd);
+
+        return -1;
+    }
+
+    return fd;
+}
+
+/**
+ * Used to get the wall clock time, which readings from sensors that
+ * don't know the time are stored under.
+ *
+ * @return Returns the time in millis since the Unix epoch as int64_t.
+*/
+int64_t Receiver::nowMillis() {
+    timespec now;
+    clock_gettime(CLOCK_REALTIME_COARSE, &now);
+
+    return ((int64_t) now.tv_sec * 1000) + (now.tv_nsec / 1000000);
+}
+
+/*
+=================================================================
+Private Functions
+=================================================================
+*/
+
+/**
+ * #### PRIVATE ####
+ * The worker thread. Waits for packets, then takes them in batches
+ * until the socket is empty, handing each to the store. Everything
+ * the loop needs is set aside before it starts.
+*/
+void Receiver::run() {
+    int epollFd = epoll_create1(EPOLL_CLOEXEC);
+    if (epollFd < 0) {
+        perror("epoll_create1");
+
+        return;
+    }
+    epoll_event event;
+    memset(&event, 0, sizeof(event));
+    event.events = EPOLLIN | EPOLLEXCLUSIVE; // One receiver woken per packet
+    event.data.fd = socketFd;
+    epoll_ctl(epollFd, EPOLL_CTL_ADD, socketFd, &event);
+    event.events = EPOLLIN; // All woken to stop
+    event.data.fd = stopFd;
+    epoll_ctl(epollFd, EPOLL_CTL_ADD, stopFd, &event);
+
+    /* Buffers For A Whole Batch */
+    static thread_local char packets[RECEIVER_BATCH][RECEIVER_PACKET_SIZE];
+    static thread_local char controls[RECEIVER_BATCH][CMSG_SPACE(sizeof(uint32_t))];
+    sockaddr_in senders[RECEIVER_BATCH];
+    iovec vectors[RECEIVER_BATCH];
+    mmsghdr messages[RECEIVER_BATCH];
+    for (size_t i = 0; i < RECEIVER_BATCH; i++) {
+        vectors[i].iov_base = packets[i];
+        vectors[i].iov_len = RECEIVER_PACKET_SIZE;
+    }
+
+    IngestCounts counts;
+    memset(&counts, 0, sizeof(counts));
+    bool isRunning = true;
+    while (isRunning) {
+        epoll_event ready[2];
+        int readyCount = epoll_wait(epollFd, ready, 2, -1);
+        if (readyCount < 0 && errno != EINTR) { // Can't wait...
+            perror("epoll_wait");
+            break;
+        }
+        for (int r = 0; r < readyCount; r++) {
+            if (ready[r].data.fd == stopFd) { // Time to go; Left for the others to see too...
+                isRunning = false;
+            }
+        }
+
+        /* Drain The Socket */
+        while (isRunning) {
+            for (size_t i = 0; i < RECEIVER_BATCH; i++) {
+                memset(&messages[i].msg_hdr, 0, sizeof(msghdr));
+                messages[i].msg_hdr.msg_name = &senders[i];
+                messages[i].msg_hdr.msg_namelen = sizeof(sockaddr_in);
+                messages[i].msg_hdr.msg_iov = &vectors[i];
+                messages[i].msg_hdr.msg_iovlen = 1;
+                messages[i].msg_hdr.msg_control = controls[i];
+                messages[i].msg_hdr.msg_controllen = sizeof(controls[i]);
+            }
+            int received = recvmmsg(socketFd, messages, RECEIVER_BATCH, MSG_DONTWAIT, nullptr);
+            if (received <= 0) { // Empty, or another receiver got there first...
+                break;
+            }
+            int64_t now = nowMillis();
+            for (int i = 0; i < received; i++) {
+                msghdr &header = messages[i].msg_hdr;
+                if ((header.msg_flags & MSG_TRUNC) != 0) { // Too long to be ours...
+                    counts.packets++;
+                    counts.rejected++;
+                    continue;
+                }
+                store.ingest(packets[i], messages[i].msg_len, ntohl(senders[i].sin_addr.s_addr), now, counts);
+                for (cmsghdr *control = CMSG_FIRSTHDR(&header); control != nullptr; control = CMSG_NXTHDR(&header, control)) {
+                    if (control->cmsg_level == SOL_SOCKET && control->cmsg_type == SO_RXQ_OVFL) {
+                        uint32_t drops;
+                        memcpy(&drops, CMSG_DATA(control), sizeof(drops));
+                        kernelDrops.store(drops, std::memory_order_relaxed);
+                    }
+                }
+            }
+            batchCount.fetch_add(1, std::memory_order_relaxed);
+            publish(counts);
+            if (received < RECEIVER_BATCH) { // Socket is empty...
+                break;
+            }
+        }
+    }
+    close(epollFd);
+}
+
+/**
+ * #### PRIVATE ####
+ * Used to make the counts kept by the worker thread readable by
+ * others. Done once a batch rather than once a packet.
+ *
+ * @param counts The counts as const IngestCounts&.
+*/
+void Receiver::publish(const IngestCounts& counts) {
+    const uint64_t *fields = (const uint64_t *) &counts;
+    for (size_t i = 0; i < 6; i++) {
+        published[i].store(fields[i], std::memory_order_relaxed);
+    }
+}
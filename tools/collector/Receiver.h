@@ -0,0 +1,61 @@
+/*
+    Receiver - A class used by the collector to take packets off the
+    broadcast port and hand them to the series store, one worker thread
+    per receiver.
+
+    Every receiver reads from the same socket. Broadcasts are handed to
+    each socket bound to the port, so one socket per thread with
+    SO_REUSEPORT would have each thread see every packet; Sharing the one
+    socket has each packet read by exactly one thread. Each thread waits
+    on its own epoll, with the socket added as EPOLLEXCLUSIVE so a packet
+    wakes only one of them, then drains the socket RECEIVER_BATCH packets
+    at a time with recvmmsg() into buffers set aside when it started. A
+    batch costs one system call however many packets are waiting.
+
+    Packets the kernel dropped because the socket's buffer was full are
+    counted through SO_RXQ_OVFL.
+
+    Written by: Scott Griffis
+    Date: 10-19-2026
+*/
+
+#ifndef Receiver_h
+    #define Receiver_h
+
+    #include <stdint.h>
+    #include <atomic>
+    #include <thread>
+    #include "SeriesStore.h"
+
+    #define RECEIVER_BATCH 64 // Packets taken per recvmmsg()
+    #define RECEIVER_PACKET_SIZE 1024 // Longer packets are rejected; A full backlog packet is under 700 bytes
+    #define RECEIVER_SOCKET_BUFFER (8 * 1024 * 1024) // Holds a burst of about 60k packets
+
+    class Receiver {
+        private:
+            int            socketFd         ; // Shared by all receivers; Not owned
+            int            stopFd           ; // eventfd written to stop; Not owned
+            SeriesStore&   store            ;
+            std::thread    worker           ;
+            std::atomic<uint64_t> published  [6]; // IngestCounts published after each batch
+            std::atomic<uint64_t> batchCount {0};
+            std::atomic<uint32_t> kernelDrops{0}; // Last SO_RXQ_OVFL seen
+
+            void           run               ()                       ;
+            void           publish           (const IngestCounts& counts);
+
+        public:
+            Receiver(int socketFd, int stopFd, SeriesStore& store);
+
+            void           start             ()                       ;
+            void           join              ()                       ;
+
+            void           getCounts         (IngestCounts& counts)   ;
+            uint64_t       getBatchCount     ()                       ;
+            uint32_t       getKernelDrops    ()                       ;
+
+            static int     openSocket        (uint32_t address, uint16_t port);
+            static int64_t nowMillis         ()                       ;
+    };
+
+#endif
@@ -0,0 +1,322 @@
+/*
+    SeriesStore - A class used by the collector to keep the readings of every
+    TempBuddy heard, as a short time series per device held in memory.
+
+    Written by: Scott Griffis
+    Date: 10-19-2026
+*/
+
+#include "SeriesStore.h"
+#include <math.h>
+#include <string.h>
+#include <BroadcastPacket.h>
+
+/**
+ * #### CLASS CONSTRUCTOR ####
+ * Allows for external instantiation of
+ * the class into an object.
+ *
+ * @param historySize The most samples kept per device as uint32_t.
+ * @param maxDevices The most devices kept as uint32_t.
+*/
+SeriesStore::SeriesStore(uint32_t historySize, uint32_t maxDevices) {
+    this->historySize = (historySize > 0 ? historySize : 1);
+    this->maxDevices = maxDevices;
+}
+
+/**
+ * Takes in a packet received on the broadcast port, storing the
+ * readings in it under the device that sent it. The packet is
+ * parsed where it lies; Only a device heard from for the first
+ * time causes an allocation.
+ *
+ * @param data The packet as const char*; Need not be null terminated.
+ * @param length The length of the packet as size_t.
+ * @param ip The address the packet came from, in host byte order, as uint32_t.
+ * @param nowMillis The time received in millis since the Unix epoch as int64_t.
+ * @param counts The counts of the calling receiver as IngestCounts&.
+ *
+ * @return Returns true if the packet was understood otherwise false as bool.
+*/
+bool SeriesStore::ingest(const char* data, size_t length, uint32_t ip, int64_t nowMillis, IngestCounts& counts) {
+    BroadcastPacket packet;
+    QueuedReading reading;
+    counts.packets++;
+
+    /* The first reading is parsed before locking as a live broadcast has no other */
+    if (!packet.begin(data, length) || !packet.nextReading(reading)) { // Not ours, malformed or empty...
+        counts.rejected++;
+
+        return false;
+    }
+    Shard &shard = shardOf(packet.getDeviceId());
+    std::lock_guard<std::mutex> guard(shard.lock);
+    Device *device = find(shard, packet.getDeviceId(), ip);
+    if (device == nullptr) { // New and no room left...
+        counts.overflowed++;
+
+        return false;
+    }
+    do {
+        counts.readings++;
+        apply(*device, reading, packet.getIsLive(), nowMillis, counts);
+    } while (packet.nextReading(reading));
+
+    return true;
+}
+
+uint32_t SeriesStore::getDeviceCount() {
+
+    return deviceCount.load(std::memory_order_relaxed);
+}
+
+uint32_t SeriesStore::getHistorySize() {
+
+    return historySize;
+}
+
+/**
+ * Used to get the summary of every device held. Each shard is
+ * locked in turn, so the list is only consistent shard by shard.
+ *
+ * @param summaries Receives the summaries as std::vector<DeviceSummary>&.
+*/
+void SeriesStore::listDevices(std::vector<DeviceSummary>& summaries) {
+    summaries.clear();
+    summaries.reserve(getDeviceCount());
+    for (Shard &shard : shards) {
+        std::lock_guard<std::mutex> guard(shard.lock);
+        for (const auto &entry : shard.devices) {
+            summaries.push_back(entry.second.summary);
+        }
+    }
+}
+
+/**
+ * Used to get the samples of a device taken within a span of time,
+ * oldest first. With a limit only the newest that many are given.
+ *
+ * @param id The device ID as uint32_t.
+ * @param fromMillis The earliest time wanted, in millis since the Unix epoch, as int64_t.
+ * @param toMillis The latest time wanted, in millis since the Unix epoch, as int64_t.
+ * @param limit The most samples wanted, 0 for all, as size_t.
+ * @param summary Receives the summary of the device as DeviceSummary&.
+ * @param samples Receives the samples as std::vector<Sample>&.
+ *
+ * @return Returns true if the device is known otherwise false as bool.
+*/
+bool SeriesStore::getSamples(uint32_t id, int64_t fromMillis, int64_t toMillis, size_t limit, DeviceSummary& summary, std::vector<Sample>& samples) {
+    samples.clear();
+    Shard &shard = shardOf(id);
+    std::lock_guard<std::mutex> guard(shard.lock);
+    auto entry = shard.devices.find(id);
+    if (entry == shard.devices.end()) { // Never heard from...
+
+        return false;
+    }
+    const Device &device = entry->second;
+    summary = device.summary;
+    for (uint32_t i = 0; i < device.summary.sampleCount; i++) {
+        const Sample &sample = getSample(device, i);
+        if (sample.timestamp >= fromMillis && sample.timestamp <= toMillis) {
+            samples.push_back(sample);
+        }
+    }
+    if (limit > 0 && samples.size() > limit) { // Keep the newest...
+        samples.erase(samples.begin(), samples.end() - limit);
+    }
+
+    return true;
+}
+
+/**
+ * Used to add the counts of one receiver to a total.
+ *
+ * @param total The total added to as IngestCounts&.
+ * @param counts The counts to add as const IngestCounts&.
+*/
+void SeriesStore::addCounts(IngestCounts& total, const IngestCounts& counts) {
+    total.packets += counts.packets;
+    total.rejected += counts.rejected;
+    total.readings += counts.readings;
+    total.stored += counts.stored;
+    total.repeats += counts.repeats;
+    total.overflowed += counts.overflowed;
+}
+
+/*
+=================================================================
+Private Functions
+=================================================================
+*/
+
+/**
+ * #### PRIVATE ####
+ * Used to find a device, making it if it's new and there is room.
+ * Must be called with the shard locked.
+ *
+ * @param shard The shard the device belongs to as Shard&.
+ * @param id The device ID as uint32_t.
+ * @param ip The address the device was heard from as uint32_t.
+ *
+ * @return Returns the device, nullptr if new and no room, as Device*.
+*/
+SeriesStore::Device* SeriesStore::find(Shard& shard, uint32_t id, uint32_t ip) {
+    auto entry = shard.devices.find(id);
+    if (entry != shard.devices.end()) { // Known...
+        entry->second.summary.ip = ip;
+
+        return &entry->second;
+    }
+    if (deviceCount.fetch_add(1, std::memory_order_relaxed) >= maxDevices) { // No room; Give back the place taken...
+        deviceCount.fetch_sub(1, std::memory_order_relaxed);
+
+        return nullptr;
+    }
+    Device &device = shard.devices[id];
+    memset(&device.summary, 0, sizeof(DeviceSummary));
+    device.summary.id = id;
+    device.summary.ip = ip;
+    device.samples.reset(new Sample[historySize]);
+    device.head = 0;
+
+    return &device;
+}
+
+/**
+ * #### PRIVATE ####
+ * Used to apply a reading to a device. A newer reading is stored and
+ * becomes the latest; A live reading older than the latest means the
+ * device restarted, while an older backlog reading is one that was
+ * counted as missed turning up late. Readings without a sequence
+ * number, from older firmware, are told apart by their timestamp.
+ *
+ * @param device The device as Device&.
+ * @param reading The reading as const QueuedReading&.
+ * @param isLive True if from a live broadcast as bool.
+ * @param nowMillis The time received in millis since the Unix epoch as int64_t.
+ * @param counts The counts of the calling receiver as IngestCounts&.
+*/
+void SeriesStore::apply(Device& device, const QueuedReading& reading, bool isLive, int64_t nowMillis, IngestCounts& counts) {
+    DeviceSummary &summary = device.summary;
+    Sample sample = {
+        (reading.timestamp != 0ull ? (int64_t) reading.timestamp : nowMillis),
+        reading.sequence,
+        (int16_t) lroundf(reading.temperature * 100.0f),
+        (uint16_t) lroundf(reading.humidity * 100.0f)
+    };
+    bool isFirst = (summary.sampleCount == 0);
+    bool isLatest = false;
+    bool isRepeat = false;
+    summary.heard++;
+    summary.lastSeen = nowMillis;
+
+    if (isFirst) { // Nothing to compare with...
+        isLatest = true;
+    } else if (sample.sequence == 0 || summary.latest.sequence == 0) { // Only the timestamp to go by...
+        isRepeat = (reading.timestamp != 0ull && sample.timestamp == summary.latest.timestamp);
+        isLatest = (!isRepeat && sample.timestamp >= summary.latest.timestamp);
+    } else if (sample.sequence == summary.latest.sequence) { // Rebroadcast...
+        isRepeat = true;
+    } else if (sample.sequence > summary.latest.sequence) { // Newer...
+        uint32_t skipped = sample.sequence - summary.latest.sequence - 1;
+        if (isLive) { // Some never arrived; Yet...
+            summary.missed += skipped;
+        }
+        isLatest = true;
+    } else if (isLive) { // Older and live; Device restarted...
+        summary.restarts++;
+        isLatest = true;
+    } else if (isHeld(device, sample.sequence)) { // Older and already held...
+        isRepeat = true;
+    } else if (summary.missed > 0) { // Older; Late arrival...
+        summary.missed--;
+    }
+
+    if (isRepeat) {
+        counts.repeats++;
+
+        return;
+    }
+    if (isLatest) {
+        summary.latest = sample;
+    }
+    insert(device, sample);
+    counts.stored++;
+}
+
+/**
+ * #### PRIVATE ####
+ * Used to add a sample to the history of a device in time order. When
+ * the history is full the oldest sample makes room, unless the new one
+ * is older still, in which case it isn't kept.
+ *
+ * @param device The device as Device&.
+ * @param sample The sample as const Sample&.
+*/
+void SeriesStore::insert(Device& device, const Sample& sample) {
+    uint32_t &count = device.summary.sampleCount;
+    if (count == historySize) { // Full...
+        if (sample.timestamp < getSample(device, 0).timestamp) { // Older than all held...
+
+            return;
+        }
+        device.head = (device.head + 1) % historySize;
+        count--;
+    }
+    uint32_t position = count;
+    while (position > 0 && getSample(device, position - 1).timestamp > sample.timestamp) { // Make way; Only late arrivals go back...
+        device.samples[(device.head + position) % historySize] = getSample(device, position - 1);
+        position--;
+    }
+    device.samples[(device.head + position) % historySize] = sample;
+    count++;
+}
+
+/**
+ * #### PRIVATE ####
+ * Used to tell if a sample with the given sequence number is held.
+ *
+ * @param device The device as const Device&.
+ * @param sequence The sequence number as uint32_t.
+ *
+ * @return Returns true if held otherwise false as bool.
+*/
+bool SeriesStore::isHeld(const Device& device, uint32_t sequence) {
+    for (uint32_t i = 0; i < device.summary.sampleCount; i++) {
+        if (getSample(device, i).sequence == sequence) {
+
+            return true;
+        }
+    }
+
+    return false;
+}
+
+/**
+ * #### PRIVATE ####
+ * Used to get a sample from the history of a device, 0 being the oldest.
+ *
+ * @param device The device as const Device&.
+ * @param index The position in the history as uint32_t.
+ *
+ * @return Returns the sample as const Sample&.
+*/
+const Sample& SeriesStore::getSample(const Device& device, uint32_t index) {
+
+    return device.samples[(device.head + index) % historySize];
+}
+
+/**
+ * #### PRIVATE ####
+ * Used to get the shard a device belongs to. Device IDs come from the
+ * end of the MAC Address, so they are mixed before taking the top bits.
+ *
+ * @param id The device ID as uint32_t.
+ *
+ * @return Returns the shard as Shard&.
+*/
+SeriesStore::Shard& SeriesStore::shardOf(uint32_t id) {
+
+    return shards[((id * 2654435761u) >> 16) & (STORE_SHARD_COUNT - 1)];
+}
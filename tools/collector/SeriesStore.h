@@ -0,0 +1,110 @@
+/*
+    SeriesStore - A class used by the collector to keep the readings of every
+    TempBuddy heard, as a short time series per device held in memory.
+
+    Devices are spread over STORE_SHARD_COUNT shards by their Device ID, each
+    with its own lock, so the receiver threads only get in each other's way
+    when two packets from devices of the same shard land at the same time.
+    A device's history is a ring of samples set aside when it is first heard
+    from, so taking in a reading from a known device allocates nothing. The
+    number of devices is capped, which caps the memory used along with it.
+
+    Samples are kept in time order. Repeats of the latest reading, as sent
+    by the 10 second rebroadcast, are counted but not stored again, and gaps
+    in the sequence numbers are counted as missed until the readings turn up
+    in a backlog packet.
+
+    Written by: Scott Griffis
+    Date: 10-19-2026
+*/
+
+#ifndef SeriesStore_h
+    #define SeriesStore_h
+
+    #include <stdint.h>
+    #include <stddef.h>
+    #include <memory>
+    #include <mutex>
+    #include <atomic>
+    #include <vector>
+    #include <unordered_map>
+    #include <ReadingQueue.h>
+
+    #define STORE_SHARD_COUNT 64 // Must be a power of two
+    #define STORE_DEFAULT_HISTORY 240 // Two hours at one reading every 30 seconds
+    #define STORE_DEFAULT_MAX_DEVICES 65536
+
+    // *****************************************************************************
+    // A single reading as stored; Temperature and humidity are in hundredths
+    // *****************************************************************************
+    struct Sample {
+        int64_t        timestamp        ; // Millis since the Unix epoch; Time received if the sensor didn't know
+        uint32_t       sequence         ; // 0 if the sensor doesn't send them
+        int16_t        centiCelsius     ;
+        uint16_t       centiHumidity    ;
+    };
+
+    // *****************************************************************************
+    // Everything known about a device apart from its history
+    // *****************************************************************************
+    struct DeviceSummary {
+        uint32_t       id               ; // Device ID as a number; Six hex digits
+        uint32_t       ip               ; // Host byte order
+        int64_t        lastSeen         ; // Millis since the Unix epoch
+        Sample         latest           ;
+        uint64_t       heard            ; // Readings heard, repeats included
+        uint64_t       missed           ; // Readings skipped over and not yet turned up
+        uint32_t       restarts         ; // Times the sequence went backwards
+        uint32_t       sampleCount      ; // Samples held
+    };
+
+    // *****************************************************************************
+    // Counts kept by each receiver for the packets it handed to the store
+    // *****************************************************************************
+    struct IngestCounts {
+        uint64_t       packets          ;
+        uint64_t       rejected         ; // Not a TempBuddy packet or malformed
+        uint64_t       readings         ; // Readings found in the packets
+        uint64_t       stored           ; // Readings that became samples
+        uint64_t       repeats          ; // Readings already held
+        uint64_t       overflowed       ; // From new devices turned away at the cap
+    };
+
+    class SeriesStore {
+        private:
+            struct Device {
+                DeviceSummary  summary          ;
+                std::unique_ptr<Sample[]> samples; // Ring of historySize
+                uint32_t       head             ; // Oldest
+            };
+            struct alignas(64) Shard {
+                std::mutex     lock             ;
+                std::unordered_map<uint32_t, Device> devices;
+            };
+
+            Shard          shards           [STORE_SHARD_COUNT];
+            uint32_t       historySize      ;
+            uint32_t       maxDevices       ;
+            std::atomic<uint32_t> deviceCount{0};
+
+            Device*        find              (Shard& shard, uint32_t id, uint32_t ip);
+            void           apply             (Device& device, const QueuedReading& reading, bool isLive, int64_t nowMillis, IngestCounts& counts);
+            void           insert            (Device& device, const Sample& sample);
+            bool           isHeld            (const Device& device, uint32_t sequence);
+            const Sample&  getSample         (const Device& device, uint32_t index);
+            Shard&         shardOf           (uint32_t id)            ;
+
+        public:
+            SeriesStore(uint32_t historySize, uint32_t maxDevices);
+
+            bool           ingest            (const char* data, size_t length, uint32_t ip, int64_t nowMillis, IngestCounts& counts);
+
+            uint32_t       getDeviceCount    ()                       ;
+            uint32_t       getHistorySize    ()                       ;
+            void           listDevices       (std::vector<DeviceSummary>& summaries);
+            bool           getSamples        (uint32_t id, int64_t fromMillis, int64_t toMillis, size_t limit, DeviceSummary& summary, std::vector<Sample>& samples);
+
+            static void    addCounts         (IngestCounts& total, const IngestCounts& counts);
+    };
+
+#endif
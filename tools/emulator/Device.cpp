@@ -0,0 +1,259 @@
+/*
+    Device - A class used by the emulator to run one emulated TempBuddy
+    unit on a thread of its own.
+
+    Written by: Scott Griffis
+    Date: 10-19-2026
+*/
+
+#include "Device.h"
+#include <stdio.h>
+#include <string.h>
+#include <errno.h>
+#include <time.h>
+#include <fcntl.h>
+#include <dlfcn.h>
+#include <unistd.h>
+#include <chrono>
+#include <sys/stat.h>
+#include <netinet/in.h>
+
+#define DEVICE_DEFAULT_SSID "ssid=TempBuddyLab" // Joins straight away rather than coming up as an access point
+#define DEVICE_DEFAULT_PWD "pwd=emulated"
+#define DEVICE_SHORT_SLEEP_MICROS 10000ull // Sleeps shorter than this don't wait on the stop condition
+#define RESET_REASON_DEFAULT 0 // rst_reason as the firmware sees it
+#define RESET_REASON_SOFT_RESTART 4
+#define RESET_REASON_DEEP_SLEEP_AWAKE 5
+
+std::mutex Device::stopMutex;
+std::condition_variable Device::stopCondition;
+std::atomic<bool> Device::isStopping_{false};
+
+/**
+ * #### CLASS CONSTRUCTOR ####
+ * Allows for external instantiation of
+ * the class into an object.
+ *
+ * @param index The place of the device in the fleet from zero as uint32_t.
+ * @param setup How the fleet is set up as const FleetSetup&.
+*/
+Device::Device(uint32_t index, const FleetSetup& setup) : index(index), setup(setup) {
+    char name[32];
+    snprintf(name, sizeof(name), "/device-%04u", index);
+    deviceDir = setup.dataDir + name;
+    imagePath = deviceDir + "/firmware.so";
+    eepromPath = deviceDir + "/eeprom.bin";
+    flashPath = deviceDir + "/flash.bin";
+    memset(rtcMemory, 0, sizeof(rtcMemory));
+
+    memset(&config, 0, sizeof(config));
+    config.index = index;
+    config.ip = htonl(setup.baseIp + index);
+    const uint8_t mac[6] = {0x5C, 0xCF, 0x7F, (uint8_t) (index >> 16), (uint8_t) (index >> 8), (uint8_t) index}; // Espressif's prefix
+    memcpy(config.mac, mac, sizeof(mac));
+    config.webPort = setup.webPort;
+    config.eepromPath = eepromPath.c_str();
+    config.flashPath = flashPath.c_str();
+    config.readingsPath = setup.readingsPath;
+    config.readingCount = &readingCount;
+    config.isLogged = setup.isLogged;
+    config.isSerialInput = setup.isSerialInput;
+    config.rtcMemory = rtcMemory;
+    config.sleep = sleep;
+    config.isStopping = isStopping;
+}
+
+/**
+ * Makes the device's directory and its copy of the firmware image,
+ * and sets the settings to apply on its first boot. A device with
+ * nothing stored yet is first given a network to join.
+ *
+ * @return Returns true if ready to start otherwise false as bool.
+*/
+bool Device::prepare() {
+    if (mkdir(deviceDir.c_str(), 0755) != 0 && errno != EEXIST) {
+        perror(deviceDir.c_str());
+
+        return false;
+    }
+    if (!copyImage()) {
+
+        return false;
+    }
+    if (access(flashPath.c_str(), F_OK) != 0 && access(eepromPath.c_str(), F_OK) != 0) { // Fresh device...
+        config.settings[config.settingCount++] = DEVICE_DEFAULT_SSID;
+        config.settings[config.settingCount++] = DEVICE_DEFAULT_PWD;
+    }
+    for (const char *setting : setup.settings) {
+        if (config.settingCount < EMULATOR_MAX_SETTINGS) {
+            config.settings[config.settingCount++] = setting;
+        }
+    }
+
+    return true;
+}
+
+/**
+ * Starts the device's thread.
+*/
+void Device::start() {
+    worker = std::thread(&Device::run, this);
+}
+
+/**
+ * Waits for the device's thread to finish, which it does once
+ * stopAll() is called.
+*/
+void Device::join() {
+    if (worker.joinable()) {
+        worker.join();
+    }
+}
+
+/**
+ * Gets the device's address.
+ *
+ * @return Returns the address in host byte order as uint32_t.
+*/
+uint32_t Device::getIp() {
+
+    return ntohl(config.ip);
+}
+
+uint32_t Device::getBootCount() {
+
+    return bootCount.load(std::memory_order_relaxed);
+}
+
+uint32_t Device::getRestartCount() {
+
+    return restartCount.load(std::memory_order_relaxed);
+}
+
+uint32_t Device::getDeepSleepCount() {
+
+    return deepSleepCount.load(std::memory_order_relaxed);
+}
+
+/**
+ * Stops every device, waking those asleep. Each ends its boot the
+ * next time its firmware gives up the CPU.
+*/
+void Device::stopAll() {
+    {
+        std::lock_guard<std::mutex> lock(stopMutex);
+        isStopping_.store(true);
+    }
+    stopCondition.notify_all();
+}
+
+/*
+=================================================================
+Private Functions
+=================================================================
+*/
+
+/**
+ * #### PRIVATE ####
+ * The device's thread. Boots the firmware over and over, as the
+ * hardware would, until the emulator stops.
+*/
+void Device::run() {
+    if (!sleep((uint64_t) index * setup.staggerMillis * 1000ull)) { // Stopped before its first boot...
+
+        return;
+    }
+    config.resetReason = RESET_REASON_DEFAULT;
+    while (!isStopping()) {
+        void *image = dlopen(imagePath.c_str(), RTLD_NOW | RTLD_LOCAL);
+        BootFunction boot = (image != nullptr ? (BootFunction) dlsym(image, EMULATOR_BOOT_SYMBOL) : nullptr);
+        if (boot == nullptr) { // Not a firmware image...
+            fprintf(stderr, "Device %u: %s\n", index, dlerror());
+            if (image != nullptr) {
+                dlclose(image);
+            }
+            break;
+        }
+
+        uint64_t sleepMicros = 0;
+        BootEnd end = boot(&config, &sleepMicros);
+        dlclose(image);
+        bootCount.fetch_add(1, std::memory_order_relaxed);
+        config.settingCount = 0; // First boot only
+
+        if (end == BOOT_RESTART) {
+            restartCount.fetch_add(1, std::memory_order_relaxed);
+            config.resetReason = RESET_REASON_SOFT_RESTART;
+        } else if (end == BOOT_DEEP_SLEEP) {
+            deepSleepCount.fetch_add(1, std::memory_order_relaxed);
+            config.resetReason = RESET_REASON_DEEP_SLEEP_AWAKE;
+            if (!sleep(sleepMicros)) { // Stopped while asleep...
+                break;
+            }
+        } else { // Stopped...
+            break;
+        }
+    }
+}
+
+/**
+ * #### PRIVATE ####
+ * Used to copy the firmware image into the device's directory. The
+ * copy is written beside the old one and then renamed over it, and
+ * shares the original's blocks where the file system allows.
+ *
+ * @return Returns true if copied otherwise false as bool.
+*/
+bool Device::copyImage() {
+    std::string temporaryPath = imagePath + ".tmp";
+    int source = open(setup.imagePath.c_str(), O_RDONLY | O_CLOEXEC);
+    int target = open(temporaryPath.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0755);
+    struct stat info;
+    bool ok = (source >= 0 && target >= 0 && fstat(source, &info) == 0);
+    off_t remaining = (ok ? info.st_size : 0);
+    while (ok && remaining > 0) {
+        ssize_t copied = copy_file_range(source, nullptr, target, nullptr, (size_t) remaining, 0);
+        ok = (copied > 0);
+        remaining -= (ok ? copied : 0);
+    }
+    if (source >= 0) {
+        close(source);
+    }
+    if (target >= 0 && close(target) != 0) {
+        ok = false;
+    }
+    if (!ok || rename(temporaryPath.c_str(), imagePath.c_str()) != 0) {
+        perror(setup.imagePath.c_str());
+        unlink(temporaryPath.c_str());
+
+        return false;
+    }
+
+    return true;
+}
+
+/**
+ * #### PRIVATE ####
+ * Given to the firmware to wait with, so a sleeping device wakes as
+ * soon as the emulator stops.
+ *
+ * @param micros The time to wait as uint64_t.
+ *
+ * @return Returns true if waited it out, false if the emulator is stopping as bool.
+*/
+bool Device::sleep(uint64_t micros) {
+    if (micros < DEVICE_SHORT_SLEEP_MICROS) { // Stop is noticed soon enough; Spares hundreds of devices the one lock...
+        timespec duration = {(time_t) (micros / 1000000ull), (long) ((micros % 1000000ull) * 1000ull)};
+        nanosleep(&duration, nullptr);
+
+        return !isStopping();
+    }
+    std::unique_lock<std::mutex> lock(stopMutex);
+
+    return !stopCondition.wait_for(lock, std::chrono::microseconds(micros), []() { return isStopping_.load(); });
+}
+
+bool Device::isStopping() {
+
+    return isStopping_.load(std::memory_order_relaxed);
+}
@@ -0,0 +1,88 @@
+/*
+    Device - A class used by the emulator to run one emulated TempBuddy
+    unit on a thread of its own.
+
+    The device runs a private copy of the firmware image, kept in its own
+    directory under the emulator's data directory along with the file
+    standing in for its flash. The copy is loaded for each boot and
+    unloaded once the boot ends, so every boot starts from fresh globals
+    as it would on the hardware (see EmulatedDevice.h). Only the RTC
+    memory, the flash and the place reached in the readings script carry
+    over from one boot to the next. A restart boots again straight away;
+    Deep sleep waits out the time asked for first.
+
+    Every device waits on the same condition when sleeping, so stopping
+    the emulator wakes them all at once.
+
+    Written by: Scott Griffis
+    Date: 10-19-2026
+*/
+
+#ifndef Device_h
+    #define Device_h
+
+    #include <stdint.h>
+    #include <atomic>
+    #include <condition_variable>
+    #include <mutex>
+    #include <string>
+    #include <thread>
+    #include <vector>
+    #include "EmulatedDevice.h"
+
+    // ************************************************************************************
+    // How the devices of the fleet are set up; Each is told apart by its index
+    // ************************************************************************************
+    struct FleetSetup {
+        uint32_t       baseIp           ; // Address of the first device, in host byte order
+        uint16_t       webPort          ;
+        std::string    dataDir          ;
+        std::string    imagePath        ; // Firmware image built as a shared object
+        const char    *readingsPath     ; // nullptr to generate readings
+        std::vector<const char *> settings; // "name=value" applied on a device's first boot
+        bool           isLogged         ;
+        bool           isSerialInput    ;
+        uint32_t       staggerMillis    ; // Between the first boots of one device and the next
+    };
+
+    class Device {
+        private:
+            uint32_t       index            ;
+            const FleetSetup& setup         ;
+            DeviceConfig   config           ;
+            std::string    deviceDir        ;
+            std::string    imagePath        ;
+            std::string    eepromPath       ;
+            std::string    flashPath        ;
+            uint8_t        rtcMemory        [EMULATOR_RTC_SIZE];
+            uint32_t       readingCount     = 0;
+            std::thread    worker           ;
+            std::atomic<uint32_t> bootCount {0};
+            std::atomic<uint32_t> restartCount{0};
+            std::atomic<uint32_t> deepSleepCount{0};
+
+            static std::mutex stopMutex     ;
+            static std::condition_variable stopCondition;
+            static std::atomic<bool> isStopping_;
+
+            void           run               ()                       ;
+            bool           copyImage         ()                       ;
+            static bool    sleep             (uint64_t micros)        ;
+            static bool    isStopping        ()                       ;
+
+        public:
+            Device(uint32_t index, const FleetSetup& setup);
+
+            bool           prepare           ()                       ;
+            void           start             ()                       ;
+            void           join              ()                       ;
+
+            uint32_t       getIp             ()                       ;
+            uint32_t       getBootCount      ()                       ;
+            uint32_t       getRestartCount   ()                       ;
+            uint32_t       getDeepSleepCount ()                       ;
+
+            static void    stopAll           ()                       ;
+    };
+
+#endif
@@ -0,0 +1,59 @@
+/*
+    EmulatedDevice - What the emulator and the firmware image it loads
+    share: How a device is to be set up for a boot and how that boot
+    came to an end.
+
+    The firmware keeps its state in globals, as a sketch does, so each
+    emulated device runs its own copy of the firmware image, built as a
+    shared object, with the globals of that copy to itself. The emulator
+    loads the copy, calls the image's boot function on the device's own
+    thread and unloads the copy again once the boot ends, so a restart or
+    a wake from deep sleep starts from fresh globals as on the hardware.
+    Only what the hardware keeps across a reset, the RTC memory and the
+    flash, is carried from one boot to the next.
+
+    Written by: Scott Griffis
+    Date: 10-19-2026
+*/
+
+#ifndef EmulatedDevice_h
+    #define EmulatedDevice_h
+
+    #include <stdint.h>
+
+    #define EMULATOR_BOOT_SYMBOL "tempbuddyBoot"
+    #define EMULATOR_RTC_SIZE 512 // User RTC memory of the ESP8266 in bytes
+    #define EMULATOR_MAX_SETTINGS 32
+
+    enum BootEnd : uint8_t {
+        BOOT_STOPPED, // Emulator is shutting down
+        BOOT_RESTART, // ESP.restart()
+        BOOT_DEEP_SLEEP // ESP.deepSleep(); Wakes after sleepMicros
+    };
+
+    // ************************************************************************************
+    // How a device is set up for a boot; Owned by the emulator
+    // ************************************************************************************
+    struct DeviceConfig {
+        uint32_t       index            ; // Place of the device in the fleet from zero
+        uint32_t       ip               ; // Address on the loopback network, in network byte order as IPAddress holds it
+        uint8_t        mac[6]           ;
+        uint16_t       webPort          ;
+        uint32_t       resetReason      ; // rst_reason of this boot
+        const char    *eepromPath       ; // Flash sector of the device's EEPROM
+        const char    *flashPath        ; // Filesystem area of the device's flash (see flash_hal.h)
+        const char    *readingsPath     ; // Scripted sensor readings; nullptr to generate them
+        uint32_t      *readingCount     ; // Readings taken across boots, so a script carries on where it was
+        const char    *settings         [EMULATOR_MAX_SETTINGS]; // "name=value" applied before setup(); First boot only
+        uint8_t        settingCount     ;
+        bool           isLogged         ; // Serial output printed with the device's address
+        bool           isSerialInput    ; // Serial input read from stdin
+        uint8_t       *rtcMemory        ; // EMULATOR_RTC_SIZE bytes which survive restarts and deep sleep
+        bool         (*sleep)           (uint64_t micros); // Waits, returning false early if the emulator is stopping
+        bool         (*isStopping)      ();
+        uint64_t     (*clockNanos)      (); // A clock of the caller's own, as host tests use; nullptr for the host's
+    };
+
+    typedef BootEnd (*BootFunction)(DeviceConfig *config, uint64_t *sleepMicros);
+
+#endif
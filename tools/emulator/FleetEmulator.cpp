@@ -0,0 +1,260 @@
+/*
+    TempBuddy Emulator - Runs a fleet of emulated TempBuddy units on Linux,
+    hundreds of them in the one process, each running the firmware itself
+    against POSIX sockets on the loopback interface. It is meant for load
+    testing what listens to a fleet, such as the collector or a hub, and
+    for profiling the firmware's handlers with the usual Linux tools.
+
+    The firmware is built as a shared object, its image, with stand ins
+    for the Arduino core and the libraries it uses (see shims/). Each
+    device runs its own copy of the image on a thread of its own (see
+    Device.h), and is given its own address on the loopback network
+    starting from 127.1.0.1, its own MAC and so its own Device ID, and a
+    file standing in for its flash. The web server is plain HTTP on the
+    device's address, as TLS is not emulated; Broadcasts go to
+    127.255.255.255.
+
+    It is built with g++ from the project root, as shown in the README
+    under Emulating A Fleet.
+
+    Usage:
+        tempbuddy-emulator [--devices 1] [--image ./tempbuddy-device.so] [--data /tmp/tempbuddy-emulator]
+                           [--base-ip 127.1.0.1] [--web-port 8443] [--readings FILE] [--set name=value]...
+                           [--stagger MS] [--log]
+
+    Written by: Scott Griffis
+    Date: 10-19-2026
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <signal.h>
+#include <memory>
+#include <vector>
+#include <sys/stat.h>
+#include <arpa/inet.h>
+#include "Device.h"
+
+#define EMULATOR_DEFAULT_IMAGE "./tempbuddy-device.so"
+#define EMULATOR_DEFAULT_DATA "/tmp/tempbuddy-emulator"
+#define EMULATOR_DEFAULT_BASE_IP "127.1.0.1"
+#define EMULATOR_DEFAULT_WEB_PORT 8443
+#define EMULATOR_MAX_DEVICES 65536
+#define EMULATOR_SPREAD_MILLIS 10000 // First boots are spread over this, so the fleet doesn't join at once
+#define EMULATOR_BROADCAST_IP 0x7FFFFFFFu // 127.255.255.255
+
+// ************************************************************************************
+// Options given on the command line
+// ************************************************************************************
+struct Options {
+    uint32_t       devices          ;
+    uint32_t       staggerMillis    ; // UINT32_MAX to spread the first boots over EMULATOR_SPREAD_MILLIS
+    FleetSetup     setup            ;
+};
+
+bool parseOptions(int argc, char **argv, Options &options);
+bool parseNumber(const char *text, uint32_t low, uint32_t high, uint32_t &value);
+void printUsage(const char *name);
+int runFleet(Options &options);
+
+/**
+ * Reads the options and runs the fleet until stopped.
+ */
+int main(int argc, char **argv) {
+    Options options;
+    options.devices = 1;
+    options.staggerMillis = UINT32_MAX;
+    options.setup.baseIp = ntohl(inet_addr(EMULATOR_DEFAULT_BASE_IP));
+    options.setup.webPort = EMULATOR_DEFAULT_WEB_PORT;
+    options.setup.dataDir = EMULATOR_DEFAULT_DATA;
+    options.setup.imagePath = EMULATOR_DEFAULT_IMAGE;
+    options.setup.readingsPath = nullptr;
+    options.setup.isLogged = false;
+    options.setup.isSerialInput = false;
+    if (!parseOptions(argc, argv, options)) { // Bad options...
+        printUsage(argv[0]);
+
+        return 2;
+    }
+
+    return runFleet(options);
+}
+
+/**
+ * Starts every device and runs them until SIGINT or SIGTERM is
+ * received. The signals are blocked in every thread and waited for
+ * here, so the devices never see them.
+ *
+ * @param options The options as Options&.
+ *
+ * @return Returns the exit code for the process as int.
+ */
+int runFleet(Options &options) {
+    sigset_t signals;
+    sigemptyset(&signals);
+    sigaddset(&signals, SIGINT);
+    sigaddset(&signals, SIGTERM);
+    pthread_sigmask(SIG_BLOCK, &signals, nullptr);
+
+    FleetSetup &setup = options.setup;
+    setup.isLogged = (setup.isLogged || options.devices == 1);
+    setup.isSerialInput = (options.devices == 1); // Serial commands go to the only device
+    setup.staggerMillis = (options.staggerMillis != UINT32_MAX ? options.staggerMillis : EMULATOR_SPREAD_MILLIS / options.devices);
+    if (mkdir(setup.dataDir.c_str(), 0755) != 0 && errno != EEXIST) {
+        perror(setup.dataDir.c_str());
+
+        return 1;
+    }
+
+    std::vector<std::unique_ptr<Device>> devices;
+    for (uint32_t i = 0; i < options.devices; i++) {
+        devices.emplace_back(new Device(i, setup));
+        if (!devices.back()->prepare()) {
+
+            return 1;
+        }
+    }
+    for (std::unique_ptr<Device> &device : devices) {
+        device->start();
+    }
+    in_addr first = {htonl(devices.front()->getIp())};
+    in_addr last = {htonl(devices.back()->getIp())};
+    char firstText[INET_ADDRSTRLEN];
+    char lastText[INET_ADDRSTRLEN];
+    inet_ntop(AF_INET, &first, firstText, sizeof(firstText));
+    inet_ntop(AF_INET, &last, lastText, sizeof(lastText));
+    if (options.devices == 1) {
+        printf("Emulating 1 device at %s; Web on http://%s:%u/api/info; Data in %s\n", firstText, firstText, setup.webPort, setup.dataDir.c_str());
+    } else {
+        printf(
+            "Emulating %u devices at %s to %s, %ums apart; Web on http://%s:%u/api/info; Data in %s\n",
+            options.devices, firstText, lastText, setup.staggerMillis, firstText, setup.webPort, setup.dataDir.c_str()
+        );
+    }
+    fflush(stdout);
+
+    int received = 0;
+    sigwait(&signals, &received);
+    printf("Stopping...\n");
+    fflush(stdout);
+    Device::stopAll();
+    uint64_t boots = 0;
+    uint64_t restarts = 0;
+    uint64_t deepSleeps = 0;
+    for (std::unique_ptr<Device> &device : devices) {
+        device->join();
+        boots += device->getBootCount();
+        restarts += device->getRestartCount();
+        deepSleeps += device->getDeepSleepCount();
+    }
+    printf(
+        "Devices booted %llu times, of which %llu after a restart and %llu after deep sleep\n",
+        (unsigned long long) boots, (unsigned long long) restarts, (unsigned long long) deepSleeps
+    );
+
+    return 0;
+}
+
+/**
+ * Reads the options from the command line, leaving the defaults
+ * for any not given.
+ *
+ * @param argc The number of arguments as int.
+ * @param argv The arguments as char**.
+ * @param options Receives the options as Options&.
+ *
+ * @return Returns true if the options were valid otherwise false as bool.
+ */
+bool parseOptions(int argc, char **argv, Options &options) {
+    for (int i = 1; i < argc; i++) {
+        const char *name = argv[i];
+        const char *value = (i + 1 < argc ? argv[i + 1] : nullptr);
+        bool isValid = true;
+        uint32_t number = 0;
+        if (strcmp(name, "--log") == 0) {
+            options.setup.isLogged = true;
+            continue;
+        } else if (strcmp(name, "--devices") == 0) {
+            isValid = parseNumber(value, 1, EMULATOR_MAX_DEVICES, options.devices);
+        } else if (strcmp(name, "--image") == 0) {
+            isValid = (value != nullptr);
+            options.setup.imagePath = (isValid ? value : "");
+        } else if (strcmp(name, "--data") == 0) {
+            isValid = (value != nullptr);
+            options.setup.dataDir = (isValid ? value : "");
+        } else if (strcmp(name, "--base-ip") == 0) {
+            in_addr address;
+            isValid = (value != nullptr && inet_pton(AF_INET, value, &address) == 1 && (ntohl(address.s_addr) >> 24) == 127);
+            options.setup.baseIp = (isValid ? ntohl(address.s_addr) : 0);
+        } else if (strcmp(name, "--web-port") == 0) {
+            isValid = parseNumber(value, 1, 65535, number);
+            options.setup.webPort = (uint16_t) number;
+        } else if (strcmp(name, "--readings") == 0) {
+            isValid = (value != nullptr);
+            options.setup.readingsPath = value;
+        } else if (strcmp(name, "--set") == 0) {
+            isValid = (value != nullptr && strchr(value, '=') != nullptr && options.setup.settings.size() < EMULATOR_MAX_SETTINGS - 2); // Room for the default network
+            if (isValid) {
+                options.setup.settings.push_back(value);
+            }
+        } else if (strcmp(name, "--stagger") == 0) {
+            isValid = parseNumber(value, 0, 60000, options.staggerMillis);
+        } else { // Not known...
+            fprintf(stderr, "Unknown option: %s\n", name);
+
+            return false;
+        }
+        if (!isValid) {
+            fprintf(stderr, "Bad value for %s\n", name);
+
+            return false;
+        }
+        i++; // Past the value
+    }
+    if (options.setup.baseIp + options.devices - 1 >= EMULATOR_BROADCAST_IP) { // Runs past the loopback network...
+        fprintf(stderr, "Too many devices from that base address\n");
+
+        return false;
+    }
+
+    return true;
+}
+
+/**
+ * Used to parse a whole number within a range.
+ *
+ * @param text The number as const char*; nullptr if missing.
+ * @param low The lowest allowed as uint32_t.
+ * @param high The highest allowed as uint32_t.
+ * @param value Receives the number as uint32_t&.
+ *
+ * @return Returns true if valid otherwise false as bool.
+ */
+bool parseNumber(const char *text, uint32_t low, uint32_t high, uint32_t &value) {
+    if (text == nullptr || *text == '\0') { // Missing...
+
+        return false;
+    }
+    char *end;
+    unsigned long long number = strtoull(text, &end, 10);
+    if (*end != '\0' || number < low || number > high) { // Not a number or out of range...
+
+        return false;
+    }
+    value = (uint32_t) number;
+
+    return true;
+}
+
+void printUsage(const char *name) {
+    fprintf(
+        stderr,
+        "Usage:\n"
+        "  %s [--devices 1] [--image %s] [--data %s]\n"
+        "     [--base-ip %s] [--web-port %u] [--readings FILE] [--set name=value]...\n"
+        "     [--stagger MS] [--log]\n",
+        name, EMULATOR_DEFAULT_IMAGE, EMULATOR_DEFAULT_DATA, EMULATOR_DEFAULT_BASE_IP, EMULATOR_DEFAULT_WEB_PORT
+    );
+}
@@ -0,0 +1,151 @@
+/*
+    AHT10 - The emulator's stand in for the AHT10 sensor library.
+
+    Written by: Scott Griffis
+    Date: 10-19-2026
+*/
+
+#include "AHT10.h"
+#include "Emulator.h"
+#include <Arduino.h>
+
+#define AHT10_DRIFT_SECONDS 3600.0 // Time of one swing of a generated reading
+#define AHT10_FAILED NAN // Marks a scripted reading the sensor doesn't answer
+
+float AHT10::scriptTemperatures[AHT10_MAX_SCRIPT_LINES];
+float AHT10::scriptHumidities[AHT10_MAX_SCRIPT_LINES];
+uint16_t AHT10::scriptLength = 0;
+
+bool AHT10::begin() {
+    delay(40); // Power on time of the sensor
+    loadScript();
+
+    return true;
+}
+
+uint8_t AHT10::readRawData() {
+    takeReading();
+
+    return (temperature == AHT10_ERROR ? AHT10_ERROR : 0);
+}
+
+/**
+ * Gets the temperature, taking a new reading if asked.
+ *
+ * @param readI2C True to take a new reading as bool.
+ *
+ * @return Returns the temperature in celsius, or AHT10_ERROR if the sensor didn't answer as float.
+*/
+float AHT10::readTemperature(bool readI2C) {
+    if (readI2C) {
+        takeReading();
+    }
+
+    return temperature;
+}
+
+/**
+ * Gets the humidity, taking a new reading if asked.
+ *
+ * @param readI2C True to take a new reading as bool.
+ *
+ * @return Returns the relative humidity in percent, or AHT10_ERROR if the sensor didn't answer as float.
+*/
+float AHT10::readHumidity(bool readI2C) {
+    if (readI2C) {
+        takeReading();
+    }
+
+    return humidity;
+}
+
+bool AHT10::softReset() {
+    delay(20);
+
+    return true;
+}
+
+bool AHT10::setNormalMode() {
+
+    return true;
+}
+
+bool AHT10::setCycleMode() {
+
+    return true;
+}
+
+/*
+=================================================================
+Private Functions
+=================================================================
+*/
+
+/**
+ * #### PRIVATE ####
+ * Used to load the readings script, if one was given. Every copy of
+ * the firmware image loads its own, so the script can change between
+ * boots.
+*/
+void AHT10::loadScript() {
+    if (isScriptLoaded) {
+
+        return;
+    }
+    isScriptLoaded = true;
+    scriptLength = 0;
+    const char *path = Emulator::getConfig().readingsPath;
+    FILE *file = (path != nullptr ? fopen(path, "r") : nullptr);
+    if (file == nullptr) { // Generated readings...
+
+        return;
+    }
+
+    char line[128];
+    while (scriptLength < AHT10_MAX_SCRIPT_LINES && fgets(line, sizeof(line), file) != nullptr) {
+        char *text = line;
+        while (*text == ' ' || *text == '\t') {
+            text++;
+        }
+        float temp;
+        float humid;
+        if (*text == '#' || *text == '\r' || *text == '\n' || *text == '\0') { // Comment or blank...
+            continue;
+        } else if (strncmp(text, "fail", 4) == 0) { // Sensor doesn't answer...
+            scriptTemperatures[scriptLength] = AHT10_FAILED;
+            scriptHumidities[scriptLength] = AHT10_FAILED;
+            scriptLength++;
+        } else if (sscanf(text, "%f , %f", &temp, &humid) == 2) {
+            scriptTemperatures[scriptLength] = temp;
+            scriptHumidities[scriptLength] = humid;
+            scriptLength++;
+        } else {
+            Serial.printf("Emulator: Reading not understood: %s", text);
+        }
+    }
+    fclose(file);
+}
+
+/**
+ * #### PRIVATE ####
+ * Used to take a reading, as long as the sensor takes to convert one.
+*/
+void AHT10::takeReading() {
+    delay(AHT10_MEASUREMENT_DELAY);
+    loadScript();
+    const DeviceConfig &config = Emulator::getConfig();
+    uint32_t count = (*config.readingCount)++;
+    if (scriptLength > 0) { // Scripted...
+        uint16_t line = (uint16_t) ((config.index + count) % scriptLength);
+        bool isFailed = isnan(scriptTemperatures[line]);
+        temperature = (isFailed ? AHT10_ERROR : scriptTemperatures[line]);
+        humidity = (isFailed ? AHT10_ERROR : scriptHumidities[line]);
+
+        return;
+    }
+
+    // Generated; Follows the wall clock so it carries on across boots...
+    double phase = (2.0 * M_PI * (double) time(nullptr)) / AHT10_DRIFT_SECONDS;
+    temperature = (float) (20.0 + (config.index % 8) + (2.0 * sin(phase + (config.index * 0.7))));
+    humidity = (float) (40.0 + (config.index % 20) + (5.0 * sin(phase + (config.index * 1.3))));
+}
@@ -0,0 +1,59 @@
+/*
+    AHT10 - The emulator's stand in for the AHT10 sensor library.
+
+    Readings come from the script given to the emulator, one per line as
+    "temperature,humidity" or "fail" for a reading the sensor doesn't
+    answer. Lines starting with # are skipped. Each device starts at the
+    line of its own place in the fleet and carries on from there across
+    restarts and deep sleep, wrapping back to the top at the end. With no
+    script, each device drifts slowly about a temperature and humidity of
+    its own. A forced read takes as long as the sensor's conversion.
+
+    Written by: Scott Griffis
+    Date: 10-19-2026
+*/
+
+#ifndef AHT10_h
+    #define AHT10_h
+
+    #include <stdint.h>
+
+    #define AHT10_ADDRESS_0X38 0x38
+    #define AHT10_FORCE_READ_DATA true
+    #define AHT10_USE_READ_DATA false
+    #define AHT10_ERROR 0xFF
+    #define AHT10_MEASUREMENT_DELAY 80
+    #define AHT10_MAX_SCRIPT_LINES 4096
+
+    enum ASAIR_I2C_SENSOR {
+        AHT10_SENSOR = 0x00,
+        AHT15_SENSOR = 0x01,
+        AHT20_SENSOR = 0x02
+    };
+
+    class AHT10 {
+        private:
+            float          temperature      = AHT10_ERROR;
+            float          humidity         = AHT10_ERROR;
+            bool           isScriptLoaded   = false;
+
+            static float   scriptTemperatures[AHT10_MAX_SCRIPT_LINES];
+            static float   scriptHumidities [AHT10_MAX_SCRIPT_LINES];
+            static uint16_t scriptLength;
+
+            void           loadScript        ()                       ;
+            void           takeReading       ()                       ;
+
+        public:
+            AHT10(uint8_t address = AHT10_ADDRESS_0X38, ASAIR_I2C_SENSOR sensorName = AHT10_SENSOR) {}
+
+            bool           begin             ()                       ;
+            uint8_t        readRawData       ()                       ;
+            float          readTemperature   (bool readI2C = AHT10_FORCE_READ_DATA);
+            float          readHumidity      (bool readI2C = AHT10_FORCE_READ_DATA);
+            bool           softReset         ()                       ;
+            bool           setNormalMode     ()                       ;
+            bool           setCycleMode      ()                       ;
+    };
+
+#endif
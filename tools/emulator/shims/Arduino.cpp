@@ -0,0 +1,666 @@
+/*
+    Arduino - The emulator's stand in for the parts of the ESP8266 Arduino
+    core the firmware uses: Time, pins, Serial and the ESP object.
+
+    Written by: Scott Griffis
+    Date: 10-19-2026
+*/
+
+#include "Arduino.h"
+#include "Emulator.h"
+#include <coredecls.h>
+#include <user_interface.h>
+#include <stdarg.h>
+#include <unistd.h>
+#include <sys/ioctl.h>
+#include <sys/random.h>
+#include <fcntl.h>
+#include <flash_hal.h>
+
+#define EMULATED_FREE_HEAP 40960 // The heap is shared by every device in the process; Profile it with heaptrack or valgrind
+#define EMULATED_MAX_BLOCK 32768
+#define EMULATED_FRAGMENTATION 10
+#define EMULATED_SKETCH_SPACE 1048576
+#define SNTP_FIRST_SYNC_MILLIS 1000 // Time for the first SNTP reply; The host's clock stands in for the server's
+#define SNTP_SYNC_INTERVAL_MILLIS 3600000 // Time between syncs after the first, as lwIP's SNTP does
+
+HardwareSerial Serial;
+EspClass ESP;
+
+uint8_t cpuFreqMHz = SYS_CPU_80MHZ;
+TrivialCB timeSetCallback = nullptr;
+BoolCB timeSetFromSntpCallback = nullptr;
+uint32_t timeSyncGeneration = 0;
+
+void doTimeSync(uint32_t generation);
+
+// ************************************************************************************
+// Time and Pins
+// ************************************************************************************
+
+unsigned long millis() {
+
+    return (unsigned long) (Emulator::getNanos() / 1000000ull);
+}
+
+unsigned long micros() {
+
+    return (unsigned long) Emulator::getMicros();
+}
+
+uint64_t micros64() {
+
+    return Emulator::getMicros();
+}
+
+void delay(unsigned long ms) {
+    Emulator::sleep(ms * 1000ull);
+}
+
+void yield() {
+    Emulator::raiseEvents();
+}
+
+void esp_delay(unsigned long ms) {
+    Emulator::sleep(ms * 1000ull);
+}
+
+/**
+ * Sleeps one interval of an esp_delay(), or what is left of its
+ * timeout if that is less.
+ *
+ * @param startMillis When the delay began as uint32_t.
+ * @param timeoutMillis The longest the delay may last as uint32_t.
+ * @param intervalMillis The time between checks as uint32_t.
+ *
+ * @return Returns false once the timeout is reached otherwise true as bool.
+*/
+bool esp_delay_slice(uint32_t startMillis, uint32_t timeoutMillis, uint32_t intervalMillis) {
+    uint32_t elapsedMillis = (uint32_t) millis() - startMillis;
+    if (elapsedMillis >= timeoutMillis) { // Waited long enough...
+        yield();
+
+        return false;
+    }
+    Emulator::sleep(min(intervalMillis, timeoutMillis - elapsedMillis) * 1000ull);
+
+    return true;
+}
+
+void pinMode(uint8_t pin, uint8_t mode) {}
+
+void digitalWrite(uint8_t pin, uint8_t value) {}
+
+int digitalRead(uint8_t pin) {
+
+    return LOW;
+}
+
+extern "C" bool system_update_cpu_freq(uint8_t freq) {
+    if (freq != SYS_CPU_80MHZ && freq != SYS_CPU_160MHZ) { // Not a speed the chip runs at...
+
+        return false;
+    }
+    cpuFreqMHz = freq;
+
+    return true;
+}
+
+// ************************************************************************************
+// Time Sync; The host's clock is taken to be synced already
+// ************************************************************************************
+
+void configTime(int timezone, int daylightOffsetSecs, const char *server1, const char *server2, const char *server3) {
+    uint32_t generation = ++timeSyncGeneration; // Syncs of an earlier server are dropped
+    Emulator::schedule(SNTP_FIRST_SYNC_MILLIS, [generation]() { doTimeSync(generation); });
+}
+
+void settimeofday_cb(const TrivialCB &callback) {
+    timeSetCallback = callback;
+}
+
+void settimeofday_cb(const BoolCB &callback) {
+    timeSetFromSntpCallback = callback;
+}
+
+/**
+ * Raises the time set callbacks as a sync with the SNTP server
+ * would, then queues the next sync.
+ *
+ * @param generation The configTime() call the sync belongs to as uint32_t.
+*/
+void doTimeSync(uint32_t generation) {
+    if (generation != timeSyncGeneration) { // Server changed since...
+
+        return;
+    }
+    if (timeSetCallback) {
+        timeSetCallback();
+    }
+    if (timeSetFromSntpCallback) {
+        timeSetFromSntpCallback(true);
+    }
+    Emulator::schedule(SNTP_SYNC_INTERVAL_MILLIS, [generation]() { doTimeSync(generation); });
+}
+
+/**
+ * The CRC32 of the ESP8266 core, worked a bit at a time from the
+ * high bit, so stored settings check out the same as on the device.
+*/
+uint32_t crc32(const void *data, size_t length, uint32_t crc) {
+    const uint8_t *bytes = (const uint8_t *) data;
+    while (length--) {
+        uint8_t c = *bytes++;
+        for (uint32_t i = 0x80; i > 0; i >>= 1) {
+            bool bit = (crc & 0x80000000) != 0;
+            if ((c & i) != 0) {
+                bit = !bit;
+            }
+            crc <<= 1;
+            if (bit) {
+                crc ^= 0x04c11db7;
+            }
+        }
+    }
+
+    return crc;
+}
+
+// ************************************************************************************
+// Print and Stream
+// ************************************************************************************
+
+size_t Print::write(const char *text) {
+
+    return (text == nullptr ? 0 : write((const uint8_t *) text, strlen(text)));
+}
+
+size_t Print::print(const char *text) {
+
+    return write(text);
+}
+
+size_t Print::print(const String &text) {
+
+    return write((const uint8_t *) text.c_str(), text.length());
+}
+
+size_t Print::print(const __FlashStringHelper *text) {
+
+    return write(reinterpret_cast<const char *>(text));
+}
+
+size_t Print::print(char value) {
+
+    return write((uint8_t) value);
+}
+
+size_t Print::print(int value, int base) {
+
+    return print(String((long) value, (unsigned char) base));
+}
+
+size_t Print::print(unsigned int value, int base) {
+
+    return print(String((unsigned long) value, (unsigned char) base));
+}
+
+size_t Print::print(long value, int base) {
+
+    return print(String(value, (unsigned char) base));
+}
+
+size_t Print::print(unsigned long value, int base) {
+
+    return print(String(value, (unsigned char) base));
+}
+
+size_t Print::print(double value, int digits) {
+
+    return print(String(value, (unsigned char) digits));
+}
+
+size_t Print::println(const char *text) {
+
+    return print(text) + write("\r\n");
+}
+
+size_t Print::println(const String &text) {
+
+    return print(text) + write("\r\n");
+}
+
+size_t Print::println(const __FlashStringHelper *text) {
+
+    return print(text) + write("\r\n");
+}
+
+size_t Print::println(int value, int base) {
+
+    return print(value, base) + write("\r\n");
+}
+
+size_t Print::println(unsigned int value, int base) {
+
+    return print(value, base) + write("\r\n");
+}
+
+size_t Print::println(long value, int base) {
+
+    return print(value, base) + write("\r\n");
+}
+
+size_t Print::println(unsigned long value, int base) {
+
+    return print(value, base) + write("\r\n");
+}
+
+size_t Print::printf(const char *format, ...) {
+    char buffer[256];
+    va_list args;
+    va_start(args, format);
+    int length = vsnprintf(buffer, sizeof(buffer), format, args);
+    va_end(args);
+    if (length < 0) { // Bad format...
+
+        return 0;
+    }
+    if ((size_t) length < sizeof(buffer)) { // Fit...
+
+        return write((const uint8_t *) buffer, length);
+    }
+    char *large = new char[length + 1];
+    va_start(args, format);
+    vsnprintf(large, length + 1, format, args);
+    va_end(args);
+    size_t written = write((const uint8_t *) large, length);
+    delete[] large;
+
+    return written;
+}
+
+void Stream::setTimeout(unsigned long timeout) {
+    timeoutMillis = timeout;
+}
+
+size_t Stream::readBytes(char *buffer, size_t length) {
+
+    return readBytes((uint8_t *) buffer, length);
+}
+
+/**
+ * Reads up to the given number of bytes, waiting up to the
+ * timeout for each to arrive.
+*/
+size_t Stream::readBytes(uint8_t *buffer, size_t length) {
+    size_t count = 0;
+    unsigned long startMillis = millis();
+    while (count < length && (millis() - startMillis) < timeoutMillis) {
+        int value = read();
+        if (value < 0) { // Nothing yet...
+            delay(1);
+            continue;
+        }
+        buffer[count++] = (uint8_t) value;
+    }
+
+    return count;
+}
+
+// ************************************************************************************
+// Serial; Output printed a line at a time, input read from stdin for a lone device
+// ************************************************************************************
+
+void HardwareSerial::begin(unsigned long baud) {}
+
+size_t HardwareSerial::write(uint8_t value) {
+    if (value == '\n' || lineLength >= sizeof(line) - 1) { // Line complete...
+        flush();
+    }
+    if (value != '\n' && value != '\r') {
+        line[lineLength++] = (char) value;
+    }
+
+    return 1;
+}
+
+size_t HardwareSerial::write(const uint8_t *buffer, size_t size) {
+    for (size_t i = 0; i < size; i++) {
+        write(buffer[i]);
+    }
+
+    return size;
+}
+
+int HardwareSerial::available() {
+    int count = 0;
+    if (!Emulator::getConfig().isSerialInput || ioctl(STDIN_FILENO, FIONREAD, &count) != 0) { // No input...
+
+        return 0;
+    }
+
+    return count;
+}
+
+int HardwareSerial::read() {
+    uint8_t value;
+    if (available() <= 0 || ::read(STDIN_FILENO, &value, 1) != 1) { // Nothing there...
+
+        return -1;
+    }
+
+    return value;
+}
+
+int HardwareSerial::peek() {
+
+    return -1;
+}
+
+/**
+ * Prints what is held of the current line, with the device's
+ * address in front so the output of a fleet can be told apart.
+*/
+void HardwareSerial::flush() {
+    if (lineLength > 0 && Emulator::getConfig().isLogged) {
+        IPAddress ip(Emulator::getConfig().ip);
+        ::printf("[%u.%u.%u.%u] %.*s\n", ip[0], ip[1], ip[2], ip[3], (int) lineLength, line);
+        fflush(stdout);
+    }
+    lineLength = 0;
+}
+
+// ************************************************************************************
+// ESP Object
+// ************************************************************************************
+
+void EspClass::restart() {
+    Emulator::endBoot(BOOT_RESTART, 0ull);
+}
+
+void EspClass::deepSleep(uint64_t timeMicros, RFMode mode) {
+    Emulator::endBoot(BOOT_DEEP_SLEEP, timeMicros);
+}
+
+void EspClass::deepSleepInstant(uint64_t timeMicros, RFMode mode) {
+    Emulator::endBoot(BOOT_DEEP_SLEEP, timeMicros);
+}
+
+uint64_t EspClass::deepSleepMax() {
+
+    return 12000000000ull; // About what the RTC of a typical chip allows
+}
+
+rst_info* EspClass::getResetInfoPtr() {
+    memset(&resetInfo, 0, sizeof(resetInfo));
+    resetInfo.reason = Emulator::getConfig().resetReason;
+
+    return &resetInfo;
+}
+
+String EspClass::getResetReason() {
+    switch (Emulator::getConfig().resetReason) {
+        case REASON_SOFT_RESTART:
+
+            return String(F("Software/System restart"));
+        case REASON_DEEP_SLEEP_AWAKE:
+
+            return String(F("Deep-Sleep Wake"));
+        default:
+
+            return String(F("Power On"));
+    }
+}
+
+/**
+ * Reads from the user RTC memory, which the emulator keeps across
+ * restarts and deep sleep as the chip does.
+ *
+ * @param offset The first 4 byte block to read as uint32_t.
+ * @param data Receives the data as uint32_t*.
+ * @param size The number of bytes to read as size_t.
+ *
+ * @return Returns true if within the user memory otherwise false as bool.
+*/
+bool EspClass::rtcUserMemoryRead(uint32_t offset, uint32_t *data, size_t size) {
+    if ((offset * 4) + size > EMULATOR_RTC_SIZE) { // Past the end...
+
+        return false;
+    }
+    memcpy(data, Emulator::getConfig().rtcMemory + (offset * 4), size);
+
+    return true;
+}
+
+bool EspClass::rtcUserMemoryWrite(uint32_t offset, uint32_t *data, size_t size) {
+    if ((offset * 4) + size > EMULATOR_RTC_SIZE) { // Past the end...
+
+        return false;
+    }
+    memcpy(Emulator::getConfig().rtcMemory + (offset * 4), data, size);
+
+    return true;
+}
+
+uint32_t EspClass::getFreeHeap() {
+
+    return EMULATED_FREE_HEAP;
+}
+
+uint32_t EspClass::getMaxFreeBlockSize() {
+
+    return EMULATED_MAX_BLOCK;
+}
+
+uint8_t EspClass::getHeapFragmentation() {
+
+    return EMULATED_FRAGMENTATION;
+}
+
+void EspClass::getHeapStats(uint32_t *free, uint32_t *max, uint8_t *fragmentation) {
+    *free = getFreeHeap();
+    *max = getMaxFreeBlockSize();
+    *fragmentation = getHeapFragmentation();
+}
+
+/**
+ * Gets the cycles the CPU would have counted since boot, at the
+ * speed the firmware has set, wrapping as the 32-bit register does.
+ *
+ * @return Returns the cycle count as uint32_t.
+*/
+uint32_t EspClass::getCycleCount() {
+
+    return (uint32_t) ((Emulator::getNanos() * cpuFreqMHz) / 1000ull);
+}
+
+uint8_t EspClass::getCpuFreqMHz() {
+
+    return cpuFreqMHz;
+}
+
+uint32_t EspClass::random() {
+    uint32_t value;
+    random((uint8_t *) &value, sizeof(value));
+
+    return value;
+}
+
+uint8_t* EspClass::random(uint8_t *buffer, size_t length) {
+    size_t filled = 0;
+    while (filled < length) {
+        ssize_t count = getrandom(buffer + filled, length - filled, 0);
+        if (count > 0) {
+            filled += count;
+        }
+    }
+
+    return buffer;
+}
+
+uint32_t EspClass::getChipId() {
+    const uint8_t *mac = Emulator::getConfig().mac;
+
+    return ((uint32_t) mac[3] << 16) | ((uint32_t) mac[4] << 8) | mac[5];
+}
+
+const char* EspClass::getFullVersion() {
+
+    return "TempBuddy Emulator";
+}
+
+uint32_t EspClass::getFreeSketchSpace() {
+
+    return EMULATED_SKETCH_SPACE;
+}
+
+/**
+ * #### PRIVATE ####
+ * Opens the device's file of the filesystem area, if the given span
+ * lies within the area.
+ *
+ * @param address The address in flash of the span as uint32_t.
+ * @param size The size of the span in bytes as size_t.
+ *
+ * @return Returns the file descriptor or -1 if not within the area as int.
+*/
+static int openFlash(uint32_t address, size_t size) {
+    const char *path = Emulator::getConfig().flashPath;
+    if (path == nullptr || address < FS_PHYS_ADDR || address + size > FS_PHYS_ADDR + FS_PHYS_SIZE) { // Not emulated...
+
+        return -1;
+    }
+
+    return open(path, O_RDWR | O_CREAT, 0644);
+}
+
+/**
+ * #### PRIVATE ####
+ * Reads from the device's file of the filesystem area. What was never
+ * written reads as erased flash does.
+*/
+static bool readFlash(int file, uint32_t address, uint8_t *data, size_t size) {
+    memset(data, 0xFF, size);
+    ssize_t got = pread(file, data, size, (off_t) (address - FS_PHYS_ADDR));
+    if (got > 0 && (size_t) got < size) { // Past the end of the file...
+        memset(data + got, 0xFF, size - got);
+    }
+
+    return (got >= 0);
+}
+
+/**
+ * #### PRIVATE ####
+ * Counts bytes of flash about to be erased or written against those
+ * left before power is cut (see cutPowerAfterFlash()).
+ *
+ * @param size The number of bytes about to be erased or written as size_t.
+ *
+ * @return Returns how many of them are done before the cut as size_t.
+*/
+size_t EspClass::takeFlashBytes(size_t size) {
+    if (flashBytesToCut < 0) { // Power stays on...
+
+        return size;
+    }
+    size_t taken = std::min(size, (size_t) flashBytesToCut);
+    flashBytesToCut -= (long) taken;
+
+    return taken;
+}
+
+/**
+ * Erases a sector of the filesystem area, setting every bit of it.
+ *
+ * @param sector The number of the sector from the start of flash as uint32_t.
+ *
+ * @return Returns true if erased otherwise false as bool.
+*/
+bool EspClass::flashEraseSector(uint32_t sector) {
+    uint32_t address = sector * FLASH_SECTOR_SIZE;
+    int file = openFlash(address, FLASH_SECTOR_SIZE);
+    if (file < 0) {
+
+        return false;
+    }
+    uint8_t erased[FLASH_SECTOR_SIZE];
+    memset(erased, 0xFF, sizeof(erased));
+    size_t length = takeFlashBytes(sizeof(erased));
+    bool ok = (pwrite(file, erased, length, (off_t) (address - FS_PHYS_ADDR)) == (ssize_t) length);
+    close(file);
+
+    return ok && length == sizeof(erased);
+}
+
+/**
+ * Writes to the filesystem area. As with the chip, the address and
+ * size must be multiples of 4 and bits can only be cleared, so what
+ * is written over must have been erased first.
+ *
+ * @param address The address in flash to write at as uint32_t.
+ * @param data The data to write as const uint32_t*.
+ * @param size The number of bytes to write as size_t.
+ *
+ * @return Returns true if written otherwise false as bool.
+*/
+bool EspClass::flashWrite(uint32_t address, const uint32_t *data, size_t size) {
+    if ((address % 4) != 0 || (size % 4) != 0) { // Not whole words...
+
+        return false;
+    }
+    int file = openFlash(address, size);
+    if (file < 0) {
+
+        return false;
+    }
+    size_t originalSize = size;
+    uint8_t stored[FLASH_SECTOR_SIZE];
+    const uint8_t *bytes = (const uint8_t *) data;
+    size = takeFlashBytes(size);
+    bool ok = true;
+    for (size_t at = 0; ok && at < size; at += sizeof(stored)) {
+        size_t length = std::min(sizeof(stored), size - at);
+        ok = readFlash(file, address + at, stored, length);
+        for (size_t i = 0; i < length; i++) {
+            stored[i] &= bytes[at + i];
+        }
+        ok = ok && (pwrite(file, stored, length, (off_t) (address + at - FS_PHYS_ADDR)) == (ssize_t) length);
+    }
+    close(file);
+
+    return ok && size == originalSize;
+}
+
+/**
+ * Reads from the filesystem area.
+ *
+ * @param address The address in flash to read from as uint32_t.
+ * @param data Receives the data as uint32_t*.
+ * @param size The number of bytes to read as size_t.
+ *
+ * @return Returns true if read otherwise false as bool.
+*/
+bool EspClass::flashRead(uint32_t address, uint32_t *data, size_t size) {
+    int file = openFlash(address, size);
+    if (file < 0) {
+
+        return false;
+    }
+    bool ok = readFlash(file, address, (uint8_t *) data, size);
+    close(file);
+
+    return ok;
+}
+
+/**
+ * Cuts the power part way through what is next erased or written to
+ * the flash, as a power cut or reset during a save would. Once the 
+ * given number of bytes is done the rest are left as they were and 
+ * the calls fail. Not part of the core; For the emulator only.
+ *
+ * @param bytes The bytes to erase or write before the cut, or -1 to
+ * keep the power on as long.
+*/
+void EspClass::cutPowerAfterFlash(long bytes) {
+    flashBytesToCut = bytes;
+}
@@ -0,0 +1,181 @@
+/*
+    Arduino - The emulator's stand in for the parts of the ESP8266 Arduino
+    core the firmware uses: Time, pins, Serial and the ESP object.
+
+    Time runs from the boot of the emulated device. The pins read LOW, so
+    the factory reset button is never pressed. Serial output is printed a
+    line at a time with the device's address in front, when logging is on.
+    The CPU clock is only a number here, but it is kept as the firmware
+    sets it so the cycle counter and the power figures follow it.
+
+    Written by: Scott Griffis
+    Date: 10-19-2026
+*/
+
+#ifndef Arduino_h
+    #define Arduino_h
+
+    #include <stdint.h>
+    #include <stddef.h>
+    #include <string.h>
+    #include <stdio.h>
+    #include <stdlib.h>
+    #include <math.h>
+    #include <time.h>
+    #include <sys/time.h>
+    #include <algorithm>
+    #include <functional>
+    #include <pgmspace.h>
+    #include <WString.h>
+    #include <IPAddress.h>
+    #include <core_esp8266_features.h>
+
+    typedef uint8_t byte;
+
+    #define HIGH 1
+    #define LOW 0
+    #define INPUT 0
+    #define OUTPUT 1
+    #ifndef MAXFLOAT
+        #define MAXFLOAT 3.40282347e+38F
+    #endif
+    #define constrain(amt, low, high) ((amt) < (low) ? (low) : ((amt) > (high) ? (high) : (amt)))
+    using std::min;
+    using std::max;
+
+    void setup();
+    void loop();
+
+    unsigned long millis();
+    unsigned long micros();
+    uint64_t micros64();
+    void delay(unsigned long ms);
+    void yield();
+    void pinMode(uint8_t pin, uint8_t mode);
+    void digitalWrite(uint8_t pin, uint8_t value);
+    int digitalRead(uint8_t pin);
+    void configTime(int timezone, int daylightOffsetSecs, const char *server1, const char *server2 = nullptr, const char *server3 = nullptr);
+
+    class Print {
+        public:
+            virtual ~Print() {}
+            virtual size_t write(uint8_t value) = 0;
+            virtual size_t write(const uint8_t *buffer, size_t size) = 0;
+            virtual int    availableForWrite() { return 0; }
+
+            size_t         write             (const char *text)       ;
+            size_t         print             (const char *text)       ;
+            size_t         print             (const String &text)     ;
+            size_t         print             (const __FlashStringHelper *text);
+            size_t         print             (char value)             ;
+            size_t         print             (int value, int base = 10);
+            size_t         print             (unsigned int value, int base = 10);
+            size_t         print             (long value, int base = 10);
+            size_t         print             (unsigned long value, int base = 10);
+            size_t         print             (double value, int digits = 2);
+            size_t         println           (const char *text = "")  ;
+            size_t         println           (const String &text)     ;
+            size_t         println           (const __FlashStringHelper *text);
+            size_t         println           (int value, int base = 10);
+            size_t         println           (unsigned int value, int base = 10);
+            size_t         println           (long value, int base = 10);
+            size_t         println           (unsigned long value, int base = 10);
+            size_t         printf            (const char *format, ...) __attribute__((format(printf, 2, 3)));
+    };
+
+    class Stream : public Print {
+        protected:
+            unsigned long  timeoutMillis    = 1000ul;
+
+        public:
+            virtual int    available         ()                       = 0;
+            virtual int    read              ()                       = 0;
+            virtual int    peek              ()                       = 0;
+
+            void           setTimeout        (unsigned long timeout)  ;
+            size_t         readBytes         (char *buffer, size_t length);
+            size_t         readBytes         (uint8_t *buffer, size_t length);
+    };
+
+    class HardwareSerial : public Stream {
+        private:
+            char           line             [256];
+            size_t         lineLength       = 0;
+
+        public:
+            void           begin             (unsigned long baud)     ;
+            size_t         write             (uint8_t value) override ;
+            size_t         write             (const uint8_t *buffer, size_t size) override;
+            int            available         () override              ;
+            int            read              () override              ;
+            int            peek              () override              ;
+            void           flush             ()                       ;
+            using Print::write;
+    };
+
+    extern HardwareSerial Serial;
+
+    struct rst_info {
+        uint32_t       reason           ;
+        uint32_t       exccause         ;
+        uint32_t       epc1             ;
+        uint32_t       epc2             ;
+        uint32_t       epc3             ;
+        uint32_t       excvaddr         ;
+        uint32_t       depc             ;
+    };
+
+    enum rst_reason {
+        REASON_DEFAULT_RST = 0,
+        REASON_WDT_RST = 1,
+        REASON_EXCEPTION_RST = 2,
+        REASON_SOFT_WDT_RST = 3,
+        REASON_SOFT_RESTART = 4,
+        REASON_DEEP_SLEEP_AWAKE = 5,
+        REASON_EXT_SYS_RST = 6
+    };
+
+    enum RFMode {
+        RF_DEFAULT = 0,
+        RF_CAL = 1,
+        RF_NO_CAL = 2,
+        RF_DISABLED = 4
+    };
+    #define WAKE_RF_DEFAULT RF_DEFAULT
+
+    class EspClass {
+        private:
+            rst_info       resetInfo        ;
+            long           flashBytesToCut  = -1; // Flash bytes erased or written before power is cut; -1 for never
+
+            size_t         takeFlashBytes    (size_t size)            ;
+
+        public:
+            [[noreturn]] void restart        ()                       ;
+            [[noreturn]] void deepSleep      (uint64_t timeMicros, RFMode mode = RF_DEFAULT);
+            [[noreturn]] void deepSleepInstant(uint64_t timeMicros, RFMode mode = RF_DEFAULT);
+            uint64_t       deepSleepMax      ()                       ;
+            rst_info*      getResetInfoPtr   ()                       ;
+            String         getResetReason    ()                       ;
+            bool           rtcUserMemoryRead (uint32_t offset, uint32_t *data, size_t size);
+            bool           rtcUserMemoryWrite(uint32_t offset, uint32_t *data, size_t size);
+            uint32_t       getFreeHeap       ()                       ;
+            uint32_t       getMaxFreeBlockSize()                      ;
+            uint8_t        getHeapFragmentation()                     ;
+            void           getHeapStats      (uint32_t *free, uint32_t *max, uint8_t *fragmentation);
+            uint32_t       getCycleCount     ()                       ;
+            uint8_t        getCpuFreqMHz     ()                       ;
+            uint32_t       random            ()                       ;
+            uint8_t*       random            (uint8_t *buffer, size_t length);
+            uint32_t       getChipId         ()                       ;
+            const char*    getFullVersion    ()                       ;
+            uint32_t       getFreeSketchSpace()                       ;
+            bool           flashEraseSector  (uint32_t sector)        ;
+            bool           flashWrite        (uint32_t address, const uint32_t *data, size_t size);
+            bool           flashRead         (uint32_t address, uint32_t *data, size_t size);
+            void           cutPowerAfterFlash(long bytes)           ; // Emulator only
+    };
+
+    extern EspClass ESP;
+
+#endif
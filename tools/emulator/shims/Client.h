@@ -0,0 +1,26 @@
+/*
+    Client - The emulator's stand in for the Arduino Client interface.
+
+    Written by: Scott Griffis
+    Date: 10-19-2026
+*/
+
+#ifndef Client_h
+    #define Client_h
+
+    #include <Arduino.h>
+    #include <IPAddress.h>
+
+    class Client : public Stream {
+        public:
+            virtual int    connect           (IPAddress ip, uint16_t port) = 0;
+            virtual int    connect           (const char *host, uint16_t port) = 0;
+            virtual int    read              (uint8_t *buffer, size_t size) = 0;
+            virtual void   flush             ()                       = 0;
+            virtual void   stop              ()                       = 0;
+            virtual uint8_t connected        ()                       = 0;
+            virtual operator bool            ()                       = 0;
+            using Stream::read;
+    };
+
+#endif
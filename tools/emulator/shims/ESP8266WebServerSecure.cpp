@@ -0,0 +1,799 @@
+/*
+    ESP8266WebServerSecure - The emulator's stand in for the ESP8266 core's
+    web server, serving plain HTTP as TLS is not emulated.
+
+    Written by: Scott Griffis
+    Date: 10-19-2026
+*/
+
+#include "ESP8266WebServerSecure.h"
+#include <MD5Builder.h>
+
+#define HTTP_MAX_LINE_LENGTH 2048
+
+namespace BearSSL {
+    static const char *METHOD_NAMES[] = {"ANY", "GET", "HEAD", "POST", "PUT", "PATCH", "DELETE", "OPTIONS"};
+
+    /**
+     * Decodes base64 text, stopping at the first char not of the alphabet.
+    */
+    static String decodeBase64(const String &text) {
+        String decoded;
+        uint32_t bits = 0;
+        int bitCount = 0;
+        for (unsigned int i = 0; i < text.length(); i++) {
+            char c = text[i];
+            int value;
+            if (c >= 'A' && c <= 'Z') {
+                value = c - 'A';
+            } else if (c >= 'a' && c <= 'z') {
+                value = c - 'a' + 26;
+            } else if (c >= '0' && c <= '9') {
+                value = c - '0' + 52;
+            } else if (c == '+') {
+                value = 62;
+            } else if (c == '/') {
+                value = 63;
+            } else { // Padding or the end...
+                break;
+            }
+            bits = (bits << 6) | (uint32_t) value;
+            bitCount += 6;
+            if (bitCount >= 8) {
+                bitCount -= 8;
+                decoded += (char) ((bits >> bitCount) & 0xFF);
+            }
+        }
+
+        return decoded;
+    }
+
+    static String hashText(const String &text) {
+        MD5Builder builder;
+        builder.begin();
+        builder.add(text);
+        builder.calculate();
+
+        return builder.toString();
+    }
+
+    void ESP8266WebServerSecure::begin() {
+        server.begin();
+    }
+
+    void ESP8266WebServerSecure::close() {
+        closeClient();
+        server.close();
+    }
+
+    void ESP8266WebServerSecure::stop() {
+        close();
+    }
+
+    /**
+     * Takes the next connection waiting, or answers the current one once
+     * its request is in. Connections are turned away while the device is
+     * off the network, which they couldn't reach on the hardware.
+    */
+    void ESP8266WebServerSecure::handleClient() {
+        if (!currentClient.connected()) { // None under way; Take the next...
+            currentClient.stop();
+            if (!server.hasClient()) {
+
+                return;
+            }
+            currentClient = ClientType(server.accept());
+            clientMillis = millis();
+            if (WiFi.status() != WL_CONNECTED && (WiFi.getMode() & WIFI_AP) == 0) { // Unreachable...
+                closeClient();
+
+                return;
+            }
+        }
+        if (currentClient.available() == 0) { // Request not in yet...
+            if ((millis() - clientMillis) >= HTTP_MAX_DATA_WAIT) { // Given up on...
+                closeClient();
+            }
+
+            return;
+        }
+        handleRequest();
+        closeClient();
+    }
+
+    /**
+     * Checks the credentials the client sent, by Basic or Digest
+     * authentication, against those given.
+     *
+     * @param username The user allowed as const char*.
+     * @param password Its password as const char*.
+     *
+     * @return Returns true if they match otherwise false as bool.
+    */
+    bool ESP8266WebServerSecure::authenticate(const char *username, const char *password) {
+        if (authorization.startsWith("Basic ")) {
+            String expected = String(username) + ":" + password;
+
+            return decodeBase64(authorization.substring(6)).equals(expected);
+        } else if (authorization.startsWith("Digest ")) {
+
+            return checkDigest(username, password);
+        }
+
+        return false;
+    }
+
+    /**
+     * Asks the client for credentials, with the given message as the
+     * page shown should it not give any.
+    */
+    void ESP8266WebServerSecure::requestAuthentication(HTTPAuthMethod mode, const char *realm, const String &authFailMsg) {
+        this->realm = (realm != nullptr ? realm : "Login Required");
+        if (mode == BASIC_AUTH) {
+            sendHeader("WWW-Authenticate", "Basic realm=\"" + this->realm + "\"");
+        } else {
+            char random[33];
+            snprintf(random, sizeof(random), "%08x%08x%08x%08x", ESP.random(), ESP.random(), ESP.random(), ESP.random());
+            nonce = random;
+            snprintf(random, sizeof(random), "%08x%08x%08x%08x", ESP.random(), ESP.random(), ESP.random(), ESP.random());
+            opaque = random;
+            sendHeader("WWW-Authenticate", "Digest realm=\"" + this->realm + "\", qop=\"auth\", nonce=\"" + nonce + "\", opaque=\"" + opaque + "\"");
+        }
+        send(401, "text/html", authFailMsg);
+    }
+
+    void ESP8266WebServerSecure::on(const Uri &uri, THandlerFunction handler) {
+        on(uri, HTTP_ANY, handler);
+    }
+
+    void ESP8266WebServerSecure::on(const Uri &uri, HTTPMethod method, THandlerFunction handler) {
+        if (routeCount >= WEB_MAX_ROUTES) { // No room...
+            Serial.printf("Emulator: Too many web routes; %s not served\n", uri.getPath().c_str());
+
+            return;
+        }
+        routes[routeCount++] = {uri.getPath(), method, handler};
+    }
+
+    void ESP8266WebServerSecure::onNotFound(THandlerFunction handler) {
+        notFoundHandler = handler;
+    }
+
+    void ESP8266WebServerSecure::onFileUpload(THandlerFunction handler) {
+        uploadHandler = handler;
+    }
+
+    const String& ESP8266WebServerSecure::uri() const {
+
+        return currentUri;
+    }
+
+    HTTPMethod ESP8266WebServerSecure::method() const {
+
+        return currentMethod;
+    }
+
+    ESP8266WebServerSecure::ClientType& ESP8266WebServerSecure::client() {
+
+        return currentClient;
+    }
+
+    const String& ESP8266WebServerSecure::arg(const String &name) const {
+        for (uint8_t i = 0; i < argCount; i++) {
+            if (argPairs[i].name.equals(name)) {
+
+                return argPairs[i].value;
+            }
+        }
+
+        return emptyString;
+    }
+
+    const String& ESP8266WebServerSecure::arg(int i) const {
+
+        return (i >= 0 && i < argCount ? argPairs[i].value : emptyString);
+    }
+
+    const String& ESP8266WebServerSecure::argName(int i) const {
+
+        return (i >= 0 && i < argCount ? argPairs[i].name : emptyString);
+    }
+
+    int ESP8266WebServerSecure::args() const {
+
+        return argCount;
+    }
+
+    bool ESP8266WebServerSecure::hasArg(const String &name) const {
+        for (uint8_t i = 0; i < argCount; i++) {
+            if (argPairs[i].name.equals(name)) {
+
+                return true;
+            }
+        }
+
+        return false;
+    }
+
+    /**
+     * Sets the headers kept for handlers, indexed in the order given.
+    */
+    void ESP8266WebServerSecure::collectHeaders(const char *headerKeys[], const size_t headerKeysCount) {
+        headerCount = (uint8_t) min(headerKeysCount, (size_t) WEB_MAX_HEADERS);
+        for (uint8_t i = 0; i < headerCount; i++) {
+            headerPairs[i] = {headerKeys[i], emptyString};
+        }
+    }
+
+    const String& ESP8266WebServerSecure::header(const String &name) const {
+        for (uint8_t i = 0; i < headerCount; i++) {
+            if (headerPairs[i].name.equalsIgnoreCase(name)) {
+
+                return headerPairs[i].value;
+            }
+        }
+
+        return emptyString;
+    }
+
+    const String& ESP8266WebServerSecure::header(int i) const {
+
+        return (i >= 0 && i < headerCount ? headerPairs[i].value : emptyString);
+    }
+
+    const String& ESP8266WebServerSecure::headerName(int i) const {
+
+        return (i >= 0 && i < headerCount ? headerPairs[i].name : emptyString);
+    }
+
+    int ESP8266WebServerSecure::headers() const {
+
+        return headerCount;
+    }
+
+    bool ESP8266WebServerSecure::hasHeader(const String &name) const {
+
+        return (header(name).length() > 0);
+    }
+
+    void ESP8266WebServerSecure::send(int code, const char *contentType, const String &content) {
+        send(code, contentType, content.c_str(), content.length());
+    }
+
+    void ESP8266WebServerSecure::send(int code, const String &contentType, const String &content) {
+        send(code, contentType.c_str(), content.c_str(), content.length());
+    }
+
+    void ESP8266WebServerSecure::send(int code, const char *contentType, const char *content) {
+        send(code, contentType, content, strlen(content));
+    }
+
+    /**
+     * Sends the response, or only its head if the length was set as
+     * unknown; The content then follows with sendContent().
+    */
+    void ESP8266WebServerSecure::send(int code, const char *contentType, const char *content, size_t contentLength) {
+        sendResponseHead(code, contentType, contentLength);
+        if (contentLength > 0 && currentMethod != HTTP_HEAD) {
+            sendContent(content, contentLength);
+        }
+    }
+
+    void ESP8266WebServerSecure::send(int code, const char *contentType, const uint8_t *content, size_t contentLength) {
+        send(code, contentType, (const char *) content, contentLength);
+    }
+
+    void ESP8266WebServerSecure::send_P(int code, PGM_P contentType, PGM_P content) {
+        send(code, contentType, content, strlen(content));
+    }
+
+    void ESP8266WebServerSecure::send_P(int code, PGM_P contentType, PGM_P content, size_t contentLength) {
+        send(code, contentType, content, contentLength);
+    }
+
+    /**
+     * Adds a header to the response. Headers are added to the end in
+     * place, so once the buffer has grown they allocate nothing.
+    */
+    void ESP8266WebServerSecure::sendHeader(const String &name, const String &value, bool first) {
+        if (first) { // Rare; Built whole to go in front...
+            String line = name + ": " + value + "\r\n";
+            pendingHeaders = line + pendingHeaders;
+
+            return;
+        }
+        pendingHeaders.concat(name);
+        pendingHeaders.concat(": ");
+        pendingHeaders.concat(value);
+        pendingHeaders.concat("\r\n");
+    }
+
+    void ESP8266WebServerSecure::setContentLength(const size_t contentLength) {
+        this->contentLength = contentLength;
+    }
+
+    void ESP8266WebServerSecure::sendContent(const String &content) {
+        sendContent(content.c_str(), content.length());
+    }
+
+    void ESP8266WebServerSecure::sendContent(const char *content) {
+        sendContent(content, strlen(content));
+    }
+
+    /**
+     * Sends more of the response. When sent in chunks, nothing sent
+     * ends the response.
+    */
+    void ESP8266WebServerSecure::sendContent(const char *content, size_t length) {
+        if (isChunked) {
+            writeChunk(content, length);
+        } else if (length > 0) {
+            currentClient.write((const uint8_t *) content, length);
+        }
+    }
+
+    void ESP8266WebServerSecure::sendContent_P(PGM_P content) {
+        sendContent(content, strlen(content));
+    }
+
+    void ESP8266WebServerSecure::sendContent_P(PGM_P content, size_t length) {
+        sendContent(content, length);
+    }
+
+    /**
+     * Adds a hook, called with each request once its request line is
+     * in. Hooks are called in the order added until one doesn't let the
+     * request continue.
+    */
+    void ESP8266WebServerSecure::addHook(HookFunction hook) {
+        if (!this->hook) { // First...
+            this->hook = hook;
+
+            return;
+        }
+        HookFunction earlier = this->hook;
+        this->hook = [earlier, hook](const String &method, const String &url, WiFiClient *client, ContentTypeFunction contentType) {
+            ClientFuture future = earlier(method, url, client, contentType);
+
+            return (future == CLIENT_REQUEST_CAN_CONTINUE ? hook(method, url, client, contentType) : future);
+        };
+    }
+
+    WiFiServerSecure& ESP8266WebServerSecure::getServer() {
+
+        return server;
+    }
+
+    /*
+    =================================================================
+    Private Functions
+    =================================================================
+    */
+
+    /**
+     * #### PRIVATE ####
+     * Used to read and answer the request of the current client.
+     *
+     * @return Returns true if answered otherwise false as bool.
+    */
+    bool ESP8266WebServerSecure::handleRequest() {
+        inputLength = 0;
+        inputOffset = 0;
+        argCount = 0;
+        authorization.clear();
+        contentType.clear();
+        pendingHeaders.clear();
+        contentLength = CONTENT_LENGTH_NOT_SET;
+        isChunked = false;
+        isChunkEnded = false;
+        isResponseSent = false;
+        for (uint8_t i = 0; i < headerCount; i++) {
+            headerPairs[i].value.clear();
+        }
+
+        /* Request Line */
+        String line;
+        if (!readLine(line)) {
+
+            return false;
+        }
+        int methodEnd = line.indexOf(' ');
+        int urlEnd = (methodEnd > 0 ? line.indexOf(' ', methodEnd + 1) : -1);
+        if (urlEnd < 0) { // Not HTTP...
+
+            return false;
+        }
+        currentMethodName = line.substring(0, methodEnd);
+        String url = line.substring(methodEnd + 1, urlEnd);
+        currentMethod = HTTP_ANY;
+        for (uint8_t i = HTTP_GET; i <= HTTP_OPTIONS; i++) {
+            if (currentMethodName.equals(METHOD_NAMES[i])) {
+                currentMethod = (HTTPMethod) i;
+            }
+        }
+        int queryStart = url.indexOf('?');
+        currentUri = (queryStart >= 0 ? url.substring(0, queryStart) : url);
+
+        if (hook) { // Asked to look first...
+            ClientFuture future = hook(currentMethodName, url, &currentClient, getContentType);
+            if (future == CLIENT_IS_GIVEN) { // Hook keeps it; Leave it open...
+                currentClient = ClientType();
+
+                return true;
+            } else if (future != CLIENT_REQUEST_CAN_CONTINUE) { // Turned away or answered...
+
+                return true;
+            }
+        }
+
+        /* Headers And Body */
+        size_t bodyLength = 0;
+        if (!readRequestHead(bodyLength)) {
+
+            return false;
+        }
+        if (queryStart >= 0) {
+            parseArgs(url.substring(queryStart + 1));
+        }
+        bool isUpload = false;
+        if (bodyLength > HTTP_MAX_BODY_SIZE) { // Won't fit on the device...
+            send(413, "text/plain", "Request too large");
+
+            return true;
+        } else if (bodyLength > 0) {
+            String body;
+            if (!readBody(bodyLength, body)) {
+
+                return false;
+            }
+            if (contentType.startsWith("application/x-www-form-urlencoded")) {
+                parseArgs(body);
+            } else if (contentType.startsWith("multipart/form-data")) {
+                isUpload = true;
+            } else {
+                addArg("plain", body);
+            }
+        }
+
+        /* Handler */
+        Route *route = nullptr;
+        for (uint8_t i = 0; i < routeCount && route == nullptr; i++) {
+            if ((routes[i].method == HTTP_ANY || routes[i].method == currentMethod) && routes[i].path.equals(currentUri)) {
+                route = &routes[i];
+            }
+        }
+        if (isUpload && uploadHandler) {
+            uploadHandler();
+        }
+        if (isResponseSent) { // Upload handler answered...
+        } else if (route != nullptr) {
+            route->handler();
+        } else if (notFoundHandler) {
+            notFoundHandler();
+        } else {
+            send(404, "text/plain", "Not found: " + currentUri);
+        }
+        if (isChunked && !isChunkEnded) { // Handler left the response open...
+            writeChunk(nullptr, 0);
+        }
+
+        return true;
+    }
+
+    /**
+     * #### PRIVATE ####
+     * Used to read the request's headers, keeping those collected along
+     * with the few the server needs itself.
+     *
+     * @param bodyLength Receives the length of the body to follow as size_t&.
+     *
+     * @return Returns true if read otherwise false as bool.
+    */
+    bool ESP8266WebServerSecure::readRequestHead(size_t &bodyLength) {
+        String line;
+        while (readLine(line)) {
+            if (line.length() == 0) { // End of the headers...
+
+                return true;
+            }
+            int colon = line.indexOf(':');
+            if (colon <= 0) { // Not a header...
+                continue;
+            }
+            String name = line.substring(0, colon);
+            String value = line.substring(colon + 1);
+            value.trim();
+            if (name.equalsIgnoreCase("Authorization")) {
+                authorization = value;
+            } else if (name.equalsIgnoreCase("Content-Type")) {
+                contentType = value;
+            } else if (name.equalsIgnoreCase("Content-Length")) {
+                bodyLength = (size_t) max(0l, value.toInt());
+            }
+            for (uint8_t i = 0; i < headerCount; i++) {
+                if (headerPairs[i].name.equalsIgnoreCase(name)) {
+                    headerPairs[i].value = value;
+                }
+            }
+        }
+
+        return false;
+    }
+
+    bool ESP8266WebServerSecure::readBody(size_t bodyLength, String &body) {
+        body.reserve(bodyLength);
+        while (body.length() < bodyLength) {
+            int value = readByte();
+            if (value < 0) { // Cut short...
+
+                return false;
+            }
+            body += (char) value;
+        }
+
+        return true;
+    }
+
+    /**
+     * #### PRIVATE ####
+     * Used to read the next byte of the request, waiting for more to
+     * arrive for up to HTTP_MAX_POST_WAIT.
+     *
+     * @return Returns the byte, or -1 if none came as int.
+    */
+    int ESP8266WebServerSecure::readByte() {
+        while (inputOffset >= inputLength) {
+            int count = currentClient.read(input, sizeof(input));
+            if (count > 0) { // More in...
+                inputLength = (size_t) count;
+                inputOffset = 0;
+                clientMillis = millis();
+            } else if (!currentClient.connected() || (millis() - clientMillis) >= HTTP_MAX_POST_WAIT) { // Gone or given up on...
+
+                return -1;
+            } else {
+                delay(1);
+            }
+        }
+
+        return input[inputOffset++];
+    }
+
+    bool ESP8266WebServerSecure::readLine(String &line) {
+        line.clear();
+        while (true) {
+            int value = readByte();
+            if (value < 0) {
+
+                return false;
+            } else if (value == '\n') { // End of the line...
+                if (line.length() > 0 && line[line.length() - 1] == '\r') {
+                    line = line.substring(0, line.length() - 1);
+                }
+
+                return true;
+            } else if (line.length() < HTTP_MAX_LINE_LENGTH) {
+                line += (char) value;
+            }
+        }
+    }
+
+    void ESP8266WebServerSecure::parseArgs(const String &text) {
+        unsigned int start = 0;
+        while (start < text.length()) {
+            int end = text.indexOf('&', start);
+            String pair = (end >= 0 ? text.substring(start, end) : text.substring(start));
+            int equals = pair.indexOf('=');
+            if (pair.length() > 0) {
+                addArg(urlDecode(equals >= 0 ? pair.substring(0, equals) : pair), urlDecode(equals >= 0 ? pair.substring(equals + 1) : emptyString));
+            }
+            start = (end >= 0 ? (unsigned int) end + 1 : text.length());
+        }
+    }
+
+    void ESP8266WebServerSecure::addArg(const String &name, const String &value) {
+        if (argCount < WEB_MAX_ARGS) {
+            argPairs[argCount++] = {name, value};
+        }
+    }
+
+    /**
+     * #### PRIVATE ####
+     * Used to close the current connection. What the client sent that
+     * wasn't read is taken first, so the close doesn't reset the
+     * connection ahead of the response.
+    */
+    void ESP8266WebServerSecure::closeClient() {
+        uint8_t unread[256];
+        while (currentClient.available() > 0 && currentClient.read(unread, sizeof(unread)) > 0) {}
+        currentClient.stop();
+        inputLength = 0;
+        inputOffset = 0;
+    }
+
+    void ESP8266WebServerSecure::sendResponseHead(int code, const char *contentType, size_t length) {
+        char head[256];
+        size_t headLength = snprintf(head, sizeof(head), "HTTP/1.1 %d %s\r\n", code, getStatusText(code));
+        if (contentType != nullptr && contentType[0] != '\0') {
+            headLength += snprintf(&head[headLength], sizeof(head) - headLength, "Content-Type: %.96s\r\n", contentType);
+        }
+        if (this->contentLength == CONTENT_LENGTH_UNKNOWN) { // Sent in chunks...
+            isChunked = true;
+            headLength += snprintf(&head[headLength], sizeof(head) - headLength, "Transfer-Encoding: chunked\r\n");
+        } else {
+            size_t bodyLength = (this->contentLength != CONTENT_LENGTH_NOT_SET ? this->contentLength : length);
+            headLength += snprintf(&head[headLength], sizeof(head) - headLength, "Content-Length: %lu\r\n", (unsigned long) bodyLength);
+        }
+        headLength += snprintf(&head[headLength], sizeof(head) - headLength, "Connection: close\r\n");
+        pendingHeaders.concat("\r\n"); // Ends the head
+        currentClient.write((const uint8_t *) head, headLength);
+        currentClient.write((const uint8_t *) pendingHeaders.c_str(), pendingHeaders.length());
+        pendingHeaders.clear();
+        this->contentLength = CONTENT_LENGTH_NOT_SET;
+        isResponseSent = true;
+    }
+
+    /**
+     * #### PRIVATE ####
+     * Used to send a chunk of the response, in one write if it fits the
+     * buffer; An empty one ends the response.
+    */
+    void ESP8266WebServerSecure::writeChunk(const char *data, size_t length) {
+        if (isChunkEnded) {
+
+            return;
+        }
+        char chunk[1024];
+        int prefixLength = snprintf(chunk, sizeof(chunk), "%zx\r\n", length);
+        const char *suffix = (length == 0 ? "\r\n\r\n" : "\r\n");
+        size_t suffixLength = strlen(suffix);
+        if (prefixLength + length + suffixLength <= sizeof(chunk)) { // Fits; One write...
+            memcpy(&chunk[prefixLength], data, length);
+            memcpy(&chunk[prefixLength + length], suffix, suffixLength);
+            currentClient.write((const uint8_t *) chunk, prefixLength + length + suffixLength);
+        } else {
+            currentClient.write((const uint8_t *) chunk, prefixLength);
+            currentClient.write((const uint8_t *) data, length);
+            currentClient.write((const uint8_t *) suffix, suffixLength);
+        }
+        isChunkEnded = (length == 0);
+    }
+
+    /**
+     * #### PRIVATE ####
+     * Used to check a Digest authorization, which must answer the last
+     * challenge sent.
+    */
+    bool ESP8266WebServerSecure::checkDigest(const char *username, const char *password) {
+        String user = getDigestParam(authorization, "username");
+        String givenRealm = getDigestParam(authorization, "realm");
+        String givenNonce = getDigestParam(authorization, "nonce");
+        String givenOpaque = getDigestParam(authorization, "opaque");
+        String givenUri = getDigestParam(authorization, "uri");
+        String response = getDigestParam(authorization, "response");
+        String qop = getDigestParam(authorization, "qop");
+        if (
+            !user.equals(username) || givenUri.length() == 0 || response.length() == 0
+            || nonce.length() == 0 || !givenNonce.equals(nonce) || !givenOpaque.equals(opaque) || !givenRealm.equals(realm)
+        ) { // Not an answer to the challenge...
+
+            return false;
+        }
+        String hashA1 = hashText(user + ":" + realm + ":" + password);
+        String hashA2 = hashText(currentMethodName + ":" + givenUri);
+        String expected = (
+            qop.startsWith("auth")
+                ? hashText(hashA1 + ":" + givenNonce + ":" + getDigestParam(authorization, "nc") + ":" + getDigestParam(authorization, "cnonce") + ":" + qop + ":" + hashA2)
+                : hashText(hashA1 + ":" + givenNonce + ":" + hashA2)
+        );
+
+        return response.equals(expected);
+    }
+
+    /**
+     * #### PRIVATE ####
+     * Used to get a parameter of a Digest authorization, quoted or not.
+    */
+    String ESP8266WebServerSecure::getDigestParam(const String &authorization, const char *name) {
+        unsigned int position = 7; // After "Digest "
+        while (position < authorization.length()) {
+            while (authorization[position] == ' ' || authorization[position] == ',') {
+                position++;
+            }
+            int equals = authorization.indexOf('=', position);
+            if (equals < 0) {
+                break;
+            }
+            String key = authorization.substring(position, equals);
+            key.trim();
+            unsigned int valueStart = equals + 1;
+            int valueEnd;
+            if (authorization[valueStart] == '"') { // Quoted...
+                valueStart++;
+                valueEnd = authorization.indexOf('"', valueStart);
+            } else {
+                valueEnd = authorization.indexOf(',', valueStart);
+            }
+            if (valueEnd < 0) {
+                valueEnd = authorization.length();
+            }
+            if (key.equals(name)) {
+
+                return authorization.substring(valueStart, valueEnd);
+            }
+            position = valueEnd + 1;
+        }
+
+        return emptyString;
+    }
+
+    String ESP8266WebServerSecure::urlDecode(const String &text) {
+        String decoded;
+        decoded.reserve(text.length());
+        for (unsigned int i = 0; i < text.length(); i++) {
+            char c = text[i];
+            if (c == '+') {
+                decoded += ' ';
+            } else if (c == '%' && (i + 2) < text.length()) {
+                char hex[3] = {text[i + 1], text[i + 2], '\0'};
+                decoded += (char) strtol(hex, nullptr, 16);
+                i += 2;
+            } else {
+                decoded += c;
+            }
+        }
+
+        return decoded;
+    }
+
+    const char* ESP8266WebServerSecure::getStatusText(int code) {
+        switch (code) {
+            case 200: return "OK";
+            case 204: return "No Content";
+            case 301: return "Moved Permanently";
+            case 302: return "Found";
+            case 303: return "See Other";
+            case 304: return "Not Modified";
+            case 400: return "Bad Request";
+            case 401: return "Unauthorized";
+            case 403: return "Forbidden";
+            case 404: return "Not Found";
+            case 405: return "Method Not Allowed";
+            case 413: return "Payload Too Large";
+            case 429: return "Too Many Requests";
+            case 500: return "Internal Server Error";
+            case 503: return "Service Unavailable";
+            default: return "";
+        }
+    }
+
+    String ESP8266WebServerSecure::getContentType(const String &path) {
+        if (path.endsWith(".html") || path.endsWith(".htm")) {
+
+            return F("text/html");
+        } else if (path.endsWith(".css")) {
+
+            return F("text/css");
+        } else if (path.endsWith(".js")) {
+
+            return F("application/javascript");
+        } else if (path.endsWith(".json")) {
+
+            return F("application/json");
+        } else if (path.endsWith(".png")) {
+
+            return F("image/png");
+        } else if (path.endsWith(".svg")) {
+
+            return F("image/svg+xml");
+        } else if (path.endsWith(".ico")) {
+
+            return F("image/x-icon");
+        } else if (path.endsWith(".gz")) {
+
+            return F("application/x-gzip");
+        }
+
+        return F("application/octet-stream");
+    }
+}
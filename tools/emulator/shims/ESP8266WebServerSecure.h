@@ -0,0 +1,162 @@
+/*
+    ESP8266WebServerSecure - The emulator's stand in for the ESP8266 core's
+    web server, serving plain HTTP as TLS is not emulated.
+
+    It handles one connection at a time and closes it once answered, as
+    the core does. A connection waits for its request across calls to
+    handleClient() rather than holding up the loop, and is given up on
+    after HTTP_MAX_DATA_WAIT. Hooks are called once the request line is
+    in, ahead of the headers, so a request turned away costs what it
+    would on the device. Only the headers asked for with collectHeaders()
+    are kept. Routes match the path exactly.
+
+    Written by: Scott Griffis
+    Date: 10-19-2026
+*/
+
+#ifndef ESP8266WebServerSecure_h
+    #define ESP8266WebServerSecure_h
+
+    #include <functional>
+    #include <Arduino.h>
+    #include <ESP8266WiFi.h>
+    #include <WiFiClient.h>
+    #include <WiFiServerSecure.h>
+
+    #define CONTENT_LENGTH_UNKNOWN ((size_t) -1)
+    #define CONTENT_LENGTH_NOT_SET ((size_t) -2)
+    #define HTTP_MAX_DATA_WAIT 5000 // Longest a connection may wait to send its request
+    #define HTTP_MAX_POST_WAIT 5000 // Longest between parts of the request once begun
+    #define HTTP_MAX_BODY_SIZE 16384
+    #define WEB_MAX_ROUTES 32
+    #define WEB_MAX_HEADERS 8
+    #define WEB_MAX_ARGS 32
+
+    enum HTTPMethod { HTTP_ANY, HTTP_GET, HTTP_HEAD, HTTP_POST, HTTP_PUT, HTTP_PATCH, HTTP_DELETE, HTTP_OPTIONS };
+    enum HTTPAuthMethod { BASIC_AUTH, DIGEST_AUTH };
+
+    class Uri {
+        private:
+            String         path             ;
+
+        public:
+            Uri(const char *path) : path(path) {}
+            Uri(const String &path) : path(path) {}
+            Uri(const __FlashStringHelper *path) : path(path) {}
+
+            const String&  getPath           () const { return path; }
+    };
+
+    namespace BearSSL {
+        class ESP8266WebServerSecure {
+            public:
+                using ClientType = WiFiClientSecure;
+                typedef std::function<void(void)> THandlerFunction;
+                enum ClientFuture { CLIENT_REQUEST_CAN_CONTINUE, CLIENT_REQUEST_IS_HANDLED, CLIENT_MUST_STOP, CLIENT_IS_GIVEN };
+                typedef String (*ContentTypeFunction) (const String&);
+                using HookFunction = std::function<ClientFuture(const String &method, const String &url, WiFiClient *client, ContentTypeFunction contentType)>;
+
+            private:
+                struct Route {
+                    String         path             ;
+                    HTTPMethod     method           ;
+                    THandlerFunction handler        ;
+                };
+
+                struct Pair {
+                    String         name             ;
+                    String         value            ;
+                };
+
+                WiFiServerSecure server         ;
+                WiFiClientSecure currentClient  ;
+                unsigned long  clientMillis     = 0; // When the current client connected or last sent
+                HTTPMethod     currentMethod    = HTTP_ANY;
+                String         currentMethodName;
+                String         currentUri       ;
+                Route          routes           [WEB_MAX_ROUTES];
+                uint8_t        routeCount       = 0;
+                THandlerFunction notFoundHandler;
+                THandlerFunction uploadHandler  ;
+                HookFunction   hook             ;
+                Pair           headerPairs      [WEB_MAX_HEADERS];
+                uint8_t        headerCount      = 0;
+                String         authorization    ;
+                String         contentType      ;
+                Pair           argPairs         [WEB_MAX_ARGS];
+                uint8_t        argCount         = 0;
+                String         pendingHeaders   ;
+                size_t         contentLength    = CONTENT_LENGTH_NOT_SET;
+                bool           isChunked        = false;
+                bool           isChunkEnded     = false;
+                bool           isResponseSent   = false;
+                String         realm            ; // Of the last challenge sent
+                String         nonce            ;
+                String         opaque           ;
+                uint8_t        input            [512];
+                size_t         inputLength      = 0;
+                size_t         inputOffset      = 0;
+
+                bool           handleRequest     ()                       ;
+                bool           readRequestHead   (size_t &bodyLength)     ;
+                bool           readBody          (size_t bodyLength, String &body);
+                int            readByte          ()                       ;
+                bool           readLine          (String &line)           ;
+                void           parseArgs         (const String &text)     ;
+                void           addArg            (const String &name, const String &value);
+                void           closeClient       ()                       ;
+                void           sendResponseHead  (int code, const char *contentType, size_t length);
+                void           writeChunk        (const char *data, size_t length);
+                bool           checkDigest       (const char *username, const char *password);
+                static String  getDigestParam    (const String &authorization, const char *name);
+                static String  urlDecode         (const String &text)     ;
+                static const char* getStatusText (int code)               ;
+                static String  getContentType    (const String &path)     ;
+
+            public:
+                ESP8266WebServerSecure(int port = 443) : server(port) {}
+
+                void           begin             ()                       ;
+                void           close             ()                       ;
+                void           stop              ()                       ;
+                void           handleClient      ()                       ;
+                bool           authenticate      (const char *username, const char *password);
+                void           requestAuthentication(HTTPAuthMethod mode = BASIC_AUTH, const char *realm = nullptr, const String &authFailMsg = String(""));
+                void           on                (const Uri &uri, THandlerFunction handler);
+                void           on                (const Uri &uri, HTTPMethod method, THandlerFunction handler);
+                void           onNotFound        (THandlerFunction handler);
+                void           onFileUpload      (THandlerFunction handler);
+                const String&  uri               () const                 ;
+                HTTPMethod     method            () const                 ;
+                ClientType&    client            ()                       ;
+                const String&  arg               (const String &name) const;
+                const String&  arg               (int i) const            ;
+                const String&  argName           (int i) const            ;
+                int            args              () const                 ;
+                bool           hasArg            (const String &name) const;
+                void           collectHeaders    (const char *headerKeys[], const size_t headerKeysCount);
+                const String&  header            (const String &name) const;
+                const String&  header            (int i) const            ;
+                const String&  headerName        (int i) const            ;
+                int            headers           () const                 ;
+                bool           hasHeader         (const String &name) const;
+                void           send              (int code, const char *contentType = nullptr, const String &content = emptyString);
+                void           send              (int code, const String &contentType, const String &content);
+                void           send              (int code, const char *contentType, const char *content);
+                void           send              (int code, const char *contentType, const char *content, size_t contentLength);
+                void           send              (int code, const char *contentType, const uint8_t *content, size_t contentLength);
+                void           send_P            (int code, PGM_P contentType, PGM_P content);
+                void           send_P            (int code, PGM_P contentType, PGM_P content, size_t contentLength);
+                void           sendHeader        (const String &name, const String &value, bool first = false);
+                void           setContentLength  (const size_t contentLength);
+                void           sendContent       (const String &content)  ;
+                void           sendContent       (const char *content)    ;
+                void           sendContent       (const char *content, size_t length);
+                void           sendContent_P     (PGM_P content)          ;
+                void           sendContent_P     (PGM_P content, size_t length);
+                void           addHook           (HookFunction hook)      ;
+                WiFiServerSecure& getServer      ()                       ;
+        };
+    }
+
+#endif
@@ -0,0 +1,425 @@
+/*
+    ESP8266WiFi - The emulator's stand in for the ESP8266 WiFi stack.
+
+    Written by: Scott Griffis
+    Date: 10-19-2026
+*/
+
+#include "ESP8266WiFi.h"
+#include "Emulator.h"
+
+#define WIFI_SCAN_JOIN_MILLIS 1500 // Scan for the network then associate
+#define WIFI_DIRECT_JOIN_MILLIS 300 // Associate with a known access point on a known channel
+#define WIFI_DHCP_MILLIS 400
+#define WIFI_STATIC_MILLIS 20
+#define WIFI_CHANNEL 6
+#define WIFI_SUBNET_MASK IPAddress(255, 0, 0, 0)
+#define WIFI_GATEWAY IPAddress(127, 0, 0, 1)
+
+ESP8266WiFiClass WiFi;
+
+const uint8_t ACCESS_POINT_BSSID[6] = {0x02, 0x00, 0x00, 0x00, 0x00, 0x01};
+
+bool ESP8266WiFiClass::mode(WiFiMode_t mode) {
+    if (mode != mode_ && (mode & WIFI_STA) == 0) { // Station turned off...
+        disconnect();
+    }
+    mode_ = mode;
+
+    return true;
+}
+
+WiFiMode_t ESP8266WiFiClass::getMode() {
+
+    return mode_;
+}
+
+/**
+ * Starts joining the network, raising the connected event once
+ * associated and the got IP event once addressed. Any join under
+ * way is abandoned.
+ *
+ * @param ssid The network to join as const char*.
+ * @param passphrase Its password as const char*.
+ * @param channel The channel of the access point; 0 if not known as int32_t.
+ * @param bssid The access point to join; nullptr if not known as const uint8_t*.
+ * @param connect False to only store the network as bool.
+ *
+ * @return Returns the status once the join has started as wl_status_t.
+*/
+wl_status_t ESP8266WiFiClass::begin(const char *ssid, const char *passphrase, int32_t channel, const uint8_t *bssid, bool connect) {
+    if (ssid != ssid_) { // Not rejoining...
+        strncpy(ssid_, (ssid != nullptr ? ssid : ""), sizeof(ssid_) - 1);
+        ssid_[sizeof(ssid_) - 1] = '\0';
+    }
+    if (!connect) { // Stored only...
+
+        return status_;
+    }
+    if ((mode_ & WIFI_STA) == 0) { // Joining turns the station on...
+        mode_ = (WiFiMode_t) (mode_ | WIFI_STA);
+    }
+    status_ = WL_DISCONNECTED;
+    uint32_t generation = ++joinGeneration;
+    bool isDirect = (bssid != nullptr && channel > 0);
+    Emulator::schedule(
+        (isDirect ? WIFI_DIRECT_JOIN_MILLIS : WIFI_SCAN_JOIN_MILLIS),
+        [this, generation]() { attemptJoin(generation); }
+    );
+
+    return status_;
+}
+
+wl_status_t ESP8266WiFiClass::begin(const String &ssid, const String &passphrase, int32_t channel, const uint8_t *bssid, bool connect) {
+
+    return begin(ssid.c_str(), passphrase.c_str(), channel, bssid, connect);
+}
+
+/**
+ * Sets static addressing, or DHCP if the address is 0.0.0.0. Only an
+ * address on the loopback network can be taken; Any other leaves the
+ * device on the address the emulator gave it. The subnet and gateway
+ * are always those of the emulated network.
+*/
+bool ESP8266WiFiClass::config(IPAddress localIp, IPAddress gateway, IPAddress subnet, IPAddress dns1, IPAddress dns2) {
+    staticIp = (localIp[0] == 127 ? localIp : IPAddress(0, 0, 0, 0));
+
+    return true;
+}
+
+bool ESP8266WiFiClass::reconnect() {
+
+    return (begin(ssid_) != WL_CONNECT_FAILED);
+}
+
+bool ESP8266WiFiClass::disconnect(bool isWifiOff) {
+    bool wasConnected = (status_ == WL_CONNECTED);
+    joinGeneration++;
+    status_ = WL_DISCONNECTED;
+    if (wasConnected) { // The stack tells of the leave...
+        Emulator::schedule(0, [this]() { raiseDisconnected(WIFI_DISCONNECT_REASON_ASSOC_LEAVE); });
+    }
+
+    return true;
+}
+
+bool ESP8266WiFiClass::isConnected() {
+
+    return (status_ == WL_CONNECTED);
+}
+
+bool ESP8266WiFiClass::setAutoReconnect(bool isAutoReconnect) {
+
+    return true;
+}
+
+bool ESP8266WiFiClass::setAutoConnect(bool isAutoConnect) {
+
+    return true;
+}
+
+void ESP8266WiFiClass::persistent(bool isPersistent) {}
+
+wl_status_t ESP8266WiFiClass::status() {
+
+    return status_;
+}
+
+IPAddress ESP8266WiFiClass::localIP() {
+    if (status_ != WL_CONNECTED) { // No address yet...
+
+        return IPAddress(0, 0, 0, 0);
+    }
+
+    return (staticIp.isSet() ? staticIp : IPAddress(Emulator::getConfig().ip));
+}
+
+IPAddress ESP8266WiFiClass::subnetMask() {
+
+    return (status_ == WL_CONNECTED ? WIFI_SUBNET_MASK : IPAddress(0, 0, 0, 0));
+}
+
+IPAddress ESP8266WiFiClass::gatewayIP() {
+
+    return (status_ == WL_CONNECTED ? WIFI_GATEWAY : IPAddress(0, 0, 0, 0));
+}
+
+IPAddress ESP8266WiFiClass::dnsIP(uint8_t dnsNumber) {
+
+    return (status_ == WL_CONNECTED && dnsNumber == 0 ? WIFI_GATEWAY : IPAddress(0, 0, 0, 0));
+}
+
+bool ESP8266WiFiClass::softAPConfig(IPAddress localIp, IPAddress gateway, IPAddress subnet) {
+
+    return true;
+}
+
+bool ESP8266WiFiClass::softAP(const char *ssid, const char *psk, int channel, int isHidden, int maxConnections) {
+    mode_ = (WiFiMode_t) (mode_ | WIFI_AP);
+
+    return true;
+}
+
+bool ESP8266WiFiClass::softAP(const String &ssid, const String &psk, int channel, int isHidden, int maxConnections) {
+
+    return softAP(ssid.c_str(), psk.c_str(), channel, isHidden, maxConnections);
+}
+
+bool ESP8266WiFiClass::softAPdisconnect(bool isWifiOff) {
+    mode_ = (WiFiMode_t) (mode_ & ~WIFI_AP);
+
+    return true;
+}
+
+/**
+ * The access point is reached at the device's own loopback address
+ * rather than the one set for it, which the host has no route to.
+*/
+IPAddress ESP8266WiFiClass::softAPIP() {
+
+    return ((mode_ & WIFI_AP) != 0 ? IPAddress(Emulator::getConfig().ip) : IPAddress(0, 0, 0, 0));
+}
+
+bool ESP8266WiFiClass::setHostname(const char *hostname) {
+    strncpy(hostname_, hostname, sizeof(hostname_) - 1);
+    hostname_[sizeof(hostname_) - 1] = '\0';
+
+    return true;
+}
+
+bool ESP8266WiFiClass::hostname(const char *hostname) {
+
+    return setHostname(hostname);
+}
+
+const char* ESP8266WiFiClass::getHostname() {
+
+    return hostname_;
+}
+
+void ESP8266WiFiClass::setOutputPower(float dBm) {}
+
+String ESP8266WiFiClass::macAddress() {
+    char text[18];
+    const uint8_t *mac = Emulator::getConfig().mac;
+    snprintf(text, sizeof(text), "%02X:%02X:%02X:%02X:%02X:%02X", mac[0], mac[1], mac[2], mac[3], mac[4], mac[5]);
+
+    return String(text);
+}
+
+uint8_t* ESP8266WiFiClass::macAddress(uint8_t *mac) {
+    memcpy(mac, Emulator::getConfig().mac, 6);
+
+    return mac;
+}
+
+uint8_t* ESP8266WiFiClass::BSSID() {
+
+    return (uint8_t *) ACCESS_POINT_BSSID;
+}
+
+String ESP8266WiFiClass::BSSIDstr() {
+    char text[18];
+    const uint8_t *b = ACCESS_POINT_BSSID;
+    snprintf(text, sizeof(text), "%02X:%02X:%02X:%02X:%02X:%02X", b[0], b[1], b[2], b[3], b[4], b[5]);
+
+    return String(text);
+}
+
+int32_t ESP8266WiFiClass::channel() {
+
+    return WIFI_CHANNEL;
+}
+
+/**
+ * Gives each device a signal of its own, between -45 and -74 dBm.
+ *
+ * @return Returns the signal strength, or 31 if not connected as the SDK does, as int32_t.
+*/
+int32_t ESP8266WiFiClass::RSSI() {
+
+    return (status_ == WL_CONNECTED ? -45 - (int32_t) (Emulator::getConfig().index % 30) : 31);
+}
+
+String ESP8266WiFiClass::SSID() const {
+
+    return String(ssid_);
+}
+
+bool ESP8266WiFiClass::setSleepMode(WiFiSleepType_t type, uint8_t listenInterval) {
+    sleepType = type;
+
+    return true;
+}
+
+WiFiSleepType_t ESP8266WiFiClass::getSleepMode() {
+
+    return sleepType;
+}
+
+bool ESP8266WiFiClass::forceSleepBegin(uint32_t sleepMicros) {
+
+    return true;
+}
+
+bool ESP8266WiFiClass::forceSleepWake() {
+
+    return true;
+}
+
+WiFiEventHandler ESP8266WiFiClass::onStationModeConnected(std::function<void(const WiFiEventStationModeConnected&)> handler) {
+    WiFiEventHandlerOpaque *opaque = new WiFiEventHandlerOpaque();
+    opaque->onConnected = handler;
+
+    return addHandler(opaque);
+}
+
+WiFiEventHandler ESP8266WiFiClass::onStationModeDisconnected(std::function<void(const WiFiEventStationModeDisconnected&)> handler) {
+    WiFiEventHandlerOpaque *opaque = new WiFiEventHandlerOpaque();
+    opaque->onDisconnected = handler;
+
+    return addHandler(opaque);
+}
+
+WiFiEventHandler ESP8266WiFiClass::onStationModeGotIP(std::function<void(const WiFiEventStationModeGotIP&)> handler) {
+    WiFiEventHandlerOpaque *opaque = new WiFiEventHandlerOpaque();
+    opaque->onGotIp = handler;
+
+    return addHandler(opaque);
+}
+
+/**
+ * DHCP never times out on the emulated network, so the handler
+ * is kept only as long as the caller holds on to it and never called.
+*/
+WiFiEventHandler ESP8266WiFiClass::onStationModeDHCPTimeout(std::function<void(void)> handler) {
+
+    return WiFiEventHandler(new WiFiEventHandlerOpaque());
+}
+
+/**
+ * Takes the access point out of range, or brings it back, as if the
+ * device were carried away from it and back again. A station on the
+ * network drops off with a beacon timeout, and joins fail until the
+ * access point is back. Not part of the core; For the emulator only.
+ *
+ * @param isInRange False to take the access point away as bool.
+*/
+void ESP8266WiFiClass::setApInRange(bool isInRange) {
+    isApInRange = isInRange;
+    if (!isInRange && status_ == WL_CONNECTED) { // Dropped off...
+        joinGeneration++;
+        status_ = WL_DISCONNECTED;
+        Emulator::schedule(0, [this]() { raiseDisconnected(WIFI_DISCONNECT_REASON_BEACON_TIMEOUT); });
+    }
+}
+
+/*
+=================================================================
+Private Functions
+=================================================================
+*/
+
+/**
+ * #### PRIVATE ####
+ * Used to keep a handler until its caller lets go of it, as the
+ * core does.
+ *
+ * @param handler The handler as WiFiEventHandlerOpaque*.
+ *
+ * @return Returns the handle for the caller to keep as WiFiEventHandler.
+*/
+WiFiEventHandler ESP8266WiFiClass::addHandler(WiFiEventHandlerOpaque *handler) {
+    WiFiEventHandler handle(handler);
+    for (std::weak_ptr<WiFiEventHandlerOpaque> &slot : handlers) {
+        if (slot.expired()) { // Free...
+            slot = handle;
+
+            return handle;
+        }
+    }
+    Serial.println(F("Emulator: Too many WiFi event handlers; Handler not called"));
+
+    return handle;
+}
+
+/**
+ * #### PRIVATE ####
+ * Used to raise the connected event of a join, then start getting
+ * an address.
+ *
+ * @param generation The join the event belongs to as uint32_t.
+*/
+void ESP8266WiFiClass::raiseConnected(uint32_t generation) {
+    WiFiEventStationModeConnected event;
+    event.ssid = ssid_;
+    memcpy(event.bssid, ACCESS_POINT_BSSID, sizeof(event.bssid));
+    event.channel = WIFI_CHANNEL;
+    for (std::weak_ptr<WiFiEventHandlerOpaque> &slot : handlers) {
+        WiFiEventHandler handler = slot.lock();
+        if (handler && handler->onConnected) {
+            handler->onConnected(event);
+        }
+    }
+    Emulator::schedule(
+        (staticIp.isSet() ? WIFI_STATIC_MILLIS : WIFI_DHCP_MILLIS),
+        [this, generation]() { raiseGotIp(generation); }
+    );
+}
+
+/**
+ * #### PRIVATE ####
+ * Used to raise the got IP event of a join, which completes it.
+ *
+ * @param generation The join the event belongs to as uint32_t.
+*/
+void ESP8266WiFiClass::raiseGotIp(uint32_t generation) {
+    if (generation != joinGeneration) { // Join abandoned...
+
+        return;
+    }
+    status_ = WL_CONNECTED;
+    WiFiEventStationModeGotIP event = {localIP(), subnetMask(), gatewayIP()};
+    for (std::weak_ptr<WiFiEventHandlerOpaque> &slot : handlers) {
+        WiFiEventHandler handler = slot.lock();
+        if (handler && handler->onGotIp) {
+            handler->onGotIp(event);
+        }
+    }
+}
+
+/**
+ * #### PRIVATE ####
+ * Used to associate once the access point has been looked for. While
+ * it is out of range the stack tells of the failure and scans again,
+ * as it keeps doing until the join is abandoned.
+ *
+ * @param generation The join the attempt belongs to as uint32_t.
+*/
+void ESP8266WiFiClass::attemptJoin(uint32_t generation) {
+    if (generation != joinGeneration) { // Join abandoned...
+
+        return;
+    }
+    if (isApInRange) { // Found it...
+        raiseConnected(generation);
+
+        return;
+    }
+    status_ = WL_NO_SSID_AVAIL;
+    raiseDisconnected(WIFI_DISCONNECT_REASON_NO_AP_FOUND);
+    Emulator::schedule(WIFI_SCAN_JOIN_MILLIS, [this, generation]() { attemptJoin(generation); });
+}
+
+void ESP8266WiFiClass::raiseDisconnected(WiFiDisconnectReason reason) {
+    WiFiEventStationModeDisconnected event;
+    event.ssid = ssid_;
+    memcpy(event.bssid, ACCESS_POINT_BSSID, sizeof(event.bssid));
+    event.reason = reason;
+    for (std::weak_ptr<WiFiEventHandlerOpaque> &slot : handlers) {
+        WiFiEventHandler handler = slot.lock();
+        if (handler && handler->onDisconnected) {
+            handler->onDisconnected(event);
+        }
+    }
+}
@@ -0,0 +1,149 @@
+/*
+    ESP8266WiFi - The emulator's stand in for the ESP8266 WiFi stack.
+
+    There is no radio, so the network is the host's loopback interface:
+    Each device is given an address of its own on it, in 127.0.0.0/8, and
+    any SSID is joined. Joining takes about as long as on the device, a
+    scan being slower than a direct connect to a known access point, and
+    the connected and got IP events are raised in the background as the
+    stack would raise them. The subnet is always 255.0.0.0, so the
+    broadcast address works out to 127.255.255.255, which the host hands
+    to every socket bound to the port. In AP mode the device is reached
+    at the same address. The access point can be taken out of range, as
+    host tests do to see the firmware ride out an outage.
+
+    Written by: Scott Griffis
+    Date: 10-19-2026
+*/
+
+#ifndef ESP8266WiFi_h
+    #define ESP8266WiFi_h
+
+    #include <memory>
+    #include <functional>
+    #include <Arduino.h>
+    #include <WiFiClient.h>
+
+    typedef enum WiFiMode {
+        WIFI_OFF = 0,
+        WIFI_STA = 1,
+        WIFI_AP = 2,
+        WIFI_AP_STA = 3
+    } WiFiMode_t;
+
+    typedef enum {
+        WL_IDLE_STATUS = 0,
+        WL_NO_SSID_AVAIL = 1,
+        WL_SCAN_COMPLETED = 2,
+        WL_CONNECTED = 3,
+        WL_CONNECT_FAILED = 4,
+        WL_CONNECTION_LOST = 5,
+        WL_WRONG_PASSWORD = 6,
+        WL_DISCONNECTED = 7
+    } wl_status_t;
+
+    typedef enum WiFiSleepType {
+        WIFI_NONE_SLEEP = 0,
+        WIFI_LIGHT_SLEEP = 1,
+        WIFI_MODEM_SLEEP = 2
+    } WiFiSleepType_t;
+
+    enum WiFiDisconnectReason {
+        WIFI_DISCONNECT_REASON_UNSPECIFIED = 1,
+        WIFI_DISCONNECT_REASON_ASSOC_LEAVE = 8,
+        WIFI_DISCONNECT_REASON_BEACON_TIMEOUT = 200,
+        WIFI_DISCONNECT_REASON_NO_AP_FOUND = 201
+    };
+
+    struct WiFiEventStationModeConnected {
+        String         ssid             ;
+        uint8_t        bssid            [6];
+        uint8_t        channel          ;
+    };
+
+    struct WiFiEventStationModeDisconnected {
+        String         ssid             ;
+        uint8_t        bssid            [6];
+        WiFiDisconnectReason reason     ;
+    };
+
+    struct WiFiEventStationModeGotIP {
+        IPAddress      ip               ;
+        IPAddress      mask             ;
+        IPAddress      gw               ;
+    };
+
+    struct WiFiEventHandlerOpaque {
+        std::function<void(const WiFiEventStationModeConnected&)> onConnected;
+        std::function<void(const WiFiEventStationModeDisconnected&)> onDisconnected;
+        std::function<void(const WiFiEventStationModeGotIP&)> onGotIp;
+    };
+    typedef std::shared_ptr<WiFiEventHandlerOpaque> WiFiEventHandler;
+
+    #define WIFI_EVENT_HANDLERS 8
+
+    class ESP8266WiFiClass {
+        private:
+            WiFiMode_t     mode_            = WIFI_OFF;
+            wl_status_t    status_          = WL_IDLE_STATUS;
+            WiFiSleepType_t sleepType       = WIFI_MODEM_SLEEP;
+            char           hostname_        [33] = "";
+            char           ssid_            [33] = "";
+            IPAddress      staticIp         ;
+            uint32_t       joinGeneration   = 0; // Events of an abandoned join are dropped
+            bool           isApInRange      = true;
+            std::weak_ptr<WiFiEventHandlerOpaque> handlers[WIFI_EVENT_HANDLERS];
+
+            WiFiEventHandler addHandler      (WiFiEventHandlerOpaque *handler);
+            void           attemptJoin       (uint32_t generation)    ;
+            void           raiseConnected    (uint32_t generation)    ;
+            void           raiseGotIp        (uint32_t generation)    ;
+            void           raiseDisconnected (WiFiDisconnectReason reason);
+
+        public:
+            bool           mode              (WiFiMode_t mode)        ;
+            WiFiMode_t     getMode           ()                       ;
+            wl_status_t    begin             (const char *ssid, const char *passphrase = nullptr, int32_t channel = 0, const uint8_t *bssid = nullptr, bool connect = true);
+            wl_status_t    begin             (const String &ssid, const String &passphrase = emptyString, int32_t channel = 0, const uint8_t *bssid = nullptr, bool connect = true);
+            bool           config            (IPAddress localIp, IPAddress gateway, IPAddress subnet, IPAddress dns1 = (uint32_t) 0, IPAddress dns2 = (uint32_t) 0);
+            bool           reconnect         ()                       ;
+            bool           disconnect        (bool isWifiOff = false) ;
+            bool           isConnected       ()                       ;
+            bool           setAutoReconnect  (bool isAutoReconnect)   ;
+            bool           setAutoConnect    (bool isAutoConnect)     ;
+            void           persistent        (bool isPersistent)      ;
+            wl_status_t    status            ()                       ;
+            IPAddress      localIP           ()                       ;
+            IPAddress      subnetMask        ()                       ;
+            IPAddress      gatewayIP         ()                       ;
+            IPAddress      dnsIP             (uint8_t dnsNumber = 0)  ;
+            bool           softAPConfig      (IPAddress localIp, IPAddress gateway, IPAddress subnet);
+            bool           softAP            (const char *ssid, const char *psk = nullptr, int channel = 1, int isHidden = 0, int maxConnections = 4);
+            bool           softAP            (const String &ssid, const String &psk = emptyString, int channel = 1, int isHidden = 0, int maxConnections = 4);
+            bool           softAPdisconnect  (bool isWifiOff = false) ;
+            IPAddress      softAPIP          ()                       ;
+            bool           setHostname       (const char *hostname)   ;
+            bool           hostname          (const char *hostname)   ;
+            const char*    getHostname       ()                       ;
+            void           setOutputPower    (float dBm)              ;
+            String         macAddress        ()                       ;
+            uint8_t*       macAddress        (uint8_t *mac)           ;
+            uint8_t*       BSSID             ()                       ;
+            String         BSSIDstr          ()                       ;
+            int32_t        channel           ()                       ;
+            int32_t        RSSI              ()                       ;
+            String         SSID              () const                 ;
+            bool           setSleepMode      (WiFiSleepType_t type, uint8_t listenInterval = 0);
+            WiFiSleepType_t getSleepMode     ()                       ;
+            bool           forceSleepBegin   (uint32_t sleepMicros = 0);
+            bool           forceSleepWake    ()                       ;
+            WiFiEventHandler onStationModeConnected(std::function<void(const WiFiEventStationModeConnected&)> handler);
+            WiFiEventHandler onStationModeDisconnected(std::function<void(const WiFiEventStationModeDisconnected&)> handler);
+            WiFiEventHandler onStationModeGotIP(std::function<void(const WiFiEventStationModeGotIP&)> handler);
+            WiFiEventHandler onStationModeDHCPTimeout(std::function<void(void)> handler);
+            void           setApInRange      (bool isInRange)         ; // Emulator only
+    };
+
+    extern ESP8266WiFiClass WiFi;
+
+#endif
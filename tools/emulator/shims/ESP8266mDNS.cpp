@@ -0,0 +1,94 @@
+/*
+    ESP8266mDNS - The emulator's stand in for the ESP8266 core's mDNS
+    responder.
+
+    Written by: Scott Griffis
+    Date: 10-19-2026
+*/
+
+#include "ESP8266mDNS.h"
+
+MDNSResponder MDNS;
+
+bool MDNSResponder::begin(const char *hostname) {
+    isRunning_ = true;
+    serviceCount = 0;
+
+    return true;
+}
+
+bool MDNSResponder::close() {
+    isRunning_ = false;
+    serviceCount = 0;
+    dynamicTxtCallback = nullptr;
+
+    return true;
+}
+
+bool MDNSResponder::end() {
+
+    return close();
+}
+
+bool MDNSResponder::isRunning() {
+
+    return isRunning_;
+}
+
+bool MDNSResponder::setHostname(const char *hostname) {
+
+    return isRunning_;
+}
+
+MDNSResponder::hMDNSService MDNSResponder::addService(const char *name, const char *service, const char *protocol, uint16_t port) {
+    if (!isRunning_ || serviceCount >= MDNS_MAX_SERVICES) {
+
+        return nullptr;
+    }
+
+    return &services[serviceCount++];
+}
+
+MDNSResponder::hMDNSTxt MDNSResponder::addServiceTxt(const hMDNSService service, const char *key, const char *value) {
+
+    return service;
+}
+
+MDNSResponder::hMDNSTxt MDNSResponder::addDynamicServiceTxt(hMDNSService service, const char *key, const char *value) {
+
+    return service;
+}
+
+bool MDNSResponder::setDynamicServiceTxtCallback(MDNSDynamicServiceTxtCallbackFunc callback) {
+    dynamicTxtCallback = callback;
+
+    return true;
+}
+
+bool MDNSResponder::update() {
+
+    return isRunning_;
+}
+
+/**
+ * Builds the dynamic TXT records as the core does before sending
+ * an announcement, so the firmware's callback costs what it would.
+*/
+bool MDNSResponder::announce() {
+    if (!isRunning_) {
+
+        return false;
+    }
+    if (dynamicTxtCallback) {
+        for (uint8_t i = 0; i < serviceCount; i++) {
+            dynamicTxtCallback(&services[i]);
+        }
+    }
+
+    return true;
+}
+
+bool MDNSResponder::notifyAPChange() {
+
+    return isRunning_;
+}
@@ -0,0 +1,49 @@
+/*
+    ESP8266mDNS - The emulator's stand in for the ESP8266 core's mDNS
+    responder. Nothing is announced, as a host can only run one responder
+    on the mDNS port and hundreds of devices would flood it besides, but
+    the services and their TXT records are taken as the core takes them so
+    the firmware runs the same code.
+
+    Written by: Scott Griffis
+    Date: 10-19-2026
+*/
+
+#ifndef ESP8266mDNS_h
+    #define ESP8266mDNS_h
+
+    #include <Arduino.h>
+    #include <functional>
+
+    #define MDNS_MAX_SERVICES 4
+
+    class MDNSResponder {
+        public:
+            typedef const void* hMDNSService;
+            typedef const void* hMDNSTxt;
+            typedef std::function<void(const hMDNSService)> MDNSDynamicServiceTxtCallbackFunc;
+
+        private:
+            bool           isRunning_       = false;
+            uint8_t        services         [MDNS_MAX_SERVICES]; // Only their addresses are used, as handles
+            uint8_t        serviceCount     = 0;
+            MDNSDynamicServiceTxtCallbackFunc dynamicTxtCallback;
+
+        public:
+            bool           begin             (const char *hostname)   ;
+            bool           close             ()                       ;
+            bool           end               ()                       ;
+            bool           isRunning         ()                       ;
+            bool           setHostname       (const char *hostname)   ;
+            hMDNSService   addService        (const char *name, const char *service, const char *protocol, uint16_t port);
+            hMDNSTxt       addServiceTxt     (const hMDNSService service, const char *key, const char *value);
+            hMDNSTxt       addDynamicServiceTxt(hMDNSService service, const char *key, const char *value);
+            bool           setDynamicServiceTxtCallback(MDNSDynamicServiceTxtCallbackFunc callback);
+            bool           update            ()                       ;
+            bool           announce          ()                       ;
+            bool           notifyAPChange    ()                       ;
+    };
+
+    extern MDNSResponder MDNS;
+
+#endif
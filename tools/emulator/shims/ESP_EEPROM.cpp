@@ -0,0 +1,154 @@
+/*
+    ESP_EEPROM - The emulator's stand in for the ESP_EEPROM library, kept
+    in a file of the device's own.
+
+    Written by: Scott Griffis
+    Date: 10-19-2026
+*/
+
+#include "ESP_EEPROM.h"
+#include "Emulator.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <sys/stat.h>
+
+EEPROMClass EEPROM;
+
+/**
+ * Loads what the device's file holds, if it was stored with the
+ * same size. Bytes not yet stored read as erased flash does.
+ *
+ * @param size The number of bytes to use as size_t.
+*/
+void EEPROMClass::begin(size_t size) {
+    end();
+    this->size = size;
+    data = (uint8_t *) malloc(size);
+    memset(data, 0xFF, size);
+    isStored = false;
+    isDirty = false;
+
+    struct stat info;
+    const char *path = Emulator::getConfig().eepromPath;
+    if (stat(path, &info) == 0 && (size_t) info.st_size == size) { // Stored with this size...
+        FILE *file = fopen(path, "rb");
+        if (file != nullptr) {
+            isStored = (fread(data, 1, size, file) == size);
+            fclose(file);
+        }
+    }
+}
+
+/**
+ * Writes the data to the device's file, if changed.
+ *
+ * @return Returns true if stored otherwise false as bool.
+*/
+bool EEPROMClass::commit() {
+    if (data == nullptr) { // Not begun...
+
+        return false;
+    }
+    if (!isDirty && isStored) { // Nothing to do...
+
+        return true;
+    }
+
+    const char *path = Emulator::getConfig().eepromPath;
+    char temporaryPath[512];
+    snprintf(temporaryPath, sizeof(temporaryPath), "%s.tmp", path);
+    FILE *file = fopen(temporaryPath, "wb");
+    if (file == nullptr) {
+
+        return false;
+    }
+    bool ok = (fwrite(data, 1, size, file) == size);
+    ok = (fclose(file) == 0) && ok;
+    if (ok && rename(temporaryPath, path) == 0) { // Switched over...
+        isStored = true;
+        isDirty = false;
+
+        return true;
+    }
+    unlink(temporaryPath);
+
+    return false;
+}
+
+/**
+ * Commits any change and lets go of the data.
+ *
+ * @return Returns true if nothing was lost otherwise false as bool.
+*/
+bool EEPROMClass::end() {
+    bool ok = (isDirty ? commit() : true);
+    free(data);
+    data = nullptr;
+    size = 0;
+    isDirty = false;
+
+    return ok;
+}
+
+/**
+ * Erases what is stored, as wiping the flash sector would.
+ *
+ * @return Returns true if erased otherwise false as bool.
+*/
+bool EEPROMClass::wipe() {
+    if (data != nullptr) {
+        memset(data, 0xFF, size);
+    }
+    isStored = false;
+    isDirty = false;
+    const char *path = Emulator::getConfig().eepromPath;
+
+    return (unlink(path) == 0 || access(path, F_OK) != 0);
+}
+
+/**
+ * Gets how much of the flash sector a stored copy takes up, as
+ * the library reports it.
+ *
+ * @return Returns the percent used, or -1 if nothing is stored as int.
+*/
+int EEPROMClass::percentUsed() {
+    if (!isStored) {
+
+        return -1;
+    }
+
+    return (int) (((size + 4) * 100) / EEPROM_SECTOR_SIZE); // Each copy is held with a word of its own
+}
+
+uint8_t EEPROMClass::read(int address) {
+
+    return (address >= 0 && (size_t) address < size ? data[address] : 0xFF);
+}
+
+void EEPROMClass::write(int address, uint8_t value) {
+    if (address >= 0 && (size_t) address < size && data[address] != value) {
+        data[address] = value;
+        isDirty = true;
+    }
+}
+
+/**
+ * Gets the data to change in place; It is taken as changed.
+*/
+uint8_t* EEPROMClass::getDataPtr() {
+    isDirty = true;
+
+    return data;
+}
+
+const uint8_t* EEPROMClass::getConstDataPtr() const {
+
+    return data;
+}
+
+size_t EEPROMClass::length() {
+
+    return size;
+}
@@ -0,0 +1,62 @@
+/*
+    ESP_EEPROM - The emulator's stand in for the ESP_EEPROM library, kept
+    in a file of the device's own rather than a sector of flash.
+
+    As with the library, what was stored is only found again when begun
+    with the same size. A commit writes a new copy of the file and then
+    renames it over the old one, so an emulator killed part way through
+    leaves the previous copy, as a power cut does on the device.
+
+    Written by: Scott Griffis
+    Date: 10-19-2026
+*/
+
+#ifndef ESP_EEPROM_h
+    #define ESP_EEPROM_h
+
+    #include <stddef.h>
+    #include <stdint.h>
+    #include <string.h>
+
+    #define EEPROM_SECTOR_SIZE 4096
+
+    class EEPROMClass {
+        private:
+            uint8_t       *data             = nullptr;
+            size_t         size             = 0;
+            bool           isStored         = false;
+            bool           isDirty          = false;
+
+        public:
+            void           begin             (size_t size)            ;
+            bool           commit            ()                       ;
+            bool           end               ()                       ;
+            bool           wipe              ()                       ;
+            int            percentUsed       ()                       ;
+            uint8_t        read              (int address)            ;
+            void           write             (int address, uint8_t value);
+            uint8_t*       getDataPtr        ()                       ;
+            const uint8_t* getConstDataPtr   () const                 ;
+            size_t         length            ()                       ;
+
+            template<typename T> T& get(int address, T &value) {
+                if (address >= 0 && (size_t) address + sizeof(T) <= size) {
+                    memcpy((void *) &value, &data[address], sizeof(T));
+                }
+
+                return value;
+            }
+
+            template<typename T> const T& put(int address, const T &value) {
+                if (address >= 0 && (size_t) address + sizeof(T) <= size) {
+                    memcpy(&data[address], (const void *) &value, sizeof(T));
+                    isDirty = true;
+                }
+
+                return value;
+            }
+    };
+
+    extern EEPROMClass EEPROM;
+
+#endif
@@ -0,0 +1,224 @@
+/*
+    Emulator - What the shims of one emulated device share: The device's
+    setup for this boot, its clock and the events raised in the background.
+
+    Written by: Scott Griffis
+    Date: 10-19-2026
+*/
+
+#include "Emulator.h"
+#include <Arduino.h>
+#include <ESP8266WiFi.h>
+#include <Settings.h>
+#include <Utils.h>
+#include <time.h>
+
+// ************************************************************************************
+// Thrown to unwind the firmware back to boot() once the boot is over
+// ************************************************************************************
+struct BootEnded {
+    BootEnd        end              ;
+    uint64_t       sleepMicros      ;
+};
+
+DeviceConfig *Emulator::config = nullptr;
+uint64_t Emulator::bootNanos = 0ull;
+Emulator::Event Emulator::events[EMULATOR_MAX_EVENTS];
+uint8_t Emulator::eventCount = 0;
+
+#ifndef UNIT_TEST // Host tests have no firmware to boot
+
+/**
+ * The entry point of the firmware image, called by the emulator on
+ * the device's own thread. Runs one boot of the device.
+ *
+ * @param config How the device is set up as DeviceConfig*.
+ * @param sleepMicros Receives the time to sleep for if the boot ended in deep sleep as uint64_t*.
+ *
+ * @return Returns how the boot ended as BootEnd.
+*/
+extern "C" __attribute__((visibility("default"))) BootEnd tempbuddyBoot(DeviceConfig *config, uint64_t *sleepMicros) {
+
+    return Emulator::boot(config, sleepMicros);
+}
+
+/**
+ * Runs setup() and then loop() over and over, as the core does,
+ * until the firmware restarts or sleeps or the emulator stops.
+ *
+ * @param config How the device is set up as DeviceConfig*.
+ * @param sleepMicros Receives the time to sleep for if the boot ended in deep sleep as uint64_t*.
+ *
+ * @return Returns how the boot ended as BootEnd.
+*/
+BootEnd Emulator::boot(DeviceConfig *config, uint64_t *sleepMicros) {
+    attach(config);
+    *sleepMicros = 0ull;
+    try {
+        applySettings();
+        setup();
+        while (true) {
+            loop();
+            yield();
+        }
+    } catch (const BootEnded &ended) {
+        *sleepMicros = ended.sleepMicros;
+
+        return ended.end;
+    }
+}
+
+#endif
+
+/**
+ * Makes the given device the one the shims stand in for, starting
+ * its clock from zero with no events queued.
+ *
+ * @param config How the device is set up as DeviceConfig*.
+*/
+void Emulator::attach(DeviceConfig *config) {
+    Emulator::config = config;
+    while (eventCount > 0) {
+        events[--eventCount].action = nullptr;
+    }
+    bootNanos = 0ull;
+    bootNanos = getNanos();
+}
+
+const DeviceConfig& Emulator::getConfig() {
+
+    return *config;
+}
+
+/**
+ * Gets the time since this boot began.
+ *
+ * @return Returns the time in nanoseconds as uint64_t.
+*/
+uint64_t Emulator::getNanos() {
+    if (config->clockNanos != nullptr) { // Caller's own...
+
+        return config->clockNanos() - bootNanos;
+    }
+    timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+
+    return (((uint64_t) now.tv_sec * 1000000000ull) + (uint64_t) now.tv_nsec) - bootNanos;
+}
+
+uint64_t Emulator::getMicros() {
+
+    return (getNanos() / 1000ull);
+}
+
+/**
+ * Queues something to happen in the background after the given
+ * delay, as the WiFi stack or SNTP would raise an event.
+ *
+ * @param delayMillis The time until it is due as uint32_t.
+ * @param action What to do as std::function<void()>.
+*/
+void Emulator::schedule(uint32_t delayMillis, std::function<void()> action) {
+    if (eventCount >= EMULATOR_MAX_EVENTS) { // Full; Only a firmware gone wrong gets here...
+        Serial.println(F("Emulator: Event queue full; Event dropped"));
+
+        return;
+    }
+    events[eventCount].dueMicros = getMicros() + (delayMillis * 1000ull);
+    events[eventCount].action = action;
+    eventCount++;
+}
+
+/**
+ * Raises the events that are due, in the order they were queued,
+ * and ends the boot if the emulator is stopping.
+*/
+void Emulator::raiseEvents() {
+    if (config->isStopping()) { // Shutting down...
+        endBoot(BOOT_STOPPED, 0ull);
+    }
+    uint64_t nowMicros = getMicros();
+    uint8_t i = 0;
+    while (i < eventCount) {
+        if (events[i].dueMicros > nowMicros) { // Not yet...
+            i++;
+            continue;
+        }
+        std::function<void()> action = events[i].action; // The action may queue more
+        for (uint8_t j = i + 1; j < eventCount; j++) {
+            events[j - 1] = events[j];
+        }
+        eventCount--;
+        events[eventCount].action = nullptr;
+        action();
+    }
+}
+
+/**
+ * Sleeps for the given time, raising events as they come due.
+ *
+ * @param micros The time to sleep for as uint64_t.
+*/
+void Emulator::sleep(uint64_t micros) {
+    uint64_t endMicros = getMicros() + micros;
+    while (true) {
+        raiseEvents();
+        uint64_t nowMicros = getMicros();
+        if (nowMicros >= endMicros) { // Done...
+
+            return;
+        }
+        uint64_t wakeMicros = endMicros;
+        for (uint8_t i = 0; i < eventCount; i++) {
+            wakeMicros = min(wakeMicros, max(events[i].dueMicros, nowMicros));
+        }
+        if (!config->sleep(wakeMicros - nowMicros)) { // Shutting down...
+            endBoot(BOOT_STOPPED, 0ull);
+        }
+    }
+}
+
+/**
+ * Ends the boot, unwinding the firmware back to boot().
+ *
+ * @param end How the boot ended as BootEnd.
+ * @param sleepMicros The time to sleep for if in deep sleep as uint64_t.
+*/
+void Emulator::endBoot(BootEnd end, uint64_t sleepMicros) {
+    Serial.flush();
+
+    throw BootEnded{end, sleepMicros};
+}
+
+/*
+=================================================================
+Private Functions
+=================================================================
+*/
+
+/**
+ * #### PRIVATE ####
+ * Used to apply the settings given to the emulator before the first
+ * boot, through the same fields as the admin page, and store them.
+*/
+void Emulator::applySettings() {
+    if (config->settingCount == 0) { // None given...
+
+        return;
+    }
+    Settings seed;
+    seed.setDeviceId(Utils::genDeviceIdFromMacAddr(WiFi.macAddress()).c_str());
+    seed.loadSettings();
+    for (uint8_t i = 0; i < config->settingCount; i++) {
+        const char *setting = config->settings[i];
+        const char *equals = strchr(setting, '='); // Checked for by the emulator
+        String name(setting, (unsigned int) (equals - setting));
+        const SettingField *field = Settings::findField(name.c_str());
+        if (field == nullptr || seed.updateField(*field, equals + 1, strlen(equals + 1)) == SETTING_INVALID) { // Not accepted...
+            Serial.printf("Emulator: Setting not accepted: %s\n", setting);
+        }
+    }
+    if (!seed.saveSettings()) {
+        Serial.println(F("Emulator: Settings not saved"));
+    }
+}
@@ -0,0 +1,56 @@
+/*
+    Emulator - What the shims of one emulated device share: The device's
+    setup for this boot, its clock and the events the WiFi stack and SNTP
+    would raise in the background on the hardware.
+
+    Background events are queued with a time they are due and raised from
+    yield(), delay() and the like, as on the ESP8266 where they run when
+    the sketch gives up the CPU. Once the emulator is stopping, the next
+    of those calls ends the boot, wherever the firmware happens to be.
+
+    The boot itself starts from tempbuddyBoot(), the one function of the
+    firmware image the emulator calls (see EmulatedDevice.h). Host tests
+    of the libraries have no firmware to boot, and attach() a device of
+    their own instead, usually with a clock they move on themselves so
+    that their sleeps take no time.
+
+    Written by: Scott Griffis
+    Date: 10-19-2026
+*/
+
+#ifndef Emulator_h
+    #define Emulator_h
+
+    #include <stdint.h>
+    #include <functional>
+    #include "../EmulatedDevice.h"
+
+    #define EMULATOR_MAX_EVENTS 16
+
+    class Emulator {
+        private:
+            struct Event {
+                uint64_t       dueMicros        ;
+                std::function<void()> action    ;
+            };
+
+            static DeviceConfig *config;
+            static uint64_t       bootNanos;
+            static Event          events[EMULATOR_MAX_EVENTS];
+            static uint8_t        eventCount;
+
+            static void    applySettings     ()                       ;
+
+        public:
+            static BootEnd boot              (DeviceConfig *config, uint64_t *sleepMicros);
+            static void    attach            (DeviceConfig *config)   ;
+            static const DeviceConfig& getConfig()                    ;
+            static uint64_t getNanos         ()                       ;
+            static uint64_t getMicros        ()                       ;
+            static void    schedule          (uint32_t delayMillis, std::function<void()> action);
+            static void    raiseEvents       ()                       ;
+            static void    sleep             (uint64_t micros)        ;
+            [[noreturn]] static void endBoot (BootEnd end, uint64_t sleepMicros);
+    };
+
+#endif
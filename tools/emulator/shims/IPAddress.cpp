@@ -0,0 +1,37 @@
+/*
+    IPAddress - The emulator's stand in for the ESP8266 core's IPv4 address.
+
+    Written by: Scott Griffis
+    Date: 10-19-2026
+*/
+
+#include "IPAddress.h"
+#include <stdio.h>
+#include <arpa/inet.h>
+
+const IPAddress INADDR_NONE(255, 255, 255, 255);
+
+/**
+ * Sets the address from its dotted decimal text.
+ *
+ * @param text The text, such as 192.168.1.10, as const char*.
+ *
+ * @return Returns true if the text was an address otherwise false as bool.
+*/
+bool IPAddress::fromString(const char *text) {
+    in_addr address;
+    if (text == nullptr || inet_pton(AF_INET, text, &address) != 1) { // Not an address...
+
+        return false;
+    }
+    memcpy(octets, &address.s_addr, sizeof(octets));
+
+    return true;
+}
+
+String IPAddress::toString() const {
+    char text[16];
+    snprintf(text, sizeof(text), "%u.%u.%u.%u", octets[0], octets[1], octets[2], octets[3]);
+
+    return String(text);
+}
@@ -0,0 +1,44 @@
+/*
+    IPAddress - The emulator's stand in for the ESP8266 core's IPv4 address.
+    The octets are held in network byte order, so the address converts to
+    and from a sockaddr_in's s_addr as is.
+
+    Written by: Scott Griffis
+    Date: 10-19-2026
+*/
+
+#ifndef IPAddress_h
+    #define IPAddress_h
+
+    #include <stdint.h>
+    #include <string.h>
+    #include <netinet/in.h>
+    #include <WString.h>
+
+    #undef INADDR_NONE // The core's IPAddress of the same name takes its place
+
+    class IPAddress {
+        private:
+            uint8_t        octets           [4] = {0, 0, 0, 0};
+
+        public:
+            IPAddress() {}
+            IPAddress(uint8_t first, uint8_t second, uint8_t third, uint8_t fourth) { octets[0] = first; octets[1] = second; octets[2] = third; octets[3] = fourth; }
+            IPAddress(uint32_t address) { memcpy(octets, &address, sizeof(octets)); }
+            IPAddress(const uint8_t *address) { memcpy(octets, address, sizeof(octets)); }
+
+            operator uint32_t                () const { uint32_t address; memcpy(&address, octets, sizeof(address)); return address; }
+            uint8_t        operator[]        (int index) const { return octets[index]; }
+            uint8_t&       operator[]        (int index) { return octets[index]; }
+            bool           operator==        (const IPAddress &other) const { return (uint32_t) *this == (uint32_t) other; }
+            bool           operator!=        (const IPAddress &other) const { return !(*this == other); }
+            bool           isSet             () const { return (uint32_t) *this != 0; }
+            uint32_t       v4                () const { return (uint32_t) *this; }
+            bool           fromString        (const char *text)       ;
+            bool           fromString        (const String &text) { return fromString(text.c_str()); }
+            String         toString          () const                 ;
+    };
+
+    extern const IPAddress INADDR_NONE;
+
+#endif
@@ -0,0 +1,35 @@
+/*
+    MD5Builder - The emulator's stand in for the ESP8266 core's MD5 hash,
+    giving the same hashes so Device IDs and stored settings match those
+    of the hardware.
+
+    Written by: Scott Griffis
+    Date: 10-19-2026
+*/
+
+#ifndef MD5Builder_h
+    #define MD5Builder_h
+
+    #include <Arduino.h>
+
+    class MD5Builder {
+        private:
+            uint32_t       state            [4];
+            uint8_t        block            [64];
+            uint64_t       totalLength      = 0;
+            uint8_t        digest           [16];
+
+            void           transform         (const uint8_t *chunk)   ;
+
+        public:
+            void           begin             ()                       ;
+            void           add               (const uint8_t *data, uint16_t length);
+            void           add               (const char *data)       ;
+            void           add               (const String &data)     ;
+            void           calculate         ()                       ;
+            void           getBytes          (uint8_t *output)        ;
+            void           getChars          (char *output)           ;
+            String         toString          ()                       ;
+    };
+
+#endif
@@ -0,0 +1,10 @@
+/*
+    Secrets - Stands in for lib/Secrets/Secrets.h when there is none, so
+    the firmware builds for the emulator without one. Secrets_h is left
+    undefined on purpose, so the firmware falls back on the sample
+    certificate as it does for the hardware; The emulator serves plain
+    HTTP and never uses it.
+
+    Written by: Scott Griffis
+    Date: 10-19-2026
+*/
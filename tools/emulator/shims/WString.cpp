@@ -0,0 +1,145 @@
+/*
+    WString - The emulator's stand in for the Arduino String class, kept
+    in a std::string.
+
+    Written by: Scott Griffis
+    Date: 10-19-2026
+*/
+
+#include "WString.h"
+#include <ctype.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <strings.h>
+
+const String emptyString;
+
+/**
+ * #### CLASS CONSTRUCTORS ####
+ * Give the text of a number in the given base, or with the
+ * given number of decimals, as the Arduino class does.
+*/
+String::String(int value, unsigned char base) : String((long) value, base) {}
+
+String::String(unsigned int value, unsigned char base) : String((unsigned long) value, base) {}
+
+String::String(long value, unsigned char base) {
+    if (base == 10 || value >= 0) { // Sign only shown in base 10...
+        text = (value < 0 ? "-" : "");
+        String digits((unsigned long) (value < 0 ? -value : value), base);
+        text += digits.text;
+    } else {
+        String digits((unsigned long) value, base);
+        text = digits.text;
+    }
+}
+
+String::String(unsigned long value, unsigned char base) {
+    char digits[65];
+    size_t at = sizeof(digits) - 1;
+    digits[at] = '\0';
+    base = (base < 2 || base > 36 ? 10 : base);
+    do {
+        uint8_t digit = (uint8_t) (value % base);
+        digits[--at] = (char) (digit < 10 ? '0' + digit : 'A' + digit - 10);
+        value /= base;
+    } while (value > 0);
+    text = &digits[at];
+}
+
+String::String(float value, unsigned char decimals) : String((double) value, decimals) {}
+
+String::String(double value, unsigned char decimals) {
+    char buffer[64];
+    snprintf(buffer, sizeof(buffer), "%.*f", (int) decimals, value);
+    text = buffer;
+}
+
+bool String::equalsIgnoreCase(const String &other) const {
+
+    return (text.size() == other.text.size() && strcasecmp(text.c_str(), other.text.c_str()) == 0);
+}
+
+bool String::endsWith(const String &suffix) const {
+
+    return (text.size() >= suffix.text.size() && text.compare(text.size() - suffix.text.size(), suffix.text.size(), suffix.text) == 0);
+}
+
+int String::indexOf(char value, unsigned int from) const {
+    size_t at = text.find(value, from);
+
+    return (at == std::string::npos ? -1 : (int) at);
+}
+
+int String::indexOf(const String &value, unsigned int from) const {
+    size_t at = text.find(value.text, from);
+
+    return (at == std::string::npos ? -1 : (int) at);
+}
+
+int String::lastIndexOf(char value) const {
+    size_t at = text.rfind(value);
+
+    return (at == std::string::npos ? -1 : (int) at);
+}
+
+String String::substring(unsigned int from) const {
+
+    return substring(from, (unsigned int) text.size());
+}
+
+String String::substring(unsigned int from, unsigned int to) const {
+    if (from > to) { // Given backwards...
+        std::swap(from, to);
+    }
+    if (from >= text.size()) { // Nothing there...
+
+        return String();
+    }
+    to = (to > text.size() ? (unsigned int) text.size() : to);
+
+    return String(text.data() + from, to - from);
+}
+
+void String::toUpperCase() {
+    for (char &c : text) {
+        c = (char) toupper((unsigned char) c);
+    }
+}
+
+void String::toLowerCase() {
+    for (char &c : text) {
+        c = (char) tolower((unsigned char) c);
+    }
+}
+
+/**
+ * Replaces every instance of the given text, working from the
+ * start so replacements aren't themselves replaced.
+ *
+ * @param find The text to replace as const String&.
+ * @param replacement What to put in its place as const String&.
+*/
+void String::replace(const String &find, const String &replacement) {
+    if (find.text.empty()) { // Nothing to look for...
+
+        return;
+    }
+    size_t at = 0;
+    while ((at = text.find(find.text, at)) != std::string::npos) {
+        text.replace(at, find.text.size(), replacement.text);
+        at += replacement.text.size();
+    }
+}
+
+void String::trim() {
+    size_t first = 0;
+    while (first < text.size() && isspace((unsigned char) text[first])) {
+        first++;
+    }
+    size_t last = text.size();
+    while (last > first && isspace((unsigned char) text[last - 1])) {
+        last--;
+    }
+    text = text.substr(first, last - first);
+}
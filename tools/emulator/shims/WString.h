@@ -0,0 +1,88 @@
+/*
+    WString - The emulator's stand in for the Arduino String class, kept
+    in a std::string. It allocates from the heap as the Arduino class
+    does, so the cost of building content in Strings shows up in a heap
+    profile of the emulator much as it would on the device.
+
+    Written by: Scott Griffis
+    Date: 10-19-2026
+*/
+
+#ifndef WString_h
+    #define WString_h
+
+    #include <stdint.h>
+    #include <string.h>
+    #include <string>
+
+    class __FlashStringHelper;
+    #define F(text) (reinterpret_cast<const __FlashStringHelper *>(text))
+    #define FPSTR(text) (reinterpret_cast<const __FlashStringHelper *>(text))
+
+    class String {
+        private:
+            std::string    text             ;
+
+        public:
+            String() {}
+            String(const char *value)                      : text(value != nullptr ? value : "") {}
+            String(const char *value, unsigned int length) : text(value, length) {}
+            String(const __FlashStringHelper *value)       : text(reinterpret_cast<const char *>(value)) {}
+            String(const String &other) = default;
+            String(String &&other) = default;
+            String& operator=(const String &other) = default;
+            String& operator=(String &&other) = default;
+            explicit String(char value)                    : text(1, value) {}
+            explicit String(int value, unsigned char base = 10);
+            explicit String(unsigned int value, unsigned char base = 10);
+            explicit String(long value, unsigned char base = 10);
+            explicit String(unsigned long value, unsigned char base = 10);
+            explicit String(float value, unsigned char decimals = 2);
+            explicit String(double value, unsigned char decimals = 2);
+
+            const char*    c_str             () const { return text.c_str(); }
+            unsigned int   length            () const { return (unsigned int) text.size(); }
+            bool           isEmpty           () const { return text.empty(); }
+            bool           reserve           (unsigned int size) { text.reserve(size); return true; }
+            void           clear             () { text.clear(); }
+            explicit operator bool           () const { return true; }
+
+            bool           concat            (const String &other) { text += other.text; return true; }
+            bool           concat            (const char *other) { text += (other != nullptr ? other : ""); return true; }
+            bool           concat            (const char *other, unsigned int length) { text.append(other, length); return true; }
+            bool           concat            (char value) { text += value; return true; }
+            String&        operator+=        (const String &other) { concat(other); return *this; }
+            String&        operator+=        (const char *other) { concat(other); return *this; }
+            String&        operator+=        (char value) { concat(value); return *this; }
+            friend String  operator+         (const String &a, const String &b) { String result(a); result += b; return result; }
+            friend String  operator+         (const String &a, const char *b) { String result(a); result += b; return result; }
+            friend String  operator+         (const char *a, const String &b) { String result(a); result += b; return result; }
+
+            bool           equals            (const String &other) const { return text == other.text; }
+            bool           equals            (const char *other) const { return text == (other != nullptr ? other : ""); }
+            bool           operator==        (const String &other) const { return equals(other); }
+            bool           operator==        (const char *other) const { return equals(other); }
+            bool           operator!=        (const String &other) const { return !equals(other); }
+            bool           operator!=        (const char *other) const { return !equals(other); }
+            bool           equalsIgnoreCase  (const String &other) const;
+            bool           startsWith        (const String &prefix) const { return text.compare(0, prefix.text.size(), prefix.text) == 0; }
+            bool           endsWith          (const String &suffix) const;
+
+            char           charAt            (unsigned int index) const { return (index < text.size() ? text[index] : '\0'); }
+            char           operator[]        (unsigned int index) const { return charAt(index); }
+            int            indexOf           (char value, unsigned int from = 0) const;
+            int            indexOf           (const String &value, unsigned int from = 0) const;
+            int            lastIndexOf       (char value) const;
+            String         substring         (unsigned int from) const;
+            String         substring         (unsigned int from, unsigned int to) const;
+            long           toInt             () const { return atol(text.c_str()); }
+            float          toFloat           () const { return (float) atof(text.c_str()); }
+            void           toUpperCase       ();
+            void           toLowerCase       ();
+            void           replace           (const String &find, const String &replacement);
+            void           trim              ();
+    };
+
+    extern const String emptyString;
+
+#endif
@@ -0,0 +1,319 @@
+/*
+    WiFiClient - The emulator's stand in for the ESP8266 core's TCP client,
+    on a POSIX socket bound to the device's own loopback address.
+
+    Written by: Scott Griffis
+    Date: 10-19-2026
+*/
+
+#include "WiFiClient.h"
+#include "Emulator.h"
+#include <errno.h>
+#include <fcntl.h>
+#include <netdb.h>
+#include <poll.h>
+#include <unistd.h>
+#include <sys/ioctl.h>
+#include <sys/socket.h>
+#include <netinet/tcp.h>
+#include <linux/sockios.h>
+
+WiFiClient::Connection::~Connection() {
+    if (fd >= 0) {
+        close(fd);
+    }
+}
+
+/**
+ * #### CLASS CONSTRUCTOR ####
+ * Takes on a connection already made, such as one accepted by
+ * a server.
+ *
+ * @param fd The socket of the connection as int.
+*/
+WiFiClient::WiFiClient(int fd) {
+    int flags = fcntl(fd, F_GETFL, 0);
+    fcntl(fd, F_SETFL, flags | O_NONBLOCK);
+    connection = std::make_shared<Connection>();
+    connection->fd = fd;
+}
+
+/**
+ * Connects to the given address, from the device's own address,
+ * waiting up to the timeout set with setTimeout().
+ *
+ * @param ip The address to connect to as IPAddress.
+ * @param port The port to connect to as uint16_t.
+ *
+ * @return Returns 1 if connected otherwise 0 as int.
+*/
+int WiFiClient::connect(IPAddress ip, uint16_t port) {
+    stop();
+    int fd = socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (fd < 0) {
+
+        return 0;
+    }
+    connection = std::make_shared<Connection>();
+    connection->fd = fd;
+
+    sockaddr_in local;
+    memset(&local, 0, sizeof(local));
+    local.sin_family = AF_INET;
+    local.sin_addr.s_addr = ((uint32_t) ip == htonl(INADDR_LOOPBACK) || IPAddress(ip)[0] == 127 ? Emulator::getConfig().ip : htonl(INADDR_ANY));
+    if (bind(fd, (sockaddr *) &local, sizeof(local)) != 0) { // Can't speak for the device...
+        stop();
+
+        return 0;
+    }
+
+    sockaddr_in remote;
+    memset(&remote, 0, sizeof(remote));
+    remote.sin_family = AF_INET;
+    remote.sin_addr.s_addr = (uint32_t) ip;
+    remote.sin_port = htons(port);
+    if (::connect(fd, (sockaddr *) &remote, sizeof(remote)) != 0 && errno != EINPROGRESS) { // Refused outright...
+        stop();
+
+        return 0;
+    }
+    int error = 0;
+    socklen_t errorLength = sizeof(error);
+    if (!waitFor(POLLOUT, timeoutMillis) || getsockopt(fd, SOL_SOCKET, SO_ERROR, &error, &errorLength) != 0 || error != 0) { // Timed out or refused...
+        stop();
+
+        return 0;
+    }
+
+    return 1;
+}
+
+/**
+ * Looks up the host, as a name or dotted address, and connects
+ * to it.
+*/
+int WiFiClient::connect(const char *host, uint16_t port) {
+    IPAddress ip;
+    if (!ip.fromString(host)) { // A name...
+        addrinfo hints;
+        memset(&hints, 0, sizeof(hints));
+        hints.ai_family = AF_INET;
+        hints.ai_socktype = SOCK_STREAM;
+        addrinfo *found = nullptr;
+        if (getaddrinfo(host, nullptr, &hints, &found) != 0 || found == nullptr) { // Not known...
+
+            return 0;
+        }
+        ip = IPAddress((uint32_t) ((sockaddr_in *) found->ai_addr)->sin_addr.s_addr);
+        freeaddrinfo(found);
+    }
+
+    return connect(ip, port);
+}
+
+int WiFiClient::connect(const String &host, uint16_t port) {
+
+    return connect(host.c_str(), port);
+}
+
+/**
+ * Used to determine if the connection is still open. Data still
+ * waiting to be read counts as connected, as in the core.
+ *
+ * @return Returns 1 if connected otherwise 0 as uint8_t.
+*/
+uint8_t WiFiClient::connected() {
+    int fd = getFd();
+    if (fd < 0) {
+
+        return 0;
+    }
+    uint8_t value;
+    ssize_t count = recv(fd, &value, 1, MSG_PEEK | MSG_DONTWAIT);
+    if (count > 0 || (count < 0 && (errno == EAGAIN || errno == EWOULDBLOCK))) { // Data waiting or open but quiet...
+
+        return 1;
+    }
+
+    return 0;
+}
+
+void WiFiClient::stop() {
+    connection.reset();
+}
+
+bool WiFiClient::stop(unsigned int maxWaitMillis) {
+    stop();
+
+    return true;
+}
+
+WiFiClient::operator bool() {
+
+    return (connected() != 0);
+}
+
+size_t WiFiClient::write(uint8_t value) {
+
+    return write(&value, 1);
+}
+
+/**
+ * Writes the data, waiting up to the timeout for room to send
+ * what doesn't fit straight away.
+ *
+ * @return Returns the number of bytes written as size_t.
+*/
+size_t WiFiClient::write(const uint8_t *buffer, size_t size) {
+    int fd = getFd();
+    size_t written = 0;
+    while (fd >= 0 && written < size) {
+        ssize_t count = send(fd, buffer + written, size - written, MSG_NOSIGNAL | MSG_DONTWAIT);
+        if (count > 0) {
+            written += count;
+        } else if (count < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) { // Full...
+            if (!waitFor(POLLOUT, timeoutMillis)) {
+                break;
+            }
+        } else { // Broken...
+            break;
+        }
+    }
+
+    return written;
+}
+
+/**
+ * Gets the room left in the socket's send buffer.
+ *
+ * @return Returns the number of bytes as int.
+*/
+int WiFiClient::availableForWrite() {
+    int fd = getFd();
+    int size = 0;
+    int queued = 0;
+    socklen_t sizeLength = sizeof(size);
+    if (fd < 0 || getsockopt(fd, SOL_SOCKET, SO_SNDBUF, &size, &sizeLength) != 0 || ioctl(fd, SIOCOUTQ, &queued) != 0) {
+
+        return 0;
+    }
+
+    return max(0, (size / 2) - queued); // Linux doubles the size given for its own use
+}
+
+int WiFiClient::available() {
+    int fd = getFd();
+    int count = 0;
+    if (fd < 0 || ioctl(fd, FIONREAD, &count) != 0) {
+
+        return 0;
+    }
+
+    return count;
+}
+
+int WiFiClient::read() {
+    uint8_t value;
+
+    return (read(&value, 1) == 1 ? value : -1);
+}
+
+int WiFiClient::read(uint8_t *buffer, size_t size) {
+    int fd = getFd();
+    if (fd < 0) {
+
+        return -1;
+    }
+    ssize_t count = recv(fd, buffer, size, MSG_DONTWAIT);
+
+    return (count > 0 ? (int) count : -1);
+}
+
+int WiFiClient::peek() {
+    int fd = getFd();
+    uint8_t value;
+    if (fd < 0 || recv(fd, &value, 1, MSG_PEEK | MSG_DONTWAIT) != 1) {
+
+        return -1;
+    }
+
+    return value;
+}
+
+void WiFiClient::flush() {}
+
+bool WiFiClient::flush(unsigned int maxWaitMillis) {
+
+    return true;
+}
+
+void WiFiClient::setNoDelay(bool isNoDelay) {
+    int fd = getFd();
+    int on = (isNoDelay ? 1 : 0);
+    if (fd >= 0) {
+        setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &on, sizeof(on));
+    }
+}
+
+IPAddress WiFiClient::remoteIP() {
+    sockaddr_in remote;
+    socklen_t remoteLength = sizeof(remote);
+    int fd = getFd();
+    if (fd < 0 || getpeername(fd, (sockaddr *) &remote, &remoteLength) != 0) {
+
+        return IPAddress(0, 0, 0, 0);
+    }
+
+    return IPAddress((uint32_t) remote.sin_addr.s_addr);
+}
+
+uint16_t WiFiClient::remotePort() {
+    sockaddr_in remote;
+    socklen_t remoteLength = sizeof(remote);
+    int fd = getFd();
+    if (fd < 0 || getpeername(fd, (sockaddr *) &remote, &remoteLength) != 0) {
+
+        return 0;
+    }
+
+    return ntohs(remote.sin_port);
+}
+
+/*
+=================================================================
+Private Functions
+=================================================================
+*/
+
+int WiFiClient::getFd() const {
+
+    return (connection ? connection->fd : -1);
+}
+
+/**
+ * #### PRIVATE ####
+ * Used to wait for the socket to be ready, raising the device's
+ * background events while waiting as the core would.
+ *
+ * @param events The poll() events to wait for as short.
+ * @param timeout The longest to wait in milliseconds as unsigned long.
+ *
+ * @return Returns true if ready otherwise false as bool.
+*/
+bool WiFiClient::waitFor(short events, unsigned long timeout) {
+    unsigned long startMillis = millis();
+    while (getFd() >= 0) {
+        pollfd ready = {getFd(), events, 0};
+        if (poll(&ready, 1, 10) > 0) { // Ready or failed...
+
+            return ((ready.revents & events) != 0);
+        }
+        if ((millis() - startMillis) >= timeout) { // Gave up...
+
+            return false;
+        }
+        yield();
+    }
+
+    return false;
+}
@@ -0,0 +1,57 @@
+/*
+    WiFiClient - The emulator's stand in for the ESP8266 core's TCP client,
+    on a POSIX socket bound to the device's own loopback address so a
+    broker or server sees each device as a host of its own. Copies share
+    the one connection, as on the device.
+
+    Written by: Scott Griffis
+    Date: 10-19-2026
+*/
+
+#ifndef WiFiClient_h
+    #define WiFiClient_h
+
+    #include <memory>
+    #include <Arduino.h>
+    #include <Client.h>
+
+    class WiFiClient : public Client {
+        private:
+            struct Connection {
+                int            fd               ;
+                ~Connection();
+            };
+
+            std::shared_ptr<Connection> connection;
+
+            int            getFd             () const                 ;
+            bool           waitFor           (short events, unsigned long timeout);
+
+        public:
+            WiFiClient() {}
+            explicit WiFiClient(int fd);
+            virtual ~WiFiClient() {}
+
+            int            connect           (IPAddress ip, uint16_t port) override;
+            int            connect           (const char *host, uint16_t port) override;
+            int            connect           (const String &host, uint16_t port);
+            uint8_t        connected         () override              ;
+            void           stop              () override              ;
+            bool           stop              (unsigned int maxWaitMillis);
+            operator bool                    () override              ;
+            size_t         write             (uint8_t value) override ;
+            size_t         write             (const uint8_t *buffer, size_t size) override;
+            int            availableForWrite () override              ;
+            int            available         () override              ;
+            int            read              () override              ;
+            int            read              (uint8_t *buffer, size_t size) override;
+            int            peek              () override              ;
+            void           flush             () override              ;
+            bool           flush             (unsigned int maxWaitMillis);
+            void           setNoDelay        (bool isNoDelay)         ;
+            IPAddress      remoteIP          ()                       ;
+            uint16_t       remotePort        ()                       ;
+            using Print::write;
+    };
+
+#endif
@@ -0,0 +1,88 @@
+/*
+    WiFiServer - The emulator's stand in for the ESP8266 core's TCP server.
+
+    Written by: Scott Griffis
+    Date: 10-19-2026
+*/
+
+#include "WiFiServer.h"
+#include "Emulator.h"
+#include <poll.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <netinet/tcp.h>
+
+WiFiServer::~WiFiServer() {
+    close();
+}
+
+/**
+ * Starts listening on the device's own address.
+*/
+void WiFiServer::begin() {
+    close();
+    fd = socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (fd < 0) {
+
+        return;
+    }
+    int on = 1;
+    setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &on, sizeof(on)); // Listens again straight after a restart
+    sockaddr_in local;
+    memset(&local, 0, sizeof(local));
+    local.sin_family = AF_INET;
+    local.sin_addr.s_addr = Emulator::getConfig().ip;
+    local.sin_port = htons(Emulator::getConfig().webPort);
+    if (bind(fd, (sockaddr *) &local, sizeof(local)) != 0 || listen(fd, WIFI_SERVER_BACKLOG) != 0) {
+        Serial.printf("Emulator: Web server can't listen on %s:%u\n", IPAddress(local.sin_addr.s_addr).toString().c_str(), Emulator::getConfig().webPort);
+        close();
+    }
+}
+
+/**
+ * Used to determine if a connection is waiting to be accepted.
+ *
+ * @return Returns true if one is waiting otherwise false as bool.
+*/
+bool WiFiServer::hasClient() {
+    if (fd < 0) {
+
+        return false;
+    }
+    pollfd waiting = {fd, POLLIN, 0};
+
+    return (poll(&waiting, 1, 0) > 0 && (waiting.revents & POLLIN) != 0);
+}
+
+/**
+ * Accepts the next connection waiting, if any.
+ *
+ * @return Returns the connection, or one not connected if none was waiting as WiFiClient.
+*/
+WiFiClient WiFiServer::accept() {
+    int clientFd = (fd >= 0 ? accept4(fd, nullptr, nullptr, SOCK_CLOEXEC) : -1);
+    if (clientFd < 0) { // None waiting...
+
+        return WiFiClient();
+    }
+    int on = 1;
+    setsockopt(clientFd, IPPROTO_TCP, TCP_NODELAY, &on, sizeof(on)); // Responses go out in whole writes
+
+    return WiFiClient(clientFd);
+}
+
+uint16_t WiFiServer::getPort() {
+
+    return Emulator::getConfig().webPort;
+}
+
+void WiFiServer::close() {
+    if (fd >= 0) {
+        ::close(fd);
+        fd = -1;
+    }
+}
+
+void WiFiServer::stop() {
+    close();
+}
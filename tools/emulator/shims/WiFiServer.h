@@ -0,0 +1,38 @@
+/*
+    WiFiServer - The emulator's stand in for the ESP8266 core's TCP server.
+
+    Every device serves on the same port, so the server listens on the
+    device's own loopback address, on the port the emulator was given for
+    the devices' web servers rather than the one the firmware asks for;
+    The firmware's port 443 would need root, and would be TLS besides.
+
+    Written by: Scott Griffis
+    Date: 10-19-2026
+*/
+
+#ifndef WiFiServer_h
+    #define WiFiServer_h
+
+    #include <Arduino.h>
+    #include <WiFiClient.h>
+
+    #define WIFI_SERVER_BACKLOG 8 // Connections waiting to be accepted, about what lwIP holds
+
+    class WiFiServer {
+        private:
+            int            fd               = -1;
+            uint16_t       port             ;
+
+        public:
+            WiFiServer(uint16_t port) : port(port) {}
+            virtual ~WiFiServer();
+
+            void           begin             ()                       ;
+            bool           hasClient         ()                       ;
+            WiFiClient     accept            ()                       ;
+            uint16_t       getPort           ()                       ;
+            void           close             ()                       ;
+            void           stop              ()                       ;
+    };
+
+#endif
@@ -0,0 +1,31 @@
+/*
+    WiFiServerSecure - The emulator's stand in for the ESP8266 core's TLS
+    server and the BearSSL classes set up with it.
+
+    Written by: Scott Griffis
+    Date: 10-19-2026
+*/
+
+#include "WiFiServerSecure.h"
+
+namespace BearSSL {
+    static void saveNothing(const br_ssl_session_cache_class **ctx, br_ssl_server_context *serverCtx, const br_ssl_session_parameters *params) {}
+
+    static int loadNothing(const br_ssl_session_cache_class **ctx, br_ssl_server_context *serverCtx, br_ssl_session_parameters *params) {
+
+        return 0;
+    }
+
+    static const br_ssl_session_cache_class NO_CACHE = {sizeof(const br_ssl_session_cache_class *), saveNothing, loadNothing};
+
+    ServerSessions::ServerSessions(uint32_t size) : cache(&NO_CACHE) {}
+
+    const br_ssl_session_cache_class** ServerSessions::getCache() {
+
+        return &cache;
+    }
+
+    void WiFiServerSecure::setRSACert(const X509List *chain, const PrivateKey *key) {}
+
+    void WiFiServerSecure::setCache(ServerSessions *cache) {}
+}
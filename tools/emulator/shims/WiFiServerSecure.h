@@ -0,0 +1,60 @@
+/*
+    WiFiServerSecure - The emulator's stand in for the ESP8266 core's TLS
+    server and the BearSSL classes set up with it.
+
+    TLS is not emulated: The server hands out plain connections and the
+    certificate, key and session cache are taken and left unused. The
+    cache still gives out a class whose calls can be watched, as the
+    metrics do, though nothing ever calls it.
+
+    Written by: Scott Griffis
+    Date: 10-19-2026
+*/
+
+#ifndef WiFiServerSecure_h
+    #define WiFiServerSecure_h
+
+    #include <Arduino.h>
+    #include <WiFiClient.h>
+    #include <WiFiServer.h>
+    #include <bearssl/bearssl.h>
+
+    namespace BearSSL {
+        class X509List {
+            public:
+                X509List(const char *pem) {}
+        };
+
+        class PrivateKey {
+            public:
+                PrivateKey(const char *pem) {}
+        };
+
+        class ServerSessions {
+            private:
+                const br_ssl_session_cache_class *cache;
+
+            public:
+                ServerSessions(uint32_t size);
+
+                const br_ssl_session_cache_class** getCache();
+        };
+
+        class WiFiClientSecure : public WiFiClient {
+            public:
+                WiFiClientSecure() {}
+                WiFiClientSecure(const WiFiClient &client) : WiFiClient(client) {}
+        };
+
+        class WiFiServerSecure : public WiFiServer {
+            public:
+                using ClientType = WiFiClientSecure;
+
+                WiFiServerSecure(uint16_t port) : WiFiServer(port) {}
+
+                void       setRSACert        (const X509List *chain, const PrivateKey *key);
+                void       setCache          (ServerSessions *cache)  ;
+        };
+    }
+
+#endif
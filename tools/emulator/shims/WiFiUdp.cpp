@@ -0,0 +1,303 @@
+/*
+    WiFiUdp - The emulator's stand in for the ESP8266 core's UDP socket.
+
+    Written by: Scott Griffis
+    Date: 10-19-2026
+*/
+
+#include "WiFiUdp.h"
+#include "ESP8266WiFi.h"
+#include "Emulator.h"
+#include <errno.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <arpa/inet.h>
+
+#define UDP_BROADCAST_ADDRESS 0x7FFFFFFFu // 127.255.255.255, the emulated network's broadcast address
+
+WiFiUDP::~WiFiUDP() {
+    stop();
+}
+
+/**
+ * Starts listening on the given port, on any address.
+ *
+ * @param port The port to listen on as uint16_t.
+ *
+ * @return Returns 1 if listening otherwise 0 as uint8_t.
+*/
+uint8_t WiFiUDP::begin(uint16_t port) {
+    stop();
+    if (!openSocket()) {
+
+        return 0;
+    }
+    sockaddr_in local;
+    memset(&local, 0, sizeof(local));
+    local.sin_family = AF_INET;
+    local.sin_addr.s_addr = htonl(INADDR_ANY);
+    local.sin_port = htons(port);
+    if (bind(fd, (sockaddr *) &local, sizeof(local)) != 0) { // Port not to be had...
+        stop();
+
+        return 0;
+    }
+
+    return 1;
+}
+
+uint8_t WiFiUDP::beginMulticast(IPAddress interfaceAddr, IPAddress multicast, uint16_t port) {
+    if (begin(port) == 0) {
+
+        return 0;
+    }
+    ip_mreq membership;
+    membership.imr_multiaddr.s_addr = (uint32_t) multicast;
+    membership.imr_interface.s_addr = htonl(INADDR_LOOPBACK);
+    if (setsockopt(fd, IPPROTO_IP, IP_ADD_MEMBERSHIP, &membership, sizeof(membership)) != 0) {
+        stop();
+
+        return 0;
+    }
+
+    return 1;
+}
+
+void WiFiUDP::stop() {
+    if (fd >= 0) {
+        close(fd);
+        fd = -1;
+    }
+    receivedLength = 0;
+    receivedOffset = 0;
+    sendingLength = 0;
+    isSending = false;
+}
+
+int WiFiUDP::beginPacket(IPAddress ip, uint16_t port) {
+    if (fd < 0 && !openSocket()) { // Sent from any free port, as the core does...
+
+        return 0;
+    }
+    destinationIp = ip;
+    destinationPort = port;
+    sendingLength = 0;
+    isSending = true;
+
+    return 1;
+}
+
+int WiFiUDP::beginPacket(const char *host, uint16_t port) {
+    IPAddress ip;
+    if (!ip.fromString(host)) { // Only addresses; The firmware sends to no names...
+
+        return 0;
+    }
+
+    return beginPacket(ip, port);
+}
+
+/**
+ * Sends the packet from the device's own address. Nothing goes out
+ * while the device is off the network.
+ *
+ * @return Returns 1 if sent otherwise 0 as int.
+*/
+int WiFiUDP::endPacket() {
+    if (!isSending) {
+
+        return 0;
+    }
+    isSending = false;
+    if (WiFi.status() != WL_CONNECTED && (WiFi.getMode() & WIFI_AP) == 0) { // No network...
+
+        return 0;
+    }
+
+    sockaddr_in remote;
+    memset(&remote, 0, sizeof(remote));
+    remote.sin_family = AF_INET;
+    remote.sin_addr.s_addr = (uint32_t) destinationIp;
+    remote.sin_port = htons(destinationPort);
+    iovec payload = {sending, sendingLength};
+
+    char control[CMSG_SPACE(sizeof(in_pktinfo))];
+    memset(control, 0, sizeof(control));
+    msghdr message;
+    memset(&message, 0, sizeof(message));
+    message.msg_name = &remote;
+    message.msg_namelen = sizeof(remote);
+    message.msg_iov = &payload;
+    message.msg_iovlen = 1;
+    message.msg_control = control;
+    message.msg_controllen = sizeof(control);
+    cmsghdr *header = CMSG_FIRSTHDR(&message);
+    header->cmsg_level = IPPROTO_IP;
+    header->cmsg_type = IP_PKTINFO;
+    header->cmsg_len = CMSG_LEN(sizeof(in_pktinfo));
+    in_pktinfo *info = (in_pktinfo *) CMSG_DATA(header);
+    info->ipi_spec_dst.s_addr = Emulator::getConfig().ip;
+
+    return (sendmsg(fd, &message, MSG_DONTWAIT) == (ssize_t) sendingLength ? 1 : 0);
+}
+
+size_t WiFiUDP::write(uint8_t value) {
+
+    return write(&value, 1);
+}
+
+/**
+ * Adds to the packet being built. What doesn't fit in one packet
+ * is left out.
+ *
+ * @return Returns the number of bytes added as size_t.
+*/
+size_t WiFiUDP::write(const uint8_t *buffer, size_t size) {
+    if (!isSending) {
+
+        return 0;
+    }
+    size_t count = min(size, sizeof(sending) - sendingLength);
+    memcpy(&sending[sendingLength], buffer, count);
+    sendingLength += count;
+
+    return count;
+}
+
+/**
+ * Moves on to the next packet received, dropping what is left of
+ * the current one.
+ *
+ * @return Returns the size of the packet, or 0 if none waiting as int.
+*/
+int WiFiUDP::parsePacket() {
+    receivedLength = 0;
+    receivedOffset = 0;
+    if (fd < 0) {
+
+        return 0;
+    }
+    while (true) {
+        sockaddr_in remote;
+        iovec payload = {received, sizeof(received)};
+        char control[CMSG_SPACE(sizeof(in_pktinfo))];
+        msghdr message;
+        memset(&message, 0, sizeof(message));
+        message.msg_name = &remote;
+        message.msg_namelen = sizeof(remote);
+        message.msg_iov = &payload;
+        message.msg_iovlen = 1;
+        message.msg_control = control;
+        message.msg_controllen = sizeof(control);
+        ssize_t count = recvmsg(fd, &message, MSG_DONTWAIT);
+        if (count < 0) { // Nothing waiting...
+
+            return 0;
+        }
+
+        uint32_t destination = 0;
+        for (cmsghdr *header = CMSG_FIRSTHDR(&message); header != nullptr; header = CMSG_NXTHDR(&message, header)) {
+            if (header->cmsg_level == IPPROTO_IP && header->cmsg_type == IP_PKTINFO) {
+                destination = ((in_pktinfo *) CMSG_DATA(header))->ipi_addr.s_addr;
+            }
+        }
+        if (isForDevice(destination)) {
+            receivedLength = (size_t) count;
+            senderIp = IPAddress((uint32_t) remote.sin_addr.s_addr);
+            senderPort = ntohs(remote.sin_port);
+
+            return (int) receivedLength;
+        }
+    }
+}
+
+int WiFiUDP::available() {
+
+    return (int) (receivedLength - receivedOffset);
+}
+
+int WiFiUDP::read() {
+
+    return (receivedOffset < receivedLength ? received[receivedOffset++] : -1);
+}
+
+int WiFiUDP::read(unsigned char *buffer, size_t length) {
+    size_t count = min(length, receivedLength - receivedOffset);
+    memcpy(buffer, &received[receivedOffset], count);
+    receivedOffset += count;
+
+    return (int) count;
+}
+
+int WiFiUDP::read(char *buffer, size_t length) {
+
+    return read((unsigned char *) buffer, length);
+}
+
+int WiFiUDP::peek() {
+
+    return (receivedOffset < receivedLength ? received[receivedOffset] : -1);
+}
+
+void WiFiUDP::flush() {
+    receivedOffset = receivedLength;
+}
+
+IPAddress WiFiUDP::remoteIP() {
+
+    return senderIp;
+}
+
+uint16_t WiFiUDP::remotePort() {
+
+    return senderPort;
+}
+
+/*
+=================================================================
+Private Functions
+=================================================================
+*/
+
+/**
+ * #### PRIVATE ####
+ * Used to open a socket able to broadcast and share its port with
+ * the other devices.
+ *
+ * @return Returns true if opened otherwise false as bool.
+*/
+bool WiFiUDP::openSocket() {
+    fd = socket(AF_INET, SOCK_DGRAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (fd < 0) {
+
+        return false;
+    }
+    int on = 1;
+    setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &on, sizeof(on));
+    setsockopt(fd, SOL_SOCKET, SO_BROADCAST, &on, sizeof(on));
+    setsockopt(fd, IPPROTO_IP, IP_PKTINFO, &on, sizeof(on));
+
+    return true;
+}
+
+/**
+ * #### PRIVATE ####
+ * Used to determine if a packet received would have reached the
+ * device on a real network: Broadcasts and what was sent to the
+ * device's own address.
+ *
+ * @param destination The address the packet was sent to, in network order as uint32_t.
+ *
+ * @return Returns true if for the device otherwise false as bool.
+*/
+bool WiFiUDP::isForDevice(uint32_t destination) {
+    uint32_t address = ntohl(destination);
+
+    return (
+        address == UDP_BROADCAST_ADDRESS
+        || address == INADDR_BROADCAST
+        || IN_MULTICAST(address)
+        || destination == (uint32_t) WiFi.localIP()
+        || destination == Emulator::getConfig().ip
+    );
+}
@@ -0,0 +1,62 @@
+/*
+    WiFiUdp - The emulator's stand in for the ESP8266 core's UDP socket.
+
+    Every device listens on the same port, so sockets are bound with
+    SO_REUSEADDR to the port on any address; The host then hands each
+    broadcast to all of them, as the network would. Packets sent to
+    another device's own address are dropped on receipt. What is sent
+    goes out from the device's own address, whatever the socket is bound
+    to, so a collector sees each device as a host of its own.
+
+    Written by: Scott Griffis
+    Date: 10-19-2026
+*/
+
+#ifndef WiFiUdp_h
+    #define WiFiUdp_h
+
+    #include <Arduino.h>
+
+    #define UDP_MAX_PACKET_SIZE 1472 // Largest payload of an unfragmented packet
+
+    class WiFiUDP : public Stream {
+        private:
+            int            fd               = -1;
+            uint8_t        received         [UDP_MAX_PACKET_SIZE];
+            size_t         receivedLength   = 0;
+            size_t         receivedOffset   = 0;
+            IPAddress      senderIp         ;
+            uint16_t       senderPort       = 0;
+            uint8_t        sending          [UDP_MAX_PACKET_SIZE];
+            size_t         sendingLength    = 0;
+            IPAddress      destinationIp    ;
+            uint16_t       destinationPort  = 0;
+            bool           isSending        = false;
+
+            bool           openSocket        ()                       ;
+            bool           isForDevice       (uint32_t destination)   ;
+
+        public:
+            virtual ~WiFiUDP();
+
+            uint8_t        begin             (uint16_t port)          ;
+            uint8_t        beginMulticast    (IPAddress interfaceAddr, IPAddress multicast, uint16_t port);
+            void           stop              ()                       ;
+            int            beginPacket       (IPAddress ip, uint16_t port);
+            int            beginPacket       (const char *host, uint16_t port);
+            int            endPacket         ()                       ;
+            size_t         write             (uint8_t value) override ;
+            size_t         write             (const uint8_t *buffer, size_t size) override;
+            int            parsePacket       ()                       ;
+            int            available         () override              ;
+            int            read              () override              ;
+            int            read              (unsigned char *buffer, size_t length);
+            int            read              (char *buffer, size_t length);
+            int            peek              () override              ;
+            void           flush             ()                       ;
+            IPAddress      remoteIP          ()                       ;
+            uint16_t       remotePort        ()                       ;
+            using Print::write;
+    };
+
+#endif
@@ -0,0 +1,169 @@
+/*
+    bearssl - The emulator's stand in for BearSSL's SHA-256 and HMAC,
+    after FIPS 180-4 and RFC 2104.
+
+    Written by: Scott Griffis
+    Date: 10-19-2026
+*/
+
+#include "bearssl.h"
+#include <string.h>
+
+#define ROTATE_RIGHT(value, bits) (((value) >> (bits)) | ((value) << (32 - (bits))))
+
+static const uint32_t ROUND_CONSTANTS[64] = {
+    0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
+    0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3, 0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
+    0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+    0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
+    0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13, 0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
+    0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+    0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+    0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208, 0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2
+};
+
+static const uint32_t INITIAL_VALUES[8] = {
+    0x6a09e667, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a, 0x510e527f, 0x9b05688c, 0x1f83d9ab, 0x5be0cd19
+};
+
+/**
+ * Mixes a 64 byte chunk of the data into the hash.
+*/
+static void sha256Transform(uint32_t *val, const unsigned char *chunk) {
+    uint32_t words[64];
+    for (int i = 0; i < 16; i++) {
+        words[i] = ((uint32_t) chunk[i * 4] << 24) | ((uint32_t) chunk[(i * 4) + 1] << 16) | ((uint32_t) chunk[(i * 4) + 2] << 8) | (uint32_t) chunk[(i * 4) + 3];
+    }
+    for (int i = 16; i < 64; i++) {
+        uint32_t s0 = ROTATE_RIGHT(words[i - 15], 7) ^ ROTATE_RIGHT(words[i - 15], 18) ^ (words[i - 15] >> 3);
+        uint32_t s1 = ROTATE_RIGHT(words[i - 2], 17) ^ ROTATE_RIGHT(words[i - 2], 19) ^ (words[i - 2] >> 10);
+        words[i] = words[i - 16] + s0 + words[i - 7] + s1;
+    }
+
+    uint32_t work[8];
+    memcpy(work, val, sizeof(work));
+    for (int i = 0; i < 64; i++) {
+        uint32_t s1 = ROTATE_RIGHT(work[4], 6) ^ ROTATE_RIGHT(work[4], 11) ^ ROTATE_RIGHT(work[4], 25);
+        uint32_t choice = (work[4] & work[5]) ^ (~work[4] & work[6]);
+        uint32_t first = work[7] + s1 + choice + ROUND_CONSTANTS[i] + words[i];
+        uint32_t s0 = ROTATE_RIGHT(work[0], 2) ^ ROTATE_RIGHT(work[0], 13) ^ ROTATE_RIGHT(work[0], 22);
+        uint32_t majority = (work[0] & work[1]) ^ (work[0] & work[2]) ^ (work[1] & work[2]);
+        uint32_t second = s0 + majority;
+        memmove(&work[1], &work[0], 7 * sizeof(uint32_t));
+        work[4] += first;
+        work[0] = first + second;
+    }
+    for (int i = 0; i < 8; i++) {
+        val[i] += work[i];
+    }
+}
+
+static void vtableInit(const br_hash_class **ctx) {
+    br_sha256_init((br_sha256_context *) ctx);
+}
+
+static void vtableUpdate(const br_hash_class **ctx, const void *data, size_t len) {
+    br_sha256_update((br_sha256_context *) ctx, data, len);
+}
+
+static void vtableOut(const br_hash_class *const *ctx, void *dst) {
+    br_sha256_out((const br_sha256_context *) ctx, dst);
+}
+
+const br_hash_class br_sha256_vtable = {
+    sizeof(br_sha256_context),
+    (uint32_t) br_sha256_SIZE << 8,
+    vtableInit,
+    vtableUpdate,
+    vtableOut
+};
+
+void br_sha256_init(br_sha256_context *ctx) {
+    ctx->vtable = &br_sha256_vtable;
+    ctx->count = 0;
+    memcpy(ctx->val, INITIAL_VALUES, sizeof(ctx->val));
+}
+
+void br_sha256_update(br_sha256_context *ctx, const void *data, size_t len) {
+    const unsigned char *bytes = (const unsigned char *) data;
+    for (size_t i = 0; i < len; i++) {
+        ctx->buf[ctx->count % 64] = bytes[i];
+        ctx->count++;
+        if ((ctx->count % 64) == 0) { // Chunk full...
+            sha256Transform(ctx->val, ctx->buf);
+        }
+    }
+}
+
+/**
+ * Works out the hash of what was added so far; More may still be
+ * added afterwards, as with BearSSL.
+*/
+void br_sha256_out(const br_sha256_context *ctx, void *out) {
+    br_sha256_context copy = *ctx;
+    uint64_t bitLength = copy.count * 8;
+    unsigned char padding = 0x80;
+    br_sha256_update(&copy, &padding, 1);
+    padding = 0x00;
+    while ((copy.count % 64) != 56) {
+        br_sha256_update(&copy, &padding, 1);
+    }
+    unsigned char lengthBytes[8];
+    for (int i = 0; i < 8; i++) {
+        lengthBytes[i] = (unsigned char) (bitLength >> (56 - (8 * i)));
+    }
+    br_sha256_update(&copy, lengthBytes, sizeof(lengthBytes));
+    unsigned char *bytes = (unsigned char *) out;
+    for (int i = 0; i < 8; i++) {
+        bytes[i * 4] = (unsigned char) (copy.val[i] >> 24);
+        bytes[(i * 4) + 1] = (unsigned char) (copy.val[i] >> 16);
+        bytes[(i * 4) + 2] = (unsigned char) (copy.val[i] >> 8);
+        bytes[(i * 4) + 3] = (unsigned char) copy.val[i];
+    }
+}
+
+/**
+ * Prepares the key; Only SHA-256 is on offer, whatever vtable is given.
+*/
+void br_hmac_key_init(br_hmac_key_context *kc, const br_hash_class *digest_vtable, const void *key, size_t key_len) {
+    unsigned char padded[64];
+    memset(padded, 0, sizeof(padded));
+    if (key_len > sizeof(padded)) { // Long keys are hashed first...
+        br_sha256_context digest;
+        br_sha256_init(&digest);
+        br_sha256_update(&digest, key, key_len);
+        br_sha256_out(&digest, padded);
+    } else {
+        memcpy(padded, key, key_len);
+    }
+    kc->dig_vtable = digest_vtable;
+    for (size_t i = 0; i < sizeof(padded); i++) {
+        kc->ksi[i] = padded[i] ^ 0x36;
+        kc->kso[i] = padded[i] ^ 0x5C;
+    }
+}
+
+void br_hmac_init(br_hmac_context *ctx, const br_hmac_key_context *kc, size_t out_len) {
+    br_sha256_init(&ctx->dig);
+    br_sha256_update(&ctx->dig, kc->ksi, sizeof(kc->ksi));
+    memcpy(ctx->kso, kc->kso, sizeof(ctx->kso));
+    ctx->out_len = (out_len == 0 || out_len > br_sha256_SIZE ? br_sha256_SIZE : out_len);
+}
+
+void br_hmac_update(br_hmac_context *ctx, const void *data, size_t len) {
+    br_sha256_update(&ctx->dig, data, len);
+}
+
+size_t br_hmac_out(const br_hmac_context *ctx, void *out) {
+    unsigned char inner[br_sha256_SIZE];
+    unsigned char outer[br_sha256_SIZE];
+    br_sha256_out(&ctx->dig, inner);
+    br_sha256_context digest;
+    br_sha256_init(&digest);
+    br_sha256_update(&digest, ctx->kso, sizeof(ctx->kso));
+    br_sha256_update(&digest, inner, sizeof(inner));
+    br_sha256_out(&digest, outer);
+    memcpy(out, outer, ctx->out_len);
+
+    return ctx->out_len;
+}
@@ -0,0 +1,77 @@
+/*
+    bearssl - The emulator's stand in for the parts of BearSSL the firmware
+    uses directly: SHA-256 with HMAC, for the admin session tokens, and the
+    session cache class whose calls the metrics count. The web server is
+    plain HTTP in the emulator, so the cache is never called.
+
+    The names and shapes follow BearSSL so the firmware builds unchanged.
+
+    Written by: Scott Griffis
+    Date: 10-19-2026
+*/
+
+#ifndef bearssl_h
+    #define bearssl_h
+
+    #include <stddef.h>
+    #include <stdint.h>
+
+    typedef struct br_ssl_server_context_ br_ssl_server_context;
+
+    typedef struct {
+        unsigned char  session_id       [32];
+        unsigned char  session_id_len   ;
+        uint16_t       version          ;
+        uint16_t       cipher_suite     ;
+        unsigned char  master_secret    [48];
+    } br_ssl_session_parameters;
+
+    typedef struct br_ssl_session_cache_class_ br_ssl_session_cache_class;
+    struct br_ssl_session_cache_class_ {
+        size_t         context_size     ;
+        void         (*save)            (const br_ssl_session_cache_class **ctx, br_ssl_server_context *server_ctx, const br_ssl_session_parameters *params);
+        int          (*load)            (const br_ssl_session_cache_class **ctx, br_ssl_server_context *server_ctx, br_ssl_session_parameters *params);
+    };
+
+    typedef struct br_hash_class_ br_hash_class;
+    struct br_hash_class_ {
+        size_t         context_size     ;
+        uint32_t       desc             ; // Bits 8 to 14 hold the output size in bytes
+        void         (*init)            (const br_hash_class **ctx);
+        void         (*update)          (const br_hash_class **ctx, const void *data, size_t len);
+        void         (*out)             (const br_hash_class *const *ctx, void *dst);
+    };
+
+    #define br_sha256_SIZE 32
+
+    typedef struct {
+        const br_hash_class *vtable     ;
+        unsigned char  buf              [64];
+        uint64_t       count            ;
+        uint32_t       val              [8];
+    } br_sha256_context;
+
+    extern const br_hash_class br_sha256_vtable;
+
+    void br_sha256_init(br_sha256_context *ctx);
+    void br_sha256_update(br_sha256_context *ctx, const void *data, size_t len);
+    void br_sha256_out(const br_sha256_context *ctx, void *out);
+
+    typedef struct {
+        const br_hash_class *dig_vtable ;
+        unsigned char  ksi              [64]; // Key padded for the inner hash
+        unsigned char  kso              [64]; // Key padded for the outer hash
+    } br_hmac_key_context;
+
+    typedef struct {
+        br_sha256_context dig           ;
+        unsigned char  kso              [64];
+        size_t         out_len          ;
+    } br_hmac_context;
+
+    void br_hmac_key_init(br_hmac_key_context *kc, const br_hash_class *digest_vtable, const void *key, size_t key_len);
+    void br_hmac_init(br_hmac_context *ctx, const br_hmac_key_context *kc, size_t out_len);
+    void br_hmac_update(br_hmac_context *ctx, const void *data, size_t len);
+    size_t br_hmac_out(const br_hmac_context *ctx, void *out);
+
+#endif
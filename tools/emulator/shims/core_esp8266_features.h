@@ -0,0 +1,12 @@
+/*
+    core_esp8266_features - The emulator's stand in for the header of the
+    same name in the ESP8266 core. Nothing in it is needed on the host.
+
+    Written by: Scott Griffis
+    Date: 10-19-2026
+*/
+
+#ifndef core_esp8266_features_h
+    #define core_esp8266_features_h
+
+#endif
@@ -0,0 +1,38 @@
+/*
+    coredecls - The emulator's stand in for the ESP8266 core's internal
+    declarations which the firmware uses: The time set callback, the CRC32
+    used by the flash and the delay which ends early once a condition is
+    met.
+
+    Written by: Scott Griffis
+    Date: 10-19-2026
+*/
+
+#ifndef coredecls_h
+    #define coredecls_h
+
+    #include <stddef.h>
+    #include <stdint.h>
+    #include <functional>
+
+    unsigned long millis();
+
+    using TrivialCB = std::function<void()>;
+    using BoolCB = std::function<void(bool)>;
+
+    void settimeofday_cb(const TrivialCB &callback);
+    void settimeofday_cb(const BoolCB &callback);
+    uint32_t crc32(const void *data, size_t length, uint32_t crc = 0xffffffff);
+    void esp_delay(unsigned long ms);
+    bool esp_delay_slice(uint32_t startMillis, uint32_t timeoutMillis, uint32_t intervalMillis);
+
+    /**
+     * Waits up to the timeout, checking every interval whether to go
+     * on waiting; Returns as soon as blocked() is false.
+    */
+    template <typename T> inline void esp_delay(const uint32_t timeoutMillis, T &&blocked, const uint32_t intervalMillis) {
+        uint32_t startMillis = (uint32_t) millis();
+        while (blocked() && esp_delay_slice(startMillis, timeoutMillis, intervalMillis)) {}
+    }
+
+#endif
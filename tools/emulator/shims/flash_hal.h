@@ -0,0 +1,25 @@
+/*
+    flash_hal - The emulator's stand in for the flash layout of the
+    ESP8266 Arduino core, as a 4MB board with a filesystem area would
+    have it.
+
+    Only the filesystem area is emulated, by ESP.flashEraseSector(),
+    ESP.flashWrite() and ESP.flashRead(), and it is kept in a file of
+    the device's own. As with NOR flash an erase sets every bit of the
+    sector and a write can only clear bits, so writing over data that
+    was not erased first leaves it garbled.
+
+    Written by: Scott Griffis
+    Date: 10-19-2026
+*/
+
+#ifndef flash_hal_h
+    #define flash_hal_h
+
+    #include <stdint.h>
+
+    #define FLASH_SECTOR_SIZE 0x1000
+    #define FS_PHYS_ADDR 0x200000ul
+    #define FS_PHYS_SIZE 0x1FA000ul
+
+#endif
@@ -0,0 +1,36 @@
+/*
+    pgmspace - The emulator's stand in for the ESP8266's flash access
+    macros. Everything is in ordinary memory on the host, so each is the
+    plain function it stands for.
+
+    Written by: Scott Griffis
+    Date: 10-19-2026
+*/
+
+#ifndef pgmspace_h
+    #define pgmspace_h
+
+    #include <stdint.h>
+    #include <stdio.h>
+    #include <string.h>
+    #include <strings.h>
+
+    #define PROGMEM
+    #define PGM_P const char *
+    #define PSTR(s) (s)
+    #define pgm_read_byte(p) (*(const uint8_t *) (p))
+    #define pgm_read_word(p) (*(const uint16_t *) (p))
+    #define pgm_read_dword(p) (*(const uint32_t *) (p))
+    #define strlen_P strlen
+    #define memcpy_P memcpy
+    #define strcpy_P strcpy
+    #define strncpy_P strncpy
+    #define strcmp_P strcmp
+    #define strncmp_P strncmp
+    #define strcasecmp_P strcasecmp
+    #define strncasecmp_P strncasecmp
+    #define strstr_P strstr
+    #define snprintf_P snprintf
+    #define sprintf_P sprintf
+
+#endif
@@ -0,0 +1,19 @@
+/*
+    user_interface - The emulator's stand in for the parts of the ESP8266
+    SDK's system interface the firmware uses.
+
+    Written by: Scott Griffis
+    Date: 10-19-2026
+*/
+
+#ifndef user_interface_h
+    #define user_interface_h
+
+    #include <stdint.h>
+
+    #define SYS_CPU_80MHZ 80
+    #define SYS_CPU_160MHZ 160
+
+    extern "C" bool system_update_cpu_freq(uint8_t freq);
+
+#endif